@@ -55,22 +55,32 @@
 #include <PlayRho/Common/Math.hpp>
 #include <PlayRho/Common/Intervals.hpp>
 #include <PlayRho/Common/OptionalValue.hpp> // for Optional
+#include <PlayRho/Common/ThreadPool.hpp>
 
 #include <PlayRho/Dynamics/World.hpp>
 #include <PlayRho/Dynamics/WorldBody.hpp> // for GetAwakeCount
+#include <PlayRho/Dynamics/WorldRayCast.hpp>
+#include <PlayRho/Dynamics/WorldShapeCast.hpp>
 #include <PlayRho/Dynamics/StepConf.hpp>
 #include <PlayRho/Dynamics/Contacts/ContactSolver.hpp>
 #include <PlayRho/Dynamics/Contacts/VelocityConstraint.hpp>
 #include <PlayRho/Dynamics/Joints/Joint.hpp>
+#include <PlayRho/Dynamics/Joints/DistanceJointConf.hpp>
 #include <PlayRho/Dynamics/Joints/RevoluteJointConf.hpp>
 
 #include <PlayRho/Collision/AABB.hpp>
 #include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/WideDynamicTree.hpp>
+#include <PlayRho/Collision/BroadPhase.hpp>
+#include <PlayRho/Collision/SweepAndPrune.hpp>
+#include <PlayRho/Collision/HashGrid.hpp>
 #include <PlayRho/Collision/Manifold.hpp>
+#include <PlayRho/Collision/RayCastOutput.hpp>
 #include <PlayRho/Collision/WorldManifold.hpp>
 #include <PlayRho/Collision/ShapeSeparation.hpp>
 #include <PlayRho/Collision/Shapes/PolygonShapeConf.hpp>
 #include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/EdgeShapeConf.hpp>
 
 // #define BENCHMARK_BOX2D
 #ifdef BENCHMARK_BOX2D
@@ -1557,6 +1567,422 @@ static void AABB(benchmark::State& state)
     }
 }
 
+static playrho::d2::DynamicTree GetRandTree(unsigned count)
+{
+    // Spreads unit sized leafs out over an area that keeps their density constant.
+    const auto dim = std::sqrt(static_cast<float>(count)) * 2.0f;
+    auto tree = playrho::d2::DynamicTree{};
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto x = Rand(0.0f, dim);
+        const auto y = Rand(0.0f, dim);
+        const auto aabb = playrho::d2::AABB{
+            playrho::LengthInterval{x * playrho::Meter, (x + 1.0f) * playrho::Meter},
+            playrho::LengthInterval{y * playrho::Meter, (y + 1.0f) * playrho::Meter}
+        };
+        tree.CreateLeaf(aabb, playrho::d2::DynamicTree::LeafData{
+            playrho::BodyID(i), playrho::FixtureID(i), 0u
+        });
+    }
+    return tree;
+}
+
+static std::vector<playrho::d2::AABB> GetQueryAABBs(const playrho::d2::DynamicTree& tree,
+                                                    unsigned count)
+{
+    auto aabbs = std::vector<playrho::d2::AABB>{};
+    aabbs.reserve(count);
+    const auto capacity = tree.GetNodeCapacity();
+    for (auto i = decltype(capacity){0}; i < capacity && size(aabbs) < count; ++i)
+    {
+        if (playrho::d2::DynamicTree::IsLeaf(tree.GetHeight(i)))
+        {
+            aabbs.push_back(tree.GetAABB(i));
+        }
+    }
+    return aabbs;
+}
+
+template <class T>
+static void TreeQuery(benchmark::State& state, const T& tree,
+                      const std::vector<playrho::d2::AABB>& aabbs)
+{
+    auto found = 0u;
+    for (auto _: state)
+    {
+        for (const auto& aabb: aabbs)
+        {
+            playrho::d2::Query(tree, aabb, [&](playrho::d2::DynamicTree::Size) {
+                ++found;
+                return playrho::d2::DynamicTreeOpcode::Continue;
+            });
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size(aabbs)));
+}
+
+static void DynamicTreeQuery(benchmark::State& state)
+{
+    const auto tree = GetRandTree(static_cast<unsigned>(state.range()));
+    TreeQuery(state, tree, GetQueryAABBs(tree, 1000));
+}
+
+/// Queries a tree of randomly placed leafs with a callback either wrapped in a
+/// <code>std::function</code> or passed directly as the lambda it is.
+static void DynamicTreeQueryCallback(benchmark::State& state)
+{
+    const auto tree = GetRandTree(static_cast<unsigned>(state.range(0)));
+    const auto aabbs = GetQueryAABBs(tree, 1000);
+    auto found = 0u;
+    const auto callback = [&found](playrho::d2::DynamicTree::Size) {
+        ++found;
+        return playrho::d2::DynamicTreeOpcode::Continue;
+    };
+    const auto wrapped = playrho::d2::DynamicTreeSizeCB{callback};
+    for (auto _: state)
+    {
+        for (const auto& aabb: aabbs)
+        {
+            if (state.range(1) == 0)
+            {
+                playrho::d2::Query(tree, aabb, wrapped);
+            }
+            else
+            {
+                playrho::d2::Query(tree, aabb, callback);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size(aabbs)));
+}
+
+/// Queries a tree of randomly placed leafs for the fixtures in each of 10000 boxes,
+/// either collecting each query's hits into its own vector or querying all the boxes at
+/// once into a batch's results.
+static void DynamicTreeQueryBatch(benchmark::State& state)
+{
+    const auto tree = GetRandTree(static_cast<unsigned>(state.range(0)));
+    const auto mode = state.range(1);
+    auto aabbs = GetQueryAABBs(tree, 10000);
+    for (auto& aabb: aabbs)
+    {
+        aabb = playrho::detail::GetFattenedAABB(aabb, 2.0f * playrho::Meter);
+    }
+    auto results = playrho::d2::QueryBatchResults{};
+    auto pool = playrho::ThreadPool{(mode == 2)? 3u: 0u};
+    auto found = std::size_t{0};
+    for (auto _: state)
+    {
+        if (mode == 0)
+        {
+            for (const auto& aabb: aabbs)
+            {
+                auto hits = std::vector<playrho::d2::QueryHit>{};
+                playrho::d2::Query(tree, aabb, playrho::d2::QueryFixtureCallback{
+                    [&hits](playrho::FixtureID fixture, playrho::ChildCounter child) {
+                    hits.push_back(playrho::d2::QueryHit{fixture, child});
+                    return true;
+                }});
+                found += hits.size();
+            }
+        }
+        else
+        {
+            if (mode == 1)
+            {
+                playrho::d2::QueryBatch(tree, aabbs, results);
+            }
+            else
+            {
+                playrho::d2::QueryBatch(tree, aabbs, results, pool);
+            }
+            found += results.hits.size();
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * aabbs.size()));
+}
+
+/// Casts rays across a tree of randomly placed leafs with a callback either wrapped in a
+/// <code>std::function</code> or passed directly as the lambda it is.
+static void DynamicTreeRayCastCallback(benchmark::State& state)
+{
+    const auto count = static_cast<unsigned>(state.range(0));
+    const auto tree = GetRandTree(count);
+    const auto dim = std::sqrt(static_cast<float>(count)) * 2.0f;
+    auto inputs = std::vector<playrho::d2::RayCastInput>{};
+    for (auto i = 0u; i < 100u; ++i)
+    {
+        const auto p1 = playrho::Length2{Rand(0.0f, dim) * playrho::Meter, 0.0f * playrho::Meter};
+        const auto p2 = playrho::Length2{Rand(0.0f, dim) * playrho::Meter, dim * playrho::Meter};
+        inputs.push_back(playrho::d2::RayCastInput{p1, p2, playrho::Real(1)});
+    }
+    auto hits = 0u;
+    const auto callback = [&hits](playrho::BodyID, playrho::FixtureID, playrho::ChildCounter,
+                                  const playrho::d2::RayCastInput& input) {
+        ++hits;
+        return playrho::Real{input.maxFraction};
+    };
+    const auto wrapped = playrho::d2::DynamicTreeRayCastCB{callback};
+    for (auto _: state)
+    {
+        for (const auto& input: inputs)
+        {
+            if (state.range(1) == 0)
+            {
+                playrho::d2::RayCast(tree, input, wrapped);
+            }
+            else
+            {
+                playrho::d2::RayCast(tree, input, callback);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * inputs.size()));
+}
+
+/// Churns a tree of randomly placed leafs through many updates, incrementally optimizing
+/// it every "step" within the given budget of nodes, then queries it.
+static void ChurnedDynamicTreeQuery(benchmark::State& state)
+{
+    const auto count = static_cast<unsigned>(state.range(0));
+    const auto budget = static_cast<playrho::d2::DynamicTree::Size>(state.range(1));
+    auto tree = GetRandTree(count);
+    const auto dim = std::sqrt(static_cast<float>(count)) * 2.0f;
+    auto leafs = std::vector<playrho::d2::DynamicTree::Size>{};
+    for (auto i = playrho::d2::DynamicTree::Size{0}; i < tree.GetNodeCapacity(); ++i)
+    {
+        if (playrho::d2::DynamicTree::IsLeaf(tree.GetHeight(i)))
+        {
+            leafs.push_back(i);
+        }
+    }
+    auto next = playrho::d2::DynamicTree::Size{0};
+    const auto churn = [&]() {
+        // Moves one percent of the leafs somewhere else.
+        for (auto i = 0u; i < count / 100u; ++i)
+        {
+            const auto leaf = leafs[static_cast<std::size_t>(Rand(0.0f, 1.0f) * (count - 1))];
+            const auto x = Rand(0.0f, dim);
+            const auto y = Rand(0.0f, dim);
+            tree.UpdateLeaf(leaf, playrho::d2::AABB{
+                playrho::LengthInterval{x * playrho::Meter, (x + 1.0f) * playrho::Meter},
+                playrho::LengthInterval{y * playrho::Meter, (y + 1.0f) * playrho::Meter}
+            });
+        }
+        next = tree.Optimize(next, budget).next;
+    };
+    for (auto i = 0; i < 500; ++i)
+    {
+        churn();
+    }
+    const auto aabbs = GetQueryAABBs(tree, 1000);
+    auto found = 0u;
+    for (auto _: state)
+    {
+        churn();
+        for (const auto& aabb: aabbs)
+        {
+            playrho::d2::Query(tree, aabb, [&](playrho::d2::DynamicTree::Size) {
+                ++found;
+                return playrho::d2::DynamicTreeOpcode::Continue;
+            });
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.counters["ratio"] = static_cast<double>(ComputePerimeterRatio(tree));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size(aabbs)));
+}
+
+static void RebuiltDynamicTreeQuery(benchmark::State& state)
+{
+    auto tree = GetRandTree(static_cast<unsigned>(state.range()));
+    tree.Rebuild();
+    TreeQuery(state, tree, GetQueryAABBs(tree, 1000));
+}
+
+/// Builds a tree of randomly placed leafs either by creating the leafs one at a time
+/// (mode 0) or by creating them all at once (mode 1).
+static void DynamicTreeBuild(benchmark::State& state)
+{
+    const auto count = static_cast<unsigned>(state.range(0));
+    const auto dim = std::sqrt(static_cast<float>(count)) * 2.0f;
+    auto aabbs = std::vector<playrho::d2::AABB>{};
+    auto data = std::vector<playrho::d2::DynamicTree::LeafData>{};
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto x = Rand(0.0f, dim);
+        const auto y = Rand(0.0f, dim);
+        aabbs.push_back(playrho::d2::AABB{
+            playrho::LengthInterval{x * playrho::Meter, (x + 1.0f) * playrho::Meter},
+            playrho::LengthInterval{y * playrho::Meter, (y + 1.0f) * playrho::Meter}
+        });
+        data.push_back(playrho::d2::DynamicTree::LeafData{
+            playrho::BodyID(i), playrho::FixtureID(i), 0u
+        });
+    }
+    const auto bulk = state.range(1) != 0;
+    for (auto _: state)
+    {
+        auto tree = playrho::d2::DynamicTree{};
+        if (bulk)
+        {
+            benchmark::DoNotOptimize(tree.CreateLeafs(aabbs, data));
+        }
+        else
+        {
+            for (auto i = std::size_t{0}; i < aabbs.size(); ++i)
+            {
+                benchmark::DoNotOptimize(tree.CreateLeaf(aabbs[i], data[i]));
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * count);
+}
+
+/// Finds the pairs of overlapping leafs for which at least one of the leafs has moved,
+/// either by querying the tree for each moved leaf (mode 0) or by descending the tree
+/// against itself (mode 1).
+static void DynamicTreeFindPairs(benchmark::State& state)
+{
+    using playrho::d2::DynamicTree;
+    const auto count = static_cast<unsigned>(state.range(0));
+    const auto percentMoved = static_cast<unsigned>(state.range(1));
+    const auto mode = state.range(2);
+    const auto tree = GetRandTree(count);
+    auto moved = std::vector<bool>(tree.GetNodeCapacity());
+    auto movedLeafs = std::vector<DynamicTree::Size>{};
+    for (auto i = DynamicTree::Size{0}; i < tree.GetNodeCapacity(); ++i)
+    {
+        if (DynamicTree::IsLeaf(tree.GetHeight(i)) && (Rand(0.0f, 100.0f) < percentMoved))
+        {
+            moved[i] = true;
+            movedLeafs.push_back(i);
+        }
+    }
+    auto pairs = std::vector<std::pair<DynamicTree::Size, DynamicTree::Size>>{};
+    for (auto _: state)
+    {
+        pairs.clear();
+        if (mode == 0)
+        {
+            for (const auto leaf: movedLeafs)
+            {
+                playrho::d2::Query(tree, tree.GetAABB(leaf), [&](DynamicTree::Size other) {
+                    if (other != leaf)
+                    {
+                        pairs.emplace_back(std::min(leaf, other), std::max(leaf, other));
+                    }
+                    return playrho::d2::DynamicTreeOpcode::Continue;
+                });
+            }
+        }
+        else
+        {
+            playrho::d2::QueryPairs(tree, [&](DynamicTree::Size a, DynamicTree::Size b) {
+                if (moved[a] || moved[b])
+                {
+                    pairs.emplace_back(std::min(a, b), std::max(a, b));
+                }
+                return playrho::d2::DynamicTreeOpcode::Continue;
+            });
+        }
+        benchmark::DoNotOptimize(pairs.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size(movedLeafs)));
+}
+
+static void WideDynamicTree4Query(benchmark::State& state)
+{
+    const auto tree = GetRandTree(static_cast<unsigned>(state.range()));
+    TreeQuery(state, playrho::d2::WideDynamicTree4{tree}, GetQueryAABBs(tree, 1000));
+}
+
+static void WideDynamicTree8Query(benchmark::State& state)
+{
+    const auto tree = GetRandTree(static_cast<unsigned>(state.range()));
+    TreeQuery(state, playrho::d2::WideDynamicTree8{tree}, GetQueryAABBs(tree, 1000));
+}
+
+static playrho::d2::BroadPhase MakeBroadPhase(playrho::d2::BroadPhaseType type)
+{
+    switch (type)
+    {
+        case playrho::d2::BroadPhaseType::DynamicTree: break;
+        case playrho::d2::BroadPhaseType::SweepAndPrune:
+            return playrho::d2::BroadPhase{playrho::d2::SweepAndPrune{}};
+        case playrho::d2::BroadPhaseType::HashGrid:
+            return playrho::d2::BroadPhase{playrho::d2::HashGrid{}};
+        case playrho::d2::BroadPhaseType::WideDynamicTree:
+            return playrho::d2::BroadPhase{playrho::d2::WideDynamicTree8{}};
+    }
+    return playrho::d2::BroadPhase{playrho::d2::DynamicTree{}};
+}
+
+/// Moves every leaf of a grid of particle sized leafs back and forth a little, then
+/// queries for each leaf's overlaps - like a world step's broad-phase work. A non-zero
+/// third argument adds a ground leaf as wide as the grid underneath it.
+static void BroadPhaseUpdateAndQuery(benchmark::State& state)
+{
+    const auto count = static_cast<int>(state.range(0));
+    auto broadPhase = MakeBroadPhase(static_cast<playrho::d2::BroadPhaseType>(state.range(1)));
+    const auto columns = static_cast<int>(std::sqrt(count)) + 1;
+    auto aabbs = std::vector<playrho::d2::AABB>{};
+    auto ids = std::vector<playrho::d2::BroadPhase::Size>{};
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto x = static_cast<playrho::Real>(i % columns) * playrho::Meter;
+        const auto y = static_cast<playrho::Real>(i / columns) * playrho::Meter;
+        const auto aabb = playrho::d2::AABB{
+            playrho::LengthInterval{x, x + 1.2f * playrho::Meter},
+            playrho::LengthInterval{y, y + 1.2f * playrho::Meter}
+        };
+        aabbs.push_back(aabb);
+        ids.push_back(broadPhase.CreateLeaf(aabb, playrho::d2::DynamicTree::LeafData{
+            playrho::BodyID(static_cast<unsigned>(i)),
+            playrho::FixtureID(static_cast<unsigned>(i)), 0u
+        }));
+    }
+    if (state.range(2))
+    {
+        const auto width = static_cast<playrho::Real>(columns) * playrho::Meter;
+        broadPhase.CreateLeaf(playrho::d2::AABB{
+            playrho::LengthInterval{-1.0f * playrho::Meter, width},
+            playrho::LengthInterval{-1.0f * playrho::Meter, 0.1f * playrho::Meter}
+        }, playrho::d2::DynamicTree::LeafData{
+            playrho::BodyID(static_cast<unsigned>(count)),
+            playrho::FixtureID(static_cast<unsigned>(count)), 0u
+        });
+    }
+    auto found = 0u;
+    auto step = 0;
+    for (auto _: state)
+    {
+        const auto offset = playrho::Length2{
+            ((step % 2)? 0.05f: -0.05f) * playrho::Meter, 0.0f * playrho::Meter
+        };
+        ++step;
+        for (auto i = std::size_t{0}; i < ids.size(); ++i)
+        {
+            broadPhase.UpdateLeaf(ids[i], playrho::detail::GetMovedAABB(aabbs[i], offset));
+        }
+        for (const auto id: ids)
+        {
+            playrho::d2::Query(broadPhase, broadPhase.GetAABB(id),
+                               [&](playrho::d2::BroadPhase::Size) {
+                ++found;
+                return playrho::d2::DynamicTreeOpcode::Continue;
+            });
+        }
+    }
+    benchmark::DoNotOptimize(found);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * count);
+}
+
 // ----
 
 using TransformationPair = std::pair<playrho::d2::Transformation, playrho::d2::Transformation>;
@@ -1769,6 +2195,103 @@ static void ManifoldForTwoSquares2(benchmark::State& state)
     }
 }
 
+static void CollideShapePair(benchmark::State& state)
+{
+    const auto disk = playrho::d2::Shape{playrho::d2::DiskShapeConf{}
+        .UseRadius(0.5f * playrho::Meter)};
+    const auto box = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}
+        .SetAsBox(0.5f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto edge = playrho::d2::Shape{playrho::d2::EdgeShapeConf{}
+        .Set(playrho::Length2{-1.0f * playrho::Meter, 0.0f * playrho::Meter},
+             playrho::Length2{+1.0f * playrho::Meter, 0.0f * playrho::Meter})};
+    const playrho::d2::Shape pairs[][2] = {
+        {disk, disk}, {disk, box}, {box, box}, {edge, disk}, {edge, box},
+    };
+    const auto& shapeA = pairs[state.range(0)][0];
+    const auto& shapeB = pairs[state.range(0)][1];
+    const auto dispatched = state.range(1) != 0;
+
+    // Mostly touching placements of shape B relative to shape A at the origin.
+    constexpr auto numPlacements = 1000;
+    auto xfms = std::vector<playrho::d2::Transformation>{};
+    xfms.reserve(numPlacements);
+    for (auto i = 0; i < numPlacements; ++i)
+    {
+        const auto location = playrho::Vec2{Rand(-1.0f, 1.0f), Rand(-1.0f, 1.0f)} * playrho::Meter;
+        const auto angle = Rand(-3.14f, 3.14f) * playrho::Radian;
+        xfms.push_back(playrho::d2::Transformation{location, playrho::d2::UnitVec::Get(angle)});
+    }
+    const auto xfA = playrho::d2::Transformation{};
+    for (auto _: state)
+    {
+        for (const auto& xfB: xfms)
+        {
+            if (dispatched)
+            {
+                benchmark::DoNotOptimize(CollideShapes(shapeA, 0, xfA, shapeB, 0, xfB));
+            }
+            else
+            {
+                benchmark::DoNotOptimize(CollideShapes(GetChild(shapeA, 0), xfA,
+                                                       GetChild(shapeB, 0), xfB));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numPlacements));
+}
+
+static void ToiViaSatBoxes(benchmark::State& state)
+{
+    const auto box = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}
+        .SetAsBox(0.5f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto proxy = GetChild(box, 0);
+    const auto warmStarted = state.range(0) != 0;
+    const auto conf = playrho::ToiConf{}.UseTargetDepth(0.015f * playrho::Meter);
+
+    // Boxes approaching each other a little differently frame after frame - like a
+    // contact's bodies do from step to step.
+    constexpr auto numPairs = 100;
+    constexpr auto numFrames = 10;
+    auto sweeps = std::vector<std::pair<playrho::d2::Sweep, playrho::d2::Sweep>>{};
+    sweeps.reserve(numPairs * numFrames);
+    for (auto i = 0; i < numPairs; ++i)
+    {
+        const auto y = Rand(-0.5f, 0.5f);
+        const auto angle = Rand(-3.14f, 3.14f);
+        for (auto j = 0; j < numFrames; ++j)
+        {
+            const auto a = (angle + 0.01f * static_cast<float>(j)) * playrho::Radian;
+            const auto x = 1.5f - 0.02f * static_cast<float>(j);
+            sweeps.emplace_back(
+                playrho::d2::Sweep{
+                    playrho::d2::Position{playrho::Vec2{-x, 0.0f} * playrho::Meter, a},
+                    playrho::d2::Position{playrho::Vec2{-0.25f, 0.0f} * playrho::Meter, a}},
+                playrho::d2::Sweep{
+                    playrho::d2::Position{playrho::Vec2{+x, y} * playrho::Meter, -a},
+                    playrho::d2::Position{playrho::Vec2{+0.25f, y} * playrho::Meter, -a}});
+        }
+    }
+    for (auto _: state)
+    {
+        for (auto i = 0; i < numPairs; ++i)
+        {
+            auto indices = playrho::InvalidIndexPair3;
+            for (auto j = 0; j < numFrames; ++j)
+            {
+                const auto& pair = sweeps[static_cast<std::size_t>(i * numFrames + j)];
+                if (!warmStarted)
+                {
+                    indices = playrho::InvalidIndexPair3;
+                }
+                benchmark::DoNotOptimize(playrho::d2::GetToiViaSat(proxy, pair.first,
+                                                                   proxy, pair.second,
+                                                                   conf, indices));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numPairs * numFrames));
+}
+
 static void ConstructAndAssignVC(benchmark::State& state)
 {
     const auto friction = playrho::Real(0.5);
@@ -1889,6 +2412,77 @@ static void SolveVC(benchmark::State& state)
     }
 }
 
+static void SolveVCs(benchmark::State& state)
+{
+    // Solves as many velocity constraints as can be solved at once, one at a time for a zero
+    // second argument or all at once otherwise. The first argument is the number of points
+    // the constraints have. The constraints' bodies are all different.
+    const auto numConstraints = playrho::GaussSeidel::VelocityConstraintsPerBatch;
+    const auto friction = playrho::Real(0.5);
+    const auto restitution = playrho::Real(1);
+    const auto tangentSpeed = playrho::LinearVelocity{playrho::Real(1.5) * playrho::MeterPerSecond};
+    const auto invMass = playrho::Real(1) / playrho::Kilogram;
+    const auto invRotI = playrho::Real(1) / ((playrho::SquareMeter * playrho::Kilogram) / playrho::SquareRadian);
+    const auto normal = playrho::d2::UnitVec::GetRight();
+    const auto location = playrho::Length2{playrho::Real(0) * playrho::Meter, playrho::Real(0) * playrho::Meter};
+    const auto impulse = playrho::Momentum2{playrho::Momentum{0}, playrho::Momentum{0}};
+    const auto separation = playrho::Length{playrho::Real(-0.001) * playrho::Meter};
+    const auto ps0 = playrho::d2::WorldManifold::PointData{location, impulse, separation};
+    const auto ps1 = playrho::d2::WorldManifold::PointData{
+        playrho::Length2{playrho::Real(0) * playrho::Meter, playrho::Real(0.5) * playrho::Meter},
+        impulse, separation
+    };
+    const auto worldManifold = (state.range(0) == 2)?
+        playrho::d2::WorldManifold{normal, ps0, ps1}: playrho::d2::WorldManifold{normal, ps0};
+    
+    const auto locA = playrho::Length2{playrho::Real(+1) * playrho::Meter, playrho::Real(0) * playrho::Meter};
+    const auto posA = playrho::d2::Position{locA, playrho::Angle(0)};
+    const auto velA = playrho::d2::Velocity{
+        playrho::LinearVelocity2{playrho::Real(-0.5) * playrho::MeterPerSecond, playrho::Real(0) * playrho::MeterPerSecond},
+        playrho::AngularVelocity{playrho::Real(0) * playrho::RadianPerSecond}
+    };
+
+    const auto locB = playrho::Length2{playrho::Real(-1) * playrho::Meter, playrho::Real(0) * playrho::Meter};
+    const auto posB = playrho::d2::Position{locB, playrho::Angle(0)};
+    const auto velB = playrho::d2::Velocity{
+        playrho::LinearVelocity2{playrho::Real(+0.5) * playrho::MeterPerSecond, playrho::Real(0) * playrho::MeterPerSecond},
+        playrho::AngularVelocity{playrho::Real(0) * playrho::RadianPerSecond}
+    };
+
+    auto bodies = std::vector<playrho::d2::BodyConstraint>{};
+    bodies.reserve(numConstraints * 2u);
+    auto vcs = std::vector<playrho::d2::VelocityConstraint>{};
+    for (auto i = decltype(numConstraints){0}; i < numConstraints; ++i)
+    {
+        bodies.emplace_back(invMass, invRotI, locA, posA, velA);
+        auto& bcA = bodies.back();
+        bodies.emplace_back(invMass, invRotI, locB, posB, velB);
+        auto& bcB = bodies.back();
+        vcs.emplace_back(friction, restitution, tangentSpeed, worldManifold, bcA, bcB);
+    }
+    playrho::d2::VelocityConstraint* batch[numConstraints];
+    for (auto i = decltype(numConstraints){0}; i < numConstraints; ++i)
+    {
+        batch[i] = &vcs[i];
+    }
+    const auto atOnce = state.range(1) != 0;
+    for (auto _: state)
+    {
+        if (atOnce)
+        {
+            benchmark::DoNotOptimize(playrho::GaussSeidel::SolveVelocityConstraints(batch, numConstraints));
+        }
+        else
+        {
+            for (auto& vc: vcs)
+            {
+                benchmark::DoNotOptimize(playrho::GaussSeidel::SolveVelocityConstraint(vc));
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
 static void WorldStep(benchmark::State& state)
 {
     auto world = playrho::d2::World{playrho::d2::WorldConf{/* zero G */}};
@@ -1933,9 +2527,13 @@ static void WorldStepWithStatsDynamicBodies(benchmark::State& state)
 }
 #endif
 
-static void DropDisks(benchmark::State& state)
+static void DropDisks(benchmark::State& state, std::uint8_t threads,
+                      playrho::d2::BroadPhaseType broadPhaseType = playrho::d2::BroadPhaseType::DynamicTree,
+                      const playrho::StepConf& stepConf = playrho::StepConf{})
 {
-    auto world = playrho::d2::World{};
+    auto world = playrho::d2::World{playrho::d2::WorldConf{}
+        .UseThreads(threads)
+        .UseBroadPhaseType(broadPhaseType)};
 
     const auto diskRadius = 0.5f * playrho::Meter;
     const auto diskConf = playrho::d2::DiskShapeConf{}.UseRadius(diskRadius);
@@ -1952,14 +2550,169 @@ static void DropDisks(benchmark::State& state)
         world.CreateFixture(body, shape);
     }
 
-    const auto stepConf = playrho::StepConf{};
+    auto proxiesMoved = 0.0;
+    auto updatesAvoided = 0.0;
+    auto falsePairs = 0.0;
     for (auto _ : state)
     {
-        benchmark::DoNotOptimize(world.Step(stepConf));
+        const auto stats = world.Step(stepConf);
+        proxiesMoved += stats.reg.proxiesMoved;
+        updatesAvoided += stats.reg.updatesAvoided;
+        falsePairs += stats.pre.falsePairs + stats.reg.falsePairs;
     }
+    state.counters["moved"] = benchmark::Counter(proxiesMoved, benchmark::Counter::kAvgIterations);
+    state.counters["avoided"] = benchmark::Counter(updatesAvoided,
+                                                   benchmark::Counter::kAvgIterations);
+    state.counters["false"] = benchmark::Counter(falsePairs, benchmark::Counter::kAvgIterations);
 }
 
-static void AddPairStressTestPlayRho(benchmark::State& state, int count)
+static void DropDisks(benchmark::State& state)
+{
+    DropDisks(state, 1);
+}
+
+static void DropDisksThreads(benchmark::State& state)
+{
+    DropDisks(state, static_cast<std::uint8_t>(state.range(1)));
+}
+
+static void DropDisksBroadPhase(benchmark::State& state)
+{
+    DropDisks(state, 1, static_cast<playrho::d2::BroadPhaseType>(state.range(1)));
+}
+
+static void DropDisksAabbExtension(benchmark::State& state)
+{
+    auto stepConf = playrho::StepConf{};
+    stepConf.aabbExtensionSteps = static_cast<playrho::Real>(state.range(1));
+    stepConf.doFalsePairStats = true;
+    DropDisks(state, 1, playrho::d2::BroadPhaseType::DynamicTree, stepConf);
+}
+
+static void ManySmallIslands(benchmark::State& state)
+{
+    // Each island is a pair of boxes stacked on the ground and held together by a distance
+    // joint. Sleeping is disallowed so that every island gets solved every step.
+    const auto numIslands = static_cast<int>(state.range(0));
+    const auto threads = static_cast<std::uint8_t>(state.range(1));
+    const auto boxShape = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}
+        .UseDensity(1.0f * playrho::KilogramPerSquareMeter)
+        .SetAsBox(0.5f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto boxConf = playrho::d2::BodyConf{}
+        .UseType(playrho::BodyType::Dynamic)
+        .UseAllowSleep(false)
+        .UseLinearAcceleration(playrho::d2::EarthlyGravity);
+    const auto width = static_cast<float>(numIslands) * 1.5f;
+    auto world = playrho::d2::World{playrho::d2::WorldConf{}.UseThreads(threads)};
+    world.CreateFixture(world.CreateBody(), playrho::d2::Shape{playrho::d2::EdgeShapeConf{}
+        .Set(playrho::Vec2(-width / 2 - 1, 0.0f) * playrho::Meter,
+             playrho::Vec2(+width / 2 + 1, 0.0f) * playrho::Meter)});
+    for (auto i = 0; i < numIslands; ++i)
+    {
+        const auto x = static_cast<float>(i) * 1.5f - width / 2;
+        const auto lower = world.CreateBody(playrho::d2::BodyConf(boxConf)
+            .UseLocation(playrho::Vec2(x, 0.5f) * playrho::Meter));
+        const auto upper = world.CreateBody(playrho::d2::BodyConf(boxConf)
+            .UseLocation(playrho::Vec2(x, 1.5f) * playrho::Meter));
+        world.CreateFixture(lower, boxShape);
+        world.CreateFixture(upper, boxShape);
+        world.CreateJoint(playrho::d2::Joint{playrho::d2::GetDistanceJointConf(world, lower, upper,
+            GetLocation(world, lower), GetLocation(world, upper))});
+    }
+    const auto stepConf = playrho::StepConf{};
+    for (auto _: state)
+    {
+        world.Step(stepConf);
+    }
+}
+
+static void PyramidConstraintThreads(benchmark::State& state)
+{
+    // The pyramid's boxes form one island so only solving its constraints by colour can
+    // spread the work among threads. Zero threads solves them one at a time instead.
+    // Sleeping is disallowed so that the island gets solved every step.
+    const auto numBodies = static_cast<int>(state.range(0));
+    const auto threads = static_cast<std::uint8_t>(state.range(1));
+    auto numRows = 0;
+    while (numRows * (numRows + 1) / 2 < numBodies)
+    {
+        ++numRows;
+    }
+    const auto boxShape = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}
+        .UseDensity(1.0f * playrho::KilogramPerSquareMeter)
+        .SetAsBox(0.5f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto boxConf = playrho::d2::BodyConf{}
+        .UseType(playrho::BodyType::Dynamic)
+        .UseAllowSleep(false)
+        .UseLinearAcceleration(playrho::d2::EarthlyGravity);
+    const auto width = static_cast<float>(numRows);
+    auto world = playrho::d2::World{playrho::d2::WorldConf{}
+        .UseColorConstraints(threads > 0)
+        .UseThreads(threads)};
+    world.CreateFixture(world.CreateBody(), playrho::d2::Shape{playrho::d2::EdgeShapeConf{}
+        .Set(playrho::Vec2(-width / 2 - 1, 0.0f) * playrho::Meter,
+             playrho::Vec2(+width / 2 + 1, 0.0f) * playrho::Meter)});
+    for (auto row = 0; row < numRows; ++row)
+    {
+        for (auto column = 0; column < numRows - row; ++column)
+        {
+            const auto x = static_cast<float>(column) + static_cast<float>(row) / 2 - width / 2;
+            const auto y = static_cast<float>(row) + 0.5f;
+            const auto body = world.CreateBody(playrho::d2::BodyConf(boxConf)
+                .UseLocation(playrho::Vec2(x, y) * playrho::Meter));
+            world.CreateFixture(body, boxShape);
+        }
+    }
+    const auto stepConf = playrho::StepConf{};
+    for (auto _: state)
+    {
+        world.Step(stepConf);
+    }
+}
+
+static void PyramidWideSolve(benchmark::State& state)
+{
+    // Like PyramidConstraintThreads but with the island's constraints always solved by colour
+    // on the calling thread. A non-zero second argument solves them a batch at a time.
+    const auto numBodies = static_cast<int>(state.range(0));
+    const auto doWideSolve = state.range(1) != 0;
+    auto numRows = 0;
+    while (numRows * (numRows + 1) / 2 < numBodies)
+    {
+        ++numRows;
+    }
+    const auto boxShape = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}
+        .UseDensity(1.0f * playrho::KilogramPerSquareMeter)
+        .SetAsBox(0.5f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto boxConf = playrho::d2::BodyConf{}
+        .UseType(playrho::BodyType::Dynamic)
+        .UseAllowSleep(false)
+        .UseLinearAcceleration(playrho::d2::EarthlyGravity);
+    const auto width = static_cast<float>(numRows);
+    auto world = playrho::d2::World{playrho::d2::WorldConf{}.UseColorConstraints(true)};
+    world.CreateFixture(world.CreateBody(), playrho::d2::Shape{playrho::d2::EdgeShapeConf{}
+        .Set(playrho::Vec2(-width / 2 - 1, 0.0f) * playrho::Meter,
+             playrho::Vec2(+width / 2 + 1, 0.0f) * playrho::Meter)});
+    for (auto row = 0; row < numRows; ++row)
+    {
+        for (auto column = 0; column < numRows - row; ++column)
+        {
+            const auto x = static_cast<float>(column) + static_cast<float>(row) / 2 - width / 2;
+            const auto y = static_cast<float>(row) + 0.5f;
+            const auto body = world.CreateBody(playrho::d2::BodyConf(boxConf)
+                .UseLocation(playrho::Vec2(x, y) * playrho::Meter));
+            world.CreateFixture(body, boxShape);
+        }
+    }
+    auto stepConf = playrho::StepConf{};
+    stepConf.doWideSolve = doWideSolve;
+    for (auto _: state)
+    {
+        world.Step(stepConf);
+    }
+}
+
+static void AddPairStressTestPlayRho(benchmark::State& state, int count, std::uint8_t threads = 1)
 {
     const auto diskConf = playrho::d2::DiskShapeConf{}
         .UseRadius(playrho::Meter / 10)
@@ -1980,7 +2733,8 @@ static void AddPairStressTestPlayRho(benchmark::State& state, int count)
     constexpr auto linearSlop = 0.005f * playrho::Meter;
     constexpr auto angularSlop = (2.0f / 180.0f * playrho::Pi) * playrho::Radian;
 
-    const auto worldConf = playrho::d2::WorldConf{/* zero G */}.UseInitialTreeSize(8192);
+    const auto worldConf = playrho::d2::WorldConf{/* zero G */}
+        .UseInitialTreeSize(8192).UseThreads(threads);
     auto stepConf = playrho::StepConf{};
     stepConf.deltaTime = playrho::Second / 60;
     stepConf.linearSlop = linearSlop;
@@ -2031,6 +2785,76 @@ static void AddPairStressTestPlayRho400(benchmark::State& state)
     AddPairStressTestPlayRho(state, 400);
 }
 
+static void AddPairStressTestPlayRho400Threads(benchmark::State& state)
+{
+    AddPairStressTestPlayRho(state, 400, static_cast<std::uint8_t>(state.range(1)));
+}
+
+static void BulletsIntoTilesPlayRho(benchmark::State& state, std::uint8_t threads)
+{
+    const auto numBullets = static_cast<int>(state.range(0));
+    const auto numColumns = static_cast<int>(state.range(1));
+    constexpr auto numRows = 10;
+
+    const auto groundShape = playrho::d2::Shape{playrho::d2::EdgeShapeConf{}
+        .Set(playrho::Length2{-100.0f * playrho::Meter, 0.0f * playrho::Meter},
+             playrho::Length2{+100.0f * playrho::Meter, 0.0f * playrho::Meter})};
+    const auto tileShape = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}
+        .UseDensity(1.0f * playrho::KilogramPerSquareMeter)
+        .SetAsBox(0.5f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto bulletShape = playrho::d2::Shape{playrho::d2::DiskShapeConf{}
+        .UseRadius(0.1f * playrho::Meter)
+        .UseDensity(10.0f * playrho::KilogramPerSquareMeter)};
+
+    const auto stepConf = playrho::StepConf{};
+    const auto tileConf = playrho::d2::BodyConf{}.UseType(playrho::BodyType::Dynamic);
+    const auto bulletConf = playrho::d2::BodyConf{}
+        .UseType(playrho::BodyType::Dynamic)
+        .UseBullet(true)
+        .UseLinearVelocity(playrho::LinearVelocity2{playrho::Vec2(0.0f, -300.0f) *
+                                                    playrho::MeterPerSecond});
+    const auto width = static_cast<float>(numColumns);
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        auto world = playrho::d2::World{playrho::d2::WorldConf{}.UseThreads(threads)};
+        world.CreateFixture(world.CreateBody(), groundShape);
+        for (auto i = 0; i < numRows; ++i)
+        {
+            for (auto j = 0; j < numColumns; ++j)
+            {
+                const auto location = playrho::Vec2(static_cast<float>(j) * 1.01f - width / 2,
+                                                    static_cast<float>(i) * 1.01f + 0.5f);
+                world.CreateFixture(world.CreateBody(playrho::d2::BodyConf(tileConf)
+                                                     .UseLocation(location * playrho::Meter)),
+                                    tileShape);
+            }
+        }
+        for (auto i = 0; i < numBullets; ++i)
+        {
+            const auto location = playrho::Vec2(Rand(-width / 2, width / 2), Rand(20.0f, 40.0f));
+            world.CreateFixture(world.CreateBody(playrho::d2::BodyConf(bulletConf)
+                                                 .UseLocation(location * playrho::Meter)),
+                                bulletShape);
+        }
+        state.ResumeTiming();
+        for (auto i = 0; i < 20; ++i)
+        {
+            world.Step(stepConf);
+        }
+    }
+}
+
+static void BulletsIntoTilesPlayRho(benchmark::State& state)
+{
+    BulletsIntoTilesPlayRho(state, 1);
+}
+
+static void BulletsIntoTilesPlayRhoThreads(benchmark::State& state)
+{
+    BulletsIntoTilesPlayRho(state, static_cast<std::uint8_t>(state.range(2)));
+}
+
 #ifdef BENCHMARK_BOX2D
 static void AddPairStressTestBox2D(benchmark::State& state, int count)
 {
@@ -2082,7 +2906,10 @@ static void AddPairStressTestBox2D400(benchmark::State& state)
 }
 #endif // BENCHMARK_BOX2D
 
-static void DropTilesPlayRho(int count)
+static void DropTilesPlayRho(int count,
+                             playrho::d2::BroadPhaseType broadPhaseType = playrho::d2::BroadPhaseType::DynamicTree,
+                             bool separateStaticTree = false,
+                             bool reuseManifolds = false)
 {
     constexpr auto linearSlop = 0.005f * playrho::Meter;
     constexpr auto angularSlop = (2.0f / 180.0f * playrho::Pi) * playrho::Radian;
@@ -2093,6 +2920,7 @@ static void DropTilesPlayRho(int count)
     auto conf = playrho::d2::PolygonShapeConf{}.UseVertexRadius(vertexRadius);
     auto world = playrho::d2::World{
         playrho::d2::WorldConf{}.UseMinVertexRadius(vertexRadius).UseInitialTreeSize(8192)
+            .UseBroadPhaseType(broadPhaseType).UseSeparateStaticTree(separateStaticTree)
     };
     
     {
@@ -2160,6 +2988,11 @@ static void DropTilesPlayRho(int count)
     step.maxTranslation = 2.0f * playrho::Meter;
     step.velocityThreshold = 1.0f * playrho::MeterPerSecond;
     step.maxSubSteps = std::uint8_t{8};
+    if (reuseManifolds)
+    {
+        step.manifoldReuseDistance = linearSlop / 4;
+        step.manifoldReuseAngle = angularSlop / 8;
+    }
 
     while (GetAwakeCount(world) > 0)
     {
@@ -2253,6 +3086,150 @@ static void TilesRestPlayRho(benchmark::State& state)
     }
 }
 
+static void TilesRestPlayRhoBroadPhase(benchmark::State& state)
+{
+    const auto range = static_cast<int>(state.range(0));
+    const auto broadPhaseType = static_cast<playrho::d2::BroadPhaseType>(state.range(1));
+    for (auto _: state)
+    {
+        DropTilesPlayRho(range, broadPhaseType);
+    }
+}
+
+static void TilesRestPlayRhoStaticTree(benchmark::State& state)
+{
+    const auto range = static_cast<int>(state.range(0));
+    const auto separateStaticTree = state.range(1) != 0;
+    for (auto _: state)
+    {
+        DropTilesPlayRho(range, playrho::d2::BroadPhaseType::DynamicTree, separateStaticTree);
+    }
+}
+
+static void TilesRestPlayRhoManifoldReuse(benchmark::State& state)
+{
+    const auto range = static_cast<int>(state.range(0));
+    const auto reuseManifolds = state.range(1) != 0;
+    for (auto _: state)
+    {
+        DropTilesPlayRho(range, playrho::d2::BroadPhaseType::DynamicTree, false, reuseManifolds);
+    }
+}
+
+/// Makes a world of the given number of static disks placed randomly within a square of
+/// the given dimension.
+static playrho::d2::World GetRandDisksWorld(unsigned count, float dim)
+{
+    auto world = playrho::d2::World{};
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto location = playrho::Length2{Rand(0.0f, dim) * playrho::Meter,
+                                               Rand(0.0f, dim) * playrho::Meter};
+        const auto body = world.CreateBody(playrho::d2::BodyConf{}
+                                           .UseType(playrho::BodyType::Static)
+                                           .UseLocation(location));
+        world.CreateFixture(body, playrho::d2::Shape{
+            playrho::d2::DiskShapeConf{}.UseRadius(0.5f * playrho::Meter)});
+    }
+    auto stepConf = playrho::StepConf{};
+    stepConf.deltaTime = playrho::Time{};
+    world.Step(stepConf);
+    return world;
+}
+
+/// Sweeps 1024 rays around each of 8 sensors in a world of randomly placed disks, either
+/// casting each ray on its own or casting them all at once in packets over threads.
+static void SensorSweepRayCast(benchmark::State& state)
+{
+    const auto count = static_cast<unsigned>(state.range(0));
+    const auto mode = state.range(1);
+    const auto dim = std::sqrt(static_cast<float>(count)) * 4.0f;
+    const auto world = GetRandDisksWorld(count, dim);
+
+    auto inputs = std::vector<playrho::d2::RayCastInput>{};
+    for (auto sensor = 0; sensor < 8; ++sensor)
+    {
+        const auto origin = playrho::Length2{Rand(0.0f, dim) * playrho::Meter,
+                                             Rand(0.0f, dim) * playrho::Meter};
+        for (auto i = 0; i < 1024; ++i)
+        {
+            const auto angle = playrho::Real(i) * 2 * playrho::Pi / 1024 * playrho::Radian;
+            const auto delta = playrho::d2::Rotate(playrho::Length2{20.0f * playrho::Meter, 0.0f * playrho::Meter},
+                                                   playrho::d2::UnitVec::Get(angle));
+            inputs.push_back(playrho::d2::RayCastInput{origin, origin + delta,
+                                                       playrho::Real(1)});
+        }
+    }
+    auto outputs = std::vector<playrho::d2::FixtureRayCastOutput>(inputs.size());
+    auto pool = playrho::ThreadPool{(mode == 2)? 3u: 0u};
+    for (auto _: state)
+    {
+        if (mode == 0)
+        {
+            for (auto i = std::size_t{0}; i < inputs.size(); ++i)
+            {
+                auto& output = outputs[i];
+                playrho::d2::RayCast(world, inputs[i], playrho::d2::FixtureRayCastCB{
+                    [&output](playrho::BodyID body, playrho::FixtureID fixture,
+                              playrho::ChildCounter child, playrho::Length2 point,
+                              playrho::d2::UnitVec normal) {
+                    output = playrho::d2::FixtureRayCastHit{body, fixture, child, point, normal};
+                    return playrho::RayCastOpcode::ClipRay;
+                }});
+            }
+        }
+        else if (mode == 1)
+        {
+            playrho::d2::RayCastClosest(world, inputs, outputs);
+        }
+        else
+        {
+            playrho::d2::RayCastClosest(world, inputs, outputs, pool);
+        }
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * inputs.size()));
+}
+
+/// Sweeps 1000 boxes 5 meters each in random directions through a world of randomly
+/// placed disks, finding the closest hit of each.
+static void ShapeCastSweeps(benchmark::State& state)
+{
+    const auto count = static_cast<unsigned>(state.range(0));
+    const auto dim = std::sqrt(static_cast<float>(count)) * 4.0f;
+    const auto world = GetRandDisksWorld(count, dim);
+    const auto box = playrho::d2::Shape{playrho::d2::PolygonShapeConf{}.SetAsBox(
+        0.25f * playrho::Meter, 0.5f * playrho::Meter)};
+    const auto proxy = playrho::d2::GetChild(box, 0);
+    auto sweeps = std::vector<std::pair<playrho::d2::Transformation, playrho::Length2>>{};
+    for (auto i = 0; i < 1000; ++i)
+    {
+        const auto start = playrho::Length2{Rand(0.0f, dim) * playrho::Meter,
+                                            Rand(0.0f, dim) * playrho::Meter};
+        const auto angle = Rand(0.0f, 2 * playrho::Pi) * playrho::Radian;
+        const auto translation = playrho::d2::Rotate(
+            playrho::Length2{5.0f * playrho::Meter, 0.0f * playrho::Meter},
+            playrho::d2::UnitVec::Get(angle));
+        sweeps.emplace_back(playrho::d2::Transformation{start}, translation);
+    }
+    auto hits = 0u;
+    for (auto _: state)
+    {
+        for (const auto& sweep: sweeps)
+        {
+            playrho::d2::ShapeCast(world, proxy, sweep.first, sweep.second,
+                                   [&hits](playrho::BodyID, playrho::FixtureID,
+                                           playrho::ChildCounter, playrho::Real,
+                                           playrho::Length2, playrho::d2::UnitVec) {
+                ++hits;
+                return playrho::RayCastOpcode::ClipRay;
+            });
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * sweeps.size()));
+}
+
 #ifdef BENCHMARK_BOX2D
 static void TilesRestBox2D(benchmark::State& state)
 {
@@ -2463,6 +3440,47 @@ BENCHMARK(LengthIntervalIsIntersecting)->Arg(1000);
 BENCHMARK(AabbTestOverlap)->Arg(1000);
 BENCHMARK(AabbContains)->Arg(1000);
 BENCHMARK(AABB)->Arg(1000);
+BENCHMARK(DynamicTreeQuery)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000)->Arg(1000000);
+BENCHMARK(RebuiltDynamicTreeQuery)->Arg(1000)->Arg(10000)->Arg(100000);
+// Second argument is 0 for calling back through std::function, 1 for calling the lambda.
+BENCHMARK(DynamicTreeQueryCallback)
+    ->Args({1000, 0})->Args({1000, 1})
+    ->Args({100000, 0})->Args({100000, 1});
+// Second argument is 0 for separate queries, 1 for a batch, 2 for a batch on 4 threads.
+BENCHMARK(DynamicTreeQueryBatch)
+    ->Args({10000, 0})->Args({10000, 1})->Args({10000, 2})
+    ->Args({100000, 0})->Args({100000, 1})->Args({100000, 2})
+    ->UseRealTime();
+BENCHMARK(DynamicTreeRayCastCallback)
+    ->Args({1000, 0})->Args({1000, 1})
+    ->Args({100000, 0})->Args({100000, 1});
+BENCHMARK(ChurnedDynamicTreeQuery)
+    ->Args({10000, 0})->Args({10000, 256})->Args({10000, 4096})
+    ->Args({100000, 0})->Args({100000, 256})->Args({100000, 4096});
+BENCHMARK(DynamicTreeBuild)
+    ->Args({1000, 0})->Args({1000, 1})
+    ->Args({10000, 0})->Args({10000, 1})
+    ->Args({100000, 0})->Args({100000, 1});
+// Arguments are the leaf count, the percentage of leafs moved, and the mode.
+BENCHMARK(DynamicTreeFindPairs)
+    ->Args({10000, 10, 0})->Args({10000, 10, 1})
+    ->Args({10000, 25, 0})->Args({10000, 25, 1})
+    ->Args({10000, 50, 0})->Args({10000, 50, 1})
+    ->Args({10000, 100, 0})->Args({10000, 100, 1})
+    ->Args({100000, 10, 0})->Args({100000, 10, 1})
+    ->Args({100000, 50, 0})->Args({100000, 50, 1})
+    ->Args({100000, 100, 0})->Args({100000, 100, 1});
+BENCHMARK(WideDynamicTree4Query)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+BENCHMARK(WideDynamicTree8Query)->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000);
+// Second argument is the broad-phase type: 0 for dynamic tree, 1 for sweep and prune,
+// 2 for hash grid, 3 for wide dynamic tree. Third argument is whether to add a ground leaf.
+BENCHMARK(BroadPhaseUpdateAndQuery)
+    ->Args({100, 0, 0})->Args({100, 1, 0})->Args({100, 2, 0})->Args({100, 3, 0})
+    ->Args({1000, 0, 0})->Args({1000, 1, 0})->Args({1000, 2, 0})->Args({1000, 3, 0})
+    ->Args({10000, 0, 0})->Args({10000, 1, 0})->Args({10000, 2, 0})->Args({10000, 3, 0})
+    ->Args({10000, 0, 1})->Args({10000, 1, 1})->Args({10000, 2, 1})->Args({10000, 3, 1})
+    ->Args({100000, 0, 0})->Args({100000, 1, 0})->Args({100000, 2, 0})
+    ->Args({100000, 3, 0});
 // BENCHMARK(malloc_free_random_size);
 
 // BENCHMARK(MaxSepBetweenAbsSquares);
@@ -2472,9 +3490,19 @@ BENCHMARK(MaxSepBetweenRelSquares)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
 
 BENCHMARK(ConstructAndAssignVC);
 BENCHMARK(SolveVC);
+BENCHMARK(SolveVCs)->Args({1, 0})->Args({1, 1})->Args({2, 0})->Args({2, 1});
 
 BENCHMARK(ManifoldForTwoSquares1);
 BENCHMARK(ManifoldForTwoSquares2);
+// First argument is the shape pair: 0 for disk-disk, 1 for disk-box, 2 for box-box,
+// 3 for edge-disk, and 4 for edge-box. Second argument is 0 for colliding the shapes'
+// distance proxies, or 1 for the shape type dispatched collision.
+BENCHMARK(CollideShapePair)
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({1, 1})->Args({2, 0})->Args({2, 1})
+    ->Args({3, 0})->Args({3, 1})->Args({4, 0})->Args({4, 1});
+// Argument is 0 for calculating every time of impact from scratch, or 1 for warm
+// starting them from the simplex indices of the previous calculation for the same boxes.
+BENCHMARK(ToiViaSatBoxes)->Arg(0)->Arg(1);
 
 BENCHMARK(AsyncFutureDeferred);
 BENCHMARK(AsyncFutureAsync);
@@ -2494,6 +3522,31 @@ BENCHMARK(WorldStepWithStatsStatic)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000
 //BENCHMARK(WorldStepWithStatsDynamicBodies)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Repetitions(4);
 
 BENCHMARK(DropDisks)->Arg(0)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+// Argument is the number of islands.
+// Second argument is the number of threads.
+BENCHMARK(ManySmallIslands)
+    ->Args({100, 1})->Args({100, 2})->Args({100, 4})
+    ->Args({1000, 1})->Args({1000, 2})->Args({1000, 4})
+    ->Args({10000, 1})->Args({10000, 2})->Args({10000, 4});
+// Second argument is the number of threads: 0 for not solving by colour.
+BENCHMARK(PyramidConstraintThreads)
+    ->Args({10000, 0})->Args({10000, 1})->Args({10000, 2})->Args({10000, 4})
+    ->Args({10000, 8})->Args({10000, 16});
+BENCHMARK(PyramidWideSolve)->Args({1000, 0})->Args({1000, 1})->Args({10000, 0})->Args({10000, 1});
+// Second argument is the number of threads.
+BENCHMARK(DropDisksThreads)
+    ->Args({1000, 1})->Args({1000, 2})->Args({1000, 4})->Args({1000, 8})
+    ->Args({10000, 1})->Args({10000, 2})->Args({10000, 4})->Args({10000, 8});
+// Second argument is the broad-phase type: 0 for dynamic tree, 1 for sweep and prune,
+// 2 for hash grid.
+BENCHMARK(DropDisksBroadPhase)
+    ->Args({100, 0})->Args({100, 1})->Args({100, 2})
+    ->Args({1000, 0})->Args({1000, 1})->Args({1000, 2})
+    ->Args({10000, 0})->Args({10000, 1})->Args({10000, 2});
+// Second argument is the AABB extension steps: 0 for the fixed AABB extension.
+BENCHMARK(DropDisksAabbExtension)
+    ->Args({1000, 0})->Args({1000, 2})->Args({1000, 4})
+    ->Args({10000, 0})->Args({10000, 2})->Args({10000, 4});
 
 // BENCHMARK(random_malloc_free_100);
 
@@ -2501,11 +3554,45 @@ BENCHMARK(TumblerAdd100SquaresPlus100Steps);
 BENCHMARK(TumblerAdd200SquaresPlus200Steps);
 
 BENCHMARK(AddPairStressTestPlayRho400)->Arg(0)->Arg(10)->Arg(15)->Arg(16)->Arg(17)->Arg(18)->Arg(19)->Arg(20)->Arg(30);
+// Second argument is the number of threads.
+BENCHMARK(AddPairStressTestPlayRho400Threads)
+    ->Args({0, 1})->Args({0, 2})->Args({0, 4})->Args({0, 8})
+    ->Args({18, 1})->Args({18, 2})->Args({18, 4})->Args({18, 8})->Args({18, 16})
+    ->Args({30, 1})->Args({30, 2})->Args({30, 4})->Args({30, 8})->Args({30, 16});
+// First argument is the number of bullets fired into the tiles. Second argument is the
+// number of columns of the ten rows of tiles.
+BENCHMARK(BulletsIntoTilesPlayRho)
+    ->Args({10, 40})->Args({100, 40})->Args({100, 200})->Args({400, 200});
+// Third argument is the number of threads.
+BENCHMARK(BulletsIntoTilesPlayRhoThreads)
+    ->Args({400, 200, 1})->Args({400, 200, 2})->Args({400, 200, 4})->Args({400, 200, 8});
 #ifdef BENCHMARK_BOX2D
 BENCHMARK(AddPairStressTestBox2D400)->Arg(0)->Arg(10)->Arg(15)->Arg(16)->Arg(17)->Arg(18)->Arg(19)->Arg(20)->Arg(30);
 #endif // BENCHMARK_BOX2D
 
 BENCHMARK(TilesRestPlayRho)->Arg(12)->Arg(20)->Arg(36);
+// Second argument is the broad-phase type: 0 for dynamic tree, 1 for sweep and prune.
+BENCHMARK(TilesRestPlayRhoBroadPhase)
+    ->Args({12, 0})->Args({12, 1})
+    ->Args({20, 0})->Args({20, 1})
+    ->Args({36, 0})->Args({36, 1});
+// Second argument is whether static proxies get their own tree: 0 for no, 1 for yes.
+BENCHMARK(TilesRestPlayRhoStaticTree)
+    ->Args({12, 0})->Args({12, 1})
+    ->Args({20, 0})->Args({20, 1})
+    ->Args({36, 0})->Args({36, 1});
+// Second argument is whether touching contacts' manifolds get reused: 0 for no, 1 for yes.
+BENCHMARK(TilesRestPlayRhoManifoldReuse)
+    ->Args({12, 0})->Args({12, 1})
+    ->Args({20, 0})->Args({20, 1})
+    ->Args({36, 0})->Args({36, 1});
+BENCHMARK(ShapeCastSweeps)->Arg(1000)->Arg(10000);
+// Second argument is 0 for casting each ray, 1 for casting rays in packets, and 2 for
+// casting rays in packets on up to 4 threads.
+BENCHMARK(SensorSweepRayCast)
+    ->Args({1000, 0})->Args({1000, 1})->Args({1000, 2})
+    ->Args({10000, 0})->Args({10000, 1})->Args({10000, 2})
+    ->UseRealTime();
 #ifdef BENCHMARK_BOX2D
 BENCHMARK(TilesRestBox2D)->Arg(12)->Arg(20)->Arg(36);
 #endif // BENCHMARK_BOX2D
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef PLAYRHO_COLLISION_BROADPHASE_HPP
+#define PLAYRHO_COLLISION_BROADPHASE_HPP
+
+/// @file
+/// Declaration of the BroadPhase class and related free functions.
+
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/RayCastOutput.hpp>
+#include <PlayRho/Common/TypeInfo.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+
+class BroadPhase;
+
+// Forward declare functions.
+// Note that these may be friend functions but that declaring these within the class that
+// they're to be friends of, doesn't also insure that they're found within the namespace
+// in terms of lookup.
+
+/// @brief Queries the given broad-phase for the leafs overlapping the given AABB.
+/// @note The callback instance is called for each leaf that overlaps the supplied AABB.
+/// @relatedalso BroadPhase
+void Query(const BroadPhase& broadPhase, const AABB& aabb, const DynamicTreeSizeCB& callback);
+
+/// @brief Casts a ray against the leafs of the given broad-phase.
+/// @return <code>true</code> if terminated at the callback's request,
+///   <code>false</code> otherwise.
+/// @relatedalso BroadPhase
+bool RayCast(const BroadPhase& broadPhase, RayCastInput input,
+             const DynamicTreeRayCastCB& callback);
+
+/// @brief Gets the type of the data structure underlying the given broad-phase.
+/// @relatedalso BroadPhase
+TypeID GetType(const BroadPhase& broadPhase) noexcept;
+
+/// @brief Broad-phase.
+///
+/// @details This is a value class for the data structure that a world uses to track the
+///   AABBs of its fixtures' children and to find which of those potentially overlap.
+///   It supports runtime polymorphism of the underlying data structure without the user
+///   having to deal with pointers or inheritance.
+///
+/// @note An underlying type <code>T</code> must provide the member functions:
+///   <code>CreateLeaf</code>, <code>CreateLeafs</code>, <code>DestroyLeaf</code>, <code>UpdateLeaf</code>,
+///   <code>GetAABB</code>, <code>GetLeafData</code>, <code>GetLeafCount</code>,
+///   <code>Clear</code>, <code>Optimize</code>, and <code>ShiftOrigin</code> with the
+///   same meanings as the <code>DynamicTree</code> member functions of these names. It
+///   must also support the free functions <code>Query(const T&, const AABB&, const DynamicTreeSizeCB&)</code>
+///   and <code>RayCast(const T&, RayCastInput, const DynamicTreeRayCastCB&)</code>.
+/// @note Leaf identifiers are only meaningful to the instance that returned them.
+///
+/// @see DynamicTree, SweepAndPrune, HashGrid
+///
+class BroadPhase
+{
+public:
+    /// @brief Size type.
+    using Size = DynamicTree::Size;
+
+    /// @brief Leaf data type.
+    using LeafData = DynamicTree::LeafData;
+
+    /// @brief Optimize statistics type.
+    using OptimizeStats = DynamicTree::OptimizeStats;
+
+    /// @brief Default constructor.
+    /// @details Constructs an instance using a default constructed <code>DynamicTree</code>.
+    /// @throws std::bad_alloc if there's a failure allocating storage.
+    BroadPhase(): BroadPhase{DynamicTree{}}
+    {
+        // Intentionally empty.
+    }
+
+    /// @brief Initializing constructor.
+    /// @throws std::bad_alloc if there's a failure allocating storage.
+    template <typename T, typename Tp = std::decay_t<T>,
+        typename = std::enable_if_t<!std::is_same<Tp, BroadPhase>::value>>
+    explicit BroadPhase(T&& arg): m_self{std::make_unique<Model<Tp>>(std::forward<T>(arg))}
+    {
+        // Intentionally empty.
+    }
+
+    /// @brief Copy constructor.
+    BroadPhase(const BroadPhase& other): m_self{other.m_self->Clone()}
+    {
+        // Intentionally empty.
+    }
+
+    /// @brief Move constructor.
+    /// @note The moved from instance may only be assigned to or destroyed.
+    BroadPhase(BroadPhase&& other) noexcept = default;
+
+    /// @brief Copy assignment operator.
+    BroadPhase& operator= (const BroadPhase& other)
+    {
+        BroadPhase(other).swap(*this);
+        return *this;
+    }
+
+    /// @brief Move assignment operator.
+    BroadPhase& operator= (BroadPhase&& other) noexcept = default;
+
+    /// @brief Swap support.
+    void swap(BroadPhase& other) noexcept
+    {
+        std::swap(m_self, other.m_self);
+    }
+
+    /// @brief Creates a leaf for the given AABB with the given data.
+    /// @return Identifier of the created leaf.
+    Size CreateLeaf(const AABB& aabb, const LeafData& data)
+    {
+        return m_self->CreateLeaf_(aabb, data);
+    }
+
+    /// @brief Creates leafs for all of the given AABBs with the given data.
+    /// @return Identifiers of the created leafs, in the order of the given AABBs.
+    /// @throws InvalidArgument If the given spans are of different sizes.
+    std::vector<Size> CreateLeafs(Span<const AABB> aabbs, Span<const LeafData> data)
+    {
+        return m_self->CreateLeafs_(aabbs, data);
+    }
+
+    /// @brief Destroys the identified leaf.
+    void DestroyLeaf(Size index) noexcept
+    {
+        m_self->DestroyLeaf_(index);
+    }
+
+    /// @brief Updates the identified leaf with the given AABB.
+    void UpdateLeaf(Size index, const AABB& aabb)
+    {
+        m_self->UpdateLeaf_(index, aabb);
+    }
+
+    /// @brief Gets the AABB of the identified leaf.
+    AABB GetAABB(Size index) const noexcept
+    {
+        return m_self->GetAABB_(index);
+    }
+
+    /// @brief Gets the leaf data of the identified leaf.
+    LeafData GetLeafData(Size index) const noexcept
+    {
+        return m_self->GetLeafData_(index);
+    }
+
+    /// @brief Gets the number of leafs.
+    Size GetLeafCount() const noexcept
+    {
+        return m_self->GetLeafCount_();
+    }
+
+    /// @brief Clears all the leafs.
+    void Clear() noexcept
+    {
+        m_self->Clear_();
+    }
+
+    /// @brief Incrementally optimizes the broad-phase.
+    /// @see DynamicTree::Optimize
+    OptimizeStats Optimize(Size start, Size budget)
+    {
+        auto buffer = std::vector<Size>{};
+        return m_self->Optimize_(start, budget, buffer);
+    }
+
+    /// @brief Incrementally optimizes the broad-phase using the given scratch buffer.
+    /// @see DynamicTree::Optimize
+    OptimizeStats Optimize(Size start, Size budget, std::vector<Size>& buffer)
+    {
+        return m_self->Optimize_(start, budget, buffer);
+    }
+
+    /// @brief Shifts the world origin.
+    void ShiftOrigin(Length2 newOrigin)
+    {
+        m_self->ShiftOrigin_(newOrigin);
+    }
+
+    friend void Query(const BroadPhase& broadPhase, const AABB& aabb,
+                      const DynamicTreeSizeCB& callback)
+    {
+        broadPhase.m_self->Query_(aabb, callback);
+    }
+
+    friend bool RayCast(const BroadPhase& broadPhase, RayCastInput input,
+                        const DynamicTreeRayCastCB& callback)
+    {
+        return broadPhase.m_self->RayCast_(input, callback);
+    }
+
+    friend TypeID GetType(const BroadPhase& broadPhase) noexcept
+    {
+        return broadPhase.m_self->GetType_();
+    }
+
+    /// @brief Converts the given broad-phase into its underlying data structure.
+    /// @return Pointer to the underlying data structure or <code>nullptr</code> if it's
+    ///   not of the given type.
+    template <typename T>
+    friend auto TypeCast(const BroadPhase* value) noexcept
+    {
+        if (!value || (GetType(*value) != GetTypeID<std::remove_pointer_t<T>>())) {
+            return static_cast<T>(nullptr);
+        }
+        return static_cast<T>(value->m_self->GetData_());
+    }
+
+private:
+    /// @brief Internal configuration concept.
+    /// @note Provides the interface for runtime value polymorphism.
+    struct Concept
+    {
+        virtual ~Concept() = default;
+
+        /// @brief Clones this concept and returns a pointer to a mutable copy.
+        /// @throws std::bad_alloc if there's a failure allocating storage.
+        virtual std::unique_ptr<Concept> Clone() const = 0;
+
+        /// @brief Creates a leaf.
+        virtual Size CreateLeaf_(const AABB& aabb, const LeafData& data) = 0;
+
+        /// @brief Creates leafs.
+        virtual std::vector<Size> CreateLeafs_(Span<const AABB> aabbs,
+                                               Span<const LeafData> data) = 0;
+
+        /// @brief Destroys a leaf.
+        virtual void DestroyLeaf_(Size index) noexcept = 0;
+
+        /// @brief Updates a leaf.
+        virtual void UpdateLeaf_(Size index, const AABB& aabb) = 0;
+
+        /// @brief Gets the AABB of a leaf.
+        virtual AABB GetAABB_(Size index) const noexcept = 0;
+
+        /// @brief Gets the leaf data of a leaf.
+        virtual LeafData GetLeafData_(Size index) const noexcept = 0;
+
+        /// @brief Gets the leaf count.
+        virtual Size GetLeafCount_() const noexcept = 0;
+
+        /// @brief Clears all the leafs.
+        virtual void Clear_() noexcept = 0;
+
+        /// @brief Incrementally optimizes.
+        virtual OptimizeStats Optimize_(Size start, Size budget,
+                                        std::vector<Size>& buffer) = 0;
+
+        /// @brief Shifts the origin.
+        virtual void ShiftOrigin_(Length2 newOrigin) = 0;
+
+        /// @brief Queries for the leafs overlapping the given AABB.
+        virtual void Query_(const AABB& aabb, const DynamicTreeSizeCB& callback) const = 0;
+
+        /// @brief Casts a ray against the leafs.
+        virtual bool RayCast_(const RayCastInput& input,
+                              const DynamicTreeRayCastCB& callback) const = 0;
+
+        /// @brief Gets the use type information.
+        virtual TypeID GetType_() const noexcept = 0;
+
+        /// @brief Gets the data for the underlying data structure.
+        virtual const void* GetData_() const noexcept = 0;
+    };
+
+    /// @brief Internal model concept.
+    /// @note Provides an implementation for runtime polymorphism of the broad-phase.
+    template <typename T>
+    struct Model final: Concept
+    {
+        /// @brief Type alias for the type of the data held.
+        using data_type = T;
+
+        /// @brief Initializing constructor.
+        template <typename U>
+        explicit Model(U&& arg): data{std::forward<U>(arg)} {}
+
+        std::unique_ptr<Concept> Clone() const override
+        {
+            return std::make_unique<Model>(data);
+        }
+
+        Size CreateLeaf_(const AABB& aabb, const LeafData& leafData) override
+        {
+            return data.CreateLeaf(aabb, leafData);
+        }
+
+        std::vector<Size> CreateLeafs_(Span<const AABB> aabbs,
+                                       Span<const LeafData> leafData) override
+        {
+            return data.CreateLeafs(aabbs, leafData);
+        }
+
+        void DestroyLeaf_(Size index) noexcept override
+        {
+            data.DestroyLeaf(index);
+        }
+
+        void UpdateLeaf_(Size index, const AABB& aabb) override
+        {
+            data.UpdateLeaf(index, aabb);
+        }
+
+        AABB GetAABB_(Size index) const noexcept override
+        {
+            return data.GetAABB(index);
+        }
+
+        LeafData GetLeafData_(Size index) const noexcept override
+        {
+            return data.GetLeafData(index);
+        }
+
+        Size GetLeafCount_() const noexcept override
+        {
+            return data.GetLeafCount();
+        }
+
+        void Clear_() noexcept override
+        {
+            data.Clear();
+        }
+
+        OptimizeStats Optimize_(Size start, Size budget,
+                                std::vector<Size>& buffer) override
+        {
+            return data.Optimize(start, budget, buffer);
+        }
+
+        void ShiftOrigin_(Length2 newOrigin) override
+        {
+            data.ShiftOrigin(newOrigin);
+        }
+
+        void Query_(const AABB& aabb, const DynamicTreeSizeCB& callback) const override
+        {
+            Query(data, aabb, callback);
+        }
+
+        bool RayCast_(const RayCastInput& input,
+                      const DynamicTreeRayCastCB& callback) const override
+        {
+            return RayCast(data, input, callback);
+        }
+
+        TypeID GetType_() const noexcept override
+        {
+            return GetTypeID<data_type>();
+        }
+
+        const void* GetData_() const noexcept override
+        {
+            return &data;
+        }
+
+        data_type data; ///< Data.
+    };
+
+    std::unique_ptr<Concept> m_self; ///< Self pointer.
+};
+
+/// @brief Tests for overlap of the identified leafs of the given broad-phase.
+/// @relatedalso BroadPhase
+inline bool TestOverlap(const BroadPhase& broadPhase,
+                        BroadPhase::Size leafIdA, BroadPhase::Size leafIdB) noexcept
+{
+    return TestOverlap(broadPhase.GetAABB(leafIdA), broadPhase.GetAABB(leafIdB));
+}
+
+/// @brief Queries the given broad-phase for all fixtures that potentially overlap the
+///   provided AABB.
+/// @param broadPhase Broad-phase to do the query over.
+/// @param aabb The query box.
+/// @param callback User implemented callback function.
+/// @relatedalso BroadPhase
+inline void Query(const BroadPhase& broadPhase, const AABB& aabb,
+                  const QueryFixtureCallback& callback)
+{
+    Query(broadPhase, aabb, [&](BroadPhase::Size leafId) {
+        const auto leafData = broadPhase.GetLeafData(leafId);
+        return callback(leafData.fixture, leafData.childIndex)?
+            DynamicTreeOpcode::Continue: DynamicTreeOpcode::End;
+    });
+}
+
+/// @brief Casts the specified instance into the template specified type.
+/// @throws std::bad_cast If the template specified type is not the type of data underlying
+///   the given instance.
+/// @relatedalso BroadPhase
+template <typename T>
+inline const T& TypeCast(const BroadPhase& broadPhase)
+{
+    const auto tmp = TypeCast<std::add_pointer_t<std::add_const_t<T>>>(&broadPhase);
+    if (tmp == nullptr)
+        throw std::bad_cast();
+    return *tmp;
+}
+
+/// @brief Gets the "size" of the given broad-phase.
+/// @note Size in this context is defined as the leaf count.
+/// @relatedalso BroadPhase
+inline std::size_t size(const BroadPhase& broadPhase) noexcept
+{
+    return broadPhase.GetLeafCount();
+}
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_COLLISION_BROADPHASE_HPP
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef PLAYRHO_COLLISION_BROADPHASETYPE_HPP
+#define PLAYRHO_COLLISION_BROADPHASETYPE_HPP
+
+/// @file
+/// Declaration of the BroadPhaseType enumeration.
+
+namespace playrho {
+namespace d2 {
+
+/// @brief Broad-phase type enumeration.
+/// @details Identifies the data structure a world uses to find potentially overlapping
+///   fixture children.
+/// @see WorldConf::broadPhaseType
+enum class BroadPhaseType
+{
+    /// @brief Dynamic AABB tree.
+    /// @details A good general purpose choice.
+    /// @see DynamicTree
+    DynamicTree,
+
+    /// @brief Sort and sweep along the X axis.
+    /// @details Can be faster than the dynamic tree for worlds whose bodies are spread
+    ///   out along the X axis and that move little relative to each other per step.
+    /// @see SweepAndPrune
+    SweepAndPrune,
+
+    /// @brief Spatial hash grid.
+    /// @details Can be faster than the dynamic tree for worlds of many similarly sized
+    ///   shapes - like particles - when its cell size suits them.
+    /// @see HashGrid, WorldConf::hashGridCellSize
+    HashGrid,
+
+    /// @brief Eight wide bounding volume hierarchy.
+    /// @details Can be faster than the dynamic tree for worlds of many proxies where
+    ///   queries dominate, since it takes fewer node visits to find overlaps.
+    /// @note This only gets rebuilt for a higher quality tree when the step
+    ///   configuration's <code>treeOptimizeBudget</code> is non-zero.
+    /// @see WideDynamicTree, StepConf::treeOptimizeBudget
+    WideDynamicTree,
+};
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_COLLISION_BROADPHASETYPE_HPP
@@ -228,9 +228,19 @@ Area TestOverlap(const DistanceProxy& proxyA, const Transformation& xfA,
                  const DistanceProxy& proxyB, const Transformation& xfB,
                  DistanceConf conf)
 {
+    auto indices = conf.cache.indices;
+    return TestOverlap(proxyA, xfA, proxyB, xfB, conf, indices);
+}
+
+Area TestOverlap(const DistanceProxy& proxyA, const Transformation& xfA,
+                 const DistanceProxy& proxyB, const Transformation& xfB,
+                 DistanceConf conf, IndexPair3& indices)
+{
+    conf.cache.indices = indices;
     const auto distanceInfo = Distance(proxyA, xfA, proxyB, xfB, conf);
     assert(distanceInfo.state != DistanceOutput::Unknown && distanceInfo.state != DistanceOutput::HitMaxIters);
-    
+    indices = GetIndexPairs(distanceInfo.simplex.GetEdges());
+
     const auto witnessPoints = GetWitnessPoints(distanceInfo.simplex);
     const auto distanceSquared = GetMagnitudeSquared(GetDelta(witnessPoints));
     const auto totalRadiusSquared = Square(proxyA.GetVertexRadius() + proxyB.GetVertexRadius());
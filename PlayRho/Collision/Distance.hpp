@@ -113,6 +113,24 @@ Area TestOverlap(const DistanceProxy& proxyA, const Transformation& xfA,
                  const DistanceProxy& proxyB, const Transformation& xfB,
                  DistanceConf conf = DistanceConf{});
 
+/// @brief Determine if two generic shapes overlap using the given simplex indices.
+///
+/// @details This is the same as the other <code>TestOverlap</code> function except that
+///   the distance calculation is warm started from the given simplex indices and the
+///   given indices are updated to those the distance calculation ended with.
+///
+/// @param proxyA Proxy A.
+/// @param xfA Transformation of A.
+/// @param proxyB Proxy B.
+/// @param xfB Transformation of B.
+/// @param conf Configuration to use. Its cache indices are replaced by the given ones.
+/// @param indices Simplex indices to warm start from. These must be invalid or
+///   within the vertex counts of the given proxies.
+///
+Area TestOverlap(const DistanceProxy& proxyA, const Transformation& xfA,
+                 const DistanceProxy& proxyB, const Transformation& xfB,
+                 DistanceConf conf, IndexPair3& indices);
+
 } // namespace d2
 } // namespace playrho
 
@@ -22,8 +22,11 @@
 #include <PlayRho/Collision/DynamicTree.hpp>
 #include <PlayRho/Common/GrowableStack.hpp>
 #include <PlayRho/Common/DynamicMemory.hpp>
+#include <PlayRho/Common/InvalidArgument.hpp>
 #include <PlayRho/Common/Math.hpp>
 #include <PlayRho/Common/Templates.hpp>
+#include <PlayRho/Common/ThreadPool.hpp>
+#include <PlayRho/Detail/QueryBatch.hpp>
 
 #include <algorithm>
 #include <cstring>
@@ -58,31 +61,43 @@ static_assert(std::is_nothrow_move_assignable<DynamicTree::LeafData>::value,
 
 namespace {
 
-inline DynamicTree::TreeNode
-MakeNode(DynamicTree::Size c1, const AABB& aabb1, DynamicTree::Height h1,
-         DynamicTree::Size c2, const AABB& aabb2, DynamicTree::Height h2,
-         DynamicTree::Size parent) noexcept
+/// @brief Node arrays that restructuring the tree works with.
+/// @note Restructuring never needs the leaf payloads so those aren't included.
+struct NodeArrays
 {
-    return DynamicTree::TreeNode{
-        DynamicTree::BranchData{c1, c2}, GetEnclosingAABB(aabb1, aabb2), 1 + std::max(h1, h2), parent
+    AABB* aabbs; ///< Node AABBs.
+    DynamicTree::TopologyData* topology; ///< Node topology.
+};
+
+/// @brief Assigns the identified node to be a branch node of the given children.
+/// @details Sets the node's AABB and height from its children.
+inline void AssignBranch(NodeArrays nodes, DynamicTree::Size index,
+                         DynamicTree::BranchData bd, DynamicTree::Size parent) noexcept
+{
+    assert(bd.child1 != DynamicTree::GetInvalidSize());
+    assert(bd.child2 != DynamicTree::GetInvalidSize());
+    nodes.aabbs[index] = GetEnclosingAABB(nodes.aabbs[bd.child1], nodes.aabbs[bd.child2]);
+    nodes.topology[index] = DynamicTree::TopologyData{
+        bd, 1 + std::max(nodes.topology[bd.child1].height, nodes.topology[bd.child2].height), parent
     };
 }
 
 std::pair<DynamicTree::Size, DynamicTree::Size>
-MakeMoveStay(const DynamicTree::TreeNode& nodeA, DynamicTree::Size indexA,
-             const DynamicTree::TreeNode& nodeB, DynamicTree::Size indexB,
+MakeMoveStay(NodeArrays nodes, DynamicTree::Size indexA, DynamicTree::Size indexB,
              const AABB& toBox) noexcept
 {
-    if (nodeA.GetHeight() < nodeB.GetHeight())
+    const auto heightA = nodes.topology[indexA].height;
+    const auto heightB = nodes.topology[indexB].height;
+    if (heightA < heightB)
     {
         return std::make_pair(indexA, indexB);
     }
-    if (nodeB.GetHeight() < nodeA.GetHeight())
+    if (heightB < heightA)
     {
         return std::make_pair(indexB, indexA);
     }
-    const auto perimA = GetPerimeter(GetEnclosingAABB(toBox, nodeA.GetAABB()));
-    const auto perimB = GetPerimeter(GetEnclosingAABB(toBox, nodeB.GetAABB()));
+    const auto perimA = GetPerimeter(GetEnclosingAABB(toBox, nodes.aabbs[indexA]));
+    const auto perimB = GetPerimeter(GetEnclosingAABB(toBox, nodes.aabbs[indexB]));
     if (perimA < perimB)
     {
         return std::make_pair(indexA, indexB);
@@ -94,10 +109,10 @@ MakeMoveStay(const DynamicTree::TreeNode& nodeA, DynamicTree::Size indexA,
     return std::make_pair(indexA, indexB);
 }
 
-DynamicTree::Size RebalanceAt(DynamicTree::TreeNode nodes[], DynamicTree::Size i) noexcept
+DynamicTree::Size RebalanceAt(NodeArrays nodes, DynamicTree::Size i) noexcept
 {
-    //assert(index < GetNodeCapacity());
-    assert(DynamicTree::IsBranch(nodes[i].GetHeight()));
+    const auto topology = nodes.topology;
+    assert(DynamicTree::IsBranch(topology[i].height));
     
     //          o
     //          |
@@ -106,22 +121,17 @@ DynamicTree::Size RebalanceAt(DynamicTree::TreeNode nodes[], DynamicTree::Size i
     //      *-c1  c2-*
     //     /   |  |   \
     // c1c1 c1c2  c2c1 c2c2
-    const auto oldNodeI = nodes[i];
-    const auto o = oldNodeI.GetOther();
-    const auto c1 = oldNodeI.AsBranch().child1;
-    const auto c2 = oldNodeI.AsBranch().child2;
-    auto c1Node = nodes[c1];
-    auto c2Node = nodes[c2];
-    const auto c1Height = c1Node.GetHeight();
-    const auto c2Height = c2Node.GetHeight();
+    const auto o = topology[i].other;
+    const auto c1 = topology[i].branch.child1;
+    const auto c2 = topology[i].branch.child2;
+    const auto c1Height = topology[c1].height;
+    const auto c2Height = topology[c2].height;
     
     if (c2Height > (c1Height + 1))
     {
         // child 2 heavier than child 1, child 2 must be branch, rotate it up.
-        const auto c2c1 = c2Node.AsBranch().child1;
-        const auto c2c2 = c2Node.AsBranch().child2;
-        const auto c2c1Node = nodes[c2c1];
-        const auto c2c2Node = nodes[c2c2];
+        const auto c2c1 = topology[c2].branch.child1;
+        const auto c2c2 = topology[c2].branch.child2;
 
         // From:
         //          *i*
@@ -139,28 +149,14 @@ DynamicTree::Size RebalanceAt(DynamicTree::TreeNode nodes[], DynamicTree::Size i
         //    c1    c2cX
         //
         // Rotate left and pick the taller of c2c1 or c2c2 or the better fitting to move to the new i node.
-        const auto ms = MakeMoveStay(c2c1Node, c2c1, c2c2Node, c2c2, c1Node.GetAABB());
-        const auto newNodeI = MakeNode(c1, c1Node.GetAABB(), c1Height,
-                                       ms.first, nodes[ms.first].GetAABB(), nodes[ms.first].GetHeight(),
-                                       c2);
-        c2Node = MakeNode(i, newNodeI.GetAABB(), newNodeI.GetHeight(),
-                          ms.second, nodes[ms.second].GetAABB(), nodes[ms.second].GetHeight(),
-                          o);
-        nodes[ms.first].SetOther(i);
-        nodes[i] = newNodeI;
-        nodes[c2] = c2Node;
+        const auto ms = MakeMoveStay(nodes, c2c1, c2c2, nodes.aabbs[c1]);
+        topology[ms.first].other = i;
+        AssignBranch(nodes, i, DynamicTree::BranchData{c1, ms.first}, c2);
+        AssignBranch(nodes, c2, DynamicTree::BranchData{i, ms.second}, o);
         if (o != DynamicTree::GetInvalidSize())
         {
-            const auto oNode = nodes[o];
-            const auto oNodeBD = oNode.AsBranch();
-            assert(oNodeBD.child1 == i || oNodeBD.child2 == i);
-            nodes[o] = (oNodeBD.child1 == i)?
-                MakeNode(c2, c2Node.GetAABB(), c2Node.GetHeight(),
-                         oNodeBD.child2, nodes[oNodeBD.child2].GetAABB(), nodes[oNodeBD.child2].GetHeight(),
-                         oNode.GetOther()):
-                MakeNode(oNodeBD.child1, nodes[oNodeBD.child1].GetAABB(), nodes[oNodeBD.child1].GetHeight(),
-                         c2, c2Node.GetAABB(), c2Node.GetHeight(),
-                         oNode.GetOther());
+            assert(topology[o].branch.child1 == i || topology[o].branch.child2 == i);
+            AssignBranch(nodes, o, ReplaceChild(topology[o].branch, i, c2), topology[o].other);
         }
         return c2;
     }
@@ -168,10 +164,8 @@ DynamicTree::Size RebalanceAt(DynamicTree::TreeNode nodes[], DynamicTree::Size i
     if (c1Height > (c2Height + 1))
     {
         // child1 must be a branch, rotate it up.
-        const auto c1c1 = c1Node.AsBranch().child1;
-        const auto c1c2 = c1Node.AsBranch().child2;
-        const auto c1c1Node = nodes[c1c1];
-        const auto c1c2Node = nodes[c1c2];
+        const auto c1c1 = topology[c1].branch.child1;
+        const auto c1c2 = topology[c1].branch.child2;
         
         // From:
         //          *i*
@@ -189,49 +183,36 @@ DynamicTree::Size RebalanceAt(DynamicTree::TreeNode nodes[], DynamicTree::Size i
         //           c1cY    c2
         //
         // Rotate right and pick the taller of c1c1 or c1c2 or the better fitting to move to the new i node.
-        const auto ms = MakeMoveStay(c1c1Node, c1c1, c1c2Node, c1c2, c2Node.GetAABB());
-        const auto newNodeI = MakeNode(ms.first, nodes[ms.first].GetAABB(), nodes[ms.first].GetHeight(),
-                                       c2, c2Node.GetAABB(), c2Height,
-                                       c1);
-        c1Node = MakeNode(ms.second, nodes[ms.second].GetAABB(), nodes[ms.second].GetHeight(),
-                          i, newNodeI.GetAABB(), newNodeI.GetHeight(),
-                          o);
-        nodes[ms.first].SetOther(i);
-        nodes[i] = newNodeI;
-        nodes[c1] = c1Node;
+        const auto ms = MakeMoveStay(nodes, c1c1, c1c2, nodes.aabbs[c2]);
+        topology[ms.first].other = i;
+        AssignBranch(nodes, i, DynamicTree::BranchData{ms.first, c2}, c1);
+        AssignBranch(nodes, c1, DynamicTree::BranchData{ms.second, i}, o);
         if (o != DynamicTree::GetInvalidSize())
         {
-            const auto oNode = nodes[o];
-            const auto oNodeBD = oNode.AsBranch();
-            assert(oNodeBD.child1 == i || oNodeBD.child2 == i);
-            nodes[o] = (oNodeBD.child1 == i)?
-                MakeNode(c1, c1Node.GetAABB(), c1Node.GetHeight(),
-                         oNodeBD.child2, nodes[oNodeBD.child2].GetAABB(), nodes[oNodeBD.child2].GetHeight(),
-                         oNode.GetOther()):
-                MakeNode(oNodeBD.child1, nodes[oNodeBD.child1].GetAABB(), nodes[oNodeBD.child1].GetHeight(),
-                         c1, c1Node.GetAABB(), c1Node.GetHeight(),
-                         oNode.GetOther());
+            assert(topology[o].branch.child1 == i || topology[o].branch.child2 == i);
+            AssignBranch(nodes, o, ReplaceChild(topology[o].branch, i, c1), topology[o].other);
         }
         return c1;
     }
     
-    nodes[i] = MakeNode(c1, c1Node.GetAABB(), c1Node.GetHeight(), c2, c2Node.GetAABB(), c2Height, o);
+    AssignBranch(nodes, i, DynamicTree::BranchData{c1, c2}, o);
     return i;
 }
 
 /// @brief Updates upward from location in tree.
 /// @note In addition to updating the heights & AABBs of branch nodes, this also rebalances
 ///  the tree.
-DynamicTree::Size UpdateUpwardFrom(DynamicTree::TreeNode nodes[], DynamicTree::Size start) noexcept
+DynamicTree::Size UpdateUpwardFrom(NodeArrays nodes, DynamicTree::Size start) noexcept
 {
-    assert(DynamicTree::IsBranch(nodes[start].GetHeight()));
+    const auto topology = nodes.topology;
+    assert(DynamicTree::IsBranch(topology[start].height));
     auto rootIndex = DynamicTree::GetInvalidSize();
-    for (auto index = start; index != DynamicTree::GetInvalidSize(); index = nodes[index].GetOther())
+    for (auto index = start; index != DynamicTree::GetInvalidSize(); index = topology[index].other)
     {
-        assert(DynamicTree::IsBranch(nodes[index].GetHeight()));
-        assert(nodes[nodes[index].AsBranch().child1].GetOther() == index);
-        assert(nodes[nodes[index].AsBranch().child2].GetOther() == index);
-        if (nodes[index].GetHeight() >= 2)
+        assert(DynamicTree::IsBranch(topology[index].height));
+        assert(topology[topology[index].branch.child1].other == index);
+        assert(topology[topology[index].branch.child2].other == index);
+        if (topology[index].height >= 2)
         {
             index = RebalanceAt(nodes, index);
         }
@@ -245,30 +226,30 @@ DynamicTree::Size UpdateUpwardFrom(DynamicTree::TreeNode nodes[], DynamicTree::S
 /// @details Finds the index of the "lowest cost" node using a surface area heuristic
 ///   (S.A.H.) for two dimensions.
 /// @warning Behavior is undefined if the given index is invalid or for an unused node.
-DynamicTree::Size FindLowestCostNode(const DynamicTree::TreeNode nodes[],
-                                     AABB leafAABB, DynamicTree::Size index) noexcept
+DynamicTree::Size FindLowestCostNode(NodeArrays nodes, AABB leafAABB,
+                                     DynamicTree::Size index) noexcept
 {
+    const auto topology = nodes.topology;
     assert(IsValid(leafAABB));
     assert(index != DynamicTree::GetInvalidSize());
-    assert(!playrho::d2::IsUnused(nodes[index]));
+    assert(!DynamicTree::IsUnused(topology[index].height));
     
     // Cost function to calculate cost of descending into specified child
-    const auto costFunc = [leafAABB](const DynamicTree::TreeNode& childNode, Length inheritCost) {
-        const auto childAabb = playrho::d2::GetAABB(childNode);
-        const auto isLeaf = playrho::d2::IsLeaf(childNode);
+    const auto costFunc = [nodes,leafAABB](DynamicTree::Size child, Length inheritCost) {
+        const auto childAabb = nodes.aabbs[child];
+        const auto isLeaf = DynamicTree::IsLeaf(nodes.topology[child].height);
         const auto leafCost = GetPerimeter(GetEnclosingAABB(leafAABB, childAabb)) + inheritCost;
         return isLeaf? leafCost: (leafCost - GetPerimeter(childAabb));
     };
     
-    while (playrho::d2::IsBranch(nodes[index]))
+    while (DynamicTree::IsBranch(topology[index].height))
     {
-        const auto& node = nodes[index];
-        const auto branch = node.AsBranch();
+        const auto branch = topology[index].branch;
         const auto child1 = branch.child1;
         const auto child2 = branch.child2;
-        assert(nodes[child1].GetOther() == index);
-        assert(nodes[child2].GetOther() == index);
-        const auto aabb = node.GetAABB();
+        assert(topology[child1].other == index);
+        assert(topology[child2].other == index);
+        const auto aabb = nodes.aabbs[index];
         const auto perimeter = GetPerimeter(aabb);
         const auto combinedPerimeter = GetPerimeter(GetEnclosingAABB(aabb, leafAABB));
         
@@ -282,8 +263,8 @@ DynamicTree::Size FindLowestCostNode(const DynamicTree::TreeNode nodes[],
         // Minimum cost of pushing the leaf further down the tree
         const auto inheritanceCost = (combinedPerimeter - perimeter) * 2;
         
-        const auto cost1 = costFunc(nodes[child1], inheritanceCost);
-        const auto cost2 = costFunc(nodes[child2], inheritanceCost);
+        const auto cost1 = costFunc(child1, inheritanceCost);
+        const auto cost2 = costFunc(child2, inheritanceCost);
         
         if ((cost < cost1) && (cost < cost2))
         {
@@ -298,78 +279,78 @@ DynamicTree::Size FindLowestCostNode(const DynamicTree::TreeNode nodes[],
 }
 
 std::pair<DynamicTree::Size, DynamicTree::Size>
-RemoveParent(DynamicTree::TreeNode nodes[], DynamicTree::Size index) noexcept
+RemoveParent(NodeArrays nodes, DynamicTree::Size index) noexcept
 {
-    const auto parent = nodes[index].GetOther();
-    const auto grandParent = nodes[parent].GetOther();
-    const auto parentBD = nodes[parent].AsBranch();
+    const auto topology = nodes.topology;
+    const auto parent = topology[index].other;
+    const auto grandParent = topology[parent].other;
+    const auto parentBD = topology[parent].branch;
     const auto sibling = (parentBD.child1 == index)? parentBD.child2: parentBD.child1;
     
-    nodes[index].SetOther(DynamicTree::GetInvalidSize());
-    nodes[sibling].SetOther(grandParent);
+    topology[index].other = DynamicTree::GetInvalidSize();
+    topology[sibling].other = grandParent;
     if (grandParent != DynamicTree::GetInvalidSize())
     {
-        const auto newBD = ReplaceChild(nodes[grandParent].AsBranch(), parent, sibling);
-        const auto newAabb = GetEnclosingAABB(nodes[newBD.child1].GetAABB(), nodes[newBD.child2].GetAABB());
-        const auto newHeight = 1 + std::max(nodes[newBD.child1].GetHeight(), nodes[newBD.child2].GetHeight());
-        nodes[grandParent].Assign(newBD, newAabb, newHeight);
-        nodes[parent].SetOther(DynamicTree::GetInvalidSize());
+        const auto newBD = ReplaceChild(topology[grandParent].branch, parent, sibling);
+        AssignBranch(nodes, grandParent, newBD, topology[grandParent].other);
+        topology[parent].other = DynamicTree::GetInvalidSize();
         return std::make_pair(UpdateUpwardFrom(nodes, grandParent), parent);
     }
     return std::make_pair(sibling, parent);
 }
 
-DynamicTree::Size InsertParent(DynamicTree::TreeNode nodes[],
+DynamicTree::Size InsertParent(NodeArrays nodes,
                                DynamicTree::Size newParent,
                                const AABB& aabb,
                                DynamicTree::Size index,
                                DynamicTree::Size rootIndex) noexcept
 {
+    const auto topology = nodes.topology;
     const auto sibling = FindLowestCostNode(nodes, aabb, rootIndex);
-    const auto oldParent = nodes[sibling].GetOther();
+    const auto oldParent = topology[sibling].other;
     
     // std::max of leaf height and sibling height + 1 = sibling height + 1
-    nodes[newParent] = DynamicTree::TreeNode{DynamicTree::BranchData{sibling, index},
-        GetEnclosingAABB(aabb, nodes[sibling].GetAABB()), 1 + nodes[sibling].GetHeight(), oldParent};
-    nodes[sibling].SetOther(newParent);
-    nodes[index].SetOther(newParent);
+    nodes.aabbs[newParent] = GetEnclosingAABB(aabb, nodes.aabbs[sibling]);
+    topology[newParent] = DynamicTree::TopologyData{
+        DynamicTree::BranchData{sibling, index}, 1 + topology[sibling].height, oldParent
+    };
+    topology[sibling].other = newParent;
+    topology[index].other = newParent;
     if (oldParent != DynamicTree::GetInvalidSize())
     {
-        const auto newBD = ReplaceChild(nodes[oldParent].AsBranch(), sibling, newParent);
-        const auto newAabb = GetEnclosingAABB(nodes[newBD.child1].GetAABB(), nodes[newBD.child2].GetAABB());
-        const auto newHeight = 1 + std::max(nodes[newBD.child1].GetHeight(), nodes[newBD.child2].GetHeight());
-        nodes[oldParent].Assign(newBD, newAabb, newHeight);
-        assert(nodes[nodes[oldParent].AsBranch().child1].GetOther() == oldParent);
-        assert(nodes[nodes[oldParent].AsBranch().child2].GetOther() == oldParent);
+        const auto newBD = ReplaceChild(topology[oldParent].branch, sibling, newParent);
+        AssignBranch(nodes, oldParent, newBD, topology[oldParent].other);
+        assert(topology[topology[oldParent].branch.child1].other == oldParent);
+        assert(topology[topology[oldParent].branch.child2].other == oldParent);
         return UpdateUpwardFrom(nodes, oldParent);
     }
     return newParent;
 }
 
-DynamicTree::Size UpdateNonRoot(DynamicTree::TreeNode nodes[],
+DynamicTree::Size UpdateNonRoot(NodeArrays nodes,
                                 DynamicTree::Size index, const AABB& aabb) noexcept
 {
-    assert(nodes[index].GetOther() != DynamicTree::GetInvalidSize());
+    const auto topology = nodes.topology;
+    assert(topology[index].other != DynamicTree::GetInvalidSize());
     
-    const auto parent = nodes[index].GetOther();
-    const auto grandParent = nodes[parent].GetOther();
-    const auto parentBD = nodes[parent].AsBranch();
+    const auto parent = topology[index].other;
+    const auto grandParent = topology[parent].other;
+    const auto parentBD = topology[parent].branch;
     assert(parentBD.child1 == index || parentBD.child2 == index);
     const auto sibling = (parentBD.child1 == index)? parentBD.child2: parentBD.child1;
 
-    nodes[sibling].SetOther(grandParent);
-    nodes[index].SetAABB(aabb);
+    topology[sibling].other = grandParent;
+    nodes.aabbs[index] = aabb;
     auto rootIndex = DynamicTree::GetInvalidSize();
     if (grandParent != DynamicTree::GetInvalidSize())
     {
-        assert(nodes[grandParent].AsBranch().child1 == parent || nodes[grandParent].AsBranch().child2 == parent);
-        const auto newBD = ReplaceChild(nodes[grandParent].AsBranch(), parent, sibling);
-        const auto newAabb = GetEnclosingAABB(nodes[newBD.child1].GetAABB(), nodes[newBD.child2].GetAABB());
-        const auto newHeight = 1 + std::max(nodes[newBD.child1].GetHeight(), nodes[newBD.child2].GetHeight());
-        nodes[grandParent].Assign(newBD, newAabb, newHeight);
-        nodes[parent].SetOther(DynamicTree::GetInvalidSize());
-        assert(nodes[nodes[grandParent].AsBranch().child1].GetOther() == grandParent);
-        assert(nodes[nodes[grandParent].AsBranch().child2].GetOther() == grandParent);
+        assert(topology[grandParent].branch.child1 == parent ||
+               topology[grandParent].branch.child2 == parent);
+        const auto newBD = ReplaceChild(topology[grandParent].branch, parent, sibling);
+        AssignBranch(nodes, grandParent, newBD, topology[grandParent].other);
+        topology[parent].other = DynamicTree::GetInvalidSize();
+        assert(topology[topology[grandParent].branch.child1].other == grandParent);
+        assert(topology[topology[grandParent].branch.child2].other == grandParent);
         rootIndex = UpdateUpwardFrom(nodes, grandParent);
     }
     else // grandParent == GetInvalidSize()
@@ -378,55 +359,138 @@ DynamicTree::Size UpdateNonRoot(DynamicTree::TreeNode nodes[],
     }
     
     const auto cheapest = FindLowestCostNode(nodes, aabb, rootIndex);
-    const auto cheapestParent = nodes[cheapest].GetOther();
+    const auto cheapestParent = topology[cheapest].other;
     
     // std::max of leaf height and cheapest height + 1 = cheapest height + 1
-    nodes[parent] = DynamicTree::TreeNode{
-        DynamicTree::BranchData{cheapest, index},
-        GetEnclosingAABB(aabb, nodes[cheapest].GetAABB()),
-        1 + nodes[cheapest].GetHeight(), cheapestParent
+    nodes.aabbs[parent] = GetEnclosingAABB(aabb, nodes.aabbs[cheapest]);
+    topology[parent] = DynamicTree::TopologyData{
+        DynamicTree::BranchData{cheapest, index}, 1 + topology[cheapest].height, cheapestParent
     };
     if (cheapestParent != DynamicTree::GetInvalidSize())
     {
-        const auto newBD = ReplaceChild(nodes[cheapestParent].AsBranch(), cheapest, parent);
-        const auto newAabb = GetEnclosingAABB(nodes[newBD.child1].GetAABB(), nodes[newBD.child2].GetAABB());
-        const auto newHeight = 1 + std::max(nodes[newBD.child1].GetHeight(), nodes[newBD.child2].GetHeight());
-        nodes[cheapestParent].Assign(newBD, newAabb, newHeight);
+        const auto newBD = ReplaceChild(topology[cheapestParent].branch, cheapest, parent);
+        AssignBranch(nodes, cheapestParent, newBD, topology[cheapestParent].other);
     }
-    nodes[cheapest].SetOther(parent);
+    topology[cheapest].other = parent;
     return UpdateUpwardFrom(nodes, parent);
 }
 
+/// @brief Links the given range of nodes into a free list.
+/// @details Each node's "other" index is set to the next node's index and the last
+///   node's "other" index is set to the invalid size.
+void LinkFreeNodes(AABB* aabbs, DynamicTree::TopologyData* topology,
+                   DynamicTree::Size first, DynamicTree::Size last) noexcept
+{
+    assert(first < last);
+    const auto end = last - 1;
+    for (auto i = first; i < end; ++i)
+    {
+        new (aabbs + i) AABB{};
+        new (topology + i) DynamicTree::TopologyData{DynamicTree::BranchData{},
+            DynamicTree::GetInvalidHeight(), i + 1};
+    }
+    new (aabbs + end) AABB{};
+    new (topology + end) DynamicTree::TopologyData{};
+}
+
+/// @brief Number of bins the bulk builder sorts node centers into along the split axis.
+constexpr auto BuildBinCount = 16;
+
+/// @brief Depth of the bulk build after which nodes are only split at their median.
+/// @note This bounds the recursion depth however the leafs are distributed.
+constexpr auto MaxBinnedBuildDepth = DynamicTree::Size{32};
+
+/// @brief Cost of a subtree for the surface area heuristic.
+/// @note Perimeter is used as the 2-D analog of surface area.
+inline Real GetBuildCost(const AABB& aabb, std::ptrdiff_t count) noexcept
+{
+    return StripUnit(GetPerimeter(aabb)) * static_cast<Real>(count);
+}
+
+/// @brief Pair of node indices of one or two trees.
+struct NodePair
+{
+    DynamicTree::Size a; ///< Index of node of first tree.
+    DynamicTree::Size b; ///< Index of node of second tree.
+};
+
+/// @brief Pushes the pairs of the children of the given pair of nodes, if they overlap.
+/// @details Splits the taller of the two nodes so the descent stays balanced.
+/// @return <code>true</code> if the given pair is of two leafs that overlap,
+///   <code>false</code> otherwise.
+template <std::size_t N>
+bool PushOverlappingChildren(const DynamicTree& treeA, const DynamicTree& treeB,
+                             NodePair pair, GrowableStack<NodePair, N>& stack)
+{
+    if (!TestOverlap(treeA.GetAABB(pair.a), treeB.GetAABB(pair.b)))
+    {
+        return false;
+    }
+    const auto heightA = treeA.GetHeight(pair.a);
+    const auto heightB = treeB.GetHeight(pair.b);
+    if (DynamicTree::IsLeaf(heightA) && DynamicTree::IsLeaf(heightB))
+    {
+        return true;
+    }
+    if (DynamicTree::IsLeaf(heightB) || (!DynamicTree::IsLeaf(heightA) && (heightA >= heightB)))
+    {
+        const auto branchData = treeA.GetBranchData(pair.a);
+        stack.push(NodePair{branchData.child1, pair.b});
+        stack.push(NodePair{branchData.child2, pair.b});
+    }
+    else
+    {
+        const auto branchData = treeB.GetBranchData(pair.b);
+        stack.push(NodePair{pair.a, branchData.child1});
+        stack.push(NodePair{pair.a, branchData.child2});
+    }
+    return false;
+}
+
 } // anonymous namespace
 
 DynamicTree::DynamicTree() noexcept = default;
 
 DynamicTree::DynamicTree(Size nodeCapacity):
-    m_nodes{nodeCapacity? AllocArray<TreeNode>(nodeCapacity): nullptr},
     m_freeIndex{nodeCapacity? 0: GetInvalidSize()},
     m_nodeCapacity{nodeCapacity}
 {
     if (nodeCapacity)
     {
+        // Allocations are made one at a time so a failure frees what's been allocated.
+        auto tmp = DynamicTree{};
+        tmp.m_aabbs = AllocArray<AABB>(nodeCapacity);
+        tmp.m_topology = AllocArray<TopologyData>(nodeCapacity);
+        tmp.m_leafs = AllocArray<LeafData>(nodeCapacity);
+        using std::swap;
+        swap(m_aabbs, tmp.m_aabbs);
+        swap(m_topology, tmp.m_topology);
+        swap(m_leafs, tmp.m_leafs);
+
         // Build a linked list for the free list.
-        const auto endCapacity = nodeCapacity - Size{1};
-        for (auto i = decltype(nodeCapacity){0}; i < endCapacity; ++i)
-        {
-            new (&m_nodes[i]) TreeNode{i + 1};
-        }
-        new (&m_nodes[endCapacity]) TreeNode{};
+        LinkFreeNodes(m_aabbs, m_topology, 0, nodeCapacity);
     }
 }
 
 DynamicTree::DynamicTree(const DynamicTree& other):
-    m_nodes{AllocArray<TreeNode>(other.m_nodeCapacity)},
     m_rootIndex{other.m_rootIndex},
     m_freeIndex{other.m_freeIndex},
     m_nodeCount{other.m_nodeCount},
     m_nodeCapacity{other.m_nodeCapacity},
     m_leafCount{other.m_leafCount}
 {
-    std::copy(&other.m_nodes[0], &other.m_nodes[other.m_nodeCapacity], &m_nodes[0]);
+    // Allocations are made one at a time so a failure frees what's been allocated.
+    auto tmp = DynamicTree{};
+    tmp.m_aabbs = AllocArray<AABB>(other.m_nodeCapacity);
+    tmp.m_topology = AllocArray<TopologyData>(other.m_nodeCapacity);
+    tmp.m_leafs = AllocArray<LeafData>(other.m_nodeCapacity);
+    std::copy(other.m_aabbs, other.m_aabbs + other.m_nodeCapacity, tmp.m_aabbs);
+    std::copy(other.m_topology, other.m_topology + other.m_nodeCapacity, tmp.m_topology);
+    std::copy(other.m_leafs, other.m_leafs + other.m_nodeCapacity, tmp.m_leafs);
+    using std::swap;
+    swap(m_aabbs, tmp.m_aabbs);
+    swap(m_topology, tmp.m_topology);
+    swap(m_leafs, tmp.m_leafs);
 }
 
 DynamicTree::DynamicTree(DynamicTree&& other) noexcept:
@@ -446,7 +510,9 @@ DynamicTree& DynamicTree::operator= (DynamicTree other) noexcept
 DynamicTree::~DynamicTree() noexcept
 {
     // This frees the entire tree in one shot.
-    Free(m_nodes);
+    Free(m_leafs);
+    Free(m_topology);
+    Free(m_aabbs);
 }
 
 void DynamicTree::SetNodeCapacity(Size value)
@@ -455,25 +521,25 @@ void DynamicTree::SetNodeCapacity(Size value)
 
     // The free list is empty. Rebuild a bigger pool.
     // Call Realloc first in case it throws so this code doesn't have to restore any state
-    // and so this function will have no effect.
-    m_nodes = ReallocArray<TreeNode>(m_nodes, value);
+    // and so this function will have no effect. The arrays are assigned as they're
+    // reallocated since a bigger array is still valid for the old capacity.
+    m_aabbs = ReallocArray<AABB>(m_aabbs, value);
+    m_topology = ReallocArray<TopologyData>(m_topology, value);
+    m_leafs = ReallocArray<LeafData>(m_leafs, value);
     m_nodeCapacity = value;
 
     // Build a linked list for the free list. The parent
     // pointer becomes the "next" pointer.
-    const auto endCapacity = m_nodeCapacity - 1;
-    for (auto i = m_nodeCount; i < endCapacity; ++i)
-    {
-        new (m_nodes + i) TreeNode{i + 1};
-    }
-    new (m_nodes + endCapacity) TreeNode{};
+    LinkFreeNodes(m_aabbs, m_topology, m_nodeCount, m_nodeCapacity);
     m_freeIndex = m_nodeCount;
 }
 
 DynamicTree::Size DynamicTree::AllocateNode(const LeafData& data, AABB aabb)
 {
     const auto index = AllocateNode();
-    m_nodes[index] = TreeNode{data, aabb};
+    m_aabbs[index] = aabb;
+    m_topology[index] = TopologyData{BranchData{}, 0, GetInvalidSize()};
+    m_leafs[index] = data;
     return index;
 }
 
@@ -482,7 +548,8 @@ DynamicTree::Size DynamicTree::AllocateNode(const BranchData& data, AABB aabb,
 {
     assert(height > 0);
     const auto index = AllocateNode();
-    m_nodes[index] = TreeNode{data, aabb, height, parent};
+    m_aabbs[index] = aabb;
+    m_topology[index] = TopologyData{data, height, parent};
     return index;
 }
 
@@ -499,7 +566,7 @@ DynamicTree::Size DynamicTree::AllocateNode()
     
     // Peel a node off the free list.
     const auto index = m_freeIndex;
-    m_freeIndex = m_nodes[index].GetOther();
+    m_freeIndex = m_topology[index].other;
     ++m_nodeCount;
     return index;
 }
@@ -510,10 +577,10 @@ void DynamicTree::FreeNode(Size index) noexcept
     assert(index < GetNodeCapacity());
     assert(index != GetFreeIndex());
     assert(m_nodeCount > 0); // index is not necessarily less than m_nodeCount.
-    assert(!IsUnused(m_nodes[index].GetHeight()));
-    assert(m_nodes[index].GetOther() == GetInvalidSize());
+    assert(!IsUnused(m_topology[index].height));
+    assert(m_topology[index].other == GetInvalidSize());
 
-    m_nodes[index] = TreeNode{m_freeIndex};
+    m_topology[index] = TopologyData{BranchData{}, GetInvalidHeight(), m_freeIndex};
     m_freeIndex = index;
     --m_nodeCount;
 }
@@ -523,18 +590,17 @@ void DynamicTree::Clear() noexcept
     m_nodeCount = Size{0u};
     m_leafCount = Size{0u};
     m_rootIndex = GetInvalidSize();
-    if (m_nodeCapacity && m_nodes) {
+    if (m_nodeCapacity && m_topology) {
         m_freeIndex = Size{0u};
-        const auto endCapacity = m_nodeCapacity - 1;
-        for (auto i = Size{0u}; i < endCapacity; ++i)
-        {
-            m_nodes[i] = TreeNode{i + 1};
-        }
-        m_nodes[endCapacity] = TreeNode{};
+        LinkFreeNodes(m_aabbs, m_topology, 0, m_nodeCapacity);
     }
     else {
-        Free(m_nodes);
-        m_nodes = nullptr;
+        Free(m_leafs);
+        Free(m_topology);
+        Free(m_aabbs);
+        m_leafs = nullptr;
+        m_topology = nullptr;
+        m_aabbs = nullptr;
         m_nodeCapacity = Size{0u};
         m_freeIndex = GetInvalidSize();
     }
@@ -542,22 +608,22 @@ void DynamicTree::Clear() noexcept
 
 DynamicTree::Size DynamicTree::FindReference(Size index) const noexcept
 {
-    const auto it = std::find_if(m_nodes, m_nodes + m_nodeCapacity, [&](TreeNode& node) {
-        if (node.GetOther() == index)
+    const auto last = m_topology + m_nodeCapacity;
+    const auto it = std::find_if(m_topology, last, [&](const TopologyData& node) {
+        if (node.other == index)
         {
             return true;
         }
-        if (IsBranch(node.GetHeight()))
+        if (IsBranch(node.height))
         {
-            const auto bd = node.AsBranch();
-            if (bd.child1 == index || bd.child2 == index)
+            if (node.branch.child1 == index || node.branch.child2 == index)
             {
                 return true;
             }
         }
         return false;
     });
-    return (it != m_nodes + m_nodeCapacity)? static_cast<Size>(it - m_nodes): GetInvalidSize();
+    return (it != last)? static_cast<Size>(it - m_topology): GetInvalidSize();
 }
 
 DynamicTree::Size DynamicTree::CreateLeaf(const AABB& aabb, const LeafData& data)
@@ -566,8 +632,9 @@ DynamicTree::Size DynamicTree::CreateLeaf(const AABB& aabb, const LeafData& data
     const auto index = AllocateNode(data, aabb);
     if (m_rootIndex != GetInvalidSize())
     {
-        const auto newParent = AllocateNode(); // Note: may change m_nodes!
-        m_rootIndex = InsertParent(m_nodes, newParent, aabb, index, m_rootIndex);
+        const auto newParent = AllocateNode(); // Note: may change the node arrays!
+        m_rootIndex = InsertParent(NodeArrays{m_aabbs, m_topology}, newParent, aabb, index,
+                                   m_rootIndex);
     }
     else
     {
@@ -581,14 +648,14 @@ void DynamicTree::DestroyLeaf(Size index) noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    assert(IsLeaf(m_nodes[index].GetHeight()));
+    assert(IsLeaf(m_topology[index].height));
     assert(m_leafCount > 0);
 
     --m_leafCount;
 
     if (m_rootIndex != index)
     {
-        const auto result = RemoveParent(m_nodes, index);
+        const auto result = RemoveParent(NodeArrays{m_aabbs, m_topology}, index);
         m_rootIndex = std::get<0>(result);
         const auto parent = std::get<1>(result);
 #ifndef NDEBUG
@@ -599,7 +666,7 @@ void DynamicTree::DestroyLeaf(Size index) noexcept
     }
     else
     {
-        assert(m_nodes[index].GetOther() == GetInvalidSize());
+        assert(m_topology[index].other == GetInvalidSize());
         m_rootIndex = GetInvalidSize();
     }
 
@@ -614,96 +681,340 @@ void DynamicTree::UpdateLeaf(Size index, const AABB& aabb)
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    assert(IsLeaf(m_nodes[index].GetHeight()));
+    assert(IsLeaf(m_topology[index].height));
 
     if (m_rootIndex != index)
     {
-        m_rootIndex = UpdateNonRoot(m_nodes, index, aabb);
+        m_rootIndex = UpdateNonRoot(NodeArrays{m_aabbs, m_topology}, index, aabb);
     }
     else
     {
-        assert(m_nodes[index].GetOther() == GetInvalidSize());
-        m_nodes[index].SetAABB(aabb);
+        assert(m_topology[index].other == GetInvalidSize());
+        m_aabbs[index] = aabb;
+    }
+}
+
+std::vector<DynamicTree::Size> DynamicTree::CreateLeafs(Span<const AABB> aabbs,
+                                                       Span<const LeafData> data)
+{
+    if (aabbs.size() != data.size())
+    {
+        throw InvalidArgument("DynamicTree::CreateLeafs: spans must be of same size");
+    }
+    const auto count = static_cast<Size>(aabbs.size());
+    auto ids = std::vector<Size>(count);
+    if (count == 0)
+    {
+        return ids;
+    }
+    const auto rebuild = (count >= m_leafCount) && (count >= GetMinBulkBuildCount());
+    auto nodes = std::vector<Size>(rebuild? m_leafCount + count: 0);
+
+    // Reserve all the nodes up front so nothing past this can throw.
+    const auto needed = m_nodeCount + 2 * count;
+    if (needed > m_nodeCapacity)
+    {
+        SetNodeCapacity(std::max(needed, m_nodeCapacity * 2));
     }
+
+    if (!rebuild)
+    {
+        for (auto i = Size{0}; i < count; ++i)
+        {
+            ids[i] = CreateLeaf(aabbs[i], data[i]);
+        }
+        return ids;
+    }
+
+    const auto last = ReleaseLeafs(nodes.data());
+    std::transform(begin(aabbs), end(aabbs), begin(data), begin(ids),
+                   [this](const AABB& aabb, const LeafData& leafData) {
+        assert(IsValid(aabb));
+        return AllocateNode(leafData, aabb);
+    });
+    std::copy(begin(ids), end(ids), last);
+    m_leafCount += count;
+    m_rootIndex = Build(nodes.data(), nodes.data() + m_leafCount);
+    return ids;
+}
+
+void DynamicTree::Rebuild()
+{
+    if (m_leafCount == 0)
+    {
+        return;
+    }
+    auto nodes = std::vector<Size>(m_leafCount);
+    const auto last = ReleaseLeafs(nodes.data());
+    m_rootIndex = Build(nodes.data(), last);
 }
 
 void DynamicTree::RebuildBottomUp()
 {
-    const auto nodes = AllocArray<Size>(m_nodeCount);
-    auto count = Size{0};
+    Rebuild();
+}
 
-    // Build array of leaves. Free the rest.
+DynamicTree::Size* DynamicTree::ReleaseLeafs(Size* out) noexcept
+{
     for (auto i = decltype(m_nodeCapacity){0}; i < m_nodeCapacity; ++i)
     {
-        const auto height = m_nodes[i].GetHeight();
+        const auto height = m_topology[i].height;
         if (IsLeaf(height))
         {
-            m_nodes[i].SetOther(GetInvalidSize());
-            nodes[count] = i;
-            ++count;
+            m_topology[i].other = GetInvalidSize();
+            *out++ = i;
         }
         else if (IsBranch(height))
         {
-            m_nodes[i].SetOther(GetInvalidSize());
+            m_topology[i].other = GetInvalidSize();
             FreeNode(i);
         }
     }
+    m_rootIndex = GetInvalidSize();
+    return out;
+}
+
+DynamicTree::Size DynamicTree::Build(Size* first, Size* last, Size depth) noexcept
+{
+    assert(first != last);
+    const auto count = last - first;
+    if (count == 1)
+    {
+        return *first;
+    }
 
-    while (count > 1)
+    // Split along the axis on which the node centers are most spread out.
+    auto centers = AABB{};
+    std::for_each(first, last, [&](Size i) { Include(centers, GetCenter(m_aabbs[i])); });
+    const auto axis = (GetSize(centers.ranges[0]) >= GetSize(centers.ranges[1]))? 0: 1;
+    const auto lo = centers.ranges[axis].GetMin();
+    const auto extent = GetSize(centers.ranges[axis]);
+    const auto center = [this,axis](Size i) { return GetCenter(m_aabbs[i].ranges[axis]); };
+
+    auto middle = first + count / 2;
+    if ((depth < MaxBinnedBuildDepth) && (extent > 0_m))
     {
-        auto minCost = std::numeric_limits<Length>::infinity();
-        auto iMin = GetInvalidSize();
-        auto jMin = GetInvalidSize();
-        for (auto i = decltype(count){0}; i < count; ++i)
+        const auto scale = Real(BuildBinCount) / StripUnit(extent);
+        const auto getBin = [&](Size i) {
+            const auto bin = static_cast<int>(StripUnit(center(i) - lo) * scale);
+            return std::min(bin, BuildBinCount - 1);
+        };
+
+        AABB binAABBs[BuildBinCount];
+        std::ptrdiff_t binCounts[BuildBinCount] = {};
+        std::for_each(first, last, [&](Size i) {
+            const auto bin = getBin(i);
+            Include(binAABBs[bin], m_aabbs[i]);
+            ++binCounts[bin];
+        });
+
+        // Sweep from the right to get the costs of everything above each split...
+        Real aboveCosts[BuildBinCount];
+        auto aabb = AABB{};
+        auto n = std::ptrdiff_t{0};
+        for (auto bin = BuildBinCount - 1; bin > 0; --bin)
         {
-            const auto& aabbi = m_nodes[nodes[i]].GetAABB();
+            Include(aabb, binAABBs[bin]);
+            n += binCounts[bin];
+            aboveCosts[bin] = GetBuildCost(aabb, n);
+        }
 
-            for (auto j = i + 1; j < count; ++j)
+        // ...then from the left to find the cheapest split.
+        aabb = AABB{};
+        n = 0;
+        auto bestCost = std::numeric_limits<Real>::infinity();
+        auto bestBin = BuildBinCount;
+        for (auto bin = 0; bin < BuildBinCount - 1; ++bin)
+        {
+            Include(aabb, binAABBs[bin]);
+            n += binCounts[bin];
+            const auto cost = GetBuildCost(aabb, n) + aboveCosts[bin + 1];
+            if ((n > 0) && (n < count) && (cost < bestCost))
             {
-                const auto& aabbj = m_nodes[nodes[j]].GetAABB();
-                const auto b = GetEnclosingAABB(aabbi, aabbj);
-                const auto cost = GetPerimeter(b);
-                if (minCost > cost)
-                {
-                    iMin = i;
-                    jMin = j;
-                    minCost = cost;
-                }
+                bestCost = cost;
+                bestBin = bin;
             }
         }
+        assert(bestBin < BuildBinCount);
+        middle = std::partition(first, last, [&](Size i) { return getBin(i) <= bestBin; });
+    }
+    else if (extent > 0_m)
+    {
+        std::nth_element(first, middle, last, [&](Size a, Size b) {
+            return center(a) < center(b);
+        });
+    }
 
-        assert((iMin < m_nodeCount) && (jMin < m_nodeCount));
+    const auto child1 = Build(first, middle, depth + 1);
+    const auto child2 = Build(middle, last, depth + 1);
+    const auto aabb = GetEnclosingAABB(m_aabbs[child1], m_aabbs[child2]);
+    const auto height = 1 + std::max(m_topology[child1].height, m_topology[child2].height);
+    const auto parent = AllocateNode(BranchData{child1, child2}, aabb, height);
+    m_topology[child1].other = parent;
+    m_topology[child2].other = parent;
+    return parent;
+}
 
-        const auto index1 = nodes[iMin];
-        const auto index2 = nodes[jMin];
-        assert(!IsUnused(m_nodes[index1].GetHeight()));
-        assert(!IsUnused(m_nodes[index2].GetHeight()));
+DynamicTree::OptimizeStats DynamicTree::Optimize(Size start, Size budget)
+{
+    auto buffer = std::vector<Size>{};
+    return Optimize(start, budget, buffer);
+}
 
-        const auto aabb = GetEnclosingAABB(m_nodes[index1].GetAABB(), m_nodes[index2].GetAABB());
-        const auto height = 1 + std::max(m_nodes[index1].GetHeight(), m_nodes[index2].GetHeight());
-        
-        // Warning: the following may change value of m_nodes!
-        const auto parent = AllocateNode(BranchData{index1, index2}, aabb, height);
-        m_nodes[index1].SetOther(parent);
-        m_nodes[index2].SetOther(parent);
+DynamicTree::OptimizeStats DynamicTree::Optimize(Size start, Size budget,
+                                                 std::vector<Size>& buffer)
+{
+    auto stats = OptimizeStats{};
+    if ((m_nodeCapacity == 0) || (budget == 0))
+    {
+        return stats;
+    }
+
+    // Rebuilds the tallest subtrees that have no more leafs than the budget allows.
+    auto maxHeight = Height{1};
+    while ((maxHeight < 30u) && (((Size{2} << (maxHeight + 1)) - 1) <= budget))
+    {
+        ++maxHeight;
+    }
+    if (size(buffer) < (Size{1} << maxHeight))
+    {
+        buffer.resize(Size{1} << maxHeight);
+    }
+
+    auto index = (start < m_nodeCapacity)? start: 0;
+    while (stats.visited < budget)
+    {
+        const auto height = m_topology[index].height;
+        const auto parent = m_topology[index].other;
+        if (IsUnused(height))
+        {
+            ++stats.visited;
+        }
+        else if (height > maxHeight)
+        {
+            ++stats.visited;
+            stats.perimeter += GetPerimeter(m_aabbs[index]);
+            const auto bd = m_topology[index].branch;
+            const auto height1 = m_topology[bd.child1].height;
+            const auto height2 = m_topology[bd.child2].height;
+            const auto imbalance = (height2 >= height1)? height2 - height1: height1 - height2;
+            stats.maxImbalance = std::max(stats.maxImbalance, imbalance);
+        }
+        else if ((parent == GetInvalidSize()) || (m_topology[parent].height > maxHeight))
+        {
+            // Charges the budget for all of the subtree's nodes since they all get visited.
+            const auto nodes = (Size{2} << height) - 1;
+            if ((stats.visited > 0) && ((stats.visited + nodes) > budget))
+            {
+                break;
+            }
+            if (IsBranch(height))
+            {
+                RebuildSubtree(index, buffer.data());
+                ++stats.rebuilds;
+            }
+            const auto subtreeStats = GetSubtreeStats(index);
+            stats.visited += std::max(nodes, Size{1});
+            stats.perimeter += subtreeStats.first;
+            stats.maxImbalance = std::max(stats.maxImbalance, subtreeStats.second);
+        }
+        else
+        {
+            // Node of a subtree whose metrics were gathered from the subtree's root.
+            ++stats.visited;
+        }
+        if (++index == m_nodeCapacity)
+        {
+            index = 0;
+            stats.sweepEnded = true;
+            break;
+        }
+    }
+    stats.next = index;
+    return stats;
+}
+
+void DynamicTree::RebuildSubtree(Size index, Size* leafs) noexcept
+{
+    assert(IsBranch(m_topology[index].height));
+    const auto parent = m_topology[index].other;
+    auto pending = GrowableStack<Size, 256>{};
+    pending.push(m_topology[index].branch.child1);
+    pending.push(m_topology[index].branch.child2);
 
-        nodes[jMin] = nodes[count-1];
-        nodes[iMin] = parent;
-        --count;
+    // Frees the subtree root first so it's the last freed node that building reuses and
+    // so that the root of the rebuilt subtree gets the same index as it had before.
+    m_topology[index].other = GetInvalidSize();
+    FreeNode(index);
+    auto last = leafs;
+    while (!pending.empty())
+    {
+        const auto i = pending.top();
+        pending.pop();
+        if (IsLeaf(m_topology[i].height))
+        {
+            *last++ = i;
+        }
+        else
+        {
+            pending.push(m_topology[i].branch.child1);
+            pending.push(m_topology[i].branch.child2);
+            m_topology[i].other = GetInvalidSize();
+            FreeNode(i);
+        }
     }
+    // Builds with median splits only so the subtree is as balanced as the rebalancing that
+    // updating leafs does expects it to be. Surface area heuristic splits don't mix well
+    // with that rebalancing and make the tree degrade faster than it otherwise would.
+    const auto root = Build(leafs, last, MaxBinnedBuildDepth);
+    assert(root == index);
+    m_topology[root].other = parent;
 
-    m_rootIndex = nodes[0];
-    Free(nodes);
+    // Rebuilding can lower the subtree's height.
+    for (auto i = parent; i != GetInvalidSize(); i = m_topology[i].other)
+    {
+        const auto bd = m_topology[i].branch;
+        const auto height = 1 + std::max(m_topology[bd.child1].height, m_topology[bd.child2].height);
+        if (m_topology[i].height == height)
+        {
+            break;
+        }
+        m_topology[i].height = height;
+    }
+}
+
+std::pair<Length, DynamicTree::Height> DynamicTree::GetSubtreeStats(Size index) const noexcept
+{
+    auto perimeter = 0_m;
+    auto maxImbalance = Height{0};
+    auto pending = GrowableStack<Size, 256>{};
+    pending.push(index);
+    while (!pending.empty())
+    {
+        const auto i = pending.top();
+        pending.pop();
+        perimeter += GetPerimeter(m_aabbs[i]);
+        if (IsBranch(m_topology[i].height))
+        {
+            const auto bd = m_topology[i].branch;
+            const auto height1 = m_topology[bd.child1].height;
+            const auto height2 = m_topology[bd.child2].height;
+            const auto imbalance = (height2 >= height1)? height2 - height1: height1 - height2;
+            maxImbalance = std::max(maxImbalance, imbalance);
+            pending.push(bd.child1);
+            pending.push(bd.child2);
+        }
+    }
+    return std::make_pair(perimeter, maxImbalance);
 }
 
 void DynamicTree::ShiftOrigin(Length2 newOrigin)
 {
-    // Build array of leaves. Free the rest.
     for (auto i = decltype(m_nodeCapacity){0}; i < m_nodeCapacity; ++i)
     {
-        if (!IsUnused(m_nodes[i].GetHeight()))
+        if (!IsUnused(m_topology[i].height))
         {
-            m_nodes[i].SetAABB(GetMovedAABB(m_nodes[i].GetAABB(), -newOrigin));
+            m_aabbs[i] = GetMovedAABB(m_aabbs[i], -newOrigin);
         }
     }
 }
@@ -713,7 +1024,9 @@ void DynamicTree::ShiftOrigin(Length2 newOrigin)
 void swap(DynamicTree& lhs, DynamicTree& rhs) noexcept
 {
     using playrho::swap;
-    swap(lhs.m_nodes, rhs.m_nodes);
+    swap(lhs.m_aabbs, rhs.m_aabbs);
+    swap(lhs.m_topology, rhs.m_topology);
+    swap(lhs.m_leafs, rhs.m_leafs);
     swap(lhs.m_rootIndex, rhs.m_rootIndex);
     swap(lhs.m_freeIndex, rhs.m_freeIndex);
     swap(lhs.m_nodeCount, rhs.m_nodeCount);
@@ -722,34 +1035,61 @@ void swap(DynamicTree& lhs, DynamicTree& rhs) noexcept
 }
 
 void Query(const DynamicTree& tree, const AABB& aabb, const DynamicTreeSizeCB& callback)
-{    
-    GrowableStack<DynamicTree::Size, 256> stack;
-    stack.push(tree.GetRootIndex());
-    
+{
+    Query<const DynamicTreeSizeCB&>(tree, aabb, callback);
+}
+
+void QueryPairs(const DynamicTree& tree, const DynamicTreePairCB& callback)
+{
+    GrowableStack<NodePair, 256> stack;
+    if (tree.GetRootIndex() != DynamicTree::GetInvalidSize())
+    {
+        stack.push(NodePair{tree.GetRootIndex(), tree.GetRootIndex()});
+    }
+    while (!empty(stack))
+    {
+        const auto pair = stack.top();
+        stack.pop();
+        if (pair.a == pair.b)
+        {
+            // Pairs of a subtree with itself are the pairs within each child subtree plus
+            // the pairs across them.
+            if (DynamicTree::IsBranch(tree.GetHeight(pair.a)))
+            {
+                const auto branchData = tree.GetBranchData(pair.a);
+                stack.push(NodePair{branchData.child1, branchData.child1});
+                stack.push(NodePair{branchData.child2, branchData.child2});
+                stack.push(NodePair{branchData.child1, branchData.child2});
+            }
+        }
+        else if (PushOverlappingChildren(tree, tree, pair, stack))
+        {
+            if (callback(pair.a, pair.b) == DynamicTreeOpcode::End)
+            {
+                return;
+            }
+        }
+    }
+}
+
+void QueryPairs(const DynamicTree& treeA, const DynamicTree& treeB,
+                const DynamicTreePairCB& callback)
+{
+    GrowableStack<NodePair, 256> stack;
+    if ((treeA.GetRootIndex() != DynamicTree::GetInvalidSize()) &&
+        (treeB.GetRootIndex() != DynamicTree::GetInvalidSize()))
+    {
+        stack.push(NodePair{treeA.GetRootIndex(), treeB.GetRootIndex()});
+    }
     while (!empty(stack))
     {
-        const auto index = stack.top();
+        const auto pair = stack.top();
         stack.pop();
-        if (index != DynamicTree::GetInvalidSize())
+        if (PushOverlappingChildren(treeA, treeB, pair, stack))
         {
-            if (TestOverlap(tree.GetAABB(index), aabb))
+            if (callback(pair.a, pair.b) == DynamicTreeOpcode::End)
             {
-                const auto height = tree.GetHeight(index);
-                if (DynamicTree::IsBranch(height))
-                {
-                    const auto branchData = tree.GetBranchData(index);
-                    stack.push(branchData.child1);
-                    stack.push(branchData.child2);
-                }
-                else
-                {
-                    assert(DynamicTree::IsLeaf(height));
-                    const auto sc = callback(index);
-                    if (sc == DynamicTreeOpcode::End)
-                    {
-                        return;
-                    }
-                }
+                return;
             }
         }
     }
@@ -757,10 +1097,45 @@ void Query(const DynamicTree& tree, const AABB& aabb, const DynamicTreeSizeCB& c
 
 void Query(const DynamicTree& tree, const AABB& aabb, QueryFixtureCallback callback)
 {
-    Query(tree, aabb, [&](DynamicTree::Size treeId) {
-        const auto leafData = tree.GetLeafData(treeId);
-        return callback(leafData.fixture, leafData.childIndex)?
-        DynamicTreeOpcode::Continue: DynamicTreeOpcode::End;
+    Query<const QueryFixtureCallback&>(tree, aabb, callback);
+}
+
+namespace {
+
+/// @brief Queries the given range of boxes, appending the hits found to the given buffer
+///   and setting the offsets of the queries into it.
+void QueryBatch(const DynamicTree& tree, Span<const AABB> aabbs, std::size_t first,
+                std::size_t last, std::vector<QueryHit>& hits, std::vector<std::size_t>& offsets)
+{
+    for (auto i = first; i < last; ++i)
+    {
+        offsets[i] = size(hits);
+        Query(tree, aabbs[i], [&tree,&hits](DynamicTree::Size treeId) {
+            const auto leafData = tree.GetLeafData(treeId);
+            hits.push_back(QueryHit{leafData.fixture, leafData.childIndex});
+            return DynamicTreeOpcode::Continue;
+        });
+    }
+}
+
+} // anonymous namespace
+
+void QueryBatch(const DynamicTree& tree, Span<const AABB> aabbs, QueryBatchResults& results)
+{
+    const auto count = aabbs.size();
+    results.hits.clear();
+    results.offsets.resize(count + 1);
+    QueryBatch(tree, aabbs, 0, count, results.hits, results.offsets);
+    results.offsets[count] = size(results.hits);
+}
+
+void QueryBatch(const DynamicTree& tree, Span<const AABB> aabbs, QueryBatchResults& results,
+                ThreadPool& pool)
+{
+    detail::QueryBatch(aabbs.size(), results, pool,
+                       [&tree,aabbs,&results](std::size_t first, std::size_t last,
+                                              std::vector<QueryHit>& hits) {
+        QueryBatch(tree, aabbs, first, last, hits, results.offsets);
     });
 }
 
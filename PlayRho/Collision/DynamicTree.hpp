@@ -26,7 +26,9 @@
 /// Declaration of the <code>DynamicTree</code> class.
 
 #include <PlayRho/Collision/AABB.hpp>
+#include <PlayRho/Common/GrowableStack.hpp>
 #include <PlayRho/Common/Settings.hpp>
+#include <PlayRho/Common/Span.hpp>
 #include <PlayRho/Common/Vector2.hpp>
 #include <PlayRho/Dynamics/BodyID.hpp>
 #include <PlayRho/Dynamics/FixtureID.hpp>
@@ -34,8 +36,12 @@
 #include <functional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace playrho {
+
+class ThreadPool;
+
 namespace d2 {
 
 /// @brief A dynamic AABB tree broad-phase.
@@ -62,7 +68,10 @@ namespace d2 {
 ///
 /// @note This code was inspired by Nathanael Presson's <code>btDbvt</code>.
 /// @note Nodes are pooled and relocatable, so we use node indices rather than pointers.
-/// @note This data structure is 32-bytes large (on at least one 64-bit platform).
+/// @note Node data is split into parallel arrays of AABBs, of topology data and of leaf
+///   data. This keeps what's needed for walking the tree (the AABBs and the topology)
+///   densely packed in cache, apart from leaf data that's only needed for found leafs.
+/// @note This data structure is 48-bytes large (on at least one 64-bit platform).
 ///
 /// @see http://www.randygaul.net/2013/08/06/dynamic-aabb-tree/
 /// @see http://www.cs.utah.edu/~thiago/papers/rotations.pdf ("Fast, Effective
@@ -78,8 +87,16 @@ public:
     struct UnusedData;
     struct BranchData;
     struct LeafData;
+    struct TopologyData;
     union VariantData;
 
+    /// @brief Gets the minimum number of leafs that <code>CreateLeafs</code> bulk builds.
+    /// @see CreateLeafs
+    static constexpr Size GetMinBulkBuildCount() noexcept
+    {
+        return Size{32};
+    }
+
     /// @brief Gets the invalid size value.
     static constexpr Size GetInvalidSize() noexcept
     {
@@ -94,6 +111,17 @@ public:
     /// @brief Invalid height constant value.
     static constexpr auto InvalidHeight = static_cast<Height>(-1);
 
+    /// @brief Statistics of a call to <code>Optimize</code>.
+    struct OptimizeStats
+    {
+        Size next = 0; ///< Index of the node to resume optimizing from.
+        Size visited = 0; ///< Count of nodes visited.
+        Size rebuilds = 0; ///< Count of subtrees rebuilt.
+        Length perimeter = 0_m; ///< Sum of the perimeters of the leaf and branch nodes visited.
+        Height maxImbalance = 0; ///< Maximum imbalance of the branch nodes visited.
+        bool sweepEnded = false; ///< Whether the visiting reached the end of the nodes.
+    };
+
     /// @brief Gets the invalid height value.
     static constexpr Height GetInvalidHeight() noexcept
     {
@@ -174,6 +202,20 @@ public:
     /// @see GetLeafCount(), GetNodeCount()
     Size CreateLeaf(const AABB& aabb, const LeafData& data);
 
+    /// @brief Creates new leaf nodes for all of the given AABBs and data at once.
+    /// @details Bulk form of <code>CreateLeaf</code> meant for adding many leafs at a time,
+    ///   like when a level gets loaded. When there are at least as many new leafs as
+    ///   existing ones, and at least <code>GetMinBulkBuildCount()</code> of them, the whole
+    ///   tree is rebuilt as by <code>Rebuild()</code>. Otherwise the new leafs are inserted
+    ///   one by one just as by <code>CreateLeaf</code>.
+    /// @post The leaf count will be incremented by the number of given AABBs.
+    /// @return Indices of the created leaf nodes, in the order of the given AABBs.
+    /// @throws InvalidArgument If the given spans are of different sizes.
+    /// @throws std::bad_alloc If unable to allocate necessary memory. If this exception is
+    ///   thrown, this function has no effect.
+    /// @see CreateLeaf, Rebuild
+    std::vector<Size> CreateLeafs(Span<const AABB> aabbs, Span<const LeafData> data);
+
     /// @brief Destroys a leaf node.
     /// @post The leaf count will be decremented by one.
     /// @warning Behavior is undefined if the given index is not valid.
@@ -224,11 +266,42 @@ public:
     /// @brief Gets the free index.
     Size GetFreeIndex() const noexcept;
 
-    /// @brief Builds an optimal tree.
-    /// @note This operation is very expensive.
-    /// @note Meant for testing.
+    /// @brief Rebuilds this tree from its leafs.
+    /// @details Builds the tree top-down by recursively splitting the leafs where a binned
+    ///   surface area heuristic finds the split to be cheapest. This takes O(n log n) time
+    ///   for n leafs and usually results in a tree that's cheaper to query than one built
+    ///   up by incremental insertions.
+    /// @note Leaf indices are preserved. Branch nodes get reallocated.
+    /// @throws std::bad_alloc If unable to allocate necessary memory. If this exception is
+    ///   thrown, this function has no effect.
+    void Rebuild();
+
+    /// @brief Rebuilds this tree from its leafs.
+    /// @deprecated Use <code>Rebuild()</code> instead. This just calls it.
     /// @throws std::bad_alloc If unable to allocate necessary memory.
-    void RebuildBottomUp();
+    [[deprecated]] void RebuildBottomUp();
+
+    /// @brief Incrementally optimizes this tree.
+    /// @details Visits up to the given number of nodes, starting from the given index, and
+    ///   rebuilds the tallest subtrees that have no more nodes than the budget allows into
+    ///   balanced subtrees of spatially median split leafs. Calling this with a small budget
+    ///   every step, resuming from where the last call left off, counters the degradation
+    ///   that churn through <code>UpdateLeaf</code> causes over time.
+    /// @note Visiting stops at the end of the nodes so that the perimeter sums and maximum
+    ///   imbalances of a full sweep of the tree can be gathered from consecutive calls.
+    /// @note Leafs are never moved so leaf indices, and query results, are unaffected.
+    /// @throws std::bad_alloc If unable to allocate necessary memory. If this exception is
+    ///   thrown, this function has no effect.
+    /// @see Optimize(Size, Size, std::vector<Size>&)
+    OptimizeStats Optimize(Size start, Size budget);
+
+    /// @brief Incrementally optimizes this tree using the given buffer as scratch space.
+    /// @details Same as <code>Optimize(Size, Size)</code> except that the given buffer's
+    ///   storage gets reused for the leaf indices of rebuilt subtrees. Calls that keep
+    ///   passing the same buffer only allocate when the budget grows.
+    /// @throws std::bad_alloc If unable to allocate necessary memory. If this exception is
+    ///   thrown, this function has no effect.
+    OptimizeStats Optimize(Size start, Size budget, std::vector<Size>& buffer);
 
     /// @brief Shifts the world origin.
     /// @note Useful for large worlds.
@@ -308,9 +381,32 @@ private:
     /// @post The free list links to the given index.
     ///
     void FreeNode(Size index) noexcept;
+
+    /// @brief Frees all of the branch nodes and outputs the indices of the leaf nodes.
+    /// @pre The given output has room for at least <code>GetLeafCount()</code> indices.
+    /// @post The root index is the invalid size.
+    /// @return Pointer to just past the last output index.
+    Size* ReleaseLeafs(Size* out) noexcept;
+
+    /// @brief Rebuilds the subtree of the identified branch node.
+    /// @note The root of the rebuilt subtree keeps the given index.
+    /// @pre The given buffer has room for all of the leafs of the subtree.
+    void RebuildSubtree(Size index, Size* leafs) noexcept;
+
+    /// @brief Gets the perimeter sum and maximum imbalance of the identified subtree.
+    std::pair<Length, Height> GetSubtreeStats(Size index) const noexcept;
+
+    /// @brief Builds a subtree out of the identified leaf or branch nodes.
+    /// @note The given range of indices gets reordered.
+    /// @pre The given range is not empty.
+    /// @pre There are free nodes for at least one less than the given number of nodes.
+    /// @return Index of the root node of the built subtree.
+    Size Build(Size* first, Size* last, Size depth = 0) noexcept;
     
-    TreeNode* m_nodes{nullptr}; ///< Nodes. @details Initialized on construction.
-    Size m_rootIndex{GetInvalidSize()}; ///< Index of root element in m_nodes or <code>GetInvalidSize()</code>.
+    AABB* m_aabbs{nullptr}; ///< Node AABBs. @details Initialized on construction.
+    TopologyData* m_topology{nullptr}; ///< Node topology. @details Initialized on construction.
+    LeafData* m_leafs{nullptr}; ///< Node leaf data. @details Initialized on construction.
+    Size m_rootIndex{GetInvalidSize()}; ///< Index of root element in the node arrays or <code>GetInvalidSize()</code>.
     Size m_freeIndex{GetInvalidSize()}; ///< Free list. @details Index to free nodes.
     Size m_nodeCount{0u}; ///< Node count. @details Count of currently allocated nodes.
     Size m_nodeCapacity{0u}; ///< Node capacity. @details Size of buffer allocated for nodes.
@@ -358,6 +454,26 @@ struct DynamicTree::LeafData
     ChildCounter childIndex;
 };
 
+/// @brief Topology data of a tree node.
+/// @details This is the data of a node, other than its AABB, that's needed for walking
+///   and restructuring the tree.
+struct DynamicTree::TopologyData
+{
+    /// @brief Branch data.
+    /// @note Only meaningful for branch nodes.
+    BranchData branch;
+
+    /// @brief Height.
+    /// @note 0 if leaf node, <code>DynamicTree::GetInvalidHeight()</code> if free (unallocated)
+    ///   node, else branch node.
+    Height height = GetInvalidHeight();
+
+    /// @brief Index to "other" node.
+    /// @note This is an index to the next node for a free node, else this is the index to the
+    ///   parent node.
+    Size other = GetInvalidSize();
+};
+
 /// @brief Equality operator.
 /// @relatedalso DynamicTree::LeafData
 constexpr bool operator== (const DynamicTree::LeafData& lhs,
@@ -417,7 +533,10 @@ constexpr bool IsLeaf(const DynamicTree::TreeNode& node) noexcept;
 constexpr bool IsBranch(const DynamicTree::TreeNode& node) noexcept;
 
 /// @brief A node in the dynamic tree.
+/// @details This is the combined value of all of a node's data.
 /// @note Users do not interact with this directly.
+/// @note <code>DynamicTree</code> stores its nodes' data in separate arrays rather than as
+///   arrays of this type.
 /// @note By using indexes to other tree nodes, these don't need to be updated
 ///   if the memory for other nodes is relocated.
 /// @note On some 64-bit architectures, pointers are 8-bytes, while indices need only be
@@ -604,46 +723,46 @@ inline DynamicTree::Height DynamicTree::GetHeight(Size index) const noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    return m_nodes[index].GetHeight();
+    return m_topology[index].height;
 }
 
 inline DynamicTree::Size DynamicTree::GetOther(Size index) const noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    return m_nodes[index].GetOther();
+    return m_topology[index].other;
 }
 
 inline AABB DynamicTree::GetAABB(Size index) const noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    assert(!IsUnused(m_nodes[index].GetHeight()));
-    return m_nodes[index].GetAABB();
+    assert(!IsUnused(m_topology[index].height));
+    return m_aabbs[index];
 }
 
 inline DynamicTree::BranchData DynamicTree::GetBranchData(Size index) const noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    assert(IsBranch(m_nodes[index].GetHeight()));
-    return m_nodes[index].AsBranch();
+    assert(IsBranch(m_topology[index].height));
+    return m_topology[index].branch;
 }
 
 inline DynamicTree::LeafData DynamicTree::GetLeafData(Size index) const noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    assert(IsLeaf(m_nodes[index].GetHeight()));
-    return m_nodes[index].AsLeaf();
+    assert(IsLeaf(m_topology[index].height));
+    return m_leafs[index];
 }
 
 inline void DynamicTree::SetLeafData(Size index, LeafData value) noexcept
 {
     assert(index != GetInvalidSize());
     assert(index < m_nodeCapacity);
-    assert(IsLeaf(m_nodes[index].GetHeight()));
-    m_nodes[index].AsLeaf() = value;
+    assert(IsLeaf(m_topology[index].height));
+    m_leafs[index] = value;
 }
 
 // Free functions...
@@ -776,9 +895,66 @@ using DynamicTreeSizeCB = std::function<DynamicTreeOpcode(DynamicTree::Size)>;
 
 /// @brief Query the given dynamic tree and find nodes overlapping the given AABB.
 /// @note The callback instance is called for each leaf node that overlaps the supplied AABB.
+/// @note This calls the callback through <code>std::function</code>. Passing the callable
+///   directly instead uses the template overload that the compiler can inline.
 void Query(const DynamicTree& tree, const AABB& aabb,
            const DynamicTreeSizeCB& callback);
 
+/// @brief Query the given dynamic tree and find nodes overlapping the given AABB.
+/// @details Visits the leafs with any callable taking a <code>DynamicTree::Size</code>
+///   and returning a <code>DynamicTreeOpcode</code>, like a lambda expression. The call
+///   is made directly so it can be inlined into the traversal loop.
+/// @note The callback instance is called for each leaf node that overlaps the supplied AABB.
+template <class F>
+auto Query(const DynamicTree& tree, const AABB& aabb, F&& callback)
+    -> std::enable_if_t<std::is_convertible<
+        decltype(std::declval<F&>()(std::declval<DynamicTree::Size>())),
+        DynamicTreeOpcode>::value>
+{
+    GrowableStack<DynamicTree::Size, 256> stack;
+    stack.push(tree.GetRootIndex());
+    while (!empty(stack))
+    {
+        const auto index = stack.top();
+        stack.pop();
+        if ((index != DynamicTree::GetInvalidSize()) && TestOverlap(tree.GetAABB(index), aabb))
+        {
+            const auto height = tree.GetHeight(index);
+            if (DynamicTree::IsBranch(height))
+            {
+                const auto branchData = tree.GetBranchData(index);
+                stack.push(branchData.child1);
+                stack.push(branchData.child2);
+            }
+            else if (callback(index) == DynamicTreeOpcode::End)
+            {
+                return;
+            }
+        }
+    }
+}
+
+/// @brief Pair query callback type.
+using DynamicTreePairCB = std::function<DynamicTreeOpcode(DynamicTree::Size,
+                                                          DynamicTree::Size)>;
+
+/// @brief Queries the given dynamic tree for all pairs of its leafs that overlap.
+/// @details Descends the tree against itself all at once so that the overlap tests of
+///   the upper levels get shared by all the pairs under them, instead of being redone
+///   for each leaf as querying the tree for each leaf's AABB would.
+/// @note The callback instance is called once for each unordered pair of different
+///   leafs whose AABBs overlap.
+/// @throws std::bad_alloc If unable to allocate necessary memory.
+void QueryPairs(const DynamicTree& tree, const DynamicTreePairCB& callback);
+
+/// @brief Queries the given dynamic trees for all pairs of their leafs that overlap.
+/// @details Descends the two trees against each other all at once.
+/// @note The callback instance is called once for each pair of a leaf of the first tree
+///   and a leaf of the second tree whose AABBs overlap, with the leafs in that order.
+/// @throws std::bad_alloc If unable to allocate necessary memory.
+void QueryPairs(const DynamicTree& treeA, const DynamicTree& treeB,
+                const DynamicTreePairCB& callback);
+
 /// @brief Query AABB for fixtures callback function type.
 /// @note Returning true will continue the query. Returning false will terminate the query.
 using QueryFixtureCallback = std::function<bool(FixtureID fixture, ChildCounter child)>;
@@ -789,6 +965,81 @@ using QueryFixtureCallback = std::function<bool(FixtureID fixture, ChildCounter
 /// @param callback User implemented callback function.
 void Query(const DynamicTree& tree, const AABB& aabb, QueryFixtureCallback callback);
 
+/// @brief Queries the world for all fixtures that potentially overlap the provided AABB.
+/// @details This is the template overload for any callable taking a fixture identifier
+///   and a child index and returning a value convertible to <code>bool</code>.
+/// @param tree Dynamic tree to do the query over.
+/// @param aabb The query box.
+/// @param callback User implemented callback. Returning true continues the query.
+///   Returning false terminates it.
+template <class F>
+auto Query(const DynamicTree& tree, const AABB& aabb, F&& callback)
+    -> std::enable_if_t<std::is_convertible<
+        decltype(std::declval<F&>()(std::declval<FixtureID>(), std::declval<ChildCounter>())),
+        bool>::value>
+{
+    Query(tree, aabb, [&tree,&callback](DynamicTree::Size treeId) {
+        const auto leafData = tree.GetLeafData(treeId);
+        return callback(leafData.fixture, leafData.childIndex)?
+            DynamicTreeOpcode::Continue: DynamicTreeOpcode::End;
+    });
+}
+
+/// @brief Fixture child found by a query.
+struct QueryHit
+{
+    FixtureID fixture; ///< Fixture whose child was found.
+    ChildCounter child; ///< Index of the child of the fixture's shape.
+};
+
+/// @brief Results of a batch of queries.
+/// @details Packs the hits of all the queries of a batch one after another into a single
+///   buffer. Reusing an instance for later batches reuses its storage so that, once it's
+///   grown big enough, querying doesn't allocate memory for results.
+/// @see QueryBatch, GetHits.
+struct QueryBatchResults
+{
+    /// @brief Hits of all the queries in the order of the queries.
+    std::vector<QueryHit> hits;
+
+    /// @brief Offsets into the hits where the hits of each query begin.
+    /// @note This has one more element than there were queries, for where the hits end.
+    std::vector<std::size_t> offsets;
+
+    /// @brief Buffers for the hits of all but the first range of queries when they're
+    ///   spread over threads.
+    std::vector<std::vector<QueryHit>> threadHits;
+};
+
+/// @brief Gets the hits of the identified query of a batch.
+/// @warning Behavior is undefined if the given index is not less than the number of
+///   queries of the batch.
+/// @relatedalso QueryBatchResults
+inline Span<const QueryHit> GetHits(const QueryBatchResults& results,
+                                    std::size_t query) noexcept
+{
+    const auto first = results.offsets[query];
+    return Span<const QueryHit>(data(results.hits) + first, results.offsets[query + 1] - first);
+}
+
+/// @brief Queries the given dynamic tree for the leafs overlapping each of the given AABBs.
+/// @param tree Dynamic tree to do the queries over.
+/// @param aabbs Query boxes.
+/// @param results Destination for the hits. Its hits are replaced with the fixture and
+///   child index of every leaf overlapping each of the query boxes.
+/// @throws std::bad_alloc If unable to allocate necessary memory.
+/// @see GetHits.
+void QueryBatch(const DynamicTree& tree, Span<const AABB> aabbs, QueryBatchResults& results);
+
+/// @brief Queries the given dynamic tree for the leafs overlapping each of the given AABBs
+///   using the given pool's workers as well as the calling thread.
+/// @details Gets the same results as the overload without the pool. The queries only read
+///   the tree so it mustn't be modified until this returns.
+/// @throws std::bad_alloc If unable to allocate necessary memory.
+/// @see GetHits.
+void QueryBatch(const DynamicTree& tree, Span<const AABB> aabbs, QueryBatchResults& results,
+                ThreadPool& pool);
+
 /// @brief Gets the "size" of the given tree.
 /// @note Size in this context is defined as the leaf count.
 /// @note This provides ancillary support for the container named requirement's size method.
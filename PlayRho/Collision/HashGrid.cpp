@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <PlayRho/Collision/HashGrid.hpp>
+#include <PlayRho/Common/InvalidArgument.hpp>
+#include <PlayRho/Common/Math.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace playrho {
+namespace d2 {
+
+namespace {
+
+/// @brief Minimum cell coordinate.
+/// @note This is halved to leave room for the arithmetic done with coordinates.
+constexpr auto MinCellCoord = std::numeric_limits<HashGrid::CellCoord>::min() / 2;
+
+/// @brief Maximum cell coordinate.
+/// @note This is halved to leave room for the arithmetic done with coordinates.
+constexpr auto MaxCellCoord = std::numeric_limits<HashGrid::CellCoord>::max() / 2;
+
+/// @brief Gets the cell coordinate for the given value in units of cells.
+/// @note Non-finite values get clamped.
+HashGrid::CellCoord GetCellCoord(Real value) noexcept
+{
+    const auto coord = std::floor(value);
+    if (!(coord > static_cast<Real>(MinCellCoord)))
+    {
+        return MinCellCoord;
+    }
+    if (coord > static_cast<Real>(MaxCellCoord))
+    {
+        return MaxCellCoord;
+    }
+    return static_cast<HashGrid::CellCoord>(coord);
+}
+
+/// @brief Gets the key of the identified cell.
+std::uint64_t GetCellKey(HashGrid::CellCoord x, HashGrid::CellCoord y) noexcept
+{
+    return (std::uint64_t{static_cast<std::uint32_t>(x)} << 32u) |
+        std::uint64_t{static_cast<std::uint32_t>(y)};
+}
+
+/// @brief Gets the number of cells in the given range.
+std::int64_t CountCells(const HashGrid::CellRange& range) noexcept
+{
+    if ((range.maxX < range.minX) || (range.maxY < range.minY))
+    {
+        return 0;
+    }
+    return (std::int64_t{range.maxX} - range.minX + 1) * (std::int64_t{range.maxY} - range.minY + 1);
+}
+
+/// @brief Whether the given cell ranges are the same.
+bool IsSame(const HashGrid::CellRange& lhs, const HashGrid::CellRange& rhs) noexcept
+{
+    return (lhs.minX == rhs.minX) && (lhs.minY == rhs.minY) &&
+        (lhs.maxX == rhs.maxX) && (lhs.maxY == rhs.maxY);
+}
+
+/// @brief Whether a leaf having the given cell count gets bucketed into cells.
+bool IsBucketed(std::int64_t cellCount) noexcept
+{
+    return (cellCount > 0) && (cellCount <= HashGrid::GetMaxCellsPerLeaf());
+}
+
+/// @brief Visits each leaf that potentially overlaps the given AABB once.
+/// @details Goes through the cells of the given AABB, or through all the leafs if
+///   that's fewer, followed by the leafs that aren't bucketed.
+/// @return <code>true</code> if the visitor returned <code>true</code> to stop the
+///   visiting, <code>false</code> otherwise.
+template <class Visitor>
+bool ForEachCandidate(const HashGrid& grid, const AABB& aabb, Visitor visit)
+{
+    const auto& leafs = grid.GetLeafs();
+    const auto range = grid.GetCellRange(aabb);
+    if (CountCells(range) > static_cast<std::int64_t>(grid.GetLeafCount()))
+    {
+        const auto numLeafs = static_cast<HashGrid::Size>(size(leafs));
+        for (auto i = HashGrid::Size{0}; i < numLeafs; ++i)
+        {
+            if (leafs[i].used && visit(i))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    for (auto y = range.minY; y <= range.maxY; ++y)
+    {
+        for (auto x = range.minX; x <= range.maxX; ++x)
+        {
+            const auto cell = grid.GetCell(x, y);
+            if (!cell)
+            {
+                continue;
+            }
+            for (const auto index: *cell)
+            {
+                // Only visits a leaf from the first cell it has in common with the range.
+                const auto& cells = leafs[index].cells;
+                if ((x == std::max(cells.minX, range.minX)) &&
+                    (y == std::max(cells.minY, range.minY)) && visit(index))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    for (const auto index: grid.GetOversized())
+    {
+        if (visit(index))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+HashGrid::Size HashGrid::CreateLeaf(const AABB& aabb, const LeafData& data)
+{
+    auto index = GetInvalidSize();
+    if (!empty(m_free))
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        index = static_cast<Size>(size(m_leafs));
+        m_leafs.emplace_back();
+    }
+    auto& leaf = m_leafs[index];
+    leaf.aabb = aabb;
+    leaf.data = data;
+    leaf.used = true;
+    ++m_leafCount;
+    Insert(index, GetCellRange(aabb));
+    return index;
+}
+
+std::vector<HashGrid::Size> HashGrid::CreateLeafs(Span<const AABB> aabbs,
+                                                 Span<const LeafData> data)
+{
+    if (aabbs.size() != data.size())
+    {
+        throw InvalidArgument("HashGrid::CreateLeafs: spans must be of same size");
+    }
+    const auto count = aabbs.size();
+    auto ids = std::vector<Size>(count);
+    m_leafs.reserve(size(m_leafs) + count);
+    for (auto i = decltype(count){0}; i < count; ++i)
+    {
+        ids[i] = CreateLeaf(aabbs[i], data[i]);
+    }
+    return ids;
+}
+
+void HashGrid::DestroyLeaf(Size index) noexcept
+{
+    auto& leaf = m_leafs[index];
+    Remove(index, leaf.cells);
+    leaf.cells = CellRange{};
+    leaf.used = false;
+    --m_leafCount;
+    m_free.push_back(index);
+}
+
+void HashGrid::UpdateLeaf(Size index, const AABB& aabb)
+{
+    auto& leaf = m_leafs[index];
+    leaf.aabb = aabb;
+    const auto range = GetCellRange(aabb);
+    const auto bucketed = IsBucketed(CountCells(range));
+    if (bucketed? IsSame(leaf.cells, range): (CountCells(leaf.cells) == 0))
+    {
+        // Still in the same cells, or still not bucketed.
+        return;
+    }
+    Remove(index, leaf.cells);
+    Insert(index, range);
+}
+
+const std::vector<HashGrid::Size>* HashGrid::GetCell(CellCoord x, CellCoord y) const noexcept
+{
+    const auto it = m_cells.find(GetCellKey(x, y));
+    return (it != end(m_cells))? &(it->second): nullptr;
+}
+
+HashGrid::CellRange HashGrid::GetCellRange(const AABB& aabb) const noexcept
+{
+    const auto cellSize = StripUnit(Length{m_cellSize});
+    return CellRange{
+        GetCellCoord(StripUnit(aabb.ranges[0].GetMin()) / cellSize),
+        GetCellCoord(StripUnit(aabb.ranges[1].GetMin()) / cellSize),
+        GetCellCoord(StripUnit(aabb.ranges[0].GetMax()) / cellSize),
+        GetCellCoord(StripUnit(aabb.ranges[1].GetMax()) / cellSize)
+    };
+}
+
+void HashGrid::Clear() noexcept
+{
+    m_leafs.clear();
+    m_free.clear();
+    m_oversized.clear();
+    m_cells.clear();
+    m_leafCount = 0;
+}
+
+void HashGrid::ShiftOrigin(Length2 newOrigin)
+{
+    m_oversized.clear();
+    m_cells.clear();
+    const auto numLeafs = static_cast<Size>(size(m_leafs));
+    for (auto i = Size{0}; i < numLeafs; ++i)
+    {
+        auto& leaf = m_leafs[i];
+        if (leaf.used)
+        {
+            leaf.aabb = GetMovedAABB(leaf.aabb, -newOrigin);
+            Insert(i, GetCellRange(leaf.aabb));
+        }
+    }
+}
+
+void HashGrid::Insert(Size index, const CellRange& range)
+{
+    auto& leaf = m_leafs[index];
+    if (!IsBucketed(CountCells(range)))
+    {
+        leaf.cells = CellRange{};
+        m_oversized.push_back(index);
+        return;
+    }
+    leaf.cells = range;
+    for (auto y = range.minY; y <= range.maxY; ++y)
+    {
+        for (auto x = range.minX; x <= range.maxX; ++x)
+        {
+            m_cells[GetCellKey(x, y)].push_back(index);
+        }
+    }
+}
+
+void HashGrid::Remove(Size index, const CellRange& range) noexcept
+{
+    if (CountCells(range) == 0)
+    {
+        const auto it = std::find(begin(m_oversized), end(m_oversized), index);
+        if (it != end(m_oversized))
+        {
+            m_oversized.erase(it);
+        }
+        return;
+    }
+    for (auto y = range.minY; y <= range.maxY; ++y)
+    {
+        for (auto x = range.minX; x <= range.maxX; ++x)
+        {
+            const auto cell = m_cells.find(GetCellKey(x, y));
+            auto& indices = cell->second;
+            const auto it = std::find(begin(indices), end(indices), index);
+            *it = indices.back();
+            indices.pop_back();
+            if (empty(indices))
+            {
+                m_cells.erase(cell);
+            }
+        }
+    }
+}
+
+void Query(const HashGrid& grid, const AABB& aabb, const DynamicTreeSizeCB& callback)
+{
+    ForEachCandidate(grid, aabb, [&](HashGrid::Size index) {
+        return TestOverlap(grid.GetAABB(index), aabb) &&
+            (callback(index) == DynamicTreeOpcode::End);
+    });
+}
+
+bool RayCast(const HashGrid& grid, RayCastInput input, const DynamicTreeRayCastCB& callback)
+{
+    const auto v = GetRevPerpendicular(GetUnitVector(input.p2 - input.p1, UnitVec::GetZero()));
+    const auto abs_v = abs(v);
+    auto segmentAABB = d2::GetAABB(input);
+    return ForEachCandidate(grid, segmentAABB, [&](HashGrid::Size index) {
+        const auto aabb = grid.GetAABB(index);
+        if (!TestOverlap(aabb, segmentAABB))
+        {
+            return false;
+        }
+
+        // Separating axis for segment (Gino, p80).
+        // |dot(v, p1 - ctr)| > dot(|v|, extents)
+        const auto center = GetCenter(aabb);
+        const auto extents = GetExtents(aabb);
+        const auto separation = abs(Dot(v, input.p1 - center)) - Dot(abs_v, extents);
+        if (separation > 0_m)
+        {
+            return false;
+        }
+
+        const auto leafData = grid.GetLeafData(index);
+        const auto value = callback(leafData.body, leafData.fixture, leafData.childIndex,
+                                    input);
+        if (value == 0)
+        {
+            return true; // Callback has terminated the ray cast.
+        }
+        if (value > 0)
+        {
+            // Update segment bounding box.
+            input.maxFraction = value;
+            segmentAABB = d2::GetAABB(input);
+        }
+        return false;
+    });
+}
+
+} // namespace d2
+} // namespace playrho
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef PLAYRHO_COLLISION_HASHGRID_HPP
+#define PLAYRHO_COLLISION_HASHGRID_HPP
+
+/// @file
+/// Declaration of the HashGrid class and related free functions.
+
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/RayCastOutput.hpp>
+#include <PlayRho/Common/Positive.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+
+/// @brief Spatial hash grid broad-phase.
+///
+/// @details Buckets leafs by the square grid cells that their AABBs overlap. The cells
+///   are hashed so only occupied cells take up storage.
+///
+/// @note Updating a leaf whose AABB stays within the same cells is a constant time
+///   operation - unlike the logarithmic cost of updating a <code>DynamicTree</code> leaf.
+///   This makes it a good fit for lots of similarly sized shapes, like particles. For
+///   that, the cell size should be around the size of the shapes' fattened AABBs.
+/// @note Leafs whose AABBs overlap more than <code>GetMaxCellsPerLeaf()</code> cells
+///   aren't bucketed but instead get checked by every query.
+/// @note Leaf identifiers are stable for the life of the leaf and are reused after
+///   leafs are destroyed - like the leaf indices of a <code>DynamicTree</code>.
+///
+/// @see https://en.wikipedia.org/wiki/Grid_(spatial_index)
+///
+class HashGrid
+{
+public:
+    /// @brief Size type.
+    using Size = DynamicTree::Size;
+
+    /// @brief Leaf data type.
+    using LeafData = DynamicTree::LeafData;
+
+    /// @brief Cell coordinate type.
+    using CellCoord = std::int32_t;
+
+    /// @brief Range of cells.
+    struct CellRange
+    {
+        CellCoord minX = 0; ///< Minimum X cell coordinate.
+        CellCoord minY = 0; ///< Minimum Y cell coordinate.
+        CellCoord maxX = -1; ///< Maximum X cell coordinate.
+        CellCoord maxY = -1; ///< Maximum Y cell coordinate.
+    };
+
+    /// @brief Leaf.
+    struct Leaf
+    {
+        AABB aabb; ///< AABB of the leaf.
+        LeafData data; ///< Data of the leaf.
+        CellRange cells; ///< Cells the leaf is in or empty if not bucketed.
+        bool used = false; ///< Whether this is for a valid leaf.
+    };
+
+    /// @brief Gets the invalid size value.
+    static constexpr Size GetInvalidSize() noexcept
+    {
+        return DynamicTree::GetInvalidSize();
+    }
+
+    /// @brief Gets the default cell size.
+    static constexpr Length GetDefaultCellSize() noexcept
+    {
+        return 2_m;
+    }
+
+    /// @brief Gets the maximum number of cells a leaf gets bucketed into.
+    static constexpr std::int64_t GetMaxCellsPerLeaf() noexcept
+    {
+        return 64;
+    }
+
+    /// @brief Initializing constructor.
+    explicit HashGrid(Positive<Length> cellSize = GetDefaultCellSize()) noexcept:
+        m_cellSize{cellSize}
+    {
+        // Intentionally empty.
+    }
+
+    /// @brief Gets the cell size.
+    Positive<Length> GetCellSize() const noexcept
+    {
+        return m_cellSize;
+    }
+
+    /// @brief Creates a leaf for the given AABB with the given data.
+    /// @return Identifier of the created leaf.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    Size CreateLeaf(const AABB& aabb, const LeafData& data);
+
+    /// @brief Creates leafs for all of the given AABBs with the given data.
+    /// @return Identifiers of the created leafs, in the order of the given AABBs.
+    /// @throws InvalidArgument If the given spans are of different sizes.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    std::vector<Size> CreateLeafs(Span<const AABB> aabbs, Span<const LeafData> data);
+
+    /// @brief Destroys the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    void DestroyLeaf(Size index) noexcept;
+
+    /// @brief Updates the identified leaf with the given AABB.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    void UpdateLeaf(Size index, const AABB& aabb);
+
+    /// @brief Gets the leaf data for the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    LeafData GetLeafData(Size index) const noexcept
+    {
+        return m_leafs[index].data;
+    }
+
+    /// @brief Sets the leaf data for the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    void SetLeafData(Size index, LeafData value) noexcept
+    {
+        m_leafs[index].data = value;
+    }
+
+    /// @brief Gets the AABB of the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    AABB GetAABB(Size index) const noexcept
+    {
+        return m_leafs[index].aabb;
+    }
+
+    /// @brief Gets the number of leafs.
+    Size GetLeafCount() const noexcept
+    {
+        return m_leafCount;
+    }
+
+    /// @brief Gets the leafs indexed by leaf identifier.
+    /// @note This includes entries for unused identifiers.
+    const std::vector<Leaf>& GetLeafs() const noexcept
+    {
+        return m_leafs;
+    }
+
+    /// @brief Gets the identifiers of the leafs in the identified cell.
+    /// @return Pointer to the identifiers or <code>nullptr</code> if the cell is empty.
+    const std::vector<Size>* GetCell(CellCoord x, CellCoord y) const noexcept;
+
+    /// @brief Gets the identifiers of the leafs that aren't bucketed into cells.
+    const std::vector<Size>& GetOversized() const noexcept
+    {
+        return m_oversized;
+    }
+
+    /// @brief Gets the range of cells that the given AABB overlaps.
+    CellRange GetCellRange(const AABB& aabb) const noexcept;
+
+    /// @brief Gets the number of occupied cells.
+    std::size_t GetCellCount() const noexcept
+    {
+        return size(m_cells);
+    }
+
+    /// @brief Clears all the leafs.
+    void Clear() noexcept;
+
+    /// @brief Incrementally optimizes this instance.
+    /// @note Grid cells don't degrade from churn so this does nothing.
+    /// @note This is the equivalent of the <code>DynamicTree</code> member function.
+    /// @return Statistics with the sweep always having ended.
+    DynamicTree::OptimizeStats Optimize(Size, Size) noexcept
+    {
+        auto stats = DynamicTree::OptimizeStats{};
+        stats.sweepEnded = true;
+        return stats;
+    }
+
+    /// @brief Incrementally optimizes this instance.
+    /// @note This doesn't need any scratch space so this ignores the given buffer.
+    DynamicTree::OptimizeStats Optimize(Size start, Size budget, std::vector<Size>&) noexcept
+    {
+        return Optimize(start, budget);
+    }
+
+    /// @brief Shifts the world origin.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    void ShiftOrigin(Length2 newOrigin);
+
+private:
+    /// @brief Adds the identified leaf to the cells of the given range.
+    void Insert(Size index, const CellRange& range);
+
+    /// @brief Removes the identified leaf from the cells of the given range.
+    void Remove(Size index, const CellRange& range) noexcept;
+
+    Positive<Length> m_cellSize; ///< Cell size.
+    std::vector<Leaf> m_leafs; ///< Leafs indexed by leaf identifier.
+    std::vector<Size> m_free; ///< Free leaf identifiers.
+    std::vector<Size> m_oversized; ///< Leafs overlapping too many cells to be bucketed.
+    std::unordered_map<std::uint64_t, std::vector<Size>> m_cells; ///< Occupied cells.
+    Size m_leafCount = 0; ///< Count of leafs.
+};
+
+/// @brief Tests for overlap of the elements identified in the given hash grid.
+/// @relatedalso HashGrid
+inline bool TestOverlap(const HashGrid& grid,
+                        HashGrid::Size leafIdA, HashGrid::Size leafIdB) noexcept
+{
+    return TestOverlap(grid.GetAABB(leafIdA), grid.GetAABB(leafIdB));
+}
+
+/// @brief Queries the given hash grid for leafs overlapping the given AABB.
+/// @note The callback instance is called once for each leaf that overlaps the supplied AABB.
+/// @relatedalso HashGrid
+void Query(const HashGrid& grid, const AABB& aabb, const DynamicTreeSizeCB& callback);
+
+/// @brief Cast rays against the leafs in the given hash grid.
+/// @note This is the equivalent of the <code>DynamicTree</code> based function.
+/// @return <code>true</code> if terminated at the callback's request,
+///   <code>false</code> otherwise.
+/// @relatedalso HashGrid
+bool RayCast(const HashGrid& grid, RayCastInput input, const DynamicTreeRayCastCB& callback);
+
+/// @brief Gets the "size" of the given hash grid.
+/// @note Size in this context is defined as the leaf count.
+/// @relatedalso HashGrid
+inline std::size_t size(const HashGrid& grid) noexcept
+{
+    return grid.GetLeafCount();
+}
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_COLLISION_HASHGRID_HPP
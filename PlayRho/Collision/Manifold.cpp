@@ -26,6 +26,9 @@
 #include <PlayRho/Collision/DistanceProxy.hpp>
 #include <PlayRho/Collision/Collision.hpp>
 #include <PlayRho/Collision/ShapeSeparation.hpp>
+#include <PlayRho/Collision/Shapes/Shape.hpp>
+#include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/PolygonShapeConf.hpp>
 
 #include <PlayRho/Defines.hpp>
 
@@ -285,9 +288,19 @@ Manifold GetManifold(bool flipped,
     return Manifold{};
 }
 
-Manifold GetManifold(bool flipped, Length totalRadius,
-                     const DistanceProxy& shape, const Transformation& sxf,
-                     Length2 point, const Transformation& xfm)
+namespace {
+
+/// @brief Computes the manifold of the given polygon of two or more vertices and point.
+/// @details Finds the polygon's face of greatest separation from the point and then which
+///   of that face's vertex regions or face region the point is in.
+/// @tparam T Type of the polygon. Anything having <code>GetVertexCount</code>,
+///   <code>GetVertex</code> and <code>GetNormal</code> member functions like
+///   <code>DistanceProxy</code> and <code>PolygonShapeConf</code> have.
+/// @param flipped Whether the point is of the first shape of the pair rather than the second.
+template <class T>
+Manifold GetPolygonPointManifold(bool flipped, Length totalRadius,
+                                 const T& shape, const Transformation& sxf,
+                                 Length2 point, const Transformation& xfm)
 {
     // Computes the center of the circle in the frame of the polygon.
     const auto cLocal = InverseTransform(Transform(point, xfm), sxf); ///< Center of circle in frame of polygon.
@@ -382,6 +395,15 @@ Manifold GetManifold(bool flipped, Length totalRadius,
                                  ContactFeature::e_vertex, 0, point);
 }
 
+} // anonymous namespace
+
+Manifold GetManifold(bool flipped, Length totalRadius,
+                     const DistanceProxy& shape, const Transformation& sxf,
+                     Length2 point, const Transformation& xfm)
+{
+    return GetPolygonPointManifold(flipped, totalRadius, shape, sxf, point, xfm);
+}
+
 Manifold GetManifold(Length2 locationA, const Transformation& xfA,
                      Length2 locationB, const Transformation& xfB,
                      Length totalRadius) noexcept
@@ -394,6 +416,56 @@ Manifold GetManifold(Length2 locationA, const Transformation& xfA,
     return (lenSq > totSq)? Manifold{}: Manifold::GetForCircles(locationA, 0, locationB, 0);
 }
 
+namespace {
+
+/// @brief Collides the given polytopes of two or more vertices each.
+/// @note This chooses the four by four separating axis search for box-box like pairs.
+Manifold CollidePolytopes(const DistanceProxy& shapeA, const Transformation& xfA,
+                          const DistanceProxy& shapeB, const Transformation& xfB,
+                          Length totalRadius, const Manifold::Conf& conf)
+{
+    const auto do4x4 = (shapeA.GetVertexCount() == 4) && (shapeB.GetVertexCount() == 4);
+    
+    const auto edgeSepA = do4x4?
+        GetMaxSeparation4x4(shapeA, xfA, shapeB, xfB):
+        GetMaxSeparation(shapeA, xfA, shapeB, xfB);
+    if (edgeSepA.distance > totalRadius)
+    {
+        return Manifold{};
+    }
+    
+    const auto edgeSepB = do4x4?
+        GetMaxSeparation4x4(shapeB, xfB, shapeA, xfA):
+        GetMaxSeparation(shapeB, xfB, shapeA, xfA);
+    if (edgeSepB.distance > totalRadius)
+    {
+        return Manifold{};
+    }
+    
+    const auto k_tol = PLAYRHO_MAGIC(conf.linearSlop / 10);
+    return (edgeSepB.distance > (edgeSepA.distance + k_tol))?
+        GetManifold(true,
+                        shapeB, xfB, edgeSepB.firstShape,
+                        shapeA, xfA, edgeSepB.secondShape,
+                        conf):
+        GetManifold(false,
+                        shapeA, xfA, edgeSepA.firstShape,
+                        shapeB, xfB, edgeSepA.secondShape,
+                        conf);
+}
+
+/// @brief Throws an <code>InvalidArgument</code> exception unless both child indices are
+///   zero - the only child index of disk and polygon shapes.
+void CheckSoleChild(ChildCounter indexA, ChildCounter indexB)
+{
+    if ((indexA != 0) || (indexB != 0))
+    {
+        throw InvalidArgument("only index of 0 is supported");
+    }
+}
+
+} // anonymous namespace
+
 /*
  * Definition of public CollideShapes functions.
  * All CollideShapes functions return a Manifold object.
@@ -425,34 +497,41 @@ Manifold CollideShapes(const DistanceProxy& shapeA, const Transformation& xfA,
             return GetManifold(false, totalRadius, shapeA, xfA, shapeB.GetVertex(0), xfB);
     }
     
-    const auto do4x4 = (countA == 4) && (countB == 4);
-    
-    const auto edgeSepA = do4x4?
-        GetMaxSeparation4x4(shapeA, xfA, shapeB, xfB):
-        GetMaxSeparation(shapeA, xfA, shapeB, xfB);
-    if (edgeSepA.distance > totalRadius)
-    {
-        return Manifold{};
+    return CollidePolytopes(shapeA, xfA, shapeB, xfB, totalRadius, conf);
+}
+
+Manifold CollideShapes(const Shape& shapeA, ChildCounter indexA, const Transformation& xfA,
+                       const Shape& shapeB, ChildCounter indexB, const Transformation& xfB,
+                       Manifold::Conf conf)
+{
+    // Only disk-polygon pairs measure faster without going through distance proxies.
+    const auto typeA = GetType(shapeA);
+    const auto typeB = GetType(shapeB);
+    if ((typeA == GetTypeID<DiskShapeConf>()) && (typeB == GetTypeID<PolygonShapeConf>()))
+    {
+        const auto& disk = *static_cast<const DiskShapeConf*>(GetData(shapeA));
+        const auto& polygon = *static_cast<const PolygonShapeConf*>(GetData(shapeB));
+        if (polygon.GetVertexCount() > 1)
+        {
+            CheckSoleChild(indexA, indexB);
+            return GetPolygonPointManifold(true, Length{disk.vertexRadius} +
+                                           Length{polygon.vertexRadius}, polygon, xfB,
+                                           disk.GetLocation(), xfA);
+        }
     }
-    
-    const auto edgeSepB = do4x4?
-        GetMaxSeparation4x4(shapeB, xfB, shapeA, xfA):
-        GetMaxSeparation(shapeB, xfB, shapeA, xfA);
-    if (edgeSepB.distance > totalRadius)
+    else if ((typeA == GetTypeID<PolygonShapeConf>()) && (typeB == GetTypeID<DiskShapeConf>()))
     {
-        return Manifold{};
+        const auto& polygon = *static_cast<const PolygonShapeConf*>(GetData(shapeA));
+        const auto& disk = *static_cast<const DiskShapeConf*>(GetData(shapeB));
+        if (polygon.GetVertexCount() > 1)
+        {
+            CheckSoleChild(indexA, indexB);
+            return GetPolygonPointManifold(false, Length{polygon.vertexRadius} +
+                                           Length{disk.vertexRadius}, polygon, xfA,
+                                           disk.GetLocation(), xfB);
+        }
     }
-    
-    const auto k_tol = PLAYRHO_MAGIC(conf.linearSlop / 10);
-    return (edgeSepB.distance > (edgeSepA.distance + k_tol))?
-        GetManifold(true,
-                        shapeB, xfB, edgeSepB.firstShape,
-                        shapeA, xfA, edgeSepB.secondShape,
-                        conf):
-        GetManifold(false,
-                        shapeA, xfA, edgeSepA.firstShape,
-                        shapeB, xfB, edgeSepA.secondShape,
-                        conf);
+    return CollideShapes(GetChild(shapeA, indexA), xfA, GetChild(shapeB, indexB), xfB, conf);
 }
 
 #if 0
@@ -31,6 +31,7 @@ struct StepConf;
 namespace d2 {
 
 class DistanceProxy;
+class Shape;
 struct Transformation;
 
 /// @brief A collision response oriented description of the intersection of two convex shapes.
@@ -600,6 +601,25 @@ Manifold GetManifold(Length2 locationA, const Transformation& xfA,
 Manifold CollideShapes(const DistanceProxy& shapeA, const Transformation& xfA,
                        const DistanceProxy& shapeB, const Transformation& xfB,
                        Manifold::Conf conf = GetDefaultManifoldConf());
+
+/// @brief Calculates the relevant collision manifold for the identified children of the
+///   given shapes.
+///
+/// @details Dispatches on the types of the two shapes. Disk-polygon pairs get the circle
+///   versus face manifold computed straight from the shapes' configurations instead of
+///   from their children as distance proxies. All other pairs measured no faster that way
+///   so they get the distance proxy based function.
+///
+/// @note The returned manifold is the same as the distance proxy based function returns for
+///   the same children.
+/// @throws InvalidArgument if a child index is invalid for its shape.
+///
+/// @see GetType(const Shape&), GetChild(const Shape&, ChildCounter).
+/// @relatedalso Manifold
+///
+Manifold CollideShapes(const Shape& shapeA, ChildCounter indexA, const Transformation& xfA,
+                       const Shape& shapeB, ChildCounter indexB, const Transformation& xfB,
+                       Manifold::Conf conf = GetDefaultManifoldConf());
 #if 0
 Manifold CollideCached(const DistanceProxy& shapeA, const Transformation& xfA,
                        const DistanceProxy& shapeB, const Transformation& xfB,
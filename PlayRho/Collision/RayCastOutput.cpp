@@ -25,9 +25,7 @@
 #include <PlayRho/Collision/AABB.hpp>
 #include <PlayRho/Collision/DistanceProxy.hpp>
 #include <PlayRho/Collision/DynamicTree.hpp>
-#include <PlayRho/Dynamics/WorldBody.hpp>
-#include <PlayRho/Dynamics/WorldFixture.hpp>
-#include <PlayRho/Dynamics/WorldMisc.hpp>
+#include <PlayRho/Dynamics/WorldRayCast.hpp>
 
 #include <utility>
 
@@ -235,102 +233,13 @@ RayCastOutput RayCast(const Shape& shape, ChildCounter childIndex,
 }
 
 bool RayCast(const DynamicTree& tree, RayCastInput input, const DynamicTreeRayCastCB& callback)
-{    
-    const auto v = GetRevPerpendicular(GetUnitVector(input.p2 - input.p1, UnitVec::GetZero()));
-    const auto abs_v = abs(v);
-    auto segmentAABB = d2::GetAABB(input);
-    
-    GrowableStack<ContactCounter, 256> stack;
-    stack.push(tree.GetRootIndex());
-    while (!empty(stack))
-    {
-        const auto index = stack.top();
-        stack.pop();
-        if (index == DynamicTree::GetInvalidSize())
-        {
-            continue;
-        }
-        
-        const auto aabb = tree.GetAABB(index);
-        if (!TestOverlap(aabb, segmentAABB))
-        {
-            continue;
-        }
-        
-        // Separating axis for segment (Gino, p80).
-        // |dot(v, p1 - ctr)| > dot(|v|, extents)
-        const auto center = GetCenter(aabb);
-        const auto extents = GetExtents(aabb);
-        const auto separation = abs(Dot(v, input.p1 - center)) - Dot(abs_v, extents);
-        if (separation > 0_m)
-        {
-            continue;
-        }
-        
-        if (DynamicTree::IsBranch(tree.GetHeight(index)))
-        {
-            const auto branchData = tree.GetBranchData(index);
-            stack.push(branchData.child1);
-            stack.push(branchData.child2);
-        }
-        else
-        {
-            assert(DynamicTree::IsLeaf(tree.GetHeight(index)));
-            const auto leafData = tree.GetLeafData(index);
-            const auto value = callback(leafData.body, leafData.fixture, leafData.childIndex,
-                                        input);
-            if (value == 0)
-            {
-                return true; // Callback has terminated the ray cast.
-            }
-            if (value > 0)
-            {
-                // Update segment bounding box.
-                input.maxFraction = value;
-                segmentAABB = d2::GetAABB(input);
-            }
-        }
-    }
-    return false;
+{
+    return RayCast<const DynamicTreeRayCastCB&>(tree, input, callback);
 }
 
 bool RayCast(const World& world, const RayCastInput& input, const FixtureRayCastCB& callback)
 {
-    return RayCast(GetTree(world), input,
-                   [&world,&callback](BodyID body, FixtureID fixture, ChildCounter index,
-                                      const RayCastInput& rci) {
-        const auto output = RayCast(GetChild(GetShape(world, fixture), index), rci,
-                                    GetTransformation(world, body));
-        if (output.has_value())
-        {
-            const auto fraction = output->fraction;
-            assert(fraction >= 0 && fraction <= 1);
-            
-            // Here point can be calculated these two ways:
-            //   (1) point = p1 * (1 - fraction) + p2 * fraction
-            //   (2) point = p1 + (p2 - p1) * fraction.
-            //
-            // The first way however suffers from the fact that:
-            //     a * (1 - fraction) + a * fraction != a
-            // for all values of a and fraction between 0 and 1 when a and fraction are
-            // floating point types.
-            // This leads to the posibility that (p1 == p2) && (point != p1 || point != p2),
-            // which may be pretty surprising to the callback. So this way SHOULD NOT be used.
-            //
-            // The second way, does not have this problem.
-            //
-            const auto point = rci.p1 + (rci.p2 - rci.p1) * fraction;
-            const auto opcode = callback(body, fixture, index, point, output->normal);
-            switch (opcode)
-            {
-                case RayCastOpcode::Terminate: return Real{0};
-                case RayCastOpcode::IgnoreFixture: return Real{-1};
-                case RayCastOpcode::ClipRay: return Real{fraction};
-                case RayCastOpcode::ResetRay: return Real{rci.maxFraction};
-            }
-        }
-        return Real{rci.maxFraction};
-    });
+    return RayCast<const FixtureRayCastCB&>(world, input, callback);
 }
 
 } // namespace d2
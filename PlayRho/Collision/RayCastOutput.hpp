@@ -27,18 +27,15 @@
 
 #include <PlayRho/Common/UnitInterval.hpp>
 #include <PlayRho/Common/OptionalValue.hpp>
+#include <PlayRho/Common/GrowableStack.hpp>
+#include <PlayRho/Common/Math.hpp>
 #include <PlayRho/Collision/RayCastInput.hpp>
+#include <PlayRho/Collision/DynamicTree.hpp>
 
 #include <PlayRho/Dynamics/BodyID.hpp>
 #include <PlayRho/Dynamics/FixtureID.hpp>
 
 namespace playrho {
-namespace detail {
-
-template <std::size_t N>
-struct AABB;
-
-} // namespace detail
 
 /// @brief Ray cast opcode enumeration.
 /// @details Instructs some ray casting methods on what to do next.
@@ -67,7 +64,6 @@ namespace d2 {
 
 class Shape;
 class DistanceProxy;
-class DynamicTree;
 class World;
 
 /// @brief Ray-cast hit data.
@@ -157,10 +153,83 @@ RayCastOutput RayCast(const Shape& shape, ChildCounter childIndex,
 bool RayCast(const DynamicTree& tree, RayCastInput input,
              const DynamicTreeRayCastCB& callback);
 
+/// @brief Cast rays against the leafs in the given tree.
+/// @details This is the template overload for any callable taking the same arguments as
+///   a <code>DynamicTreeRayCastCB</code> and returning a value convertible to
+///   <code>Real</code>, like a lambda expression. The call is made directly so it can be
+///   inlined into the traversal loop instead of going through <code>std::function</code>.
+/// @return <code>true</code> if terminated at the callback's request,
+///   <code>false</code> otherwise.
+template <class F>
+auto RayCast(const DynamicTree& tree, RayCastInput input, F&& callback)
+    -> std::enable_if_t<std::is_convertible<
+        decltype(std::declval<F&>()(std::declval<BodyID>(), std::declval<FixtureID>(),
+                                    std::declval<ChildCounter>(),
+                                    std::declval<const RayCastInput&>())),
+        Real>::value, bool>
+{
+    const auto v = GetRevPerpendicular(GetUnitVector(input.p2 - input.p1, UnitVec::GetZero()));
+    const auto abs_v = abs(v);
+    auto segmentAABB = d2::GetAABB(input);
+    
+    GrowableStack<DynamicTree::Size, 256> stack;
+    stack.push(tree.GetRootIndex());
+    while (!empty(stack))
+    {
+        const auto index = stack.top();
+        stack.pop();
+        if (index == DynamicTree::GetInvalidSize())
+        {
+            continue;
+        }
+        
+        const auto aabb = tree.GetAABB(index);
+        if (!TestOverlap(aabb, segmentAABB))
+        {
+            continue;
+        }
+        
+        // Separating axis for segment (Gino, p80).
+        // |dot(v, p1 - ctr)| > dot(|v|, extents)
+        const auto center = GetCenter(aabb);
+        const auto extents = GetExtents(aabb);
+        const auto separation = abs(Dot(v, input.p1 - center)) - Dot(abs_v, extents);
+        if (separation > 0_m)
+        {
+            continue;
+        }
+        
+        if (DynamicTree::IsBranch(tree.GetHeight(index)))
+        {
+            const auto branchData = tree.GetBranchData(index);
+            stack.push(branchData.child1);
+            stack.push(branchData.child2);
+        }
+        else
+        {
+            const auto leafData = tree.GetLeafData(index);
+            const auto value = static_cast<Real>(callback(leafData.body, leafData.fixture,
+                                                          leafData.childIndex, input));
+            if (value == 0)
+            {
+                return true; // Callback has terminated the ray cast.
+            }
+            if (value > 0)
+            {
+                // Update segment bounding box.
+                input.maxFraction = value;
+                segmentAABB = d2::GetAABB(input);
+            }
+        }
+    }
+    return false;
+}
+
 /// @brief Ray-cast the world for all fixtures in the path of the ray.
 ///
 /// @note The callback controls whether you get the closest point, any point, or n-points.
 /// @note The ray-cast ignores shapes that contain the starting point.
+/// @note Any separate static tree the world has gets ray-cast after the broad-phase.
 ///
 /// @param world The world instance to raycast in.
 /// @param input Ray cast input data.
@@ -168,6 +237,7 @@ bool RayCast(const DynamicTree& tree, RayCastInput input,
 ///
 /// @return <code>true</code> if terminated by callback, <code>false</code> otherwise.
 ///
+/// @see WorldRayCast.hpp for the template overload taking any callable.
 /// @relatedalso World
 bool RayCast(const World& world, const RayCastInput& input, const FixtureRayCastCB& callback);
 
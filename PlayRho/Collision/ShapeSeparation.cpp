@@ -21,13 +21,18 @@
 
 #include <PlayRho/Collision/ShapeSeparation.hpp>
 #include <PlayRho/Collision/DistanceProxy.hpp>
+#include <PlayRho/Detail/Sse2.hpp>
 #include <algorithm>
+#include <type_traits>
 
 namespace playrho {
 namespace d2 {
 
 namespace {
 
+/// @brief Maximum number of directions the minimum separations are gotten for at a time.
+constexpr auto DirectionsPerGroup = VertexCounter{4};
+
 /// @brief Gets the minimum separation information for the given vertices from the given
 ///  origin in the given direction.
 /// @param direction Directional normal for face on first convex shape starting from origin.
@@ -64,6 +69,128 @@ LengthIndices GetMinSeparationInfo(Length2 origin, UnitVec direction,
     return LengthIndices{minSeparation, {{first, second}}};
 }
 
+#ifdef PLAYRHO_SSE2
+
+using sse2::Vec2Lanes;
+using sse2::Select;
+
+/// @brief Gets the X and Y values of up to four of the given 2-D values as vectors.
+/// @note Pads out unused lanes with the first value.
+template <typename T>
+inline Vec2Lanes GetXY(const T* values, VertexCounter count) noexcept
+{
+    const auto get = [&](VertexCounter i) {
+        const auto& value = values[(i < count)? i: VertexCounter{0}];
+        return std::make_pair(static_cast<float>(StripUnit(GetX(value))),
+                              static_cast<float>(StripUnit(GetY(value))));
+    };
+    const auto v0 = get(0);
+    const auto v1 = get(1);
+    const auto v2 = get(2);
+    const auto v3 = get(3);
+    return Vec2Lanes{_mm_setr_ps(v0.first, v1.first, v2.first, v3.first),
+                     _mm_setr_ps(v0.second, v1.second, v2.second, v3.second)};
+}
+
+/// @brief Gets the minimum separation information for up to four origin and direction
+///   pairs at once using SSE2 instructions.
+/// @details Evaluates the four directions against one vertex per iteration. The results
+///   are the same - bit for bit - as from the scalar code since the transformations and
+///   separations are calculated with the same operations in the same order.
+/// @note Only for when <code>Real</code> is <code>float</code>.
+void GetMinSeparationInfosSse2(const Length2* origins, const UnitVec* directions,
+                               VertexCounter count, const Transformation* xf,
+                               Range<DistanceProxy::ConstVertexIterator> vertices,
+                               LengthIndices* results) noexcept
+{
+    assert((count > 0) && (count <= DirectionsPerGroup));
+    auto origin = GetXY(origins, count);
+    auto direction = GetXY(directions, count);
+    if (xf)
+    {
+        // Same as Transform(origin, *xf) and Rotate(direction, xf->q).
+        const auto qx = _mm_set1_ps(static_cast<float>(GetX(xf->q)));
+        const auto qy = _mm_set1_ps(static_cast<float>(GetY(xf->q)));
+        const auto px = _mm_set1_ps(static_cast<float>(StripUnit(GetX(xf->p))));
+        const auto py = _mm_set1_ps(static_cast<float>(StripUnit(GetY(xf->p))));
+        origin = Vec2Lanes{
+            _mm_add_ps(_mm_sub_ps(_mm_mul_ps(qx, origin.x), _mm_mul_ps(qy, origin.y)), px),
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(qy, origin.x), _mm_mul_ps(qx, origin.y)), py)};
+        direction = Vec2Lanes{
+            _mm_sub_ps(_mm_mul_ps(qx, direction.x), _mm_mul_ps(qy, direction.y)),
+            _mm_add_ps(_mm_mul_ps(qy, direction.x), _mm_mul_ps(qx, direction.y))};
+    }
+    const auto zero = _mm_setzero_ps();
+    const auto invalid = _mm_set1_epi32(InvalidVertex);
+    auto minSeparation = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    auto first = invalid;
+    auto second = invalid;
+    auto i = 0;
+    for (const auto& vertex: vertices)
+    {
+        const auto vx = _mm_set1_ps(static_cast<float>(StripUnit(GetX(vertex))));
+        const auto vy = _mm_set1_ps(static_cast<float>(StripUnit(GetY(vertex))));
+        // Same as Dot(direction, vertex - origin) - including its addition to zero.
+        const auto sx = _mm_mul_ps(direction.x, _mm_sub_ps(vx, origin.x));
+        const auto sy = _mm_mul_ps(direction.y, _mm_sub_ps(vy, origin.y));
+        const auto s = _mm_add_ps(_mm_add_ps(zero, sx), sy);
+        const auto lt = _mm_cmplt_ps(s, minSeparation);
+        const auto eq = _mm_cmpeq_ps(s, minSeparation);
+        const auto index = _mm_set1_epi32(i);
+        first = Select(lt, index, first);
+        second = Select(lt, invalid, Select(eq, index, second));
+        minSeparation = Select(lt, s, minSeparation);
+        ++i;
+    }
+    alignas(16) float separations[DirectionsPerGroup];
+    alignas(16) std::int32_t firsts[DirectionsPerGroup];
+    alignas(16) std::int32_t seconds[DirectionsPerGroup];
+    _mm_store_ps(separations, minSeparation);
+    _mm_store_si128(reinterpret_cast<__m128i*>(firsts), first);
+    _mm_store_si128(reinterpret_cast<__m128i*>(seconds), second);
+    for (auto j = VertexCounter{0}; j < count; ++j)
+    {
+        results[j] = LengthIndices{static_cast<Real>(separations[j]) * Meter, {{
+            static_cast<VertexCounter>(firsts[j]), static_cast<VertexCounter>(seconds[j])
+        }}};
+    }
+}
+
+#endif // PLAYRHO_SSE2
+
+/// @brief Gets the minimum separation information for each of the given origin and
+///   direction pairs.
+/// @param origins Vertices from first convex shape from which the directions originate.
+/// @param directions Directional normals for faces on first convex shape.
+/// @param count Number of origin and direction pairs. Must be between one and
+///   <code>DirectionsPerGroup</code> inclusive.
+/// @param xf Transformation to apply to the origins and directions or null for none.
+/// @param vertices Vertices from second convex shape.
+/// @param results Output for the results of each origin and direction pair.
+/// @note This uses SSE2 instructions where they're available and <code>Real</code> is
+///   <code>float</code>, and calls the scalar function per pair otherwise. The results
+///   are the same either way.
+inline void GetMinSeparationInfos(const Length2* origins, const UnitVec* directions,
+                                  VertexCounter count, const Transformation* xf,
+                                  Range<DistanceProxy::ConstVertexIterator> vertices,
+                                  LengthIndices* results) noexcept
+{
+#ifdef PLAYRHO_SSE2
+    if (std::is_same<Real, float>::value)
+    {
+        GetMinSeparationInfosSse2(origins, directions, count, xf, vertices, results);
+        return;
+    }
+#endif
+    for (auto i = VertexCounter{0}; i < count; ++i)
+    {
+        results[i] = xf?
+            GetMinSeparationInfo(Transform(origins[i], *xf), Rotate(directions[i], xf->q),
+                                 vertices):
+            GetMinSeparationInfo(origins[i], directions[i], vertices);
+    }
+}
+
 } // anonymous namespace
 
 SeparationInfo GetMaxSeparation4x4(const DistanceProxy& proxy1, Transformation xf1,
@@ -73,7 +200,6 @@ SeparationInfo GetMaxSeparation4x4(const DistanceProxy& proxy1, Transformation x
     auto separation = -std::numeric_limits<Length>::infinity();
     auto firstIndex = InvalidVertex;
     auto secondIndices = VertexCounter2{{InvalidVertex, InvalidVertex}};
-#if 1
     const auto xf = MulT(xf1, xf2);
     const Length2 p2vertices[4] = {
         Transform(proxy2.GetVertex(0), xf),
@@ -82,22 +208,15 @@ SeparationInfo GetMaxSeparation4x4(const DistanceProxy& proxy1, Transformation x
         Transform(proxy2.GetVertex(3), xf),
     };
     const auto vertices = Range<DistanceProxy::ConstVertexIterator>(p2vertices, p2vertices + 4);
-#else
-    const auto xf = MulT(xf2, xf1);
-    const auto vertices = proxy2.GetVertices();
-#endif
+
+    // Gets proxy1's normals and vertices relative to the transformed proxy2 vertices all
+    // at once.
+    LengthIndices aps[4];
+    GetMinSeparationInfos(proxy1.GetVertices().begin(), proxy1.GetNormals().begin(),
+                          VertexCounter{4}, nullptr, vertices, aps);
     for (auto i = VertexCounter{0}; i < VertexCounter{4}; ++i)
     {
-        // Get proxy1 normal and vertex relative to proxy2.
-#if 1
-        const auto origin = proxy1.GetVertex(i);
-        const auto normal = proxy1.GetNormal(i);
-        const auto ap = GetMinSeparationInfo(origin, normal, vertices);
-#else
-        const auto origin = Transform(proxy1.GetVertex(i), xf);
-        const auto normal = Rotate(proxy1.GetNormal(i), xf.q);
-        const auto ap = GetMinIndexSeparation(origin, normal, vertices);
-#endif
+        const auto& ap = aps[i];
         if (separation < ap.distance)
         {
             separation = ap.distance;
@@ -111,27 +230,7 @@ SeparationInfo GetMaxSeparation4x4(const DistanceProxy& proxy1, Transformation x
 SeparationInfo GetMaxSeparation(const DistanceProxy& proxy1, Transformation xf1,
                                 const DistanceProxy& proxy2, Transformation xf2)
 {
-    // Find the max separation between proxy1 and proxy2 using edge normals from proxy1.
-    auto separation = -std::numeric_limits<Length>::infinity();
-    auto firstIndex = InvalidVertex;
-    auto secondIndices = VertexCounter2{{InvalidVertex, InvalidVertex}};
-    const auto count1 = proxy1.GetVertexCount();
-    const auto xf = MulT(xf2, xf1);
-    const auto proxy2vertices = proxy2.GetVertices();
-    for (auto i = VertexCounter{0}; i < count1; ++i)
-    {
-        // Get proxy1 normal and vertex relative to proxy2.
-        const auto origin = Transform(proxy1.GetVertex(i), xf);
-        const auto normal = Rotate(proxy1.GetNormal(i), xf.q);
-        const auto ap = GetMinSeparationInfo(origin, normal, proxy2vertices);
-        if (separation < ap.distance)
-        {
-            separation = ap.distance;
-            secondIndices = ap.indices;
-            firstIndex = i;
-        }
-    }
-    return SeparationInfo{separation, firstIndex, secondIndices};
+    return GetMaxSeparation(proxy1, xf1, proxy2, xf2, std::numeric_limits<Length>::infinity());
 }
 
 SeparationInfo GetMaxSeparation(const DistanceProxy& proxy1, Transformation xf1,
@@ -144,21 +243,30 @@ SeparationInfo GetMaxSeparation(const DistanceProxy& proxy1, Transformation xf1,
     auto secondIndices = VertexCounter2{{InvalidVertex, InvalidVertex}};
     const auto xf = MulT(xf2, xf1);
     const auto count1 = proxy1.GetVertexCount();
-    for (auto i = VertexCounter{0}; i < count1; ++i)
+    const auto origins = proxy1.GetVertices().begin();
+    const auto normals = proxy1.GetNormals().begin();
+    for (auto offset = 0u; offset < count1; offset += DirectionsPerGroup)
     {
-        // Get proxy1 normal and vertex relative to proxy2.
-        const auto origin = Transform(proxy1.GetVertex(i), xf);
-        const auto normal = Rotate(proxy1.GetNormal(i), xf.q);
-        const auto ap = GetMinSeparationInfo(origin, normal, proxy2.GetVertices());
-        if (stop < ap.distance)
-        {
-            return SeparationInfo{ap.distance, i, ap.indices};
-        }
-        if (separation < ap.distance)
+        // Get proxy1 normals and vertices relative to proxy2 a group at a time.
+        const auto count = std::min(static_cast<VertexCounter>(count1 - offset),
+                                    DirectionsPerGroup);
+        LengthIndices aps[DirectionsPerGroup];
+        GetMinSeparationInfos(origins + offset, normals + offset, count, &xf,
+                              proxy2.GetVertices(), aps);
+        for (auto j = VertexCounter{0}; j < count; ++j)
         {
-            separation = ap.distance;
-            secondIndices = ap.indices;
-            firstIndex = i;
+            const auto& ap = aps[j];
+            const auto i = static_cast<VertexCounter>(offset + j);
+            if (stop < ap.distance)
+            {
+                return SeparationInfo{ap.distance, i, ap.indices};
+            }
+            if (separation < ap.distance)
+            {
+                separation = ap.distance;
+                secondIndices = ap.indices;
+                firstIndex = i;
+            }
         }
     }
     return SeparationInfo{separation, firstIndex, secondIndices};
@@ -172,25 +280,34 @@ SeparationInfo GetMaxSeparation(const DistanceProxy& proxy1, const DistanceProxy
     auto firstIndex = InvalidVertex;
     auto secondIndices = VertexCounter2{{InvalidVertex, InvalidVertex}};
     const auto count1 = proxy1.GetVertexCount();
-    for (auto i = decltype(count1){0}; i < count1; ++i)
+    const auto origins = proxy1.GetVertices().begin();
+    const auto normals = proxy1.GetNormals().begin();
+    for (auto offset = 0u; offset < count1; offset += DirectionsPerGroup)
     {
-        // Get proxy1 normal and vertex relative to proxy2.
-        const auto origin = proxy1.GetVertex(i);
-        const auto normal = proxy1.GetNormal(i);
-        const auto ap = GetMinSeparationInfo(origin, normal, proxy2.GetVertices());
-        if (stop < ap.distance)
+        // Get proxy1 normals and vertices relative to proxy2 a group at a time.
+        const auto count = std::min(static_cast<VertexCounter>(count1 - offset),
+                                    DirectionsPerGroup);
+        LengthIndices aps[DirectionsPerGroup];
+        GetMinSeparationInfos(origins + offset, normals + offset, count, nullptr,
+                              proxy2.GetVertices(), aps);
+        for (auto j = VertexCounter{0}; j < count; ++j)
         {
-            return SeparationInfo{ap.distance, i, ap.indices};
-        }
-        if (separation < ap.distance)
-        {
-            separation = ap.distance;
-            secondIndices = ap.indices;
-            firstIndex = i;
+            const auto& ap = aps[j];
+            const auto i = static_cast<VertexCounter>(offset + j);
+            if (stop < ap.distance)
+            {
+                return SeparationInfo{ap.distance, i, ap.indices};
+            }
+            if (separation < ap.distance)
+            {
+                separation = ap.distance;
+                secondIndices = ap.indices;
+                firstIndex = i;
+            }
         }
     }
     return SeparationInfo{separation, firstIndex, secondIndices};
 }
-    
+
 } // namespace d2
 } // namespace playrho
@@ -259,7 +259,7 @@ public:
 
     friend TypeID GetType(const Shape& shape) noexcept
     {
-        return shape.m_self? shape.m_self->GetType_(): GetTypeID<void>();
+        return shape.m_self? shape.m_self->type: GetTypeID<void>();
     }
 
     template <typename T>
@@ -287,6 +287,9 @@ private:
     /// @note Provides the interface for runtime value polymorphism.
     struct Concept
     {
+        /// @brief Initializing constructor.
+        explicit Concept(TypeID t) noexcept: type{t} {}
+
         virtual ~Concept() = default;
 
         /// @brief Clones this concept and returns a pointer to a mutable copy.
@@ -324,10 +327,6 @@ private:
         /// @brief Equality checking method.
         virtual bool IsEqual_(const Concept& other) const noexcept = 0;
         
-        /// @brief Gets the use type information.
-        /// @return Type info of the underlying value's type.
-        virtual TypeID GetType_() const noexcept = 0;
-        
         /// @brief Gets the data for the underlying configuration.
         virtual const void* GetData_() const noexcept = 0;
         
@@ -342,6 +341,11 @@ private:
         {
             return !(lhs == rhs);
         }
+
+        /// @brief Type info of the underlying value's type.
+        /// @note This is held as data rather than gotten from a virtual function since
+        ///   it's used to dispatch on for every contact update.
+        const TypeID type;
     };
 
     /// @brief Internal model configuration concept.
@@ -353,7 +357,7 @@ private:
         using data_type = T;
 
         /// @brief Initializing constructor.
-        Model(T arg): data{std::move(arg)} {}
+        Model(T arg): Concept{GetTypeID<data_type>()}, data{std::move(arg)} {}
         
         std::unique_ptr<Concept> Clone() const override
         {
@@ -404,15 +408,10 @@ private:
         {
             // Would be preferable to do this without using any kind of RTTI system.
             // But how would that be done?
-            return (GetType_() == other.GetType_()) &&
+            return (type == other.type) &&
                 (data == *static_cast<const T*>(other.GetData_()));
         }
 
-        TypeID GetType_() const noexcept override
-        {
-            return GetTypeID<data_type>();
-        }
-
         const void* GetData_() const noexcept override
         {
             // Note address of "data" not necessarily same as address of "this" since
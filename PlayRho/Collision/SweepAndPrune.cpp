@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <PlayRho/Collision/SweepAndPrune.hpp>
+#include <PlayRho/Common/InvalidArgument.hpp>
+#include <PlayRho/Common/Math.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace playrho {
+namespace d2 {
+
+namespace {
+
+/// @brief Gets the lower X coordinate of the given entry.
+inline Length GetMinX(const SweepAndPrune::Entry& entry) noexcept
+{
+    return entry.aabb.ranges[0].GetMin();
+}
+
+/// @brief Gets the width along the X axis of the given AABB.
+/// @note This is rounded up slightly so lower bounds derived from it stay conservative.
+inline Length GetWidth(const AABB& aabb) noexcept
+{
+    const auto width = GetSize(aabb.ranges[0]);
+    return width + width / Real(1024);
+}
+
+/// @brief Less-than comparison of an entry's lower X coordinate with the given value.
+inline bool LessMinX(const SweepAndPrune::Entry& entry, Length value) noexcept
+{
+    return GetMinX(entry) < value;
+}
+
+/// @brief Less-than comparison of the given value with an entry's lower X coordinate.
+inline bool LessValue(Length value, const SweepAndPrune::Entry& entry) noexcept
+{
+    return value < GetMinX(entry);
+}
+
+/// @brief Whether the given entry is dead.
+inline bool IsDead(const SweepAndPrune::Entry& entry) noexcept
+{
+    return entry.index == SweepAndPrune::GetInvalidSize();
+}
+
+} // anonymous namespace
+
+SweepAndPrune::Size SweepAndPrune::CreateLeaf(const AABB& aabb, const LeafData& data)
+{
+    const auto index = Append(aabb, data);
+    if (IsMergeDue())
+    {
+        Merge();
+    }
+    return index;
+}
+
+std::vector<SweepAndPrune::Size> SweepAndPrune::CreateLeafs(Span<const AABB> aabbs,
+                                                           Span<const LeafData> data)
+{
+    if (aabbs.size() != data.size())
+    {
+        throw InvalidArgument("SweepAndPrune::CreateLeafs: spans must be of same size");
+    }
+    const auto count = aabbs.size();
+    auto ids = std::vector<Size>(count);
+    m_entries.reserve(size(m_entries) + count);
+    m_slots.reserve(size(m_slots) + count);
+    m_leafs.reserve(size(m_leafs) + count);
+    for (auto i = decltype(count){0}; i < count; ++i)
+    {
+        ids[i] = Append(aabbs[i], data[i]);
+    }
+    Merge();
+    return ids;
+}
+
+SweepAndPrune::Size SweepAndPrune::Append(const AABB& aabb, const LeafData& data)
+{
+    auto index = GetInvalidSize();
+    if (!empty(m_free))
+    {
+        index = m_free.back();
+        m_free.pop_back();
+        m_leafs[index] = data;
+    }
+    else
+    {
+        index = static_cast<Size>(size(m_slots));
+        m_slots.push_back(Slot{});
+        m_leafs.push_back(data);
+    }
+    m_slots[index] = Slot{static_cast<Size>(size(m_entries)), false};
+    m_entries.push_back(Entry{aabb, index});
+    return index;
+}
+
+void SweepAndPrune::DestroyLeaf(Size index) noexcept
+{
+    const auto slot = m_slots[index];
+    if (slot.wide)
+    {
+        // Wide entries aren't in any order so just move the last one into this one's place.
+        const auto last = m_wideEntries.back();
+        m_slots[last.index].position = slot.position;
+        m_wideEntries[slot.position] = last;
+        m_wideEntries.pop_back();
+    }
+    else
+    {
+        // Leave the entry where it is, so the others don't all need to be moved, until the
+        // next merge compacts it out.
+        m_entries[slot.position].index = GetInvalidSize();
+        ++m_deadCount;
+    }
+    m_slots[index] = Slot{};
+    m_free.push_back(index);
+}
+
+void SweepAndPrune::UpdateLeaf(Size index, const AABB& aabb)
+{
+    const auto slot = m_slots[index].position;
+    if (m_slots[index].wide)
+    {
+        m_wideEntries[slot].aabb = aabb;
+        return;
+    }
+    const auto first = begin(m_entries);
+    const auto it = first + slot;
+    if (slot >= m_sortedCount)
+    {
+        it->aabb = aabb;
+        return;
+    }
+    const auto width = GetWidth(aabb);
+    if (width > m_wideWidth)
+    {
+        // Move the entry to the wide ones rather than widening the stretch every query
+        // needs to scan.
+        m_wideEntries.push_back(Entry{aabb, index});
+        m_slots[index] = Slot{static_cast<Size>(size(m_wideEntries) - 1u), true};
+        it->index = GetInvalidSize();
+        ++m_deadCount;
+        if (IsMergeDue())
+        {
+            Merge();
+        }
+        return;
+    }
+    it->aabb = aabb;
+    m_maxWidth = std::max(m_maxWidth, width);
+
+    // Restore the sort order by rotating the entry to where it now belongs.
+    const auto minX = GetMinX(*it);
+    if ((it != first) && (minX < GetMinX(*std::prev(it))))
+    {
+        const auto pos = std::upper_bound(first, it, minX, LessValue);
+        std::rotate(pos, it, std::next(it));
+        Renumber(static_cast<Size>(pos - first), slot + 1);
+    }
+    else
+    {
+        const auto last = first + m_sortedCount;
+        const auto next = std::next(it);
+        if ((next != last) && (GetMinX(*next) < minX))
+        {
+            const auto pos = std::lower_bound(next, last, minX, LessMinX);
+            std::rotate(it, next, pos);
+            Renumber(slot, static_cast<Size>(pos - first));
+        }
+    }
+}
+
+void SweepAndPrune::Clear() noexcept
+{
+    m_entries.clear();
+    m_wideEntries.clear();
+    m_slots.clear();
+    m_leafs.clear();
+    m_free.clear();
+    m_sortedCount = 0;
+    m_deadCount = 0;
+    m_maxWidth = 0_m;
+    m_wideWidth = 0_m;
+}
+
+DynamicTree::OptimizeStats SweepAndPrune::Optimize(Size, Size budget)
+{
+    auto stats = DynamicTree::OptimizeStats{};
+    const auto unmerged = GetUnmergedCount();
+    if ((unmerged > 0) && (unmerged <= budget))
+    {
+        Merge();
+        stats.visited = unmerged;
+    }
+    stats.sweepEnded = true;
+    return stats;
+}
+
+void SweepAndPrune::ShiftOrigin(Length2 newOrigin) noexcept
+{
+    // Shifting every entry by the same amount keeps them in sorted order.
+    for (auto& entry: m_entries)
+    {
+        entry.aabb = GetMovedAABB(entry.aabb, -newOrigin);
+    }
+    for (auto& entry: m_wideEntries)
+    {
+        entry.aabb = GetMovedAABB(entry.aabb, -newOrigin);
+    }
+}
+
+SweepAndPrune::Size SweepAndPrune::GetUnmergedCount() const noexcept
+{
+    return static_cast<Size>(size(m_entries)) - m_sortedCount + m_deadCount;
+}
+
+bool SweepAndPrune::IsMergeDue() const noexcept
+{
+    // Unsorted entries get scanned by every query so merge them in soon. Dead entries only
+    // get skipped so let them build up in proportion to the sorted ones before compacting.
+    const auto pending = static_cast<Size>(size(m_entries)) - m_sortedCount;
+    return (pending >= GetMaxPending())
+        || (m_deadCount >= std::max(GetMaxPending(), m_sortedCount / 4));
+}
+
+void SweepAndPrune::Merge()
+{
+    // Recalculate what's wide from the mean width of all the live entries.
+    auto totalWidth = 0_m;
+    for (const auto& entry: m_entries)
+    {
+        if (!IsDead(entry))
+        {
+            totalWidth += GetWidth(entry.aabb);
+        }
+    }
+    for (const auto& entry: m_wideEntries)
+    {
+        totalWidth += GetWidth(entry.aabb);
+    }
+    const auto count = size(m_entries) - m_deadCount + size(m_wideEntries);
+    m_wideWidth = (count > 0u)? totalWidth * GetWideFactor() / Real(count): 0_m;
+
+    // Move the wide entries that are no longer wide to the unsorted ones.
+    auto wideCount = std::size_t{0};
+    for (const auto& entry: m_wideEntries)
+    {
+        if (GetWidth(entry.aabb) > m_wideWidth)
+        {
+            m_wideEntries[wideCount++] = entry;
+        }
+        else
+        {
+            m_entries.push_back(entry);
+        }
+    }
+    m_wideEntries.resize(wideCount);
+
+    // Compact out the dead entries and move the newly wide ones to the wide ones. This
+    // keeps the sorted ones in order and ahead of the unsorted ones.
+    auto liveCount = std::size_t{0};
+    auto sortedCount = std::size_t{0};
+    for (auto i = std::size_t{0}; i < size(m_entries); ++i)
+    {
+        const auto entry = m_entries[i];
+        if (IsDead(entry))
+        {
+            continue;
+        }
+        if (GetWidth(entry.aabb) > m_wideWidth)
+        {
+            m_wideEntries.push_back(entry);
+            continue;
+        }
+        m_entries[liveCount++] = entry;
+        if (i < m_sortedCount)
+        {
+            sortedCount = liveCount;
+        }
+    }
+    m_entries.resize(liveCount);
+
+    const auto first = begin(m_entries);
+    const auto middle = first + static_cast<std::ptrdiff_t>(sortedCount);
+    const auto last = end(m_entries);
+    std::sort(middle, last, [](const Entry& lhs, const Entry& rhs) {
+        return GetMinX(lhs) < GetMinX(rhs);
+    });
+    std::inplace_merge(first, middle, last, [](const Entry& lhs, const Entry& rhs) {
+        return GetMinX(lhs) < GetMinX(rhs);
+    });
+    m_sortedCount = static_cast<Size>(size(m_entries));
+    m_deadCount = 0;
+    Renumber(0, m_sortedCount);
+    for (auto i = std::size_t{0}; i < size(m_wideEntries); ++i)
+    {
+        m_slots[m_wideEntries[i].index] = Slot{static_cast<Size>(i), true};
+    }
+
+    // Take this opportunity to tighten up the maximum width.
+    m_maxWidth = 0_m;
+    for (const auto& entry: m_entries)
+    {
+        m_maxWidth = std::max(m_maxWidth, GetWidth(entry.aabb));
+    }
+}
+
+void SweepAndPrune::Renumber(Size first, Size last) noexcept
+{
+    for (auto i = first; i < last; ++i)
+    {
+        const auto index = m_entries[i].index;
+        if (index != GetInvalidSize())
+        {
+            m_slots[index] = Slot{i, false};
+        }
+    }
+}
+
+void Query(const SweepAndPrune& sap, const AABB& aabb, const DynamicTreeSizeCB& callback)
+{
+    const auto visit = [&](const SweepAndPrune::Entry& entry) {
+        return !IsDead(entry) && TestOverlap(entry.aabb, aabb)
+            && (callback(entry.index) == DynamicTreeOpcode::End);
+    };
+    const auto& entries = sap.GetEntries();
+    const auto sortedEnd = cbegin(entries) + sap.GetSortedCount();
+    const auto maxX = aabb.ranges[0].GetMax();
+    auto it = std::lower_bound(cbegin(entries), sortedEnd,
+                               aabb.ranges[0].GetMin() - sap.GetMaxWidth(), LessMinX);
+    for (; (it != sortedEnd) && (GetMinX(*it) <= maxX); ++it)
+    {
+        if (visit(*it))
+        {
+            return;
+        }
+    }
+    for (it = sortedEnd; it != cend(entries); ++it)
+    {
+        if (visit(*it))
+        {
+            return;
+        }
+    }
+    for (const auto& entry: sap.GetWideEntries())
+    {
+        if (visit(entry))
+        {
+            return;
+        }
+    }
+}
+
+bool RayCast(const SweepAndPrune& sap, RayCastInput input, const DynamicTreeRayCastCB& callback)
+{
+    const auto v = GetRevPerpendicular(GetUnitVector(input.p2 - input.p1, UnitVec::GetZero()));
+    const auto abs_v = abs(v);
+    auto segmentAABB = d2::GetAABB(input);
+
+    // Returns true if the callback terminated the ray cast.
+    const auto visit = [&](const SweepAndPrune::Entry& entry) {
+        if (IsDead(entry) || !TestOverlap(entry.aabb, segmentAABB))
+        {
+            return false;
+        }
+
+        // Separating axis for segment (Gino, p80).
+        // |dot(v, p1 - ctr)| > dot(|v|, extents)
+        const auto center = GetCenter(entry.aabb);
+        const auto extents = GetExtents(entry.aabb);
+        const auto separation = abs(Dot(v, input.p1 - center)) - Dot(abs_v, extents);
+        if (separation > 0_m)
+        {
+            return false;
+        }
+
+        const auto leafData = sap.GetLeafData(entry.index);
+        const auto value = callback(leafData.body, leafData.fixture, leafData.childIndex,
+                                    input);
+        if (value == 0)
+        {
+            return true;
+        }
+        if (value > 0)
+        {
+            // Update segment bounding box.
+            input.maxFraction = value;
+            segmentAABB = d2::GetAABB(input);
+        }
+        return false;
+    };
+
+    const auto& entries = sap.GetEntries();
+    const auto sortedEnd = cbegin(entries) + sap.GetSortedCount();
+    auto it = std::lower_bound(cbegin(entries), sortedEnd,
+                               segmentAABB.ranges[0].GetMin() - sap.GetMaxWidth(), LessMinX);
+    for (; (it != sortedEnd) && (GetMinX(*it) <= segmentAABB.ranges[0].GetMax()); ++it)
+    {
+        if (visit(*it))
+        {
+            return true; // Callback has terminated the ray cast.
+        }
+    }
+    for (it = sortedEnd; it != cend(entries); ++it)
+    {
+        if (visit(*it))
+        {
+            return true; // Callback has terminated the ray cast.
+        }
+    }
+    for (const auto& entry: sap.GetWideEntries())
+    {
+        if (visit(entry))
+        {
+            return true; // Callback has terminated the ray cast.
+        }
+    }
+    return false;
+}
+
+} // namespace d2
+} // namespace playrho
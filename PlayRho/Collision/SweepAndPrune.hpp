@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PLAYRHO_COLLISION_SWEEPANDPRUNE_HPP
+#define PLAYRHO_COLLISION_SWEEPANDPRUNE_HPP
+
+/// @file
+/// Declaration of the SweepAndPrune class and related free functions.
+
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/RayCastOutput.hpp>
+
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+
+/// @brief Sort and sweep broad-phase.
+///
+/// @details Keeps leaf AABBs in an array sorted by their lower X coordinate so that
+///   overlaps can be found by scanning just the stretch of entries whose X range could
+///   intersect a given AABB. Leafs whose AABBs are much wider along the X axis than is
+///   typical, like those of the ground, are kept in a separate unsorted array instead so
+///   that they don't widen that stretch for every query.
+///
+/// @note Leaf identifiers are stable for the life of the leaf and are reused after
+///   leafs are destroyed - like the leaf indices of a <code>DynamicTree</code>.
+/// @note Updating a leaf moves its entry only by as many positions as it needs to
+///   restore the sort order. This makes updates cheap when things move little from
+///   step to step relative to each other; in particular for worlds that are mostly
+///   spread out along the X axis.
+/// @note Entries for newly created leafs are appended unsorted, and entries of destroyed
+///   leafs are only marked as dead. These get merged in, or compacted out, in batches.
+///
+/// @see https://en.wikipedia.org/wiki/Sweep_and_prune
+///
+class SweepAndPrune
+{
+public:
+    /// @brief Size type.
+    using Size = DynamicTree::Size;
+
+    /// @brief Leaf data type.
+    using LeafData = DynamicTree::LeafData;
+
+    /// @brief Sorted entry data.
+    struct Entry
+    {
+        AABB aabb; ///< AABB of the leaf.
+        Size index; ///< Identifier of the leaf or the invalid size if the entry is dead.
+    };
+
+    /// @brief Gets the invalid size value.
+    static constexpr Size GetInvalidSize() noexcept
+    {
+        return DynamicTree::GetInvalidSize();
+    }
+
+    /// @brief Gets the maximum number of unsorted entries kept before they're merged.
+    static constexpr Size GetMaxPending() noexcept
+    {
+        return Size{64};
+    }
+
+    /// @brief Gets how many times wider than the mean width an AABB must be for its leaf
+    ///   to be kept out of the sorted entries.
+    static constexpr Real GetWideFactor() noexcept
+    {
+        return Real(4);
+    }
+
+    /// @brief Creates a leaf for the given AABB with the given data.
+    /// @return Identifier of the created leaf.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    Size CreateLeaf(const AABB& aabb, const LeafData& data);
+
+    /// @brief Creates leafs for all of the given AABBs with the given data.
+    /// @note The new entries are merged in all at once.
+    /// @return Identifiers of the created leafs, in the order of the given AABBs.
+    /// @throws InvalidArgument If the given spans are of different sizes.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    std::vector<Size> CreateLeafs(Span<const AABB> aabbs, Span<const LeafData> data);
+
+    /// @brief Destroys the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    void DestroyLeaf(Size index) noexcept;
+
+    /// @brief Updates the identified leaf with the given AABB.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    /// @throws std::bad_alloc If unable to allocate needed storage.
+    void UpdateLeaf(Size index, const AABB& aabb);
+
+    /// @brief Gets the leaf data for the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    LeafData GetLeafData(Size index) const noexcept
+    {
+        return m_leafs[index];
+    }
+
+    /// @brief Sets the leaf data for the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    void SetLeafData(Size index, LeafData value) noexcept
+    {
+        m_leafs[index] = value;
+    }
+
+    /// @brief Gets the AABB of the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    AABB GetAABB(Size index) const noexcept
+    {
+        const auto& slot = m_slots[index];
+        return (slot.wide? m_wideEntries[slot.position]: m_entries[slot.position]).aabb;
+    }
+
+    /// @brief Gets the number of leafs.
+    Size GetLeafCount() const noexcept
+    {
+        return static_cast<Size>(size(m_slots) - size(m_free));
+    }
+
+    /// @brief Gets the entries.
+    /// @note The first <code>GetSortedCount()</code> entries are in non-decreasing order
+    ///   of their AABB's lower X coordinate. The rest are in no particular order.
+    /// @note This includes dead entries. Their index is the invalid size.
+    /// @see GetWideEntries.
+    const std::vector<Entry>& GetEntries() const noexcept
+    {
+        return m_entries;
+    }
+
+    /// @brief Gets the entries of the leafs whose AABBs are too wide to be sorted.
+    /// @note These are in no particular order.
+    const std::vector<Entry>& GetWideEntries() const noexcept
+    {
+        return m_wideEntries;
+    }
+
+    /// @brief Gets the number of sorted entries.
+    Size GetSortedCount() const noexcept
+    {
+        return m_sortedCount;
+    }
+
+    /// @brief Gets a value no less than the width along the X axis of any sorted entry's
+    ///   AABB.
+    Length GetMaxWidth() const noexcept
+    {
+        return m_maxWidth;
+    }
+
+    /// @brief Gets the width along the X axis beyond which the AABB of a sorted entry
+    ///   gets moved to the wide entries.
+    /// @note This gets recalculated whenever the entries get merged.
+    /// @see GetWideFactor.
+    Length GetWideWidth() const noexcept
+    {
+        return m_wideWidth;
+    }
+
+    /// @brief Clears all the leafs.
+    void Clear() noexcept;
+
+    /// @brief Incrementally optimizes this instance.
+    /// @details Merges the unsorted entries, if there are any, into the sorted ones and
+    ///   compacts out the dead ones. The sort order itself never degrades so there's
+    ///   nothing else to do.
+    /// @note This is the equivalent of the <code>DynamicTree</code> member function.
+    /// @return Statistics with the count of entries merged or compacted out as the count
+    ///   visited and with the sweep always having ended.
+    DynamicTree::OptimizeStats Optimize(Size start, Size budget);
+
+    /// @brief Incrementally optimizes this instance.
+    /// @note This doesn't need any scratch space so this ignores the given buffer.
+    DynamicTree::OptimizeStats Optimize(Size start, Size budget, std::vector<Size>&)
+    {
+        return Optimize(start, budget);
+    }
+
+    /// @brief Shifts the world origin.
+    void ShiftOrigin(Length2 newOrigin) noexcept;
+
+private:
+    /// @brief Where a leaf's entry is.
+    struct Slot
+    {
+        Size position = GetInvalidSize(); ///< Position of the entry.
+        bool wide = false; ///< Whether the entry is a wide one.
+    };
+
+    /// @brief Appends an unsorted entry for a new leaf.
+    /// @return Identifier of the new leaf.
+    Size Append(const AABB& aabb, const LeafData& data);
+
+    /// @brief Gets the count of the unsorted and dead entries.
+    Size GetUnmergedCount() const noexcept;
+
+    /// @brief Whether enough entries are unmerged for them to be merged.
+    bool IsMergeDue() const noexcept;
+
+    /// @brief Reclassifies the wide entries, compacts out the dead entries, and merges the
+    ///   unsorted entries into the sorted ones.
+    void Merge();
+
+    /// @brief Updates the slots of the leafs of the given range of entries.
+    void Renumber(Size first, Size last) noexcept;
+
+    std::vector<Entry> m_entries; ///< Entries.
+    std::vector<Entry> m_wideEntries; ///< Wide entries.
+    std::vector<Slot> m_slots; ///< Entry slots of leafs indexed by leaf identifier.
+    std::vector<LeafData> m_leafs; ///< Leaf data indexed by leaf identifier.
+    std::vector<Size> m_free; ///< Free leaf identifiers.
+    Size m_sortedCount = 0; ///< Count of sorted entries.
+    Size m_deadCount = 0; ///< Count of dead entries.
+    Length m_maxWidth = 0_m; ///< Maximum width. @see GetMaxWidth.
+    Length m_wideWidth = 0_m; ///< Wide width. @see GetWideWidth.
+};
+
+/// @brief Tests for overlap of the elements identified in the given sweep and prune.
+/// @relatedalso SweepAndPrune
+inline bool TestOverlap(const SweepAndPrune& sap,
+                        SweepAndPrune::Size leafIdA, SweepAndPrune::Size leafIdB) noexcept
+{
+    return TestOverlap(sap.GetAABB(leafIdA), sap.GetAABB(leafIdB));
+}
+
+/// @brief Queries the given sweep and prune for leafs overlapping the given AABB.
+/// @note The callback instance is called for each leaf that overlaps the supplied AABB.
+/// @relatedalso SweepAndPrune
+void Query(const SweepAndPrune& sap, const AABB& aabb, const DynamicTreeSizeCB& callback);
+
+/// @brief Cast rays against the leafs in the given sweep and prune.
+/// @note This is the equivalent of the <code>DynamicTree</code> based function.
+/// @return <code>true</code> if terminated at the callback's request,
+///   <code>false</code> otherwise.
+/// @relatedalso SweepAndPrune
+bool RayCast(const SweepAndPrune& sap, RayCastInput input,
+             const DynamicTreeRayCastCB& callback);
+
+/// @brief Gets the "size" of the given sweep and prune.
+/// @note Size in this context is defined as the leaf count.
+/// @relatedalso SweepAndPrune
+inline std::size_t size(const SweepAndPrune& sap) noexcept
+{
+    return sap.GetLeafCount();
+}
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_COLLISION_SWEEPANDPRUNE_HPP
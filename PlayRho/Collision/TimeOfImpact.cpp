@@ -66,6 +66,14 @@ namespace d2 {
 TOIOutput GetToiViaSat(const DistanceProxy& proxyA, const Sweep& sweepA,
                        const DistanceProxy& proxyB, const Sweep& sweepB,
                        ToiConf conf)
+{
+    auto indices = InvalidIndexPair3;
+    return GetToiViaSat(proxyA, sweepA, proxyB, sweepB, conf, indices);
+}
+
+TOIOutput GetToiViaSat(const DistanceProxy& proxyA, const Sweep& sweepA,
+                       const DistanceProxy& proxyB, const Sweep& sweepB,
+                       ToiConf conf, IndexPair3& indices)
 {
     assert(IsValid(sweepA));
     assert(IsValid(sweepB));
@@ -105,6 +113,7 @@ TOIOutput GetToiViaSat(const DistanceProxy& proxyA, const Sweep& sweepA,
 
     // Prepare input for distance query.
     auto distanceConf = GetDistanceConf(conf);
+    distanceConf.cache.indices = indices;
 
     // The outer loop progressively attempts to compute new separating axes.
     // This loop terminates when an axis is repeated (no progress is made).
@@ -123,6 +132,7 @@ TOIOutput GetToiViaSat(const DistanceProxy& proxyA, const Sweep& sweepA,
         }
         assert(dinfo.state != DistanceOutput::Unknown);
         distanceConf.cache = Simplex::GetCache(dinfo.simplex.GetEdges());
+        indices = distanceConf.cache.indices;
         
         // Get the real distance squared between shapes at the time of timeLo.
         const auto distSquared = GetMagnitudeSquared(GetDelta(GetWitnessPoints(dinfo.simplex)));
@@ -25,6 +25,7 @@
 #include <PlayRho/Common/Math.hpp>
 #include <PlayRho/Common/Wider.hpp>
 #include <PlayRho/Common/NonNegative.hpp>
+#include <PlayRho/Collision/IndexPair.hpp>
 
 namespace playrho {
 
@@ -297,6 +298,31 @@ TOIOutput GetToiViaSat(const DistanceProxy& proxyA, const Sweep& sweepA,
                        const DistanceProxy& proxyB, const Sweep& sweepB,
                        ToiConf conf = GetDefaultToiConf());
 
+/// @brief Gets the time of impact for two disjoint convex sets using the
+///    Separating Axis Theorem and the given simplex indices.
+///
+/// @details This is the same as the other <code>GetToiViaSat</code> function except that
+///   the distance calculations are warm started from the given simplex indices and the
+///   given indices are updated to those of the last distance calculation. Keeping the
+///   indices between calls for the same pair of proxies typically reduces the number of
+///   distance iterations needed.
+///
+/// @param proxyA Proxy A. The proxy's vertex count must be 1 or more.
+/// @param sweepA Sweep A. Sweep of motion for shape represented by proxy A.
+/// @param proxyB Proxy B. The proxy's vertex count must be 1 or more.
+/// @param sweepB Sweep B. Sweep of motion for shape represented by proxy B.
+/// @param conf Configuration details for on calculation. Like the targeted depth of penetration.
+/// @param indices Simplex indices to warm start from. These must be invalid or
+///   within the vertex counts of the given proxies.
+///
+/// @return Time of impact output data.
+///
+/// @relatedalso ::playrho::TOIOutput
+///
+TOIOutput GetToiViaSat(const DistanceProxy& proxyA, const Sweep& sweepA,
+                       const DistanceProxy& proxyB, const Sweep& sweepB,
+                       ToiConf conf, IndexPair3& indices);
+
 } // namespace d2
 } // namespace playrho
 
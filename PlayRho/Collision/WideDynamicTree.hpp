@@ -0,0 +1,1022 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PLAYRHO_COLLISION_WIDEDYNAMICTREE_HPP
+#define PLAYRHO_COLLISION_WIDEDYNAMICTREE_HPP
+
+/// @file
+/// Declaration of the <code>WideDynamicTree</code> class template and related free functions.
+
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/RayCastInput.hpp>
+#include <PlayRho/Collision/RayCastOutput.hpp>
+#include <PlayRho/Common/GrowableStack.hpp>
+#include <PlayRho/Common/InvalidArgument.hpp>
+#include <PlayRho/Common/Math.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+
+/// @brief A wide bounding volume hierarchy.
+///
+/// @details This arranges leafs into a tree whose nodes each have up to <code>N</code>
+///   children. Nodes store their children's bounds in structure-of-arrays form so that a
+///   single node visit tests all of its children in one tight, branch free, loop that
+///   compilers can vectorize when lengths are of a built-in floating point type.
+///   Compared to visiting a binary tree, this takes fewer and more cache friendly node
+///   visits.
+///
+/// @note This can be used as a broad-phase. Leafs can be created, updated, and destroyed
+///   incrementally. Updates that keep a leaf within its node's bounds just refit the
+///   bounds of the node and its ancestors. Other updates and creations insert the leaf
+///   where it enlarges the bounds the least, splitting full nodes in two like a B-tree
+///   does. That makes for a lower quality tree than building it from all its leafs at
+///   once does. So <code>Optimize</code> rebuilds the tree from scratch once enough leafs
+///   have been inserted since the last time it was built.
+/// @note Leafs constructed or assigned from a <code>DynamicTree</code> are identified by
+///   the same indices that identify them in that tree. So callbacks work unchanged
+///   between the two tree types.
+///
+/// @see DynamicTree.
+///
+template <std::size_t N>
+class WideDynamicTree
+{
+    static_assert(N >= 2 && N <= 32, "N must be between 2 and 32 inclusive");
+
+public:
+    /// @brief Size type.
+    using Size = DynamicTree::Size;
+
+    /// @brief Leaf data type.
+    using LeafData = DynamicTree::LeafData;
+
+    /// @brief Gets the invalid size value.
+    static constexpr Size GetInvalidSize() noexcept
+    {
+        return DynamicTree::GetInvalidSize();
+    }
+
+    /// @brief Gets the maximum number of children per node.
+    static constexpr std::size_t GetWidth() noexcept
+    {
+        return N;
+    }
+
+    /// @brief Node of the wide tree.
+    /// @note Used child slots come before the unused ones. Unused child slots have
+    ///   "unset" bounds (lower bound above the upper bound) so they never overlap anything.
+    struct Node
+    {
+        Length lowerX[N]; ///< Lower X bounds of the children.
+        Length lowerY[N]; ///< Lower Y bounds of the children.
+        Length upperX[N]; ///< Upper X bounds of the children.
+        Length upperY[N]; ///< Upper Y bounds of the children.
+
+        /// @brief Index of the child node or of the leaf for the slot.
+        Size children[N];
+
+        /// @brief Bit mask of which slots hold leafs (rather than nodes).
+        std::uint32_t leafs = 0;
+
+        /// @brief Count of used child slots.
+        Size count = 0;
+
+        /// @brief Index of the parent node or <code>GetInvalidSize()</code> for the root.
+        Size parent = GetInvalidSize();
+
+        /// @brief Slot of this node in its parent.
+        Size parentSlot = GetInvalidSize();
+    };
+
+    /// @brief Default constructor.
+    WideDynamicTree() = default;
+
+    /// @brief Initializing constructor.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    explicit WideDynamicTree(const DynamicTree& tree)
+    {
+        Assign(tree);
+    }
+
+    /// @brief Assigns this tree the leafs of the given dynamic tree.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    void Assign(const DynamicTree& tree);
+
+    /// @brief Creates a leaf for the given AABB with the given data.
+    /// @return Identifier of the created leaf.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    Size CreateLeaf(const AABB& aabb, const LeafData& data);
+
+    /// @brief Creates leafs for all of the given AABBs with the given data.
+    /// @note This rebuilds the whole tree when adding at least as many leafs as it
+    ///   already has.
+    /// @return Identifiers of the created leafs, in the order of the given AABBs.
+    /// @throws InvalidArgument If the given spans are of different sizes.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    std::vector<Size> CreateLeafs(Span<const AABB> aabbs, Span<const LeafData> data);
+
+    /// @brief Destroys the identified leaf.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    void DestroyLeaf(Size index) noexcept;
+
+    /// @brief Updates the identified leaf with the given AABB.
+    /// @warning Behavior is undefined if the given index is not for a valid leaf.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    void UpdateLeaf(Size index, const AABB& aabb);
+
+    /// @brief Rebuilds this tree from its leafs.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    void Rebuild();
+
+    /// @brief Rebuilds this tree once enough leafs have been inserted since it was last
+    ///   built.
+    /// @details Enough is a quarter of the leafs. This is the equivalent of the
+    ///   <code>DynamicTree</code> member function in name only since this doesn't work
+    ///   incrementally nor heed the budget.
+    /// @return Statistics with the count of leafs rebuilt as the count visited and with
+    ///   the sweep always having ended.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    DynamicTree::OptimizeStats Optimize(Size start, Size budget);
+
+    /// @brief Rebuilds this tree once enough leafs have been inserted since it was last
+    ///   built.
+    /// @note This doesn't need any scratch space so this ignores the given buffer.
+    DynamicTree::OptimizeStats Optimize(Size start, Size budget, std::vector<Size>&)
+    {
+        return Optimize(start, budget);
+    }
+
+    /// @brief Clears all the leafs.
+    void Clear() noexcept;
+
+    /// @brief Shifts the world origin.
+    void ShiftOrigin(Length2 newOrigin) noexcept;
+
+    /// @brief Gets the index of the root node or <code>GetInvalidSize()</code> if empty.
+    Size GetRootIndex() const noexcept
+    {
+        return m_root;
+    }
+
+    /// @brief Gets the node at the given index.
+    /// @warning Behavior is undefined if the given index is not less than the node count.
+    const Node& GetNode(Size index) const noexcept
+    {
+        assert(index < size(m_nodes));
+        return m_nodes[index];
+    }
+
+    /// @brief Gets the count of nodes.
+    Size GetNodeCount() const noexcept
+    {
+        return static_cast<Size>(size(m_nodes) - size(m_freeNodes));
+    }
+
+    /// @brief Gets the count of leafs.
+    Size GetLeafCount() const noexcept
+    {
+        return m_leafCount;
+    }
+
+    /// @brief Gets the AABB enclosing all of the leafs in this tree.
+    /// @return Enclosing AABB or the "unset" AABB.
+    AABB GetAABB() const noexcept
+    {
+        return (m_root != GetInvalidSize())? GetNodeAABB(m_root): AABB{};
+    }
+
+    /// @brief Gets the AABB of the identified leaf.
+    /// @warning Behavior is undefined if the given index is not a leaf of this tree.
+    AABB GetAABB(Size leaf) const noexcept
+    {
+        assert(leaf < size(m_leafAABBs));
+        return m_leafAABBs[leaf];
+    }
+
+    /// @brief Gets the leaf data of the identified leaf.
+    /// @warning Behavior is undefined if the given index is not a leaf of this tree.
+    LeafData GetLeafData(Size leaf) const noexcept
+    {
+        assert(leaf < size(m_leafData));
+        return m_leafData[leaf];
+    }
+
+private:
+    /// @brief Location of a leaf.
+    struct LeafSlot
+    {
+        Size node = GetInvalidSize(); ///< Index of the node holding the leaf.
+        Size slot = GetInvalidSize(); ///< Slot of the leaf in that node.
+    };
+
+    /// @brief Gets the bounds of the given slot of the given node.
+    static AABB GetSlotAABB(const Node& node, std::size_t slot) noexcept
+    {
+        return AABB{LengthInterval{node.lowerX[slot], node.upperX[slot]},
+                    LengthInterval{node.lowerY[slot], node.upperY[slot]}};
+    }
+
+    /// @brief Sets the bounds of the given slot of the given node.
+    static void SetSlotAABB(Node& node, std::size_t slot, const AABB& aabb) noexcept
+    {
+        node.lowerX[slot] = aabb.ranges[0].GetMin();
+        node.lowerY[slot] = aabb.ranges[1].GetMin();
+        node.upperX[slot] = aabb.ranges[0].GetMax();
+        node.upperY[slot] = aabb.ranges[1].GetMax();
+    }
+
+    /// @brief Gets whether the given slot of the given node holds a leaf.
+    static bool IsLeafSlot(const Node& node, std::size_t slot) noexcept
+    {
+        return (node.leafs & (std::uint32_t{1} << slot)) != 0u;
+    }
+
+    /// @brief Gets the AABB enclosing the used slots of the identified node.
+    AABB GetNodeAABB(Size index) const noexcept;
+
+    /// @brief Sets the given slot of the identified node to the given child.
+    /// @details Also points the child back at the slot.
+    void SetSlot(Size index, std::size_t slot, const AABB& aabb, Size child, bool leaf) noexcept;
+
+    /// @brief Makes sure that inserting a leaf won't need to allocate memory for nodes.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    void ReserveNodes();
+
+    /// @brief Allocates a node with all of its slots unused.
+    /// @return Index of the allocated node.
+    Size AllocateNode();
+
+    /// @brief Frees the identified node.
+    void FreeNode(Size index) noexcept;
+
+    /// @brief Refits the bounds of the ancestors of the identified node.
+    void Refit(Size index) noexcept;
+
+    /// @brief Inserts the identified leaf where its AABB enlarges the bounds the least.
+    void InsertLeaf(Size leaf);
+
+    /// @brief Adds a slot for the given child to the identified node.
+    /// @details Splits the node if it's full, adding the new node to its parent likewise.
+    void AddSlot(Size index, const AABB& aabb, Size child, bool leaf);
+
+    /// @brief Removes the given slot from the identified node.
+    /// @details Nodes left empty get removed too and nodes left with one child get
+    ///   replaced by that child.
+    void RemoveSlot(Size index, std::size_t slot) noexcept;
+
+    /// @brief Allocates an identifier for a new leaf.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    Size AllocateLeaf(const AABB& aabb, const LeafData& data);
+
+    /// @brief Builds this tree from scratch for the identified leafs.
+    /// @throws std::bad_alloc If unable to allocate necessary memory.
+    void Build(const std::vector<Size>& leafs);
+
+    /// @brief Gets the identifiers of all the leafs in this tree.
+    std::vector<Size> GetLeafs() const;
+
+    /// @brief Appends a node for the subtree of the given tree at the given index.
+    /// @param tree Tree to collapse.
+    /// @param index Index of the subtree in the tree.
+    /// @param leafIds Identifiers to use for the tree's leafs indexed by their index in
+    ///   the tree or an empty span to use the tree's leaf indices themselves.
+    /// @return Index of the appended node.
+    Size Append(const DynamicTree& tree, Size index, Span<const Size> leafIds);
+
+    std::vector<Node> m_nodes; ///< Nodes.
+    std::vector<Size> m_freeNodes; ///< Free node indices.
+    std::vector<AABB> m_leafAABBs; ///< Leaf AABBs indexed by leaf index.
+    std::vector<LeafData> m_leafData; ///< Leaf data indexed by leaf index.
+    std::vector<LeafSlot> m_leafSlots; ///< Leaf locations indexed by leaf index.
+    std::vector<Size> m_freeLeafs; ///< Free leaf indices.
+    Size m_root = GetInvalidSize(); ///< Index of the root node.
+    Size m_leafCount{0u}; ///< Leaf count.
+    Size m_insertCount{0u}; ///< Count of leafs inserted since the tree was last built.
+};
+
+/// @brief Four wide bounding volume hierarchy.
+using WideDynamicTree4 = WideDynamicTree<4>;
+
+/// @brief Eight wide bounding volume hierarchy.
+using WideDynamicTree8 = WideDynamicTree<8>;
+
+template <std::size_t N>
+void WideDynamicTree<N>::Assign(const DynamicTree& tree)
+{
+    Clear();
+    const auto capacity = tree.GetNodeCapacity();
+    m_leafAABBs.resize(capacity);
+    m_leafData.resize(capacity);
+    m_leafSlots.resize(capacity);
+    const auto root = tree.GetRootIndex();
+    if (root != DynamicTree::GetInvalidSize())
+    {
+        m_nodes.reserve((tree.GetLeafCount() + N - 2) / (N - 1) + 1);
+        m_root = Append(tree, root, Span<const Size>{});
+        m_leafCount = tree.GetLeafCount();
+    }
+
+    // Indices that aren't of leafs in the given tree are free for new leafs.
+    for (auto i = capacity; i > 0u; --i)
+    {
+        if (m_leafSlots[i - 1u].node == GetInvalidSize())
+        {
+            m_freeLeafs.push_back(i - 1u);
+        }
+    }
+}
+
+template <std::size_t N>
+typename WideDynamicTree<N>::Size
+WideDynamicTree<N>::CreateLeaf(const AABB& aabb, const LeafData& data)
+{
+    ReserveNodes();
+    const auto leaf = AllocateLeaf(aabb, data);
+    InsertLeaf(leaf);
+    ++m_leafCount;
+    return leaf;
+}
+
+template <std::size_t N>
+std::vector<typename WideDynamicTree<N>::Size>
+WideDynamicTree<N>::CreateLeafs(Span<const AABB> aabbs, Span<const LeafData> data)
+{
+    if (aabbs.size() != data.size())
+    {
+        throw InvalidArgument("WideDynamicTree::CreateLeafs: spans must be of same size");
+    }
+    const auto count = aabbs.size();
+    if (count < m_leafCount)
+    {
+        auto ids = std::vector<Size>(count);
+        for (auto i = decltype(count){0}; i < count; ++i)
+        {
+            ids[i] = CreateLeaf(aabbs[i], data[i]);
+        }
+        return ids;
+    }
+    auto leafs = GetLeafs();
+    leafs.reserve(size(leafs) + count);
+    const auto first = size(leafs);
+    for (auto i = decltype(count){0}; i < count; ++i)
+    {
+        leafs.push_back(AllocateLeaf(aabbs[i], data[i]));
+    }
+    Build(leafs);
+    return std::vector<Size>(cbegin(leafs) + static_cast<std::ptrdiff_t>(first), cend(leafs));
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::DestroyLeaf(Size index) noexcept
+{
+    const auto location = m_leafSlots[index];
+    RemoveSlot(location.node, location.slot);
+    m_leafSlots[index] = LeafSlot{};
+    m_freeLeafs.push_back(index);
+    --m_leafCount;
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::UpdateLeaf(Size index, const AABB& aabb)
+{
+    const auto location = m_leafSlots[index];
+    const auto& node = m_nodes[location.node];
+    if ((node.parent == GetInvalidSize()) ||
+        Contains(GetSlotAABB(m_nodes[node.parent], node.parentSlot), aabb))
+    {
+        // Still within the node's bounds so those of its ancestors can only shrink.
+        m_leafAABBs[index] = aabb;
+        SetSlotAABB(m_nodes[location.node], location.slot, aabb);
+        Refit(location.node);
+        return;
+    }
+    ReserveNodes();
+    RemoveSlot(location.node, location.slot);
+    m_leafAABBs[index] = aabb;
+    InsertLeaf(index);
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::Rebuild()
+{
+    Build(GetLeafs());
+}
+
+template <std::size_t N>
+DynamicTree::OptimizeStats WideDynamicTree<N>::Optimize(Size, Size)
+{
+    auto stats = DynamicTree::OptimizeStats{};
+    if ((m_insertCount > 0u) && (m_insertCount >= m_leafCount / 4u))
+    {
+        Rebuild();
+        stats.visited = m_leafCount;
+    }
+    stats.sweepEnded = true;
+    return stats;
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::Clear() noexcept
+{
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_leafAABBs.clear();
+    m_leafData.clear();
+    m_leafSlots.clear();
+    m_freeLeafs.clear();
+    m_root = GetInvalidSize();
+    m_leafCount = 0u;
+    m_insertCount = 0u;
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::ShiftOrigin(Length2 newOrigin) noexcept
+{
+    for (auto& node: m_nodes)
+    {
+        for (auto i = std::size_t{0}; i < node.count; ++i)
+        {
+            SetSlotAABB(node, i, GetMovedAABB(GetSlotAABB(node, i), -newOrigin));
+        }
+    }
+    for (auto& aabb: m_leafAABBs)
+    {
+        aabb = GetMovedAABB(aabb, -newOrigin);
+    }
+}
+
+template <std::size_t N>
+AABB WideDynamicTree<N>::GetNodeAABB(Size index) const noexcept
+{
+    const auto& node = m_nodes[index];
+    auto aabb = AABB{};
+    for (auto i = std::size_t{0}; i < node.count; ++i)
+    {
+        Include(aabb, GetSlotAABB(node, i));
+    }
+    return aabb;
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::SetSlot(Size index, std::size_t slot, const AABB& aabb, Size child,
+                                 bool leaf) noexcept
+{
+    auto& node = m_nodes[index];
+    SetSlotAABB(node, slot, aabb);
+    node.children[slot] = child;
+    if (leaf)
+    {
+        node.leafs |= (std::uint32_t{1} << slot);
+        m_leafSlots[child] = LeafSlot{index, static_cast<Size>(slot)};
+    }
+    else
+    {
+        node.leafs &= ~(std::uint32_t{1} << slot);
+        m_nodes[child].parent = index;
+        m_nodes[child].parentSlot = static_cast<Size>(slot);
+    }
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::ReserveNodes()
+{
+    // Inserting splits at most one node per level and may add a new root. Since nodes
+    // other than the root have at least two children, there's at most about log2 levels.
+    auto needed = std::size_t{3};
+    for (auto count = m_leafCount; count > 0u; count /= 2u)
+    {
+        ++needed;
+    }
+    if ((size(m_nodes) + needed) > m_nodes.capacity())
+    {
+        m_nodes.reserve(std::max(size(m_nodes) * 2u, size(m_nodes) + needed));
+    }
+}
+
+template <std::size_t N>
+typename WideDynamicTree<N>::Size WideDynamicTree<N>::AllocateNode()
+{
+    auto index = GetInvalidSize();
+    if (!empty(m_freeNodes))
+    {
+        index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        index = static_cast<Size>(size(m_nodes));
+        m_nodes.emplace_back();
+    }
+    auto& node = m_nodes[index];
+    for (auto i = std::size_t{0}; i < N; ++i)
+    {
+        SetSlotAABB(node, i, AABB{});
+        node.children[i] = GetInvalidSize();
+    }
+    node.leafs = 0;
+    node.count = 0;
+    node.parent = GetInvalidSize();
+    node.parentSlot = GetInvalidSize();
+    return index;
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::FreeNode(Size index) noexcept
+{
+    m_nodes[index].count = 0;
+    m_freeNodes.push_back(index);
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::Refit(Size index) noexcept
+{
+    for (auto parent = m_nodes[index].parent; parent != GetInvalidSize();
+         parent = m_nodes[index].parent)
+    {
+        const auto slot = m_nodes[index].parentSlot;
+        const auto aabb = GetNodeAABB(index);
+        if (GetSlotAABB(m_nodes[parent], slot) == aabb)
+        {
+            break;
+        }
+        SetSlotAABB(m_nodes[parent], slot, aabb);
+        index = parent;
+    }
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::InsertLeaf(Size leaf)
+{
+    ++m_insertCount;
+    const auto aabb = m_leafAABBs[leaf];
+    if (m_root == GetInvalidSize())
+    {
+        m_root = AllocateNode();
+        SetSlot(m_root, 0u, aabb, leaf, true);
+        m_nodes[m_root].count = 1;
+        return;
+    }
+    auto index = m_root;
+    for (;;)
+    {
+        // Descends through the slot whose bounds the new AABB enlarges the least.
+        auto& node = m_nodes[index];
+        auto best = std::size_t{0};
+        auto bestCost = 0_m;
+        for (auto i = std::size_t{0}; i < node.count; ++i)
+        {
+            const auto slotAABB = GetSlotAABB(node, i);
+            const auto cost = GetPerimeter(GetEnclosingAABB(slotAABB, aabb)) -
+                              GetPerimeter(slotAABB);
+            if ((i == 0u) || (cost < bestCost))
+            {
+                best = i;
+                bestCost = cost;
+            }
+        }
+        if (IsLeafSlot(node, best))
+        {
+            break;
+        }
+        SetSlotAABB(node, best, GetEnclosingAABB(GetSlotAABB(node, best), aabb));
+        index = node.children[best];
+    }
+    AddSlot(index, aabb, leaf, true);
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::AddSlot(Size index, const AABB& aabb, Size child, bool leaf)
+{
+    {
+        auto& node = m_nodes[index];
+        if (node.count < N)
+        {
+            SetSlot(index, node.count, aabb, child, leaf);
+            ++node.count;
+            return;
+        }
+    }
+
+    // Splits the full node in two along the axis its children's centers are most spread
+    // out over. This keeps the tree balanced like a B-tree.
+    struct Entry
+    {
+        AABB aabb;
+        Size child;
+        bool leaf;
+    };
+    Entry entries[N + 1];
+    auto centers = AABB{};
+    {
+        const auto& node = m_nodes[index];
+        for (auto i = std::size_t{0}; i < N; ++i)
+        {
+            entries[i] = Entry{GetSlotAABB(node, i), node.children[i], IsLeafSlot(node, i)};
+        }
+    }
+    entries[N] = Entry{aabb, child, leaf};
+    for (const auto& entry: entries)
+    {
+        Include(centers, GetCenter(entry.aabb));
+    }
+    const auto axis = (GetSize(centers.ranges[0]) < GetSize(centers.ranges[1]))? 1u: 0u;
+    std::sort(entries, entries + N + 1, [axis](const Entry& lhs, const Entry& rhs) {
+        return GetCenter(lhs.aabb.ranges[axis]) < GetCenter(rhs.aabb.ranges[axis]);
+    });
+    const auto half = (N + 1) / 2;
+    const auto sibling = AllocateNode(); // May reallocate m_nodes!
+    {
+        auto& node = m_nodes[index];
+        for (auto i = std::size_t{0}; i < N; ++i)
+        {
+            SetSlotAABB(node, i, AABB{});
+            node.children[i] = GetInvalidSize();
+        }
+        node.leafs = 0;
+    }
+    for (auto i = std::size_t{0}; i < half; ++i)
+    {
+        SetSlot(index, i, entries[i].aabb, entries[i].child, entries[i].leaf);
+    }
+    for (auto i = half; i < N + 1; ++i)
+    {
+        SetSlot(sibling, i - half, entries[i].aabb, entries[i].child, entries[i].leaf);
+    }
+    m_nodes[index].count = static_cast<Size>(half);
+    m_nodes[sibling].count = static_cast<Size>(N + 1 - half);
+
+    const auto parent = m_nodes[index].parent;
+    if (parent == GetInvalidSize())
+    {
+        m_root = AllocateNode();
+        SetSlot(m_root, 0u, GetNodeAABB(index), index, false);
+        SetSlot(m_root, 1u, GetNodeAABB(sibling), sibling, false);
+        m_nodes[m_root].count = 2;
+        return;
+    }
+    SetSlotAABB(m_nodes[parent], m_nodes[index].parentSlot, GetNodeAABB(index));
+    AddSlot(parent, GetNodeAABB(sibling), sibling, false);
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::RemoveSlot(Size index, std::size_t slot) noexcept
+{
+    {
+        // Keeps the used slots before the unused ones by moving the last into the gap.
+        auto& node = m_nodes[index];
+        const auto last = node.count - 1u;
+        if (slot != last)
+        {
+            SetSlot(index, slot, GetSlotAABB(node, last), node.children[last],
+                    IsLeafSlot(node, last));
+        }
+        SetSlotAABB(node, last, AABB{});
+        node.children[last] = GetInvalidSize();
+        node.leafs &= ~(std::uint32_t{1} << last);
+        --node.count;
+    }
+    const auto node = m_nodes[index];
+    if (node.count == 0u)
+    {
+        FreeNode(index);
+        if (node.parent == GetInvalidSize())
+        {
+            m_root = GetInvalidSize();
+            return;
+        }
+        RemoveSlot(node.parent, node.parentSlot);
+        return;
+    }
+    if ((node.count == 1u) && !IsLeafSlot(node, 0u) && (node.parent == GetInvalidSize()))
+    {
+        // Promotes the root's only child node to being the root.
+        FreeNode(index);
+        m_root = node.children[0];
+        m_nodes[m_root].parent = GetInvalidSize();
+        m_nodes[m_root].parentSlot = GetInvalidSize();
+        return;
+    }
+    if ((node.count == 1u) && (node.parent != GetInvalidSize()))
+    {
+        // Replaces the node with its only child.
+        FreeNode(index);
+        SetSlot(node.parent, node.parentSlot, GetSlotAABB(node, 0u), node.children[0],
+                IsLeafSlot(node, 0u));
+        Refit(node.parent);
+        return;
+    }
+    Refit(index);
+}
+
+template <std::size_t N>
+typename WideDynamicTree<N>::Size
+WideDynamicTree<N>::AllocateLeaf(const AABB& aabb, const LeafData& data)
+{
+    auto index = GetInvalidSize();
+    if (!empty(m_freeLeafs))
+    {
+        index = m_freeLeafs.back();
+        m_freeLeafs.pop_back();
+    }
+    else
+    {
+        index = static_cast<Size>(size(m_leafSlots));
+        m_leafAABBs.emplace_back();
+        m_leafData.emplace_back();
+        m_leafSlots.emplace_back();
+    }
+    m_leafAABBs[index] = aabb;
+    m_leafData[index] = data;
+    return index;
+}
+
+template <std::size_t N>
+void WideDynamicTree<N>::Build(const std::vector<Size>& leafs)
+{
+    // Bulk builds a binary tree of the leafs and then collapses it.
+    auto aabbs = std::vector<AABB>{};
+    auto data = std::vector<LeafData>{};
+    aabbs.reserve(size(leafs));
+    data.reserve(size(leafs));
+    for (const auto leaf: leafs)
+    {
+        aabbs.push_back(m_leafAABBs[leaf]);
+        data.push_back(m_leafData[leaf]);
+    }
+    auto tree = DynamicTree{};
+    const auto treeIds = tree.CreateLeafs(aabbs, data);
+    auto leafIds = std::vector<Size>(tree.GetNodeCapacity(), GetInvalidSize());
+    for (auto i = std::size_t{0}; i < size(leafs); ++i)
+    {
+        leafIds[treeIds[i]] = leafs[i];
+    }
+    auto nodes = std::vector<Node>{};
+    nodes.reserve((size(leafs) + N - 2) / (N - 1) + 1);
+    m_nodes.swap(nodes);
+    m_freeNodes.clear();
+    m_root = GetInvalidSize();
+    const auto root = tree.GetRootIndex();
+    if (root != DynamicTree::GetInvalidSize())
+    {
+        m_root = Append(tree, root, leafIds);
+    }
+    m_leafCount = static_cast<Size>(size(leafs));
+    m_insertCount = 0u;
+}
+
+template <std::size_t N>
+std::vector<typename WideDynamicTree<N>::Size> WideDynamicTree<N>::GetLeafs() const
+{
+    auto leafs = std::vector<Size>{};
+    leafs.reserve(m_leafCount);
+    for (auto i = std::size_t{0}; i < size(m_leafSlots); ++i)
+    {
+        if (m_leafSlots[i].node != GetInvalidSize())
+        {
+            leafs.push_back(static_cast<Size>(i));
+        }
+    }
+    return leafs;
+}
+
+template <std::size_t N>
+typename WideDynamicTree<N>::Size
+WideDynamicTree<N>::Append(const DynamicTree& tree, Size index, Span<const Size> leafIds)
+{
+    // Collapses the binary subtree into up to N slots by repeatedly opening up the
+    // branch with the largest perimeter, as that's the one most likely to be visited.
+    Size slots[N];
+    auto count = std::size_t{0};
+    slots[count++] = index;
+    while (count < N)
+    {
+        auto best = N;
+        auto bestPerimeter = 0_m;
+        for (auto i = std::size_t{0}; i < count; ++i)
+        {
+            if (DynamicTree::IsBranch(tree.GetHeight(slots[i])))
+            {
+                const auto perimeter = GetPerimeter(tree.GetAABB(slots[i]));
+                if (best == N || perimeter > bestPerimeter)
+                {
+                    best = i;
+                    bestPerimeter = perimeter;
+                }
+            }
+        }
+        if (best == N)
+        {
+            break;
+        }
+        const auto bd = tree.GetBranchData(slots[best]);
+        slots[best] = bd.child1;
+        slots[count++] = bd.child2;
+    }
+
+    const auto nodeIndex = AllocateNode();
+    for (auto i = std::size_t{0}; i < count; ++i)
+    {
+        const auto aabb = tree.GetAABB(slots[i]);
+        if (DynamicTree::IsLeaf(tree.GetHeight(slots[i])))
+        {
+            const auto leaf = empty(leafIds)? slots[i]: leafIds[slots[i]];
+            m_leafAABBs[leaf] = aabb;
+            m_leafData[leaf] = tree.GetLeafData(slots[i]);
+            SetSlot(nodeIndex, i, aabb, leaf, true);
+        }
+        else
+        {
+            const auto child = Append(tree, slots[i], leafIds); // May reallocate m_nodes!
+            SetSlot(nodeIndex, i, aabb, child, false);
+        }
+    }
+    m_nodes[nodeIndex].count = static_cast<Size>(count);
+    return nodeIndex;
+}
+
+/// @brief Query the given wide tree and find leafs overlapping the given AABB.
+/// @note The callback instance is called for each leaf that overlaps the supplied AABB.
+/// @relatedalso WideDynamicTree
+template <std::size_t N>
+void Query(const WideDynamicTree<N>& tree, const AABB& aabb,
+           const DynamicTreeSizeCB& callback)
+{
+    using Size = typename WideDynamicTree<N>::Size;
+    if (tree.GetRootIndex() == WideDynamicTree<N>::GetInvalidSize())
+    {
+        return;
+    }
+    const auto minX = aabb.ranges[0].GetMin();
+    const auto minY = aabb.ranges[1].GetMin();
+    const auto maxX = aabb.ranges[0].GetMax();
+    const auto maxY = aabb.ranges[1].GetMax();
+
+    GrowableStack<Size, 256> stack;
+    stack.push(tree.GetRootIndex());
+    while (!empty(stack))
+    {
+        const auto& node = tree.GetNode(stack.top());
+        stack.pop();
+
+        // Tests all the slots at once. Intentionally uses non short-circuiting operators.
+        bool overlaps[N];
+        for (auto i = std::size_t{0}; i < N; ++i)
+        {
+            overlaps[i] = (node.lowerX[i] <= maxX) & (minX <= node.upperX[i]) &
+                          (node.lowerY[i] <= maxY) & (minY <= node.upperY[i]);
+        }
+        for (auto i = std::size_t{0}; i < N; ++i)
+        {
+            if (overlaps[i])
+            {
+                if (node.leafs & (std::uint32_t{1} << i))
+                {
+                    if (callback(node.children[i]) == DynamicTreeOpcode::End)
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    stack.push(node.children[i]);
+                }
+            }
+        }
+    }
+}
+
+/// @brief Queries the given wide tree for all fixtures that potentially overlap the AABB.
+/// @param tree Wide tree to do the query over.
+/// @param aabb The query box.
+/// @param callback User implemented callback function.
+/// @relatedalso WideDynamicTree
+template <std::size_t N>
+void Query(const WideDynamicTree<N>& tree, const AABB& aabb, QueryFixtureCallback callback)
+{
+    Query(tree, aabb, [&](DynamicTree::Size treeId) {
+        const auto leafData = tree.GetLeafData(treeId);
+        return callback(leafData.fixture, leafData.childIndex)?
+            DynamicTreeOpcode::Continue: DynamicTreeOpcode::End;
+    });
+}
+
+/// @brief Cast rays against the leafs in the given wide tree.
+/// @details This behaves the same as ray casting against a <code>DynamicTree</code>.
+/// @return <code>true</code> if terminated at the callback's request,
+///   <code>false</code> otherwise.
+/// @see RayCast(const DynamicTree&, RayCastInput, const DynamicTreeRayCastCB&).
+/// @relatedalso WideDynamicTree
+template <std::size_t N>
+bool RayCast(const WideDynamicTree<N>& tree, RayCastInput input,
+             const DynamicTreeRayCastCB& callback)
+{
+    using Size = typename WideDynamicTree<N>::Size;
+    if (tree.GetRootIndex() == WideDynamicTree<N>::GetInvalidSize())
+    {
+        return false;
+    }
+    const auto v = GetRevPerpendicular(GetUnitVector(input.p2 - input.p1, UnitVec::GetZero()));
+    const auto abs_v = abs(v);
+    auto segmentAABB = d2::GetAABB(input);
+
+    // Separating axis for segment (Gino, p80): |dot(v, p1 - ctr)| > dot(|v|, extents)
+    const auto isHit = [&](const typename WideDynamicTree<N>::Node& node, std::size_t i,
+                           const AABB& bounds) {
+        const auto ctrX = (node.lowerX[i] + node.upperX[i]) / Real{2};
+        const auto ctrY = (node.lowerY[i] + node.upperY[i]) / Real{2};
+        const auto extX = (node.upperX[i] - node.lowerX[i]) / Real{2};
+        const auto extY = (node.upperY[i] - node.lowerY[i]) / Real{2};
+        const auto separation = abs(GetX(v) * (GetX(input.p1) - ctrX) +
+                                    GetY(v) * (GetY(input.p1) - ctrY)) -
+                                (GetX(abs_v) * extX + GetY(abs_v) * extY);
+        // Intentionally uses non short-circuiting operators.
+        return (node.lowerX[i] <= bounds.ranges[0].GetMax()) &
+               (bounds.ranges[0].GetMin() <= node.upperX[i]) &
+               (node.lowerY[i] <= bounds.ranges[1].GetMax()) &
+               (bounds.ranges[1].GetMin() <= node.upperY[i]) &
+               (separation <= 0_m);
+    };
+
+    GrowableStack<Size, 256> stack;
+    stack.push(tree.GetRootIndex());
+    while (!empty(stack))
+    {
+        const auto& node = tree.GetNode(stack.top());
+        stack.pop();
+
+        // Tests all the slots at once.
+        bool hits[N];
+        for (auto i = std::size_t{0}; i < N; ++i)
+        {
+            hits[i] = isHit(node, i, segmentAABB);
+        }
+        auto segmentChanged = false;
+        for (auto i = std::size_t{0}; i < N; ++i)
+        {
+            // Re-tests the slot if a callback has since changed the segment, so slots
+            // that a clipped segment no longer reaches aren't reported or descended into.
+            if (!(segmentChanged? isHit(node, i, segmentAABB): hits[i]))
+            {
+                continue;
+            }
+            if (node.leafs & (std::uint32_t{1} << i))
+            {
+                const auto leafData = tree.GetLeafData(node.children[i]);
+                const auto value = callback(leafData.body, leafData.fixture,
+                                            leafData.childIndex, input);
+                if (value == 0)
+                {
+                    return true; // Callback has terminated the ray cast.
+                }
+                if (value > 0)
+                {
+                    // Update segment bounding box.
+                    input.maxFraction = value;
+                    segmentAABB = d2::GetAABB(input);
+                    segmentChanged = true;
+                }
+            }
+            else
+            {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the "size" of the given tree.
+/// @note Size in this context is defined as the leaf count.
+/// @relatedalso WideDynamicTree
+template <std::size_t N>
+inline std::size_t size(const WideDynamicTree<N>& tree) noexcept
+{
+    return tree.GetLeafCount();
+}
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_COLLISION_WIDEDYNAMICTREE_HPP
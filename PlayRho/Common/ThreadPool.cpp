@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2017 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <PlayRho/Common/ThreadPool.hpp>
+
+namespace playrho {
+
+ThreadPool::ThreadPool(std::size_t workers)
+{
+    Start(workers);
+}
+
+ThreadPool::ThreadPool(const ThreadPool& other): ThreadPool(other.GetWorkers())
+{
+    // Intentionally empty.
+}
+
+ThreadPool& ThreadPool::operator=(const ThreadPool& other)
+{
+    if ((this != &other) && (GetWorkers() != other.GetWorkers()))
+    {
+        Stop();
+        Start(other.GetWorkers());
+    }
+    return *this;
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    Stop();
+}
+
+void ThreadPool::Start(std::size_t workers)
+{
+    m_stopping = false;
+    m_next = 0;
+    m_queues.clear();
+    for (auto i = std::size_t{0}; i <= workers; ++i)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    m_threads.reserve(workers);
+    for (auto i = std::size_t{0}; i < workers; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::Work, this, i + 1);
+    }
+}
+
+void ThreadPool::Stop() noexcept
+{
+    {
+        const auto lock = std::lock_guard<std::mutex>{m_mutex};
+        m_stopping = true;
+    }
+    m_pushed.notify_all();
+    for (auto& thread: m_threads)
+    {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void ThreadPool::Push(Task task)
+{
+    auto& queue = *m_queues[m_next];
+    m_next = (m_next + 1) % m_queues.size();
+    ++m_pending;
+    {
+        // Counted under the pool's mutex so that waiting workers can't miss it, and before
+        // the task's queued so that taking it can't decrement the count below zero.
+        const auto lock = std::lock_guard<std::mutex>{m_mutex};
+        ++m_queued;
+    }
+    {
+        const auto lock = std::lock_guard<std::mutex>{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+    m_pushed.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    while (TryRun(0))
+    {
+        // Keep running tasks.
+    }
+    auto lock = std::unique_lock<std::mutex>{m_mutex};
+    m_done.wait(lock, [this]() { return m_pending == 0; });
+    if (m_exception)
+    {
+        const auto exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+void ThreadPool::Work(std::size_t thread)
+{
+    for (;;)
+    {
+        if (TryRun(thread))
+        {
+            continue;
+        }
+        auto lock = std::unique_lock<std::mutex>{m_mutex};
+        m_pushed.wait(lock, [this]() { return m_stopping || (m_queued > 0); });
+        if (m_queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::TryRun(std::size_t thread)
+{
+    auto task = Task{};
+    const auto numQueues = m_queues.size();
+    for (auto i = std::size_t{0}; i < numQueues; ++i)
+    {
+        auto& queue = *m_queues[(thread + i) % numQueues];
+        const auto lock = std::lock_guard<std::mutex>{queue.mutex};
+        if (!queue.tasks.empty())
+        {
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            break;
+        }
+    }
+    if (!task)
+    {
+        return false;
+    }
+    --m_queued;
+    try
+    {
+        task(thread);
+    }
+    catch (...)
+    {
+        const auto lock = std::lock_guard<std::mutex>{m_mutex};
+        if (!m_exception)
+        {
+            m_exception = std::current_exception();
+        }
+    }
+    if (--m_pending == 0)
+    {
+        const auto lock = std::lock_guard<std::mutex>{m_mutex};
+        m_done.notify_all();
+    }
+    return true;
+}
+
+} // namespace playrho
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2017 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PLAYRHO_COMMON_THREADPOOL_HPP
+#define PLAYRHO_COMMON_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace playrho {
+
+/// @brief Pool of persistent worker threads that run tasks.
+/// @details The workers stay around for the lifetime of the pool so that running tasks
+///   doesn't cost creating threads. Every thread has its own queue that pushed tasks get
+///   dealt out to in turn. Threads take tasks from the fronts of their own queues and,
+///   once theirs are empty, steal them from the backs of the others' queues.
+/// @note The thread that calls <code>Wait</code> runs tasks too so a pool without workers
+///   just runs the tasks on that thread in the order they were pushed.
+/// @note Copies get their own workers, as many as what's copied has.
+class ThreadPool
+{
+public:
+    /// @brief Task type.
+    /// @details Tasks get called with the index of the thread running them. That's
+    ///   zero for the thread calling <code>Wait</code> and one more than the worker's
+    ///   index for the workers.
+    using Task = std::function<void(std::size_t thread)>;
+
+    /// @brief Initializing constructor.
+    /// @param workers Number of worker threads to start.
+    explicit ThreadPool(std::size_t workers = 0);
+
+    /// @brief Copy constructor.
+    ThreadPool(const ThreadPool& other);
+
+    /// @brief Copy assignment operator.
+    /// @pre Neither pool has tasks that haven't been waited for.
+    ThreadPool& operator=(const ThreadPool& other);
+
+    ~ThreadPool() noexcept;
+
+    /// @brief Gets the number of worker threads.
+    std::size_t GetWorkers() const noexcept
+    {
+        return m_threads.size();
+    }
+
+    /// @brief Pushes the given task to be run.
+    /// @note Tasks can run as soon as they're pushed.
+    void Push(Task task);
+
+    /// @brief Runs pushed tasks till they've all been run.
+    /// @note Tasks must not push or wait on tasks themselves.
+    /// @throws Whatever the first task to throw since the last wait threw. The other
+    ///   tasks still get run.
+    void Wait();
+
+private:
+    /// @brief Task queue of a thread.
+    struct Queue
+    {
+        std::mutex mutex; ///< Mutex of the tasks.
+        std::deque<Task> tasks; ///< Tasks.
+    };
+
+    /// @brief Starts the given number of workers.
+    void Start(std::size_t workers);
+
+    /// @brief Stops the workers after they've run the tasks that are left.
+    void Stop() noexcept;
+
+    /// @brief Runs tasks for the identified worker till the pool gets stopped.
+    void Work(std::size_t thread);
+
+    /// @brief Runs a task for the identified thread if there's one to take or steal.
+    /// @return Whether a task got run.
+    bool TryRun(std::size_t thread);
+
+    std::vector<std::unique_ptr<Queue>> m_queues; ///< Queues indexed by thread.
+    std::vector<std::thread> m_threads; ///< Worker threads.
+    std::mutex m_mutex; ///< Mutex of the following state.
+    std::condition_variable m_pushed; ///< Signaled when tasks get pushed or on stopping.
+    std::condition_variable m_done; ///< Signaled when the last pending task is done.
+    std::atomic<std::size_t> m_queued{0}; ///< Number of tasks that are queued.
+    std::atomic<std::size_t> m_pending{0}; ///< Number of tasks that aren't done.
+    std::size_t m_next = 0; ///< Index of the queue to push to next.
+    std::exception_ptr m_exception; ///< First exception of a task since the last wait.
+    bool m_stopping = false; ///< Whether the workers are stopping.
+};
+
+} // namespace playrho
+
+#endif // PLAYRHO_COMMON_THREADPOOL_HPP
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PLAYRHO_DETAIL_QUERYBATCH_HPP
+#define PLAYRHO_DETAIL_QUERYBATCH_HPP
+
+/// @file
+/// Internal helper for spreading batches of queries over threads.
+
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Common/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+namespace detail {
+
+/// @brief Does the given number of queries in consecutive ranges spread over the given
+///   pool's workers and the calling thread.
+/// @details Calls the given function with the first and last index of each range and the
+///   buffer to append that range's hits to. The function must also set the offsets of the
+///   range's queries into that buffer. The first range's hits go straight into the results
+///   while those of each later range get appended to them afterwards.
+template <class F>
+void QueryBatch(std::size_t count, QueryBatchResults& results, ThreadPool& pool,
+                const F& queryRange)
+{
+    const auto numThreads = std::max(std::min(pool.GetWorkers() + 1u, count), std::size_t{1});
+    const auto perThread = count / numThreads;
+    results.hits.clear();
+    results.offsets.resize(count + 1);
+    results.threadHits.resize(numThreads - 1);
+    for (auto i = decltype(numThreads){0}; i < numThreads; ++i)
+    {
+        auto& hits = (i == 0u)? results.hits: results.threadHits[i - 1];
+        const auto first = perThread * i;
+        const auto last = (i + 1 < numThreads)? first + perThread: count;
+        pool.Push([&queryRange,&hits,first,last](std::size_t) {
+            hits.clear();
+            queryRange(first, last, hits);
+        });
+    }
+    pool.Wait();
+    for (auto i = decltype(numThreads){1}; i < numThreads; ++i)
+    {
+        const auto& hits = results.threadHits[i - 1];
+        const auto base = size(results.hits);
+        const auto first = perThread * i;
+        const auto last = (i + 1 < numThreads)? first + perThread: count;
+        for (auto j = first; j < last; ++j)
+        {
+            results.offsets[j] += base;
+        }
+        results.hits.insert(end(results.hits), cbegin(hits), cend(hits));
+    }
+    results.offsets[count] = size(results.hits);
+}
+
+} // namespace detail
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_DETAIL_QUERYBATCH_HPP
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PLAYRHO_DETAIL_SSE2_HPP
+#define PLAYRHO_DETAIL_SSE2_HPP
+
+/// @file
+/// Internal helpers for the SSE2 code paths of the library's source files.
+/// @note <code>PLAYRHO_SSE2</code> is only defined when the target supports SSE2.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PLAYRHO_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef PLAYRHO_SSE2
+
+namespace playrho {
+namespace sse2 {
+
+/// @brief Up to four 2-D values as vectors of their X and Y values.
+struct Vec2Lanes
+{
+    __m128 x; ///< X values.
+    __m128 y; ///< Y values.
+};
+
+/// @brief Selects the elements of <code>a</code> where <code>mask</code> is set and
+///   those of <code>b</code> elsewhere.
+inline __m128 Select(__m128 mask, __m128 a, __m128 b) noexcept
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// @brief Selects the elements of <code>a</code> where <code>mask</code> is set and
+///   those of <code>b</code> elsewhere.
+inline __m128i Select(__m128 mask, __m128i a, __m128i b) noexcept
+{
+    const auto m = _mm_castps_si128(mask);
+    return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+/// @brief Gets the negations of the given values.
+inline __m128 Negate(__m128 value) noexcept
+{
+    return _mm_xor_ps(value, _mm_set1_ps(-0.0f));
+}
+
+/// @brief Gets the absolute values of the given values.
+inline __m128 Abs(__m128 value) noexcept
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+/// @brief Gets the greater of the given values the way <code>std::max</code> does.
+inline __m128 Max(__m128 a, __m128 b) noexcept
+{
+    return Select(_mm_cmplt_ps(a, b), b, a);
+}
+
+} // namespace sse2
+} // namespace playrho
+
+#endif // PLAYRHO_SSE2
+
+#endif // PLAYRHO_DETAIL_SSE2_HPP
@@ -24,6 +24,9 @@
 #include <PlayRho/Dynamics/MovementConf.hpp>
 #include <PlayRho/Dynamics/Body.hpp>
 
+#include <stdexcept> // for std::out_of_range
+#include <vector>
+
 namespace playrho {
 namespace d2 {
 
@@ -149,6 +152,83 @@ namespace d2 {
         };
     }
 
+    /// @brief Gets whether solving constraints can change the velocity or position of the
+    ///   given body constraint.
+    /// @details That's not the case for the constraints of static and kinematic bodies so
+    ///   constraints sharing such bodies don't depend on each other.
+    inline bool IsMovable(const BodyConstraint& body) noexcept
+    {
+        return (body.GetInvMass() != InvMass{}) || (body.GetInvRotInertia() != InvRotInertia{});
+    }
+
+    /// @brief Body constraints map.
+    /// @details Provides access to body constraints by body identifier. The constraints are
+    ///   either indexed directly by the underlying values of the identifiers or, for the
+    ///   constraints of an island, densely stored in the order of the island's bodies and
+    ///   indexed through a map of island-local indices.
+    /// @note This is a non-owning view of the constraints that's cheap to copy.
+    class BodyConstraintsMap
+    {
+    public:
+        /// @brief Initializing constructor for constraints indexed by body identifier.
+        BodyConstraintsMap(std::vector<BodyConstraint>& constraints) noexcept:
+            m_constraints{&constraints}
+        {
+            // Intentionally empty.
+        }
+
+        /// @brief Initializing constructor for island-local constraints.
+        /// @param constraints Constraints of the given bodies in the same order as them.
+        /// @param bodies Identifiers of the bodies of the constraints.
+        /// @param indices Island-local indices indexed by body identifier. Only the entries
+        ///   for the given bodies are used so the others can be left over from other islands.
+        BodyConstraintsMap(std::vector<BodyConstraint>& constraints,
+                           const std::vector<BodyID>& bodies,
+                           const std::vector<BodyCounter>& indices) noexcept:
+            m_constraints{&constraints}, m_bodies{&bodies}, m_indices{&indices}
+        {
+            assert(size(constraints) == size(bodies));
+        }
+
+        /// @brief Accesses the constraint for the identified body.
+        /// @throws std::out_of_range If there's no constraint for the identified body.
+        BodyConstraint& at(BodyID key) const
+        {
+            const auto i = UnderlyingValue(key);
+            if (!m_indices)
+            {
+                return m_constraints->at(i);
+            }
+            if (i < size(*m_indices))
+            {
+                const auto index = (*m_indices)[i];
+                if ((index < size(*m_bodies)) && ((*m_bodies)[index] == key))
+                {
+                    return (*m_constraints)[index];
+                }
+            }
+            throw std::out_of_range{"BodyConstraintsMap::at: no such body"};
+        }
+
+        /// @brief Accesses the constraint for the identified body.
+        /// @warning Behavior is undefined if there's no constraint for the identified body.
+        BodyConstraint& operator[](BodyID key) const noexcept
+        {
+            const auto i = UnderlyingValue(key);
+            if (!m_indices)
+            {
+                return (*m_constraints)[i];
+            }
+            assert((*m_bodies)[(*m_indices)[i]] == key);
+            return (*m_constraints)[(*m_indices)[i]];
+        }
+
+    private:
+        std::vector<BodyConstraint>* m_constraints; ///< Constraints.
+        const std::vector<BodyID>* m_bodies = nullptr; ///< Bodies of island-local constraints.
+        const std::vector<BodyCounter>* m_indices = nullptr; ///< Island-local indices.
+    };
+
 } // namespace d2
 } // namespace playrho
 
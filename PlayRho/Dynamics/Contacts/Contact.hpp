@@ -192,6 +192,17 @@ public:
     ///   means no actual impact in current time slot), otherwise undefined.
     Real GetToi() const;
 
+    /// @brief Gets the simplex indices cached from the last distance calculation.
+    /// @details These are the index pairs of the simplex that the last distance
+    ///   calculation between this contact's children ended with. They're used to warm
+    ///   start the next distance calculation for this contact.
+    /// @see SetSimplexIndices.
+    IndexPair3 GetSimplexIndices() const noexcept;
+
+    /// @brief Sets the simplex indices to warm start distance calculations from.
+    /// @see GetSimplexIndices.
+    void SetSimplexIndices(IndexPair3 value) noexcept;
+
     /// @brief Flags the contact for filtering.
     void FlagForFiltering() noexcept;
 
@@ -344,6 +355,10 @@ private:
     substep_type m_toiCount = 0;
 
     FlagsType m_flags = e_enabledFlag|e_dirtyFlag; ///< Flags.
+
+    /// Simplex indices of the last distance calculation.
+    /// @note Field is 6-bytes.
+    IndexPair3 m_simplexIndices = InvalidIndexPair3;
 };
 
 inline void Contact::SetEnabled(bool flag) noexcept
@@ -494,6 +509,16 @@ inline void Contact::UnsetToi() noexcept
     m_flags &= ~Contact::e_toiFlag;
 }
 
+inline IndexPair3 Contact::GetSimplexIndices() const noexcept
+{
+    return m_simplexIndices;
+}
+
+inline void Contact::SetSimplexIndices(IndexPair3 value) noexcept
+{
+    m_simplexIndices = value;
+}
+
 inline void Contact::SetToiCount(substep_type value) noexcept
 {
     m_toiCount = value;
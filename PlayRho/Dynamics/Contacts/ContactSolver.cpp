@@ -25,8 +25,12 @@
 #include <PlayRho/Dynamics/Contacts/PositionConstraint.hpp>
 #include <PlayRho/Dynamics/StepConf.hpp>
 #include <PlayRho/Common/OptionalValue.hpp>
+#include <PlayRho/Detail/Sse2.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
 
 #if !defined(NDEBUG)
 // Solver debugging is normally disabled because the block solver sometimes has to deal with a
@@ -61,6 +65,18 @@ struct ImpulseChange
     UnitVec direction; ///< Direction.
 };
 
+/// @brief Sets the velocity of the given body constraint if it's movable.
+/// @details Unmovable bodies keep their velocities anyway. Not writing to them lets the
+///   constraints that share them get solved concurrently.
+/// @see IsMovable.
+inline void SetVelocityIfMovable(BodyConstraint& body, const Velocity& value) noexcept
+{
+    if (IsMovable(body))
+    {
+        body.SetVelocity(value);
+    }
+}
+
 VelocityPair GetVelocityDelta(const VelocityConstraint& vc, const Momentum2 impulses)
 {
     assert(IsValid(impulses));
@@ -94,8 +110,8 @@ VelocityPair GetVelocityDelta(const VelocityConstraint& vc, const Momentum2 impu
 Momentum BlockSolveUpdate(VelocityConstraint& vc, const Momentum2 newImpulses)
 {
     const auto delta_v = GetVelocityDelta(vc, newImpulses - GetNormalImpulses(vc));
-    vc.GetBodyA()->SetVelocity(vc.GetBodyA()->GetVelocity() + std::get<0>(delta_v));
-    vc.GetBodyB()->SetVelocity(vc.GetBodyB()->GetVelocity() + std::get<1>(delta_v));
+    SetVelocityIfMovable(*vc.GetBodyA(), vc.GetBodyA()->GetVelocity() + std::get<0>(delta_v));
+    SetVelocityIfMovable(*vc.GetBodyB(), vc.GetBodyB()->GetVelocity() + std::get<1>(delta_v));
     SetNormalImpulses(vc, newImpulses);
     return std::max(abs(newImpulses[0]), abs(newImpulses[1]));
 }
@@ -368,8 +384,8 @@ inline Momentum SeqSolveNormalConstraint(VelocityConstraint& vc)
     }
     solverProc(0);
     
-    bodyA->SetVelocity(newVelA);
-    bodyB->SetVelocity(newVelB);
+    SetVelocityIfMovable(*bodyA, newVelA);
+    SetVelocityIfMovable(*bodyB, newVelB);
     
     return maxIncImpulse;
 }
@@ -428,8 +444,8 @@ inline Momentum SolveTangentConstraint(VelocityConstraint& vc)
     }
     solverProc(0);
 
-    bodyA->SetVelocity(newVelA);
-    bodyB->SetVelocity(newVelB);
+    SetVelocityIfMovable(*bodyA, newVelA);
+    SetVelocityIfMovable(*bodyB, newVelB);
     
     return maxIncImpulse;
 }
@@ -452,6 +468,470 @@ inline Momentum SolveNormalConstraint(VelocityConstraint& vc)
 #endif
 }
 
+#ifdef PLAYRHO_SSE2
+
+// The following solves up to four velocity constraints at once. Each is in a lane of the
+// SSE2 vectors. The results are the same - bit for bit - as from the scalar code above since
+// every lane gets calculated with the same operations in the same order as it does. Lanes
+// that the scalar code would branch away from just get masked out instead.
+
+using sse2::Vec2Lanes;
+using sse2::Select;
+using sse2::Negate;
+using sse2::Abs;
+using sse2::Max;
+
+/// @brief Gets the dot products of the given vectors the way <code>Dot</code> does -
+///   including its addition to zero.
+inline __m128 Dot(__m128 ax, __m128 ay, __m128 bx, __m128 by) noexcept
+{
+    return _mm_add_ps(_mm_add_ps(_mm_setzero_ps(), _mm_mul_ps(ax, bx)), _mm_mul_ps(ay, by));
+}
+
+/// @brief Gets the cross products of the given vectors the way <code>Cross</code> does.
+inline __m128 Cross(__m128 ax, __m128 ay, __m128 bx, __m128 by) noexcept
+{
+    return _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+}
+
+/// @brief Velocities as lanes.
+struct VelocityLanes
+{
+    __m128 x; ///< Linear velocity X values.
+    __m128 y; ///< Linear velocity Y values.
+    __m128 w; ///< Angular velocity values.
+};
+
+/// @brief Body constraints of velocity constraints as lanes.
+struct BodyLanes
+{
+    VelocityLanes velocity; ///< Velocities.
+    __m128 invMass; ///< Inverse masses.
+    __m128 invRotInertia; ///< Inverse rotational inertias.
+    __m128 movable; ///< Mask of the movable bodies.
+};
+
+/// @brief Velocity constraint points as lanes.
+struct PointLanes
+{
+    __m128 relAx; ///< Positions of body A relative to the points. X values.
+    __m128 relAy; ///< Positions of body A relative to the points. Y values.
+    __m128 relBx; ///< Positions of body B relative to the points. X values.
+    __m128 relBy; ///< Positions of body B relative to the points. Y values.
+    __m128 normalImpulse; ///< Normal impulses.
+    __m128 tangentImpulse; ///< Tangent impulses.
+    __m128 normalMass; ///< Normal masses.
+    __m128 tangentMass; ///< Tangent masses.
+    __m128 velocityBias; ///< Velocity biases.
+};
+
+/// @brief Velocity constraints as lanes.
+/// @details This is the structure of arrays form of up to four velocity constraints and
+///   of the body constraints they refer to.
+struct VelocityConstraintLanes
+{
+    BodyLanes bodyA; ///< Body constraints A.
+    BodyLanes bodyB; ///< Body constraints B.
+    __m128 normalX; ///< Normals. X values.
+    __m128 normalY; ///< Normals. Y values.
+    __m128 friction; ///< Frictions.
+    __m128 tangentSpeed; ///< Tangent speeds.
+    __m128 k00; ///< K values. First row and first column.
+    __m128 k01; ///< K values. First row and second column, same as second row and first column.
+    __m128 k11; ///< K values. Second row and second column.
+    __m128 m00; ///< Normal masses. First row and first column.
+    __m128 m01; ///< Normal masses. First row and second column.
+    __m128 m11; ///< Normal masses. Second row and second column.
+    __m128 twoPoints; ///< Mask of the velocity constraints that have two points.
+    __m128 blockSolve; ///< Mask of the velocity constraints to block solve.
+    PointLanes points[MaxManifoldPoints]; ///< Points.
+};
+
+/// @brief Gets the given velocity constraints as lanes.
+/// @details Gathers the values of each velocity constraint in turn and then loads each
+///   value's lanes at once.
+/// @note Pads out unused lanes with the first velocity constraint.
+VelocityConstraintLanes GetVelocityConstraintLanes(VelocityConstraint* const* vcs,
+                                                   std::size_t count) noexcept
+{
+    constexpr auto numValues = 20u + 9u * MaxManifoldPoints;
+    constexpr auto numMasks = 4u;
+    alignas(16) float values[numValues][4];
+    alignas(16) std::int32_t masks[numMasks][4];
+    for (auto i = 0u; i < 4u; ++i)
+    {
+        const auto& vc = *vcs[(i < count)? i: 0u];
+        auto k = 0u;
+        const auto put = [&](auto value) {
+            values[k++][i] = static_cast<float>(StripUnit(value));
+        };
+        for (const auto body: {vc.GetBodyA(), vc.GetBodyB()})
+        {
+            const auto velocity = body->GetVelocity();
+            put(GetX(velocity.linear));
+            put(GetY(velocity.linear));
+            put(velocity.angular);
+            put(body->GetInvMass());
+            put(body->GetInvRotInertia());
+        }
+        const auto normal = vc.GetNormal();
+        const auto K = vc.GetK();
+        const auto normalMass = vc.GetNormalMass();
+        put(GetX(normal));
+        put(GetY(normal));
+        put(vc.GetFriction());
+        put(vc.GetTangentSpeed());
+        put(get<0>(get<0>(K)));
+        put(get<1>(get<0>(K)));
+        put(get<1>(get<1>(K)));
+        put(get<0>(get<0>(normalMass)));
+        put(get<1>(get<0>(normalMass)));
+        put(get<1>(get<1>(normalMass)));
+        for (auto j = VelocityConstraint::size_type{0}; j < MaxManifoldPoints; ++j)
+        {
+            const auto& point = vc.GetPointAt(j);
+            put(GetX(point.relA));
+            put(GetY(point.relA));
+            put(GetX(point.relB));
+            put(GetY(point.relB));
+            put(point.normalImpulse);
+            put(point.tangentImpulse);
+            put(point.normalMass);
+            put(point.tangentMass);
+            put(point.velocityBias);
+        }
+        assert(k == numValues);
+        const auto twoPoints = vc.GetPointCount() == 2;
+        masks[0][i] = IsMovable(*vc.GetBodyA())? -1: 0;
+        masks[1][i] = IsMovable(*vc.GetBodyB())? -1: 0;
+        masks[2][i] = twoPoints? -1: 0;
+        // Same condition as in SolveNormalConstraint.
+        masks[3][i] = (twoPoints && (K != InvMass22{}))? -1: 0;
+    }
+
+    auto k = 0u;
+    const auto get = [&]() {
+        return _mm_load_ps(values[k++]);
+    };
+    auto result = VelocityConstraintLanes{};
+    for (auto body: {&result.bodyA, &result.bodyB})
+    {
+        body->velocity.x = get();
+        body->velocity.y = get();
+        body->velocity.w = get();
+        body->invMass = get();
+        body->invRotInertia = get();
+    }
+    result.normalX = get();
+    result.normalY = get();
+    result.friction = get();
+    result.tangentSpeed = get();
+    result.k00 = get();
+    result.k01 = get();
+    result.k11 = get();
+    result.m00 = get();
+    result.m01 = get();
+    result.m11 = get();
+    for (auto& point: result.points)
+    {
+        point.relAx = get();
+        point.relAy = get();
+        point.relBx = get();
+        point.relBy = get();
+        point.normalImpulse = get();
+        point.tangentImpulse = get();
+        point.normalMass = get();
+        point.tangentMass = get();
+        point.velocityBias = get();
+    }
+    assert(k == numValues);
+    const auto getMask = [&](std::size_t index) {
+        return _mm_load_ps(reinterpret_cast<const float*>(masks[index]));
+    };
+    result.bodyA.movable = getMask(0);
+    result.bodyB.movable = getMask(1);
+    result.twoPoints = getMask(2);
+    result.blockSolve = getMask(3);
+    return result;
+}
+
+/// @brief Gets the given lanes as an array.
+inline std::array<float, 4> GetArray(__m128 value) noexcept
+{
+    auto result = std::array<float, 4>{};
+    _mm_storeu_ps(data(result), value);
+    return result;
+}
+
+/// @brief Gets the velocities of the given body constraints' movable bodies from the given
+///   velocities and their unchanged velocities otherwise.
+/// @note This is the same as only setting the velocities of the movable bodies.
+/// @see SetVelocityIfMovable.
+inline VelocityLanes GetVelocityIfMovable(const BodyLanes& bodies,
+                                          const VelocityLanes& velocity) noexcept
+{
+    return VelocityLanes{
+        Select(bodies.movable, velocity.x, bodies.velocity.x),
+        Select(bodies.movable, velocity.y, bodies.velocity.y),
+        Select(bodies.movable, velocity.w, bodies.velocity.w)
+    };
+}
+
+/// @brief Gets the closing velocities at the given points the way
+///   <code>GetContactRelVelocity</code> does.
+inline Vec2Lanes GetContactRelVelocity(const VelocityLanes& velA, const PointLanes& point,
+                                       const VelocityLanes& velB) noexcept
+{
+    // Adding the negated products - like GetRevPerpendicular gives - is the same as
+    // subtracting the products.
+    const auto vBx = _mm_sub_ps(velB.x, _mm_mul_ps(point.relBy, velB.w));
+    const auto vBy = _mm_add_ps(velB.y, _mm_mul_ps(point.relBx, velB.w));
+    const auto vAx = _mm_sub_ps(velA.x, _mm_mul_ps(point.relAy, velA.w));
+    const auto vAy = _mm_add_ps(velA.y, _mm_mul_ps(point.relAx, velA.w));
+    return Vec2Lanes{_mm_sub_ps(vBx, vAx), _mm_sub_ps(vBy, vAy)};
+}
+
+/// @brief Applies the given impulses at the given points to the given velocities for the
+///   lanes where <code>mask</code> is set.
+inline void ApplyImpulses(const VelocityConstraintLanes& lanes, const PointLanes& point,
+                          __m128 px, __m128 py, __m128 mask,
+                          VelocityLanes& velA, VelocityLanes& velB) noexcept
+{
+    const auto LA = Cross(point.relAx, point.relAy, px, py);
+    const auto LB = Cross(point.relBx, point.relBy, px, py);
+    velA.x = Select(mask, _mm_sub_ps(velA.x, _mm_mul_ps(lanes.bodyA.invMass, px)), velA.x);
+    velA.y = Select(mask, _mm_sub_ps(velA.y, _mm_mul_ps(lanes.bodyA.invMass, py)), velA.y);
+    velA.w = Select(mask, _mm_sub_ps(velA.w, _mm_mul_ps(lanes.bodyA.invRotInertia, LA)),
+                    velA.w);
+    velB.x = Select(mask, _mm_add_ps(velB.x, _mm_mul_ps(lanes.bodyB.invMass, px)), velB.x);
+    velB.y = Select(mask, _mm_add_ps(velB.y, _mm_mul_ps(lanes.bodyB.invMass, py)), velB.y);
+    velB.w = Select(mask, _mm_add_ps(velB.w, _mm_mul_ps(lanes.bodyB.invRotInertia, LB)),
+                    velB.w);
+}
+
+/// @brief Solves the tangent constraints at the given points for the lanes where
+///   <code>mask</code> is set.
+/// @see SolveTangentConstraint.
+inline void SolveTangentConstraints(const VelocityConstraintLanes& lanes, PointLanes& point,
+                                    __m128 mask, VelocityLanes& velA, VelocityLanes& velB,
+                                    __m128& maxIncImpulse) noexcept
+{
+    const auto directionX = lanes.normalY;
+    const auto directionY = Negate(lanes.normalX);
+    const auto closingVel = GetContactRelVelocity(velA, point, velB);
+    const auto directionalVel = _mm_sub_ps(lanes.tangentSpeed, Dot(closingVel.x, closingVel.y,
+                                                                   directionX, directionY));
+    const auto lambda = _mm_mul_ps(point.tangentMass, directionalVel);
+    const auto maxImpulse = _mm_mul_ps(lanes.friction, point.normalImpulse);
+    const auto minImpulse = Negate(maxImpulse);
+    const auto oldImpulse = point.tangentImpulse;
+    const auto impulse = _mm_add_ps(oldImpulse, lambda);
+    // Same as std::clamp(impulse, minImpulse, maxImpulse).
+    const auto newImpulse = Select(_mm_cmplt_ps(impulse, minImpulse), minImpulse,
+                                   Select(_mm_cmplt_ps(maxImpulse, impulse), maxImpulse,
+                                          impulse));
+    const auto incImpulse = _mm_sub_ps(newImpulse, oldImpulse);
+    ApplyImpulses(lanes, point, _mm_mul_ps(incImpulse, directionX),
+                  _mm_mul_ps(incImpulse, directionY), mask, velA, velB);
+    maxIncImpulse = Select(mask, Max(maxIncImpulse, Abs(incImpulse)), maxIncImpulse);
+    point.tangentImpulse = Select(mask, _mm_add_ps(oldImpulse, incImpulse), oldImpulse);
+}
+
+/// @brief Sequentially solves the normal constraints at the given points for the lanes
+///   where <code>mask</code> is set.
+/// @see SeqSolveNormalConstraint.
+inline void SeqSolveNormalConstraints(const VelocityConstraintLanes& lanes, PointLanes& point,
+                                      __m128 mask, VelocityLanes& velA, VelocityLanes& velB,
+                                      __m128& maxIncImpulse) noexcept
+{
+    const auto zero = _mm_setzero_ps();
+    const auto directionX = lanes.normalX;
+    const auto directionY = lanes.normalY;
+    const auto closingVel = GetContactRelVelocity(velA, point, velB);
+    const auto directionalVel = Dot(closingVel.x, closingVel.y, directionX, directionY);
+    const auto lambda = _mm_mul_ps(point.normalMass,
+                                   _mm_sub_ps(point.velocityBias, directionalVel));
+    const auto oldImpulse = point.normalImpulse;
+    const auto impulse = _mm_add_ps(oldImpulse, lambda);
+    // Same as std::max(impulse, 0_Ns).
+    const auto newImpulse = Select(_mm_cmplt_ps(impulse, zero), zero, impulse);
+    const auto incImpulse = _mm_sub_ps(newImpulse, oldImpulse);
+    ApplyImpulses(lanes, point, _mm_mul_ps(incImpulse, directionX),
+                  _mm_mul_ps(incImpulse, directionY), mask, velA, velB);
+    maxIncImpulse = Select(mask, Max(maxIncImpulse, Abs(incImpulse)), maxIncImpulse);
+    point.normalImpulse = Select(mask, _mm_add_ps(oldImpulse, incImpulse), oldImpulse);
+}
+
+/// @brief Block solves the normal constraints for the lanes where <code>mask</code> is set.
+/// @details Tries all four of the cases and takes the first valid one of each lane.
+/// @return Maximum incremental impulses or zero for lanes without a solution.
+/// @see BlockSolveNormalConstraint.
+inline __m128 BlockSolveNormalConstraints(VelocityConstraintLanes& lanes, __m128 mask,
+                                          VelocityLanes& velA, VelocityLanes& velB) noexcept
+{
+    const auto zero = _mm_setzero_ps();
+    auto& point0 = lanes.points[0];
+    auto& point1 = lanes.points[1];
+    const auto normalX = lanes.normalX;
+    const auto normalY = lanes.normalY;
+
+    // Gets b' from the normal velocities and the old total impulses.
+    const auto dv0 = GetContactRelVelocity(velA, point0, velB);
+    const auto dv1 = GetContactRelVelocity(velA, point1, velB);
+    const auto vn0 = Dot(dv0.x, dv0.y, normalX, normalY);
+    const auto vn1 = Dot(dv1.x, dv1.y, normalX, normalY);
+    const auto a0 = point0.normalImpulse;
+    const auto a1 = point1.normalImpulse;
+    const auto b0 = _mm_sub_ps(_mm_sub_ps(vn0, point0.velocityBias),
+                               Dot(lanes.k00, lanes.k01, a0, a1));
+    const auto b1 = _mm_sub_ps(_mm_sub_ps(vn1, point1.velocityBias),
+                               Dot(lanes.k01, lanes.k11, a0, a1));
+
+    // Case 1: vn = 0
+    const auto x0Case1 = Negate(Dot(lanes.m00, lanes.m01, b0, b1));
+    const auto x1Case1 = Negate(Dot(lanes.m01, lanes.m11, b0, b1));
+    const auto case1 = _mm_and_ps(_mm_cmpge_ps(x0Case1, zero), _mm_cmpge_ps(x1Case1, zero));
+
+    // Case 2: vn1 = 0 and x2 = 0
+    const auto x0Case2 = _mm_mul_ps(Negate(point0.normalMass), b0);
+    const auto vn2Case2 = _mm_add_ps(_mm_mul_ps(lanes.k01, x0Case2), b1);
+    const auto case2 = _mm_and_ps(_mm_cmpge_ps(x0Case2, zero), _mm_cmpge_ps(vn2Case2, zero));
+
+    // Case 3: vn2 = 0 and x1 = 0
+    const auto x1Case3 = _mm_mul_ps(Negate(point1.normalMass), b1);
+    const auto vn1Case3 = _mm_add_ps(_mm_mul_ps(lanes.k01, x1Case3), b0);
+    const auto case3 = _mm_and_ps(_mm_cmpge_ps(x1Case3, zero), _mm_cmpge_ps(vn1Case3, zero));
+
+    // Case 4: x1 = 0 and x2 = 0
+    const auto case4 = _mm_and_ps(_mm_cmpge_ps(b0, zero), _mm_cmpge_ps(b1, zero));
+
+    const auto x0 = Select(case1, x0Case1, Select(case2, x0Case2, zero));
+    const auto x1 = Select(case1, x1Case1, Select(case2, zero, Select(case3, x1Case3, zero)));
+    const auto solved = _mm_and_ps(mask, _mm_or_ps(_mm_or_ps(case1, case2),
+                                                   _mm_or_ps(case3, case4)));
+
+    // Same as BlockSolveUpdate.
+    const auto d0 = _mm_sub_ps(x0, a0);
+    const auto d1 = _mm_sub_ps(x1, a1);
+    const auto P0x = _mm_mul_ps(d0, normalX);
+    const auto P0y = _mm_mul_ps(d0, normalY);
+    const auto P1x = _mm_mul_ps(d1, normalX);
+    const auto P1y = _mm_mul_ps(d1, normalY);
+    const auto Px = _mm_add_ps(P0x, P1x);
+    const auto Py = _mm_add_ps(P0y, P1y);
+    const auto LA = _mm_add_ps(Cross(point0.relAx, point0.relAy, P0x, P0y),
+                               Cross(point1.relAx, point1.relAy, P1x, P1y));
+    const auto LB = _mm_add_ps(Cross(point0.relBx, point0.relBy, P0x, P0y),
+                               Cross(point1.relBx, point1.relBy, P1x, P1y));
+    velA.x = Select(solved, _mm_sub_ps(velA.x, _mm_mul_ps(lanes.bodyA.invMass, Px)), velA.x);
+    velA.y = Select(solved, _mm_sub_ps(velA.y, _mm_mul_ps(lanes.bodyA.invMass, Py)), velA.y);
+    velA.w = Select(solved, _mm_sub_ps(velA.w, _mm_mul_ps(lanes.bodyA.invRotInertia, LA)),
+                    velA.w);
+    velB.x = Select(solved, _mm_add_ps(velB.x, _mm_mul_ps(lanes.bodyB.invMass, Px)), velB.x);
+    velB.y = Select(solved, _mm_add_ps(velB.y, _mm_mul_ps(lanes.bodyB.invMass, Py)), velB.y);
+    velB.w = Select(solved, _mm_add_ps(velB.w, _mm_mul_ps(lanes.bodyB.invRotInertia, LB)),
+                    velB.w);
+    point0.normalImpulse = Select(solved, x0, a0);
+    point1.normalImpulse = Select(solved, x1, a1);
+    return Select(solved, Max(Abs(x0), Abs(x1)), zero);
+}
+
+/// @brief Solves up to four velocity constraints at once using SSE2 instructions.
+/// @note Only for when <code>Real</code> is <code>float</code>.
+/// @see GaussSeidel::SolveVelocityConstraints.
+Momentum SolveVelocityConstraintsSse2(VelocityConstraint* const* vcs,
+                                      std::size_t count) noexcept
+{
+    assert((count > 0) && (count <= GaussSeidel::VelocityConstraintsPerBatch));
+    auto lanes = GetVelocityConstraintLanes(vcs, count);
+    const auto zero = _mm_setzero_ps();
+    const auto all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+    // Applies frictional changes to velocity.
+    auto velA = lanes.bodyA.velocity;
+    auto velB = lanes.bodyB.velocity;
+    const auto anyTwoPoints = _mm_movemask_ps(lanes.twoPoints) != 0;
+    auto tangentIncImpulse = zero;
+    if (anyTwoPoints)
+    {
+        SolveTangentConstraints(lanes, lanes.points[1], lanes.twoPoints, velA, velB,
+                                tangentIncImpulse);
+    }
+    SolveTangentConstraints(lanes, lanes.points[0], all, velA, velB, tangentIncImpulse);
+    velA = GetVelocityIfMovable(lanes.bodyA, velA);
+    velB = GetVelocityIfMovable(lanes.bodyB, velB);
+    lanes.bodyA.velocity = velA;
+    lanes.bodyB.velocity = velB;
+
+    // Applies restitutional changes to velocity.
+    // Lanes get masked out of what they don't need. What none of them need gets skipped.
+    const auto blockSolves = _mm_movemask_ps(lanes.blockSolve);
+    const auto seqSolve = _mm_andnot_ps(lanes.blockSolve, all);
+    auto normalIncImpulse = zero;
+    if (blockSolves != 0xF)
+    {
+        if (anyTwoPoints)
+        {
+            SeqSolveNormalConstraints(lanes, lanes.points[1],
+                                      _mm_and_ps(seqSolve, lanes.twoPoints),
+                                      velA, velB, normalIncImpulse);
+        }
+        SeqSolveNormalConstraints(lanes, lanes.points[0], seqSolve, velA, velB,
+                                  normalIncImpulse);
+    }
+    if (blockSolves != 0)
+    {
+        normalIncImpulse = Select(lanes.blockSolve,
+                                  BlockSolveNormalConstraints(lanes, lanes.blockSolve,
+                                                              velA, velB),
+                                  normalIncImpulse);
+    }
+    velA = GetVelocityIfMovable(lanes.bodyA, velA);
+    velB = GetVelocityIfMovable(lanes.bodyB, velB);
+
+    const auto maxIncImpulses = GetArray(Max(Max(zero, tangentIncImpulse), normalIncImpulse));
+    const auto velAx = GetArray(velA.x);
+    const auto velAy = GetArray(velA.y);
+    const auto velAw = GetArray(velA.w);
+    const auto velBx = GetArray(velB.x);
+    const auto velBy = GetArray(velB.y);
+    const auto velBw = GetArray(velB.w);
+    const auto normalImpulses = std::array<std::array<float, 4>, MaxManifoldPoints>{{
+        GetArray(lanes.points[0].normalImpulse), GetArray(lanes.points[1].normalImpulse)
+    }};
+    const auto tangentImpulses = std::array<std::array<float, 4>, MaxManifoldPoints>{{
+        GetArray(lanes.points[0].tangentImpulse), GetArray(lanes.points[1].tangentImpulse)
+    }};
+    auto maxIncImpulse = 0_Ns;
+    for (auto i = std::size_t{0}; i < count; ++i)
+    {
+        auto& vc = *vcs[i];
+        SetVelocityIfMovable(*vc.GetBodyA(), Velocity{
+            LinearVelocity2{static_cast<Real>(velAx[i]) * MeterPerSecond,
+                            static_cast<Real>(velAy[i]) * MeterPerSecond},
+            static_cast<Real>(velAw[i]) * RadianPerSecond
+        });
+        SetVelocityIfMovable(*vc.GetBodyB(), Velocity{
+            LinearVelocity2{static_cast<Real>(velBx[i]) * MeterPerSecond,
+                            static_cast<Real>(velBy[i]) * MeterPerSecond},
+            static_cast<Real>(velBw[i]) * RadianPerSecond
+        });
+        const auto pointCount = vc.GetPointCount();
+        for (auto j = decltype(pointCount){0}; j < pointCount; ++j)
+        {
+            vc.SetNormalImpulseAtPoint(j, static_cast<Real>(normalImpulses[j][i]) *
+                                       NewtonSecond);
+            vc.SetTangentImpulseAtPoint(j, static_cast<Real>(tangentImpulses[j][i]) *
+                                        NewtonSecond);
+        }
+        maxIncImpulse = std::max(maxIncImpulse,
+                                 Momentum{static_cast<Real>(maxIncImpulses[i]) * NewtonSecond});
+    }
+    return maxIncImpulse;
+}
+
+#endif // PLAYRHO_SSE2
+
 }; // anonymous namespace
     
 } // namespace d2
@@ -491,6 +971,23 @@ Momentum SolveVelocityConstraint(d2::VelocityConstraint& vc)
     return maxIncImpulse;
 }
 
+Momentum SolveVelocityConstraints(d2::VelocityConstraint* const* vcs, std::size_t count)
+{
+    assert((count > 0) && (count <= VelocityConstraintsPerBatch));
+#ifdef PLAYRHO_SSE2
+    if (std::is_same<Real, float>::value)
+    {
+        return d2::SolveVelocityConstraintsSse2(vcs, count);
+    }
+#endif
+    auto maxIncImpulse = 0_Ns;
+    for (auto i = std::size_t{0}; i < count; ++i)
+    {
+        maxIncImpulse = std::max(maxIncImpulse, SolveVelocityConstraint(*vcs[i]));
+    }
+    return maxIncImpulse;
+}
+
 d2::PositionSolution SolvePositionConstraint(const d2::PositionConstraint& pc,
                                            const bool moveA, const bool moveB,
                                            ConstraintSolverConf conf)
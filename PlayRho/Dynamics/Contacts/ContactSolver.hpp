@@ -183,6 +183,29 @@ namespace GaussSeidel {
 ///
 Momentum SolveVelocityConstraint(d2::VelocityConstraint& vc);
 
+/// @brief Maximum number of velocity constraints that <code>SolveVelocityConstraints</code>
+///   solves at once.
+constexpr auto VelocityConstraintsPerBatch = std::size_t{4};
+
+/// Solves the given velocity constraints.
+///
+/// @details This is the same - bit for bit - as calling <code>SolveVelocityConstraint</code>
+///   for each of the velocity constraints in turn. It solves them all at once though using
+///   SSE2 instructions where they're available and <code>Real</code> is <code>float</code>.
+///
+/// @warning Behavior is undefined if any two of the velocity constraints have a movable
+///   body in common.
+///
+/// @param vcs Velocity constraints to solve.
+/// @param count Number of velocity constraints to solve. Must be between one and
+///   <code>VelocityConstraintsPerBatch</code> inclusive.
+///
+/// @return Maximum incremental impulse of the velocity constraints.
+///
+/// @see SolveVelocityConstraint, VelocityConstraintsPerBatch, IsMovable.
+///
+Momentum SolveVelocityConstraints(d2::VelocityConstraint* const* vcs, std::size_t count);
+
 /// Solves the given position constraint.
 /// @details
 /// This pushes apart the two given positions for every point in the contact position constraint
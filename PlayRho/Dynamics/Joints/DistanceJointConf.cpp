@@ -82,7 +82,7 @@ DistanceJointConf GetDistanceJointConf(const World& world, BodyID bodyA, BodyID
     };
 }
 
-void InitVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(DistanceJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -171,7 +171,7 @@ void InitVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodies
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(DistanceJointConf& object, BodyConstraintsMap bodies,
                    const StepConf&)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -201,7 +201,7 @@ bool SolveVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodie
     return impulse == 0_Ns;
 }
 
-bool SolvePosition(const DistanceJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const DistanceJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     if (object.frequency > 0_Hz)
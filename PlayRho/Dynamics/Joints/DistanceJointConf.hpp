@@ -35,6 +35,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Distance joint definition.
 /// @details This requires defining an anchor point on both bodies and the non-zero
@@ -153,7 +154,7 @@ constexpr bool ShiftOrigin(DistanceJointConf&, Length2) noexcept
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso DistanceJointConf
-void InitVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(DistanceJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -162,13 +163,13 @@ void InitVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodies
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso DistanceJointConf
-bool SolveVelocity(DistanceJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(DistanceJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso DistanceJointConf
-bool SolvePosition(const DistanceJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const DistanceJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for setting the frequency value of the given configuration.
@@ -75,7 +75,7 @@ FrictionJointConf GetFrictionJointConf(const World& world,
     };
 }
 
-void InitVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(FrictionJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -154,7 +154,7 @@ void InitVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodies
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(FrictionJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -226,7 +226,7 @@ bool SolveVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodie
     return solved;
 }
 
-bool SolvePosition(const FrictionJointConf&, std::vector<BodyConstraint>&,
+bool SolvePosition(const FrictionJointConf&, BodyConstraintsMap,
                    const ConstraintSolverConf&)
 {
     return true;
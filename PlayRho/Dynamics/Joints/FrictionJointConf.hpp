@@ -36,6 +36,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Friction joint definition.
 /// @details This is used for top-down friction. It provides 2-D translational friction
@@ -127,7 +128,7 @@ constexpr bool ShiftOrigin(FrictionJointConf&, Length2) noexcept
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso FrictionJointConf
-void InitVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(FrictionJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -136,13 +137,13 @@ void InitVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodies
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso FrictionJointConf
-bool SolveVelocity(FrictionJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(FrictionJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso FrictionJointConf
-bool SolvePosition(const FrictionJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const FrictionJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for getting the max force value of the given configuration.
@@ -127,7 +127,7 @@ GearJointConf GetGearJointConf(const World& world, JointID id1, JointID id2, Rea
     return def;
 }
 
-void InitVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(GearJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -235,7 +235,7 @@ void InitVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
     bodyConstraintD.SetVelocity(velD);
 }
 
-bool SolveVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(GearJointConf& object, BodyConstraintsMap bodies,
                    const StepConf&)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -282,7 +282,7 @@ bool SolveVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
     return impulse == 0_Ns;
 }
 
-bool SolvePosition(const GearJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const GearJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -37,6 +37,7 @@ namespace d2 {
 class Joint;
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Gear joint definition.
 /// @details A gear joint is used to connect two joints together. Either joint can be
@@ -143,7 +144,7 @@ constexpr bool ShiftOrigin(GearJointConf&, Length2) noexcept
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso GearJointConf
-void InitVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(GearJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -152,13 +153,13 @@ void InitVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso GearJointConf
-bool SolveVelocity(GearJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(GearJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso GearJointConf
-bool SolvePosition(const GearJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const GearJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for getting the ratio value of the given configuration.
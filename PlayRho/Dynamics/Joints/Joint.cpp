@@ -59,9 +59,9 @@ static_assert(std::is_nothrow_destructible<Joint>::value,
 
 // Free functions...
 
-BodyConstraint& At(std::vector<BodyConstraint>& container, BodyID key)
+BodyConstraint& At(BodyConstraintsMap container, BodyID key)
 {
-    return container.at(UnderlyingValue(key));
+    return container.at(key);
 }
 
 Length2 GetLocalAnchorA(const Joint& object)
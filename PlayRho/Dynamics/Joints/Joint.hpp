@@ -27,6 +27,7 @@
 #include <PlayRho/Dynamics/Joints/JointType.hpp>
 #include <PlayRho/Dynamics/Joints/LimitState.hpp>
 #include <PlayRho/Dynamics/BodyID.hpp>
+#include <PlayRho/Dynamics/Contacts/BodyConstraint.hpp> // for BodyConstraintsMap
 
 #include <memory> // for std::unique_ptr
 #include <vector>
@@ -41,7 +42,6 @@ struct ConstraintSolverConf;
 namespace d2 {
 
 class Joint;
-class BodyConstraint;
 
 /// @brief Gets the identifier of the type of data this can be casted to.
 JointType GetType(const Joint& object) noexcept;
@@ -64,7 +64,7 @@ bool ShiftOrigin(Joint& object, Length2 value) noexcept;
 /// @brief Initializes velocity constraint data based on the given solver data.
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
-void InitVelocity(Joint& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(Joint& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -72,12 +72,12 @@ void InitVelocity(Joint& object, std::vector<BodyConstraint>& bodies,
 /// @pre <code>InitVelocity</code> has been called.
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
-bool SolveVelocity(Joint& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(Joint& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
-bool SolvePosition(const Joint& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const Joint& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @defgroup JointsGroup Joint Classes
@@ -93,7 +93,7 @@ class Joint
 {
 public:
     /// @brief Body constraints map type alias.
-    using BodyConstraintsMap = std::vector<BodyConstraint>;
+    using BodyConstraintsMap = ::playrho::d2::BodyConstraintsMap;
 
     /// @brief Default constructor.
     Joint() noexcept = default;
@@ -186,20 +186,20 @@ public:
         return object.m_self? object.m_self->ShiftOrigin_(value): false;
     }
 
-    friend void InitVelocity(Joint& object, std::vector<BodyConstraint>& bodies,
+    friend void InitVelocity(Joint& object, BodyConstraintsMap bodies,
                              const playrho::StepConf& step,
                              const ConstraintSolverConf& conf)
     {
         if (object.m_self) object.m_self->InitVelocity_(bodies, step, conf);
     }
 
-    friend bool SolveVelocity(Joint& object, std::vector<BodyConstraint>& bodies,
+    friend bool SolveVelocity(Joint& object, BodyConstraintsMap bodies,
                               const playrho::StepConf& step)
     {
         return object.m_self? object.m_self->SolveVelocity_(bodies, step): false;
     }
 
-    friend bool SolvePosition(const Joint& object, std::vector<BodyConstraint>& bodies,
+    friend bool SolvePosition(const Joint& object, BodyConstraintsMap bodies,
                               const ConstraintSolverConf& conf)
     {
         return object.m_self? object.m_self->SolvePosition_(bodies, conf): false;
@@ -239,16 +239,16 @@ private:
         virtual bool ShiftOrigin_(Length2 value) noexcept = 0;
 
         /// @brief Initializes the velocities for this joint.
-        virtual void InitVelocity_(BodyConstraintsMap& bodies,
+        virtual void InitVelocity_(BodyConstraintsMap bodies,
                                    const playrho::StepConf& step,
                                    const ConstraintSolverConf& conf) = 0;
 
         /// @brief Solves the velocities for this joint.
-        virtual bool SolveVelocity_(BodyConstraintsMap& bodies,
+        virtual bool SolveVelocity_(BodyConstraintsMap bodies,
                                     const playrho::StepConf& step) = 0;
 
         /// @brief Solves the positions for this joint.
-        virtual bool SolvePosition_(BodyConstraintsMap& bodies,
+        virtual bool SolvePosition_(BodyConstraintsMap bodies,
                                     const ConstraintSolverConf& conf) const = 0;
     };
 
@@ -308,7 +308,7 @@ private:
         }
 
         /// @copydoc Concept::InitVelocity_
-        void InitVelocity_(BodyConstraintsMap& bodies,
+        void InitVelocity_(BodyConstraintsMap bodies,
                            const playrho::StepConf& step,
                            const ConstraintSolverConf& conf) override
         {
@@ -316,14 +316,14 @@ private:
         }
 
         /// @copydoc Concept::SolveVelocity_
-        bool SolveVelocity_(BodyConstraintsMap& bodies,
+        bool SolveVelocity_(BodyConstraintsMap bodies,
                             const playrho::StepConf& step) override
         {
             return SolveVelocity(data, bodies, step);
         }
 
         /// @copydoc Concept::SolvePosition_
-        bool SolvePosition_(BodyConstraintsMap& bodies,
+        bool SolvePosition_(BodyConstraintsMap bodies,
                             const ConstraintSolverConf& conf) const override
         {
             return SolvePosition(data, bodies, conf);
@@ -338,7 +338,8 @@ private:
 // Free functions...
 
 /// @brief Provides referenced access to the identified element of the given container.
-BodyConstraint& At(std::vector<BodyConstraint>& container, BodyID key);
+/// @throws std::out_of_range If the given container has no element for the given key.
+BodyConstraint& At(BodyConstraintsMap container, BodyID key);
 
 /// @brief Converts the given joint into its current configuration value.
 /// @note The design for this was based off the design of the C++17 <code>std::any</code>
@@ -79,7 +79,7 @@ MotorJointConf GetMotorJointConf(const World& world, BodyID bA, BodyID bB)
     };
 }
 
-void InitVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(MotorJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -162,7 +162,7 @@ void InitVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(MotorJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -238,7 +238,7 @@ bool SolveVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
     return solved;
 }
 
-bool SolvePosition(const MotorJointConf&, std::vector<BodyConstraint>&,
+bool SolvePosition(const MotorJointConf&, BodyConstraintsMap,
                    const ConstraintSolverConf&)
 {
     return true;
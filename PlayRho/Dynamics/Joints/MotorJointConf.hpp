@@ -36,6 +36,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Motor joint definition.
 /// @details A motor joint is used to control the relative motion between two bodies. A
@@ -149,7 +150,7 @@ constexpr auto ShiftOrigin(MotorJointConf&, Length2) noexcept
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso MotorJointConf
-void InitVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(MotorJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -158,13 +159,13 @@ void InitVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso MotorJointConf
-bool SolveVelocity(MotorJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(MotorJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso MotorJointConf
-bool SolvePosition(const MotorJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const MotorJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for getting the maximum force value of the given configuration.
@@ -151,7 +151,7 @@ AngularMomentum GetAngularReaction(const PrismaticJointConf& conf)
     return GetY(conf.impulse) * SquareMeter * Kilogram / (Second * Radian);
 }
 
-void InitVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(PrismaticJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf)
 {
@@ -285,7 +285,7 @@ void InitVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodie
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(PrismaticJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -410,7 +410,7 @@ bool SolveVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodi
 // We could take the active state from the velocity solver. However, the joint might push past the
 // limit when the velocity solver indicates the limit is inactive.
 //
-bool SolvePosition(const PrismaticJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const PrismaticJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -36,6 +36,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Prismatic joint definition.
 /// @details This joint provides one degree of freedom: translation along an axis fixed in
@@ -214,7 +215,7 @@ AngularMomentum GetAngularReaction(const PrismaticJointConf& conf);
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocityConstraints.
 /// @relatedalso PrismaticJointConf
-void InitVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(PrismaticJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -223,13 +224,13 @@ void InitVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodie
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso PrismaticJointConf
-bool SolveVelocity(PrismaticJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(PrismaticJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso PrismaticJointConf
-bool SolvePosition(const PrismaticJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const PrismaticJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for setting the maximum motor torque value of the given configuration.
@@ -84,7 +84,7 @@ PulleyJointConf GetPulleyJointConf(const World& world,
     };
 }
 
-void InitVelocity(PulleyJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(PulleyJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -147,7 +147,7 @@ void InitVelocity(PulleyJointConf& object, std::vector<BodyConstraint>& bodies,
 }
 
 bool SolveVelocity(PulleyJointConf& object,
-                   std::vector<BodyConstraint>& bodies, const StepConf&)
+                   BodyConstraintsMap bodies, const StepConf&)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
     auto& bodyConstraintB = At(bodies, GetBodyB(object));
@@ -179,7 +179,7 @@ bool SolveVelocity(PulleyJointConf& object,
 }
 
 bool SolvePosition(const PulleyJointConf& object,
-                   std::vector<BodyConstraint>& bodies,
+                   BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
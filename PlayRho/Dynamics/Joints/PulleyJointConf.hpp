@@ -36,6 +36,7 @@ namespace d2 {
 class Joint;
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Pulley joint definition.
 /// @details The pulley joint is connected to two bodies and two fixed ground points.
@@ -150,7 +151,7 @@ bool ShiftOrigin(PulleyJointConf& object, Length2 newOrigin) noexcept;
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso PulleyJointConf
-void InitVelocity(PulleyJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(PulleyJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -159,13 +160,13 @@ void InitVelocity(PulleyJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso PulleyJointConf
-bool SolveVelocity(PulleyJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(PulleyJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso PulleyJointConf
-bool SolvePosition(const PulleyJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const PulleyJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for getting the length A value of the given configuration.
@@ -136,7 +136,7 @@ AngularVelocity GetAngularVelocity(const World& world, const RevoluteJointConf&
          - GetVelocity(world, GetBodyA(conf)).angular;
 }
 
-void InitVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(RevoluteJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf)
 {
@@ -242,7 +242,7 @@ void InitVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodies
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(RevoluteJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -373,7 +373,7 @@ bool SolveVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodie
     return true;
 }
 
-bool SolvePosition(const RevoluteJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const RevoluteJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -36,6 +36,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Revolute joint definition.
 /// @details A revolute joint constrains two bodies to share a common point while they
@@ -212,7 +213,7 @@ constexpr AngularMomentum GetAngularReaction(const RevoluteJointConf& conf) noex
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocityConstraints.
 /// @relatedalso RevoluteJointConf
-void InitVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(RevoluteJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -221,13 +222,13 @@ void InitVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodies
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso RevoluteJointConf
-bool SolveVelocity(RevoluteJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(RevoluteJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso RevoluteJointConf
-bool SolvePosition(const RevoluteJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const RevoluteJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for setting the angular limits of the given configuration.
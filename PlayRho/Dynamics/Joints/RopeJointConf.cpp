@@ -56,7 +56,7 @@ RopeJointConf GetRopeJointConf(const Joint& joint) noexcept
 // K = J * invM * JT
 //   = invMassA + invIA * cross(rA, u)^2 + invMassB + invIB * cross(rB, u)^2
 
-void InitVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(RopeJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf)
 {
@@ -131,7 +131,7 @@ void InitVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(RopeJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -169,7 +169,7 @@ bool SolveVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
     return localImpulse == 0_Ns;
 }
 
-bool SolvePosition(const RopeJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const RopeJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -37,6 +37,7 @@ namespace d2 {
 class Joint;
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Rope joint definition.
 /// @details A rope joint enforces a maximum distance between two points on two bodies.
@@ -121,7 +122,7 @@ constexpr auto ShiftOrigin(RopeJointConf&, Length2) noexcept
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso RopeJointConf
-void InitVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(RopeJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -130,13 +131,13 @@ void InitVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso RopeJointConf
-bool SolveVelocity(RopeJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(RopeJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso RopeJointConf
-bool SolvePosition(const RopeJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const RopeJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for getting the maximum length value of the given configuration.
@@ -77,7 +77,7 @@ Mass22 GetEffectiveMassMatrix(const TargetJointConf& object, const BodyConstrain
 // Identity used:
 // w k % (rx i + ry j) = w * (-ry i + rx j)
 
-void InitVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(TargetJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step, const ConstraintSolverConf&)
 {
     auto& bodyConstraintB = At(bodies, GetBodyB(object));
@@ -135,7 +135,7 @@ void InitVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(TargetJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintB = At(bodies, GetBodyB(object));
@@ -168,7 +168,7 @@ bool SolveVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
     return incImpulse == Momentum2{};
 }
 
-bool SolvePosition(const TargetJointConf&, std::vector<BodyConstraint>&,
+bool SolvePosition(const TargetJointConf&, BodyConstraintsMap,
                    const ConstraintSolverConf&)
 {
     return true;
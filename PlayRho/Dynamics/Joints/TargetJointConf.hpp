@@ -34,6 +34,7 @@ struct StepConf;
 namespace d2 {
 
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Target joint definition.
 /// @details A target joint is used to make a point on a body track a specified world point.
@@ -176,7 +177,7 @@ Mass22 GetEffectiveMassMatrix(const TargetJointConf& object, const BodyConstrain
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso TargetJointConf
-void InitVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(TargetJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -185,13 +186,13 @@ void InitVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso TargetJointConf
-bool SolveVelocity(TargetJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(TargetJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso TargetJointConf
-bool SolvePosition(const TargetJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const TargetJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for setting the target value of the given configuration.
@@ -120,7 +120,7 @@ WeldJointConf GetWeldJointConf(const World& world, BodyID bodyA, BodyID bodyB, c
     };
 }
 
-void InitVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(WeldJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -222,7 +222,7 @@ void InitVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @pre <code>InitVelocity</code> has been called.
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
-bool SolveVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(WeldJointConf& object, BodyConstraintsMap bodies,
                    const StepConf&)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -302,7 +302,7 @@ bool SolveVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
-bool SolvePosition(const WeldJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const WeldJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -35,6 +35,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Weld joint definition.
 /// @note A weld joint essentially glues two bodies together. A weld joint may
@@ -140,7 +141,7 @@ constexpr auto ShiftOrigin(WeldJointConf&, Length2) noexcept
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso WeldJointConf
-void InitVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(WeldJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -149,13 +150,13 @@ void InitVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso WeldJointConf
-bool SolveVelocity(WeldJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(WeldJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso WeldJointConf
-bool SolvePosition(const WeldJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const WeldJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Free function for setting the frequency of the given configuration.
@@ -88,7 +88,7 @@ AngularVelocity GetAngularVelocity(const World& world, const WheelJointConf& con
          - GetVelocity(world, GetBodyA(conf)).angular;
 }
 
-void InitVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(WheelJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf&)
 {
@@ -215,7 +215,7 @@ void InitVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
     bodyConstraintB.SetVelocity(velB);
 }
 
-bool SolveVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(WheelJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
@@ -286,7 +286,7 @@ bool SolveVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
     return true;
 }
 
-bool SolvePosition(const WheelJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const WheelJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf)
 {
     auto& bodyConstraintA = At(bodies, GetBodyA(object));
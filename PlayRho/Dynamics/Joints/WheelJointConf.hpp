@@ -35,6 +35,7 @@ namespace d2 {
 
 class World;
 class BodyConstraint;
+class BodyConstraintsMap;
 
 /// @brief Wheel joint definition.
 /// @details This joint provides two degrees of freedom: translation along an axis fixed
@@ -175,7 +176,7 @@ constexpr auto ShiftOrigin(WheelJointConf&, Length2)
 /// @note This MUST be called prior to calling <code>SolveVelocity</code>.
 /// @see SolveVelocity.
 /// @relatedalso WheelJointConf
-void InitVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
+void InitVelocity(WheelJointConf& object, BodyConstraintsMap bodies,
                   const StepConf& step,
                   const ConstraintSolverConf& conf);
 
@@ -184,13 +185,13 @@ void InitVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
 /// @see InitVelocity.
 /// @return <code>true</code> if velocity is "solved", <code>false</code> otherwise.
 /// @relatedalso WheelJointConf
-bool SolveVelocity(WheelJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolveVelocity(WheelJointConf& object, BodyConstraintsMap bodies,
                    const StepConf& step);
 
 /// @brief Solves the position constraint.
 /// @return <code>true</code> if the position errors are within tolerance.
 /// @relatedalso WheelJointConf
-bool SolvePosition(const WheelJointConf& object, std::vector<BodyConstraint>& bodies,
+bool SolvePosition(const WheelJointConf& object, BodyConstraintsMap bodies,
                    const ConstraintSolverConf& conf);
 
 /// @brief Sets the maximum motor torque for the given configuration.
@@ -37,7 +37,7 @@ namespace playrho {
 /// the values have defaults. These defaults are intended to most likely be the values desired.
 /// @note Be sure to confirm that the delta time (the time-per-step i.e. <code>deltaTime</code>)
 ///   is correct for your use.
-/// @note This data structure is 104-bytes large (with 4-byte Real on at least one 64-bit platform).
+/// @note This data structure is 108-bytes large (with 4-byte Real on at least one 64-bit platform).
 /// @see World::Step.
 struct StepConf
 {
@@ -206,6 +206,25 @@ struct StepConf
     /// @note Should be greater than 0.
     Length aabbExtension = DefaultAabbExtension;
 
+    /// @brief AABB extension steps.
+    /// @details When greater than zero, the AABB extension applied to the proxies of a
+    ///   moving body is this many times that body's recent per-step distance moved -
+    ///   clamped to the range of <code>minAabbExtension</code> to
+    ///   <code>maxAabbExtension</code> - rather than <code>aabbExtension</code>. This
+    ///   gives slowly moving bodies tighter AABBs, for fewer false pairs, and faster
+    ///   moving bodies looser AABBs, for fewer broad-phase updates.
+    /// @note Zero disables this velocity based extension.
+    /// @see minAabbExtension, maxAabbExtension.
+    Real aabbExtensionSteps = 0;
+
+    /// @brief Minimum AABB extension that a body's velocity based extension can be.
+    /// @see aabbExtensionSteps.
+    Length minAabbExtension = DefaultAabbExtension / Real{4};
+
+    /// @brief Maximum AABB extension that a body's velocity based extension can be.
+    /// @see aabbExtensionSteps.
+    Length maxAabbExtension = DefaultAabbExtension * Real{16};
+
     /// @brief Max. circles ratio.
     /// @details When the ratio of the closest face's length to the vertex radius is
     ///   more than this amount, then face-manifolds are forced, else circles-manifolds
@@ -213,6 +232,32 @@ struct StepConf
     /// @note This is used in the calculation of new contact manifolds.
     Real maxCirclesRatio = DefaultCirclesRatio;
 
+    /// @brief Manifold reuse distance.
+    /// @details When greater than zero, the manifold of a touching contact is reused - rather
+    ///   than recomputed - while the position of its second body relative to its first body
+    ///   stays less than this distance away from where it was when the manifold was last
+    ///   computed and while their relative angle stays less than
+    ///   <code>manifoldReuseAngle</code> away from what it was then too.
+    /// @note Manifolds are in the bodies' local coordinates so reused ones still get
+    ///   re-projected by the bodies' current transformations.
+    /// @note Zero disables reusing manifolds.
+    /// @note Used in the regular phase of step processing.
+    /// @see manifoldReuseAngle.
+    Length manifoldReuseDistance = 0_m;
+
+    /// @brief Manifold reuse angle.
+    /// @note Should be between zero and Pi * Radian. Zero disables reusing manifolds.
+    /// @see manifoldReuseDistance.
+    Angle manifoldReuseAngle = 0_deg;
+
+    /// @brief Tree optimize budget.
+    /// @details Maximum number of broad-phase tree nodes to visit per step for incrementally
+    ///   optimizing the tree. Each step resumes from where the previous one left off. Zero
+    ///   disables this optimizing.
+    /// @note This doesn't change which contacts are found. It only keeps finding them fast.
+    /// @see DynamicTree::Optimize.
+    ContactCounter treeOptimizeBudget = 0;
+
     /// @brief Regular velocity iterations.
     /// @details The number of iterations of velocity resolution that will be done in the step.
     /// @note Used in the regular phase of step processing.
@@ -280,6 +325,22 @@ struct StepConf
 
     /// @brief Do the block-solve algorithm.
     bool doBlocksolve = true;
+
+    /// @brief Do the wide-solve algorithm.
+    /// @details Whether or not to solve the contact velocity constraints of islands with
+    ///   enough contacts for their constraints to get solved by colour a batch at a time.
+    ///   The constraints of a batch are of the same colour so they've no movable bodies in
+    ///   common and can be solved all at once using SIMD instructions where available.
+    /// @note Used in the regular phase of step processing.
+    /// @see WorldConf::colorConstraints, GaussSeidel::SolveVelocityConstraints.
+    bool doWideSolve = false;
+
+    /// @brief Do false pair statistics.
+    /// @details Whether or not to count the contacts found whose fixture children's AABBs
+    ///   don't overlap. That's two AABB computations per contact added.
+    /// @note Used in the pre and regular phases of step processing.
+    /// @see PreStepStats::falsePairs, RegStepStats::falsePairs.
+    bool doFalsePairStats = false;
 };
 
 /// @brief Gets the maximum regular linear correction from the given value.
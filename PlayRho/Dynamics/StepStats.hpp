@@ -26,7 +26,8 @@
 namespace playrho {
 
 /// @brief Pre-phase per-step statistics.
-/// @note This data structure is 24-bytes large (on at least one 64-bit platform).
+/// @note This data structure is 56-bytes large (on at least one 64-bit platform with
+///   4-byte Real type).
 struct PreStepStats
 {
     /// @brief Counter type.
@@ -38,10 +39,29 @@ struct PreStepStats
     counter_type ignored = 0; ///< Count of contacts ignored during update processing.
     counter_type updated = 0; ///< Count of contacts updated (during update processing).
     counter_type skipped = 0; ///< Count of contacts Skipped (during update processing).
+    counter_type reused = 0; ///< Count of contacts updated by reusing their manifolds.
+    counter_type treeNodesVisited = 0; ///< Count of tree nodes visited by the optimizer.
+    counter_type treeRebuilds = 0; ///< Count of subtrees rebuilt by the optimizer.
+    counter_type treeHeight = 0; ///< Height of the broad-phase tree.
+
+    /// @brief Count of proxies synchronized that still fit in their broad-phase AABBs.
+    counter_type updatesAvoided = 0;
+
+    /// @brief Count of contacts added whose fixture children's AABBs don't overlap.
+    /// @note These are pairs only found due to the extension of the broad-phase AABBs.
+    /// @note Only counted when <code>StepConf::doFalsePairStats</code> is set.
+    counter_type falsePairs = 0;
+
+    /// @brief Max imbalance of the broad-phase tree as of the optimizer's last full sweep.
+    counter_type treeMaxImbalance = 0;
+
+    /// @brief Perimeter ratio of the broad-phase tree as of the optimizer's last full sweep.
+    /// @see ComputePerimeterRatio(const DynamicTree&).
+    Real treePerimeterRatio = 0;
 };
 
 /// @brief Regular-phase per-step statistics.
-/// @note This data structure is 32-bytes large (on at least one 64-bit platform with
+/// @note This data structure is 40-bytes large (on at least one 64-bit platform with
 ///   4-byte Real type).
 struct RegStepStats
 {
@@ -59,12 +79,14 @@ struct RegStepStats
     counter_type contactsAdded = 0; ///< Contacts added count.
     counter_type bodiesSlept = 0; ///< Bodies slept count.
     counter_type proxiesMoved = 0; ///< Proxies moved count.
+    counter_type updatesAvoided = 0; ///< Proxies synchronized but not moved count.
+    counter_type falsePairs = 0; ///< Contacts added with non-overlapping AABBs count (if counted).
     counter_type sumPosIters = 0; ///< Sum of the position iterations.
     counter_type sumVelIters = 0; ///< Sum of the velocity iterations.
 };
 
 /// @brief TOI-phase per-step statistics.
-/// @note This data structure is 60-bytes large (on at least one 64-bit platform with
+/// @note This data structure is 72-bytes large (on at least one 64-bit platform with
 ///   4-byte Real type).
 struct ToiStepStats
 {
@@ -90,6 +112,20 @@ struct ToiStepStats
     counter_type sumVelIters = 0; ///< Sum velocity iterations count.
     counter_type maxSimulContacts = 0; ///< Max contacts occurring simultaneously.
 
+    /// @brief Sum of distance iterations.
+    /// @note Dividing this by <code>sumToiIters</code> gives the average number of
+    ///   iterations per distance calculation.
+    counter_type sumDistIters = 0;
+
+    /// @brief Sum of TOI iterations.
+    /// @note Dividing this by <code>contactsUpdatedToi</code> gives the average number
+    ///   of iterations per time of impact calculation.
+    counter_type sumToiIters = 0;
+
+    /// @brief Count of events solved in batches of more than one event.
+    /// @see WorldConf::threads, WorldConf::toiBatchWindow.
+    counter_type eventsBatched = 0;
+
     /// @brief Distance iteration type.
     using dist_iter_type = std::remove_const<decltype(DefaultMaxDistanceIters)>::type;
 
@@ -102,12 +138,16 @@ struct ToiStepStats
     dist_iter_type maxDistIters = 0; ///< Max distance iterations.
     toi_iter_type maxToiIters = 0; ///< Max TOI iterations.
     root_iter_type maxRootIters = 0; ///< Max root iterations.
+
+    /// @brief Max number of threads that the events of a batch got split among.
+    /// @see WorldConf::threads, WorldConf::toiBatchWindow.
+    std::uint8_t maxBatchThreads = 0;
 };
 
 /// @brief Per-step statistics.
 ///
 /// @details These are statistics output from the <code>d2::World::Step</code> method.
-/// @note This data structure is 116-bytes large (on at least one 64-bit platform with
+/// @note This data structure is 168-bytes large (on at least one 64-bit platform with
 ///   4-byte Real type).
 /// @note Efficient transfer of this data is predicated on compiler support for
 ///   "named-return-value-optimization" (N.R.V.O.) - a form of "copy elision".
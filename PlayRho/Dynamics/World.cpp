@@ -223,6 +223,16 @@ const DynamicTree& World::GetTree() const noexcept
     return ::playrho::d2::GetTree(*m_impl);
 }
 
+const BroadPhase& World::GetBroadPhase() const noexcept
+{
+    return ::playrho::d2::GetBroadPhase(*m_impl);
+}
+
+const DynamicTree& World::GetStaticTree() const noexcept
+{
+    return ::playrho::d2::GetStaticTree(*m_impl);
+}
+
 Filter World::GetFilterData(FixtureID id) const
 {
     return ::playrho::d2::GetFilterData(*m_impl, id);
@@ -63,6 +63,7 @@ class WorldImpl;
 class Manifold;
 class ContactImpulsesList;
 class DynamicTree;
+class BroadPhase;
 struct JointConf;
 
 /// @defgroup PhysicalEntities Physical Entities
@@ -290,8 +291,20 @@ public:
     void SetSubStepping(bool flag) noexcept;
 
     /// @brief Gets access to the broad-phase dynamic tree information.
+    /// @note This is an empty tree if the world's broad-phase isn't a dynamic tree.
+    /// @see GetBroadPhase, WorldConf::broadPhaseType
     const DynamicTree& GetTree() const noexcept;
 
+    /// @brief Gets access to the broad-phase.
+    /// @see WorldConf::broadPhaseType
+    const BroadPhase& GetBroadPhase() const noexcept;
+
+    /// @brief Gets access to the dynamic tree of static proxies.
+    /// @note This is an empty tree unless the world was configured to keep a separate
+    ///   static tree.
+    /// @see WorldConf::separateStaticTree
+    const DynamicTree& GetStaticTree() const noexcept;
+
     /// @brief Is the world locked (in the middle of a time step).
     bool IsLocked() const noexcept;
 
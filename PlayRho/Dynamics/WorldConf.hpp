@@ -25,6 +25,7 @@
 /// Declarations of the WorldConf class.
 
 #include <PlayRho/Common/Positive.hpp>
+#include <PlayRho/Collision/BroadPhaseType.hpp>
 
 namespace playrho {
 namespace d2 {
@@ -41,6 +42,27 @@ struct WorldConf
     /// @brief Uses the given value as the initial dynamic tree size.
     constexpr WorldConf& UseInitialTreeSize(ContactCounter value) noexcept;
 
+    /// @brief Uses the given value as the number of threads to step the world with.
+    constexpr WorldConf& UseThreads(std::uint8_t value) noexcept;
+
+    /// @brief Uses the given value as the number of contacts per update chunk.
+    constexpr WorldConf& UseUpdateContactsChunkSize(Positive<ContactCounter> value) noexcept;
+
+    /// @brief Uses the given value for whether to solve big islands' constraints by colour.
+    constexpr WorldConf& UseColorConstraints(bool value) noexcept;
+
+    /// @brief Uses the given value as the time window of batched TOI events.
+    constexpr WorldConf& UseToiBatchWindow(Real value) noexcept;
+
+    /// @brief Uses the given type of broad-phase.
+    constexpr WorldConf& UseBroadPhaseType(BroadPhaseType value) noexcept;
+
+    /// @brief Uses the given value as the cell size of the hash grid broad-phase.
+    constexpr WorldConf& UseHashGridCellSize(Positive<Length> value) noexcept;
+
+    /// @brief Uses the given value for whether static proxies get their own tree.
+    constexpr WorldConf& UseSeparateStaticTree(bool value) noexcept;
+
     /// @brief Minimum vertex radius.
     /// @details This is the minimum vertex radius that this world establishes which bodies
     ///    shall allow fixtures to be created with. Trying to create a fixture with a shape
@@ -62,6 +84,73 @@ struct WorldConf
 
     /// @brief Initial tree size.
     ContactCounter initialTreeSize = 4096;
+
+    /// @brief Number of threads to step the world with.
+    /// @details This is the maximum number of threads that the work of stepping the world
+    ///   gets split among. That's finding new contacts, updating contacts, solving the
+    ///   islands of the regular phase, solving the constraints of a colour, and solving
+    ///   batched time of impact (TOI) events. These never run at the same time so they all
+    ///   share one pool of threads. The extra threads get started with the world and stay
+    ///   around for its lifetime. Values less than two keep all of the work on the calling
+    ///   thread.
+    /// @note The results are the same regardless of this value. So is the order that the
+    ///   contact listeners get called in, except that with more than one thread the
+    ///   listeners of updated contacts get called after all of the contacts needing
+    ///   updating have been updated rather than as each one is, and that the listeners of
+    ///   batched TOI events get called a batch at a time.
+    /// @see updateContactsChunkSize, colorConstraints, toiBatchWindow.
+    std::uint8_t threads = 1;
+
+    /// @brief Number of contacts that threads updating contacts take at a time.
+    /// @details Smaller chunks balance the work between threads better while larger ones
+    ///   have less overhead. This also sets the minimum number of contacts needing updating
+    ///   per thread used.
+    /// @see threads.
+    Positive<ContactCounter> updateContactsChunkSize = ContactCounter{64};
+
+    /// @brief Whether to solve the contact constraints of big islands colour by colour.
+    /// @details The contact constraints of islands with lots of contacts then get split
+    ///   into colours such that no two constraints of a colour share a body that they can
+    ///   move. The colours get solved one after another but each colour's constraints can
+    ///   be solved concurrently. This is for worlds where most bodies end up in one giant
+    ///   island, like big pyramids or piles, which solving islands concurrently doesn't help.
+    /// @note Solving constraints in a different order gives slightly different results than
+    ///   solving them one at a time. The results are the same regardless of
+    ///   <code>threads</code> however.
+    /// @see threads.
+    bool colorConstraints = false;
+
+    /// @brief Time window of batched time of impact (TOI) events.
+    /// @details With more than one thread, TOI events get batched together when their
+    ///   times of impact are within this fraction of the step after the soonest one's. A
+    ///   batch stops at the first event whose bodies, or the AABBs of their proxies, overlap
+    ///   those of the events before it. The islands of a batch's events get solved
+    ///   concurrently. Larger windows make for bigger batches but for more time spent
+    ///   looking for them. A window of zero only batches events with the same time of
+    ///   impact.
+    /// @note The results with batching are the same as without since the events of a
+    ///   batch can't come into contact with each other.
+    /// @see threads.
+    Real toiBatchWindow = Real{1} / Real{16};
+
+    /// @brief Type of broad-phase to use.
+    /// @note The <code>initialTreeSize</code> setting only applies to the dynamic tree.
+    BroadPhaseType broadPhaseType = BroadPhaseType::DynamicTree;
+
+    /// @brief Cell size of the hash grid broad-phase.
+    /// @details This is best set to around the size of the fattened AABBs of the
+    ///   world's typical shapes.
+    /// @note Only applies when the broad-phase type is <code>BroadPhaseType::HashGrid</code>.
+    Positive<Length> hashGridCellSize = 2_m;
+
+    /// @brief Whether the proxies of static bodies go in a separate tree.
+    /// @details When set, the fixtures of static bodies get their proxies in a dynamic tree
+    ///   of their own instead of in the broad-phase. That tree only changes when static
+    ///   geometry is added, removed, or moved. Moving proxies then get queried against both
+    ///   while pairs of static proxies never get looked for.
+    /// @note Worlds with lots of static geometry, like big levels, benefit the most.
+    /// @see World::GetStaticTree.
+    bool separateStaticTree = false;
 };
 
 constexpr WorldConf& WorldConf::UseMinVertexRadius(Positive<Length> value) noexcept
@@ -82,6 +171,48 @@ constexpr WorldConf& WorldConf::UseInitialTreeSize(ContactCounter value) noexcep
     return *this;
 }
 
+constexpr WorldConf& WorldConf::UseThreads(std::uint8_t value) noexcept
+{
+    threads = value;
+    return *this;
+}
+
+constexpr WorldConf& WorldConf::UseUpdateContactsChunkSize(Positive<ContactCounter> value) noexcept
+{
+    updateContactsChunkSize = value;
+    return *this;
+}
+
+constexpr WorldConf& WorldConf::UseColorConstraints(bool value) noexcept
+{
+    colorConstraints = value;
+    return *this;
+}
+
+constexpr WorldConf& WorldConf::UseToiBatchWindow(Real value) noexcept
+{
+    toiBatchWindow = value;
+    return *this;
+}
+
+constexpr WorldConf& WorldConf::UseBroadPhaseType(BroadPhaseType value) noexcept
+{
+    broadPhaseType = value;
+    return *this;
+}
+
+constexpr WorldConf& WorldConf::UseHashGridCellSize(Positive<Length> value) noexcept
+{
+    hashGridCellSize = value;
+    return *this;
+}
+
+constexpr WorldConf& WorldConf::UseSeparateStaticTree(bool value) noexcept
+{
+    separateStaticTree = value;
+    return *this;
+}
+
 /// Gets the default definitions value.
 /// @note This method exists as a work-around for providing the World constructor a default
 ///   value without otherwise getting a compiler error such as:
@@ -52,6 +52,9 @@
 #include <PlayRho/Collision/TimeOfImpact.hpp>
 #include <PlayRho/Collision/RayCastOutput.hpp>
 #include <PlayRho/Collision/DistanceProxy.hpp>
+#include <PlayRho/Collision/SweepAndPrune.hpp>
+#include <PlayRho/Collision/WideDynamicTree.hpp>
+#include <PlayRho/Collision/HashGrid.hpp>
 
 #include <PlayRho/Common/LengthError.hpp>
 #include <PlayRho/Common/DynamicMemory.hpp>
@@ -61,6 +64,7 @@
 #include <algorithm>
 #include <new>
 #include <functional>
+#include <future>
 #include <type_traits>
 #include <memory>
 #include <set>
@@ -70,11 +74,6 @@
 #include <atomic>
 #endif
 
-//#define DO_THREADED
-#if defined(DO_THREADED)
-#include <future>
-#endif
-
 using std::for_each;
 using std::remove;
 using std::sort;
@@ -112,6 +111,8 @@ struct WorldImpl::ContactUpdateConf
 {
     DistanceConf distance; ///< Distance configuration data.
     Manifold::Conf manifold; ///< Manifold configuration data.
+    Length reuseDistance = 0_m; ///< Manifold reuse distance. Zero for no reusing.
+    Real reuseCosine = 1; ///< Cosine of the manifold reuse angle.
 };
 
 namespace {
@@ -177,25 +178,36 @@ inline void WarmStartVelocities(const VelocityConstraints& velConstraints)
     });
 }
 
-BodyConstraints GetBodyConstraints(const Island::Bodies& bodies,
-                                   const ArrayAllocator<Body>& bodyBuffer,
-                                   Time h, MovementConf conf)
+/// @brief Gets the island-local body constraints for the given bodies.
+/// @details Fills the given buffer with the constraints of the given bodies in their order
+///   and with their island-local indices. This takes time proportional to the number of
+///   the given bodies and not to the number of bodies in the world.
+BodyConstraintsMap GetBodyConstraints(const Island::Bodies& bodies,
+                                      const ArrayAllocator<Body>& bodyBuffer,
+                                      Time h, MovementConf conf,
+                                      WorldImpl::BodyConstraintsBuffer& buffer)
 {
-    auto constraints = std::vector<BodyConstraint>{};
-    constraints.resize(size(bodyBuffer));
+    auto& constraints = buffer.constraints;
+    auto& indices = buffer.indices;
+    constraints.clear();
+    constraints.reserve(size(bodies));
+    if (size(indices) < size(bodyBuffer))
+    {
+        indices.resize(size(bodyBuffer));
+    }
     for (const auto& id : bodies)
     {
-        constraints[UnderlyingValue(id)] =
-            GetBodyConstraint(bodyBuffer[UnderlyingValue(id)], h, conf);
+        indices[UnderlyingValue(id)] = static_cast<BodyCounter>(size(constraints));
+        constraints.push_back(GetBodyConstraint(bodyBuffer[UnderlyingValue(id)], h, conf));
     }
-    return constraints;
+    return BodyConstraintsMap{constraints, bodies, indices};
 }
 
 PositionConstraints GetPositionConstraints(const Island::Contacts& contacts,
                                            const ArrayAllocator<Fixture>& fixtureBuffer,
                                            const ArrayAllocator<Contact>& contactBuffer,
                                            const ArrayAllocator<Manifold>& manifoldBuffer,
-                                           BodyConstraints& bodies)
+                                           BodyConstraintsMap bodies)
 {
     auto constraints = PositionConstraints{};
     constraints.reserve(size(contacts));
@@ -211,8 +223,8 @@ PositionConstraints GetPositionConstraints(const Island::Contacts& contacts,
         const auto bodyB = GetBodyB(contact);
         const auto shapeA = fixtureBuffer[UnderlyingValue(fixtureA)].GetShape();
         const auto shapeB = fixtureBuffer[UnderlyingValue(fixtureB)].GetShape();
-        auto& bodyConstraintA = bodies[UnderlyingValue(bodyA)];
-        auto& bodyConstraintB = bodies[UnderlyingValue(bodyB)];
+        auto& bodyConstraintA = bodies[bodyA];
+        auto& bodyConstraintB = bodies[bodyB];
         const auto radiusA = GetVertexRadius(shapeA, indexA);
         const auto radiusB = GetVertexRadius(shapeB, indexB);
         return PositionConstraint{
@@ -233,7 +245,7 @@ VelocityConstraints GetVelocityConstraints(const Island::Contacts& contacts,
                                            const ArrayAllocator<Fixture>& fixtureBuffer,
                                            const ArrayAllocator<Contact>& contactBuffer,
                                            const ArrayAllocator<Manifold>& manifoldBuffer,
-                                           BodyConstraints& bodies,
+                                           BodyConstraintsMap bodies,
                                            const VelocityConstraint::Conf conf)
 {
     auto velConstraints = VelocityConstraints{};
@@ -253,8 +265,8 @@ VelocityConstraints GetVelocityConstraints(const Island::Contacts& contacts,
         const auto shapeA = fixtureBuffer[UnderlyingValue(fixtureA)].GetShape();
         const auto bodyB = fixtureBuffer[UnderlyingValue(fixtureB)].GetBody();
         const auto shapeB = fixtureBuffer[UnderlyingValue(fixtureB)].GetShape();
-        auto& bodyConstraintA = bodies[UnderlyingValue(bodyA)];
-        auto& bodyConstraintB = bodies[UnderlyingValue(bodyB)];
+        auto& bodyConstraintA = bodies[bodyA];
+        auto& bodyConstraintB = bodies[bodyB];
         const auto radiusA = GetVertexRadius(shapeA, indexA);
         const auto radiusB = GetVertexRadius(shapeB, indexB);
         const auto xfA = GetTransformation(bodyConstraintA.GetPosition(),
@@ -305,6 +317,198 @@ Length SolvePositionConstraintsViaGS(PositionConstraints& posConstraints,
     return minSeparation;
 }
 
+/// @brief Minimum number of contacts of islands that get solved by colour.
+/// @details Colouring the constraints of smaller islands costs more than it saves.
+/// @see WorldConf::colorConstraints.
+constexpr auto MinColoredContacts = ContactCounter{128};
+
+/// @brief Number of constraints of a colour that threads take at a time.
+/// @details This also sets the minimum number of constraints of a colour per thread used.
+constexpr auto ColoredConstraintsChunkSize = std::size_t{64};
+
+/// @brief Number of colours that constraints get split into before the overflow colour.
+/// @details Each is a bit of a body's colours taken.
+/// @see WorldImpl::ConstraintColors.
+constexpr auto MaxConstraintColors = std::size_t{64};
+
+/// @brief Colours the given velocity constraints.
+/// @details Constraints get the least colour that none of the others of their movable
+///   bodies have. Those that can't get one of the <code>MaxConstraintColors</code>
+///   colours get the overflow colour after them.
+/// @param velConstraints Constraints to colour.
+/// @param bodies Island's body constraints that the constraints refer to.
+/// @param[out] colors Colouring of the constraints.
+void ColorConstraints(const VelocityConstraints& velConstraints,
+                      const std::vector<BodyConstraint>& bodies,
+                      WorldImpl::ConstraintColors& colors)
+{
+    const auto numConstraints = size(velConstraints);
+    colors.bodyColors.assign(size(bodies), 0u);
+    colors.colors.resize(numConstraints);
+    colors.offsets.assign(MaxConstraintColors + 2u, 0u);
+    for (auto i = decltype(numConstraints){0}; i < numConstraints; ++i)
+    {
+        const auto& vc = velConstraints[i];
+        const auto indexA = static_cast<std::size_t>(vc.GetBodyA() - data(bodies));
+        const auto indexB = static_cast<std::size_t>(vc.GetBodyB() - data(bodies));
+        const auto movableA = IsMovable(*vc.GetBodyA());
+        const auto movableB = IsMovable(*vc.GetBodyB());
+        const auto taken = (movableA? colors.bodyColors[indexA]: 0u) |
+                           (movableB? colors.bodyColors[indexB]: 0u);
+        auto color = std::size_t{0};
+        while ((color < MaxConstraintColors) && ((taken & (std::uint64_t{1} << color)) != 0u))
+        {
+            ++color;
+        }
+        if (color < MaxConstraintColors)
+        {
+            const auto bit = std::uint64_t{1} << color;
+            colors.bodyColors[indexA] |= movableA? bit: 0u;
+            colors.bodyColors[indexB] |= movableB? bit: 0u;
+        }
+        colors.colors[i] = static_cast<std::uint8_t>(color);
+        ++colors.offsets[color + 1u];
+    }
+
+    // Groups the constraints by colour keeping them in order within their groups.
+    for (auto color = std::size_t{0}; color <= MaxConstraintColors; ++color)
+    {
+        colors.offsets[color + 1u] += colors.offsets[color];
+    }
+    colors.constraints.resize(numConstraints);
+    auto next = std::vector<std::size_t>(cbegin(colors.offsets), cend(colors.offsets) - 1);
+    for (auto i = decltype(numConstraints){0}; i < numConstraints; ++i)
+    {
+        colors.constraints[next[colors.colors[i]]++] = i;
+    }
+}
+
+/// @brief Calls the given function for every batch of constraints of the identified colour.
+/// @details The constraints of all but the overflow colour get split among the given
+///   pool's threads which take chunks of them at a time till there are none left. The
+///   overflow colour's constraints get batched one at a time since they can have movable
+///   bodies in common.
+/// @param batchSize Maximum number of constraints per batch. Must divide
+///   <code>ColoredConstraintsChunkSize</code>.
+/// @param function Function to call with the indices of a batch's constraints, the
+///   number of them, and the index of the thread calling it.
+template <class Function>
+void ForEachBatchOfColor(const WorldImpl::ConstraintColors& colors, std::size_t color,
+                         std::size_t batchSize, ThreadPool& pool, const Function& function)
+{
+    assert((batchSize > 0u) && ((ColoredConstraintsChunkSize % batchSize) == 0u));
+    const auto first = colors.offsets[color];
+    const auto count = colors.offsets[color + 1u] - first;
+    const auto numChunks = (count + ColoredConstraintsChunkSize - 1u) / ColoredConstraintsChunkSize;
+    const auto numThreads = std::min(pool.GetWorkers() + 1u, numChunks);
+    if (color == MaxConstraintColors)
+    {
+        batchSize = 1u;
+    }
+    const auto forEachBatch = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+        for (auto j = begin; j < end; j += batchSize)
+        {
+            function(&colors.constraints[j], std::min(batchSize, end - j), thread);
+        }
+    };
+    if ((color == MaxConstraintColors) || (numThreads < 2u))
+    {
+        forEachBatch(first, first + count, std::size_t{0});
+        return;
+    }
+    auto nextChunk = std::atomic<std::size_t>{0};
+    for (auto i = decltype(numThreads){0}; i < numThreads; ++i)
+    {
+        pool.Push([&](std::size_t thread) {
+            for (auto chunk = nextChunk.fetch_add(1); chunk < numChunks;
+                 chunk = nextChunk.fetch_add(1))
+            {
+                const auto begin = first + chunk * ColoredConstraintsChunkSize;
+                const auto end = std::min(begin + ColoredConstraintsChunkSize, first + count);
+                forEachBatch(begin, end, thread);
+            }
+        });
+    }
+    pool.Wait();
+}
+
+/// @brief Calls the given function for every constraint of the identified colour.
+/// @param function Function to call with the index of a constraint and the index of the
+///   thread calling it.
+/// @see ForEachBatchOfColor.
+template <class Function>
+void ForEachOfColor(const WorldImpl::ConstraintColors& colors, std::size_t color,
+                    ThreadPool& pool, const Function& function)
+{
+    ForEachBatchOfColor(colors, color, 1u, pool,
+                        [&](const std::size_t* indices, std::size_t, std::size_t thread) {
+        function(*indices, thread);
+    });
+}
+
+/// @brief Solves the given velocity constraints colour by colour.
+/// @details The results are the same regardless of how many threads the pool has and of
+///   whether the constraints get solved a batch at a time.
+/// @param wide Whether to solve the constraints of a colour a batch at a time.
+/// @return Maximum incremental impulse.
+/// @see SolveVelocityConstraintsViaGS, GaussSeidel::SolveVelocityConstraints.
+Momentum SolveVelocityConstraintsViaColors(VelocityConstraints& velConstraints,
+                                           const WorldImpl::ConstraintColors& colors,
+                                           ThreadPool& pool, bool wide)
+{
+    constexpr auto maxBatchSize = GaussSeidel::VelocityConstraintsPerBatch;
+    const auto batchSize = wide? maxBatchSize: std::size_t{1};
+    auto maxIncImpulses = std::vector<Momentum>(pool.GetWorkers() + 1u, 0_Ns);
+    for (auto color = std::size_t{0}; color <= MaxConstraintColors; ++color)
+    {
+        ForEachBatchOfColor(colors, color, batchSize, pool,
+                            [&](const std::size_t* indices, std::size_t count,
+                                std::size_t thread) {
+            VelocityConstraint* batch[maxBatchSize];
+            for (auto j = std::size_t{0}; j < count; ++j)
+            {
+                batch[j] = &velConstraints[indices[j]];
+            }
+            const auto incImpulse = (count > 1u)?
+                GaussSeidel::SolveVelocityConstraints(batch, count):
+                GaussSeidel::SolveVelocityConstraint(*batch[0]);
+            maxIncImpulses[thread] = std::max(maxIncImpulses[thread], incImpulse);
+        });
+    }
+    return *std::max_element(cbegin(maxIncImpulses), cend(maxIncImpulses));
+}
+
+/// @brief Solves the given position constraints colour by colour.
+/// @details The results are the same regardless of how many threads the pool has.
+/// @return Minimum separation.
+/// @see SolvePositionConstraintsViaGS.
+Length SolvePositionConstraintsViaColors(PositionConstraints& posConstraints,
+                                         ConstraintSolverConf conf,
+                                         const WorldImpl::ConstraintColors& colors,
+                                         ThreadPool& pool)
+{
+    auto minSeparations = std::vector<Length>(pool.GetWorkers() + 1u,
+                                              std::numeric_limits<Length>::infinity());
+    for (auto color = std::size_t{0}; color <= MaxConstraintColors; ++color)
+    {
+        ForEachOfColor(colors, color, pool, [&](std::size_t i, std::size_t thread) {
+            auto& pc = posConstraints[i];
+            const auto res = GaussSeidel::SolvePositionConstraint(pc, true, true, conf);
+            // Unmovable bodies can be shared by the constraints of a colour.
+            if (IsMovable(*pc.GetBodyA()))
+            {
+                pc.GetBodyA()->SetPosition(res.pos_a);
+            }
+            if (IsMovable(*pc.GetBodyB()))
+            {
+                pc.GetBodyB()->SetPosition(res.pos_b);
+            }
+            minSeparations[thread] = std::min(minSeparations[thread], res.min_separation);
+        });
+    }
+    return *std::min_element(cbegin(minSeparations), cend(minSeparations));
+}
+
 #if 0
 /// Solves the given position constraints.
 ///
@@ -409,7 +613,8 @@ void FlagContactsForFiltering(ArrayAllocator<Contact>& contactBuffer, BodyID bod
 /// @brief Gets the update configuration from the given step configuration data.
 WorldImpl::ContactUpdateConf GetUpdateConf(const StepConf& conf) noexcept
 {
-    return WorldImpl::ContactUpdateConf{GetDistanceConf(conf), GetManifoldConf(conf)};
+    return WorldImpl::ContactUpdateConf{GetDistanceConf(conf), GetManifoldConf(conf),
+        conf.manifoldReuseDistance, cos(conf.manifoldReuseAngle)};
 }
 
 [[maybe_unused]]
@@ -504,9 +709,64 @@ void ResetContactsForSolveTOI(ArrayAllocator<Contact>& buffer,
     });
 }
 
+/// @brief Greater-than comparison of time of impact queue entries.
+/// @note Makes heaps of these entries into min-heaps of their times of impact with ties
+///   going to the least position.
+struct ToiQueueEntryGreater
+{
+    /// @brief Function call operator.
+    template <class T>
+    bool operator()(const T& lhs, const T& rhs) const noexcept
+    {
+        return (lhs.toi > rhs.toi) || ((lhs.toi == rhs.toi) && (lhs.position > rhs.position));
+    }
+};
+
+/// @brief Time of impact event of a batch of events.
+struct ToiEvent
+{
+    StepConf conf; ///< Step configuration for the remainder of the step.
+    Island island; ///< Island of the event.
+    IslandStats stats; ///< Statistics of the event.
+    VelocityConstraints velConstraints; ///< Velocity constraints of the island's contacts.
+    std::vector<BodyID> moved; ///< Bodies whose transformations changed.
+};
+
+/// @brief Flag set in the identifiers of the proxies that are in the static tree.
+/// @see WorldConf::separateStaticTree.
+constexpr auto StaticProxyFlag = ~(~BroadPhase::Size{0} >> 1u);
+
+/// @brief Gets whether the identified proxy is in the static tree.
+constexpr bool IsStaticProxy(BroadPhase::Size id) noexcept
+{
+    return (id & StaticProxyFlag) != 0u;
+}
+
+/// @brief Gets the static tree leaf index of the identified static proxy.
+constexpr DynamicTree::Size GetStaticLeaf(BroadPhase::Size id) noexcept
+{
+    return id & ~StaticProxyFlag;
+}
+
+/// @brief Gets the AABB of the identified proxy.
+AABB GetProxyAABB(const BroadPhase& broadPhase, const DynamicTree& staticTree,
+                  BroadPhase::Size id) noexcept
+{
+    return IsStaticProxy(id)? staticTree.GetAABB(GetStaticLeaf(id)): broadPhase.GetAABB(id);
+}
+
+/// @brief Gets the leaf data of the identified proxy.
+BroadPhase::LeafData GetProxyLeafData(const BroadPhase& broadPhase,
+                                      const DynamicTree& staticTree,
+                                      BroadPhase::Size id) noexcept
+{
+    return IsStaticProxy(id)? staticTree.GetLeafData(GetStaticLeaf(id)):
+        broadPhase.GetLeafData(id);
+}
+
 /// @brief Destroys all of the given fixture's proxies.
-void DestroyProxies(Fixture& fixture,
-                    std::vector<DynamicTree::Size>& proxies, DynamicTree& tree) noexcept
+void DestroyProxies(Fixture& fixture, std::vector<BroadPhase::Size>& proxies,
+                    BroadPhase& broadPhase, DynamicTree& staticTree) noexcept
 {
     const auto fixtureProxies = fixture.GetProxies();
     const auto childCount = size(fixtureProxies);
@@ -517,23 +777,154 @@ void DestroyProxies(Fixture& fixture,
         {
             const auto treeId = fixtureProxies[i].treeId;
             EraseFirst(proxies, treeId);
-            tree.DestroyLeaf(treeId);
+            if (IsStaticProxy(treeId))
+            {
+                staticTree.DestroyLeaf(GetStaticLeaf(treeId));
+            }
+            else
+            {
+                broadPhase.DestroyLeaf(treeId);
+            }
         }
     }
     fixture.SetProxies(std::vector<FixtureProxy>{});
 }
 
+/// @brief Ratio of a proxy's AABB extension to the extension it needs, above which its
+///   AABB gets refit when AABB extensions are velocity based.
+/// @details This keeps bodies that slow down from holding onto AABBs sized for when
+///   they were faster, while not refitting the AABBs of bodies whose speeds just vary.
+/// @see StepConf::aabbExtensionSteps.
+constexpr auto AabbRefitRatio = Real{4};
+
+/// @brief Minimum number of moved proxies per thread for finding new contacts.
+/// @details Splitting up fewer proxies than this per thread costs more in thread
+///   overhead than it saves.
+constexpr auto MinProxiesPerFindThread = std::size_t{64};
+
+/// @brief Minimum number of batched TOI events per thread for solving them.
+/// @details The islands of TOI events are usually tiny so solving fewer events than this
+///   per thread costs more in thread overhead than it saves.
+constexpr auto MinToiEventsPerThread = std::size_t{16};
+
+/// @brief Maximum number of bodies in the regions of the TOI events of a batch.
+/// @details Bounds the cost of looking for events to batch in worlds where lots of
+///   bodies are connected through impenetrable contacts.
+/// @see WorldImpl::FindToiBatch.
+constexpr auto MaxToiBatchBodies = BodyCounter{1024};
+
+/// @brief Appends keys for the leafs overlapping the given range of proxies.
+/// @note Leafs of the same body as the proxy they overlap are skipped.
+/// @note Proxies in the static tree are only paired with proxies in the broad-phase.
+template <class InputIt>
+void FindContactKeys(const BroadPhase& broadPhase, const DynamicTree& staticTree,
+                     InputIt first, InputIt last, std::vector<ContactKey>& keys)
+{
+    for_each(first, last, [&](BroadPhase::Size pid) {
+        const auto body0 = GetProxyLeafData(broadPhase, staticTree, pid).body;
+        const auto aabb = GetProxyAABB(broadPhase, staticTree, pid);
+        Query(broadPhase, aabb, [&](BroadPhase::Size nodeId) {
+            const auto body1 = broadPhase.GetLeafData(nodeId).body;
+            // A proxy cannot form a pair with itself.
+            if ((nodeId != pid) && (body0 != body1))
+            {
+                keys.push_back(ContactKey{nodeId, pid});
+            }
+            return DynamicTreeOpcode::Continue;
+        });
+        if (!IsStaticProxy(pid))
+        {
+            Query(staticTree, aabb, [&](DynamicTree::Size leaf) {
+                if (body0 != staticTree.GetLeafData(leaf).body)
+                {
+                    keys.push_back(ContactKey{leaf | StaticProxyFlag, pid});
+                }
+                return DynamicTreeOpcode::Continue;
+            });
+        }
+    });
+}
+
+/// @brief Divisor of the tree's leaf count giving the number of moved proxies at and
+///   above which new contacts get found by descending the tree against itself.
+/// @details Querying the tree for every moved proxy redoes the overlap tests of the
+///   tree's upper levels for each of them. Once a large enough fraction of the leafs
+///   moved, it's cheaper to visit all overlapping pairs once and skip the unmoved ones.
+/// @note Only applies when finding new contacts on one thread since the descent isn't
+///   split up over threads the way the per-proxy querying is.
+constexpr auto PairQueryLeafDivisor = std::size_t{4};
+
+/// @brief Appends keys for the overlapping pairs of leafs that include any of the given
+///   proxies.
+/// @details Finds the same keys as the per-proxy querying overload does but by descending
+///   the tree against itself and against the static tree.
+/// @note Leafs of the same body are skipped.
+void FindContactKeys(const DynamicTree& tree, const DynamicTree& staticTree,
+                     const std::vector<BroadPhase::Size>& proxies,
+                     std::vector<ContactKey>& keys)
+{
+    auto moved = std::vector<bool>(tree.GetNodeCapacity());
+    auto movedStatic = std::vector<bool>(staticTree.GetNodeCapacity());
+    for (const auto pid: proxies)
+    {
+        if (IsStaticProxy(pid))
+        {
+            movedStatic[GetStaticLeaf(pid)] = true;
+        }
+        else
+        {
+            moved[pid] = true;
+        }
+    }
+    QueryPairs(tree, [&](DynamicTree::Size a, DynamicTree::Size b) {
+        if ((moved[a] || moved[b]) && (tree.GetLeafData(a).body != tree.GetLeafData(b).body))
+        {
+            keys.push_back(ContactKey{a, b});
+        }
+        return DynamicTreeOpcode::Continue;
+    });
+    QueryPairs(tree, staticTree, [&](DynamicTree::Size a, DynamicTree::Size b) {
+        if ((moved[a] || movedStatic[b]) &&
+            (tree.GetLeafData(a).body != staticTree.GetLeafData(b).body))
+        {
+            keys.push_back(ContactKey{a, b | StaticProxyFlag});
+        }
+        return DynamicTreeOpcode::Continue;
+    });
+}
+
+/// @brief Makes the broad-phase the given world configuration calls for.
+BroadPhase MakeBroadPhase(const WorldConf& def)
+{
+    switch (def.broadPhaseType)
+    {
+        case BroadPhaseType::DynamicTree: break;
+        case BroadPhaseType::SweepAndPrune: return BroadPhase{SweepAndPrune{}};
+        case BroadPhaseType::HashGrid: return BroadPhase{HashGrid{def.hashGridCellSize}};
+        case BroadPhaseType::WideDynamicTree: return BroadPhase{WideDynamicTree8{}};
+    }
+    return BroadPhase{DynamicTree{def.initialTreeSize}};
+}
+
 } // anonymous namespace
 
 WorldImpl::WorldImpl(const WorldConf& def):
-    m_tree(def.initialTreeSize),
+    m_broadPhase{MakeBroadPhase(def)},
     m_minVertexRadius{def.minVertexRadius},
-    m_maxVertexRadius{def.maxVertexRadius}
+    m_maxVertexRadius{def.maxVertexRadius},
+    m_threadPool{(def.threads > 1u)? def.threads - 1u: 0u},
+    m_updateContactsChunkSize{def.updateContactsChunkSize},
+    m_colorConstraints{def.colorConstraints},
+    m_toiBatchWindow{def.toiBatchWindow}
 {
     if (def.minVertexRadius > def.maxVertexRadius)
     {
         throw InvalidArgument("max vertex radius must be >= min vertex radius");
     }
+    if (def.separateStaticTree)
+    {
+        m_flags |= e_staticTree;
+    }
     m_proxyKeys.reserve(1024);
     m_proxies.reserve(1024);
 }
@@ -565,7 +956,11 @@ void WorldImpl::Clear() noexcept
     m_fixturesForProxies.clear();
     m_proxies.clear();
     m_proxyKeys.clear();
-    m_tree.Clear();
+    m_broadPhase.Clear();
+    m_staticTree.Clear();
+    m_optimizer = OptimizerState{};
+    m_bodyMotions.clear();
+    m_manifoldPoses.clear();
     m_manifoldBuffer.clear();
     m_contactBuffer.clear();
     m_jointBuffer.clear();
@@ -573,6 +968,13 @@ void WorldImpl::Clear() noexcept
     m_bodyBuffer.clear();
 }
 
+const DynamicTree& WorldImpl::GetTree() const noexcept
+{
+    static const auto emptyTree = DynamicTree{};
+    const auto tree = TypeCast<const DynamicTree*>(&m_broadPhase);
+    return tree? *tree: emptyTree;
+}
+
 BodyCounter WorldImpl::GetBodyRange() const noexcept
 {
     return static_cast<BodyCounter>(m_bodyBuffer.size());
@@ -590,6 +992,8 @@ BodyID WorldImpl::CreateBody(const BodyConf& def)
     }
     const auto id = static_cast<BodyID>(
         static_cast<BodyID::underlying_type>(m_bodyBuffer.Allocate(def)));
+    m_bodyMotions.resize(size(m_bodyBuffer));
+    m_bodyMotions[UnderlyingValue(id)] = 0_m;
     m_bodies.push_back(id);
     return id;
 }
@@ -646,7 +1050,8 @@ void WorldImpl::Destroy(BodyID id)
             m_fixtureDestructionListener(fixtureID);
         }
         EraseAll(m_fixturesForProxies, fixtureID);
-        DestroyProxies(m_fixtureBuffer[UnderlyingValue(fixtureID)], m_proxies, m_tree);
+        DestroyProxies(m_fixtureBuffer[UnderlyingValue(fixtureID)], m_proxies, m_broadPhase,
+                       m_staticTree);
         m_fixtureBuffer.Free(UnderlyingValue(fixtureID));
     });
     body.ClearFixtures();
@@ -905,11 +1310,9 @@ RegStepStats WorldImpl::SolveReg(const StepConf& conf)
     m_islandedContacts.resize(size(m_contactBuffer));
     m_islandedJoints.resize(size(m_jointBuffer));
 
-#if defined(DO_THREADED)
-    std::vector<std::future<IslandStats>> futures;
-    futures.reserve(remNumBodies);
-#endif
-    // Build and simulate all awake islands.
+    // Build all awake islands. Solving an island doesn't change how the others get built
+    // so they're all built first. That lets them get solved concurrently.
+    auto numIslands = std::size_t{0};
     for (const auto& b: m_bodies)
     {
         if (!m_islandedBodies[UnderlyingValue(b)]) {
@@ -918,31 +1321,100 @@ RegStepStats WorldImpl::SolveReg(const StepConf& conf)
             if (body.IsAwake() && body.IsEnabled())
             {
                 ++stats.islandsFound;
-                ::playrho::d2::Clear(m_island);
-                // Size the island for the remaining un-evaluated bodies, contacts, and joints.
-                Reserve(m_island, remNumBodies, remNumContacts, remNumJoints);
-                AddToIsland(m_island, b, remNumBodies, remNumContacts, remNumJoints);
-                remNumBodies += RemoveUnspeedablesFromIslanded(m_island.bodies, m_bodyBuffer,
+                if (numIslands == size(m_regIslands))
+                {
+                    m_regIslands.emplace_back();
+                }
+                auto& island = m_regIslands[numIslands].island;
+                ++numIslands;
+                ::playrho::d2::Clear(island);
+                AddToIsland(island, b, remNumBodies, remNumContacts, remNumJoints);
+                remNumBodies += RemoveUnspeedablesFromIslanded(island.bodies, m_bodyBuffer,
                                                                m_islandedBodies);
-#if defined(DO_THREADED)
-                // Updates bodies' sweep.pos0 to current sweep.pos1 and bodies' sweep.pos1 to new positions
-                futures.push_back(std::async(std::launch::async, &WorldImpl::SolveRegIslandViaGS,
-                                             this, conf, m_island));
-#else
-                const auto solverResults = SolveRegIslandViaGS(conf, m_island);
-                ::playrho::Update(stats, solverResults);
-#endif
+
+                // Update bodies' pos0 values. Static bodies can be in more than one island
+                // so this is done here rather than while solving the island.
+                for (const auto& id: island.bodies)
+                {
+                    auto& islandBody = m_bodyBuffer[UnderlyingValue(id)];
+                    islandBody.SetPosition0(GetPosition1(islandBody)); // like Advance0(1).
+                }
             }
         }
     }
 
-#if defined(DO_THREADED)
-    for (auto&& future: futures)
+    // Islands solved by colour spread their constraints over the thread pool so they get
+    // solved one at a time from this thread. The others get spread over the thread pool.
+    m_regIslandOrder.clear();
+    for (auto i = std::size_t{0}; i < numIslands; ++i)
+    {
+        auto& entry = m_regIslands[i];
+        if (IsSolvedByColor(entry.island, conf))
+        {
+            entry.stats = SolveRegIslandViaGS(conf, entry.island, entry.velConstraints,
+                                              entry.moved, m_bodyConstraintsBuffer);
+        }
+        else
+        {
+            m_regIslandOrder.push_back(i);
+        }
+    }
+
+    const auto numThreads = std::min(m_threadPool.GetWorkers() + 1u, size(m_regIslandOrder));
+    if (numThreads > 1u)
+    {
+        // Islands get solved biggest first so that the threads end up with about as much
+        // work as each other.
+        const auto cost = [this](std::size_t i) {
+            const auto& island = m_regIslands[i].island;
+            return size(island.bodies) + size(island.contacts) + size(island.joints);
+        };
+        std::stable_sort(begin(m_regIslandOrder), end(m_regIslandOrder),
+                         [&](std::size_t lhs, std::size_t rhs) {
+            return cost(lhs) > cost(rhs);
+        });
+        if (size(m_workerBodyConstraintsBuffers) < (numThreads - 1u))
+        {
+            m_workerBodyConstraintsBuffers.resize(numThreads - 1u);
+        }
+        for (const auto i: m_regIslandOrder)
+        {
+            m_threadPool.Push([this,i,&conf](std::size_t thread) {
+                auto& entry = m_regIslands[i];
+                auto& buffer = (thread == 0u)? m_bodyConstraintsBuffer:
+                    m_workerBodyConstraintsBuffers[thread - 1u];
+                entry.stats = SolveRegIslandViaGS(conf, entry.island, entry.velConstraints,
+                                                  entry.moved, buffer);
+            });
+        }
+        m_threadPool.Wait();
+    }
+    else
     {
-        const auto solverResults = future.get();
-        ::playrho::Update(stats, solverResults);
+        for (const auto i: m_regIslandOrder)
+        {
+            auto& entry = m_regIslands[i];
+            entry.stats = SolveRegIslandViaGS(conf, entry.island, entry.velConstraints,
+                                              entry.moved, m_bodyConstraintsBuffer);
+        }
+    }
+
+    // The rest is done from this thread in the order the islands were built in.
+    for (auto i = std::size_t{0}; i < numIslands; ++i)
+    {
+        const auto& entry = m_regIslands[i];
+        for (const auto& id: entry.moved)
+        {
+            FlagForUpdating(m_contactBuffer, m_bodyBuffer[UnderlyingValue(id)].GetContacts());
+        }
+        if (m_postSolveContactListener)
+        {
+            Report(m_postSolveContactListener, entry.island.contacts, entry.velConstraints,
+                   entry.stats.solved? entry.stats.positionIterations - 1:
+                   StepConf::InvalidIteration);
+        }
+        ::playrho::Update(stats, entry.stats);
     }
-#endif
 
     for (const auto& b: m_bodies)
     {
@@ -951,21 +1423,38 @@ RegStepStats WorldImpl::SolveReg(const StepConf& conf)
             auto& body = m_bodyBuffer[UnderlyingValue(b)];
             if (body.IsSpeedable())
             {
+                const auto xfm0 = GetTransform0(body.GetSweep());
+                const auto xfm1 = body.GetTransformation();
+                UpdateMotion(b, GetMagnitude(xfm1.p - xfm0.p));
+
                 // Update fixtures (for broad-phase).
-                stats.proxiesMoved += Synchronize(body, GetTransform0(body.GetSweep()),
-                                                  body.GetTransformation(),
-                                                  conf.displaceMultiplier, conf.aabbExtension);
+                const auto syncStats = Synchronize(body, xfm0, xfm1, conf.displaceMultiplier,
+                                                   GetAabbExtension(b, conf),
+                                                   conf.aabbExtensionSteps > 0);
+                stats.proxiesMoved += syncStats.moved;
+                stats.updatesAvoided += syncStats.unmoved;
             }
         }
     }
 
     // Look for new contacts.
-    stats.contactsAdded = FindNewContacts();
+    const auto findStats = FindNewContacts(conf.doFalsePairStats);
+    stats.contactsAdded = findStats.added;
+    stats.falsePairs = findStats.falsePairs;
     
     return stats;
 }
 
-IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& island)
+bool WorldImpl::IsSolvedByColor(const Island& island, const StepConf& conf) const noexcept
+{
+    return (m_colorConstraints || conf.doWideSolve) &&
+           (size(island.contacts) >= MinColoredContacts);
+}
+
+IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& island,
+                                           VelocityConstraints& velConstraints,
+                                           std::vector<BodyID>& moved,
+                                           BodyConstraintsBuffer& buffer)
 {
     assert(!empty(island.bodies) || !empty(island.contacts) || !empty(island.joints));
     
@@ -973,21 +1462,17 @@ IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& i
     results.positionIterations = conf.regPositionIterations;
     const auto h = conf.deltaTime; ///< Time step.
 
-    // Update bodies' pos0 values.
-    for_each(cbegin(island.bodies), cend(island.bodies), [&](const auto& bodyID) {
-        auto& body = m_bodyBuffer[UnderlyingValue(bodyID)];
-        body.SetPosition0(GetPosition1(body)); // like Advance0(1) on the sweep.
-    });
-
     // Copy bodies' pos1 and velocity data into local arrays.
-    auto bodyConstraints = GetBodyConstraints(island.bodies, m_bodyBuffer, h, GetMovementConf(conf));
+    const auto bodyConstraints = GetBodyConstraints(island.bodies, m_bodyBuffer, h,
+                                                    GetMovementConf(conf),
+                                                    buffer);
     auto posConstraints = GetPositionConstraints(island.contacts,
                                                  m_fixtureBuffer, m_contactBuffer, m_manifoldBuffer,
                                                  bodyConstraints);
-    auto velConstraints = GetVelocityConstraints(island.contacts,
-                                                 m_fixtureBuffer, m_contactBuffer, m_manifoldBuffer,
-                                                 bodyConstraints,
-                                                 GetRegVelocityConstraintConf(conf));
+    velConstraints = GetVelocityConstraints(island.contacts,
+                                            m_fixtureBuffer, m_contactBuffer, m_manifoldBuffer,
+                                            bodyConstraints,
+                                            GetRegVelocityConstraintConf(conf));
 #if 0
     auto constraints = std::vector<BodyConstraint*>{};
     for_each(cbegin(island.m_joints), cend(island.m_joints), [&](const auto& id) {
@@ -1004,6 +1489,12 @@ IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& i
 
     const auto psConf = GetRegConstraintSolverConf(conf);
 
+    const auto byColor = IsSolvedByColor(island, conf);
+    if (byColor)
+    {
+        ColorConstraints(velConstraints, buffer.constraints, m_constraintColors);
+    }
+
     for_each(cbegin(island.joints), cend(island.joints), [&](const auto& id) {
         auto& joint = m_jointBuffer[UnderlyingValue(id)];
         InitVelocity(joint, bodyConstraints, conf, psConf);
@@ -1020,7 +1511,10 @@ IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& i
 
         // Note that the new incremental impulse can potentially be orders of magnitude
         // greater than the last incremental impulse used in this loop.
-        const auto newIncImpulse = SolveVelocityConstraintsViaGS(velConstraints);
+        const auto newIncImpulse = byColor?
+            SolveVelocityConstraintsViaColors(velConstraints, m_constraintColors,
+                                              m_threadPool, conf.doWideSolve):
+            SolveVelocityConstraintsViaGS(velConstraints);
         results.maxIncImpulse = std::max(results.maxIncImpulse, newIncImpulse);
 
         if (jointsOkay && (newIncImpulse <= conf.regMinMomentum))
@@ -1036,12 +1530,15 @@ IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& i
     }
     
     // updates array of tentative new body positions per the velocities as if there were no obstacles...
-    IntegratePositions(bodyConstraints, h);
+    IntegratePositions(buffer.constraints, h);
     
     // Solve position constraints
     for (auto i = decltype(conf.regPositionIterations){0}; i < conf.regPositionIterations; ++i)
     {
-        const auto minSeparation = SolvePositionConstraintsViaGS(posConstraints, psConf);
+        const auto minSeparation = byColor?
+            SolvePositionConstraintsViaColors(posConstraints, psConf, m_constraintColors,
+                                              m_threadPool):
+            SolvePositionConstraintsViaGS(posConstraints, psConf);
         results.minSeparation = std::min(results.minSeparation, minSeparation);
         const auto contactsOkay = (minSeparation >= conf.regMinSeparation);
 
@@ -1067,28 +1564,28 @@ IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& i
         AssignImpulses(manifold, vc);
     });
 
-    for (const auto& id: island.bodies)
+    moved.clear();
+    const auto numBodies = size(island.bodies);
+    for (auto i = decltype(numBodies){0}; i < numBodies; ++i)
     {
-        const auto i = UnderlyingValue(id);
-        const auto& bc = bodyConstraints[i];
-        auto& body = m_bodyBuffer[i];
+        auto& body = m_bodyBuffer[UnderlyingValue(island.bodies[i])];
+        if (!body.IsSpeedable())
+        {
+            // Static bodies can be in other islands and don't move anyway.
+            continue;
+        }
+        const auto& bc = buffer.constraints[i];
         // Could normalize position here to avoid unbounded angles but angular
         // normalization isn't handled correctly by joints that constrain rotation.
         body.JustSetVelocity(bc.GetVelocity());
         if (UpdateBody(body, bc.GetPosition()))
         {
-            FlagForUpdating(m_contactBuffer, body.GetContacts());
+            moved.push_back(island.bodies[i]);
         }
     }
 
     // XXX: Should contacts needing updating be updated now??
 
-    if (m_postSolveContactListener)
-    {
-        Report(m_postSolveContactListener, island.contacts, velConstraints,
-               results.solved? results.positionIterations - 1: StepConf::InvalidIteration);
-    }
-    
     results.bodiesSlept = BodyCounter{0};
     const auto minUnderActiveTime = UpdateUnderActiveTimes(island.bodies, m_bodyBuffer, conf);
     if ((minUnderActiveTime >= conf.minStillTimeToSleep) && results.solved)
@@ -1100,26 +1597,49 @@ IslandStats WorldImpl::SolveRegIslandViaGS(const StepConf& conf, const Island& i
     return results;
 }
 
-WorldImpl::UpdateContactsData WorldImpl::UpdateContactTOIs(ArrayAllocator<Contact>& contactBuffer,
-                                                           ArrayAllocator<Body>& bodyBuffer,
-                                                           const ArrayAllocator<Fixture>& fixtureBuffer,
-                                                           const Contacts& contacts, const StepConf& conf)
+WorldImpl::UpdateContactsData WorldImpl::UpdateContactTOIs(const StepConf& conf)
 {
     auto results = UpdateContactsData{};
 
+    // Times of impact are updated in the order of the contacts container since advancing
+    // the bodies' sweeps can affect the times of impact of contacts updated after.
+    sort(begin(m_toiCandidates), end(m_toiCandidates));
+    m_toiCandidates.erase(unique(begin(m_toiCandidates), end(m_toiCandidates)),
+                          end(m_toiCandidates));
+
+    // Only the enabled state and the TOI count of a contact can change its eligibility for
+    // a time of impact during the step. Contacts that could still become eligible stay
+    // candidates for the next update.
+    auto numCandidates = std::size_t{0};
+    const auto keepCandidate = [&](ContactCounter position) {
+        m_toiCandidates[numCandidates] = position;
+        ++numCandidates;
+    };
+
     const auto toiConf = GetToiConf(conf);
-    for (const auto& contact: contacts)
+    const auto maxToi = nextafter(Real{1}, Real{0});
+    for (const auto position: m_toiCandidates)
     {
-        auto& c = contactBuffer[UnderlyingValue(std::get<ContactID>(contact))];
+        auto& c = m_contactBuffer[UnderlyingValue(std::get<ContactID>(m_contacts[position]))];
         if (c.HasValidToi())
         {
             ++results.numValidTOI;
+            if (c.GetToi() < maxToi)
+            {
+                m_toiQueue.push_back(ToiQueueEntry{c.GetToi(), position});
+                push_heap(begin(m_toiQueue), end(m_toiQueue), ToiQueueEntryGreater{});
+            }
             continue;
         }
-        if (!IsEnabled(c) || IsSensor(c) || !IsActive(c) || !IsImpenetrable(c))
+        if (IsSensor(c) || !IsActive(c) || !IsImpenetrable(c))
         {
             continue;
         }
+        if (!IsEnabled(c))
+        {
+            keepCandidate(position);
+            continue;
+        }
         if (c.GetToiCount() >= conf.maxSubSteps)
         {
             // What are the pros/cons of this?
@@ -1127,11 +1647,12 @@ WorldImpl::UpdateContactsData WorldImpl::UpdateContactTOIs(ArrayAllocator<Contac
             // m_maxSubSteps of 44 and higher seems to decrease the occurrance of tunneling
             // of multiple bullet body collisions with static objects.
             ++results.numAtMaxSubSteps;
+            keepCandidate(position);
             continue;
         }
 
-        auto& bA = bodyBuffer[UnderlyingValue(c.GetBodyA())];
-        auto& bB = bodyBuffer[UnderlyingValue(c.GetBodyB())];
+        auto& bA = m_bodyBuffer[UnderlyingValue(c.GetBodyA())];
+        auto& bB = m_bodyBuffer[UnderlyingValue(c.GetBodyB())];
 
         /*
          * Put the sweeps onto the same time interval.
@@ -1146,9 +1667,9 @@ WorldImpl::UpdateContactsData WorldImpl::UpdateContactTOIs(ArrayAllocator<Contac
 
         // Compute the TOI for this contact (one or both bodies are active and impenetrable).
         // Computes the time of impact in interval [0, 1]
-        const auto proxyA = GetChild(fixtureBuffer[UnderlyingValue(c.GetFixtureA())].GetShape(),
+        const auto proxyA = GetChild(m_fixtureBuffer[UnderlyingValue(c.GetFixtureA())].GetShape(),
                                      c.GetChildIndexA());
-        const auto proxyB = GetChild(fixtureBuffer[UnderlyingValue(c.GetFixtureB())].GetShape(),
+        const auto proxyB = GetChild(m_fixtureBuffer[UnderlyingValue(c.GetFixtureB())].GetShape(),
                                      c.GetChildIndexB());
 
         // Large rotations can make the root finder of TimeOfImpact fail, so normalize sweep angles.
@@ -1158,7 +1679,11 @@ WorldImpl::UpdateContactsData WorldImpl::UpdateContactTOIs(ArrayAllocator<Contac
         // Compute the TOI for this contact (one or both bodies are active and impenetrable).
         // Computes the time of impact in interval [0, 1]
         // Large rotations can make the root finder of TimeOfImpact fail, so normalize the sweep angles.
-        const auto output = GetToiViaSat(proxyA, sweepA, proxyB, sweepB, toiConf);
+        // Warm starts from and keeps the simplex indices of the contact's last
+        // distance calculation since these rarely change much between calls.
+        auto indices = c.GetSimplexIndices();
+        const auto output = GetToiViaSat(proxyA, sweepA, proxyB, sweepB, toiConf, indices);
+        c.SetSimplexIndices(indices);
 
         // Use Min function to handle floating point imprecision which possibly otherwise
         // could provide a TOI that's greater than 1.
@@ -1166,71 +1691,317 @@ WorldImpl::UpdateContactsData WorldImpl::UpdateContactTOIs(ArrayAllocator<Contac
             std::min(alpha0 + (1 - alpha0) * output.time, Real{1}): Real{1};
         assert(toi >= alpha0 && toi <= 1);
         c.SetToi(toi);
-        
+        if (toi < maxToi)
+        {
+            m_toiQueue.push_back(ToiQueueEntry{toi, position});
+            push_heap(begin(m_toiQueue), end(m_toiQueue), ToiQueueEntryGreater{});
+        }
+
         results.maxDistIters = std::max(results.maxDistIters, output.stats.max_dist_iters);
         results.maxToiIters = std::max(results.maxToiIters, output.stats.toi_iters);
         results.maxRootIters = std::max(results.maxRootIters, output.stats.max_root_iters);
+        results.sumDistIters += output.stats.sum_dist_iters;
+        results.sumToiIters += output.stats.toi_iters;
         ++results.numUpdatedTOI;
     }
+    m_toiCandidates.resize(numCandidates);
 
     return results;
 }
 
-WorldImpl::ContactToiData WorldImpl::GetSoonestContact(const Contacts& contacts,
-                                                       const ArrayAllocator<Contact>& buffer) noexcept
+bool WorldImpl::IsStale(const ToiQueueEntry& entry) const noexcept
+{
+    const auto contactID = std::get<ContactID>(m_contacts[entry.position]);
+    const auto& c = m_contactBuffer[UnderlyingValue(contactID)];
+    return !c.HasValidToi() || (c.GetToi() != entry.toi);
+}
+
+WorldImpl::ContactToiData WorldImpl::GetSoonestContact()
 {
-    auto minToi = nextafter(Real{1}, Real{0});
-    auto found = InvalidContactID;
-    auto count = ContactCounter{0};
-    for (const auto& contact: contacts)
+    const auto pop = [this]() {
+        pop_heap(begin(m_toiQueue), end(m_toiQueue), ToiQueueEntryGreater{});
+        const auto entry = m_toiQueue.back();
+        m_toiQueue.pop_back();
+        return entry;
+    };
+
+    while (!empty(m_toiQueue) && IsStale(m_toiQueue.front()))
     {
-        const auto contactID = std::get<ContactID>(contact);
-        const auto& c = buffer[UnderlyingValue(contactID)];
-        if (c.HasValidToi())
+        pop();
+    }
+    if (empty(m_toiQueue))
+    {
+        return ContactToiData{InvalidContactID, nextafter(Real{1}, Real{0}), 0};
+    }
+
+    // The front entry is the soonest one of least position. The others of the same time of
+    // impact are only counted so they're found by walking the heap instead of popping them
+    // off, which would take time proportional to their number times the log of the queue's
+    // size for every event. Duplicates come from contacts whose times of impact got
+    // recalculated to what they were.
+    const auto minToi = m_toiQueue.front().toi;
+    m_toiSimultaneous.clear();
+    m_toiHeapNodes.clear();
+    m_toiHeapNodes.push_back(0u);
+    while (!empty(m_toiHeapNodes))
+    {
+        const auto node = m_toiHeapNodes.back();
+        m_toiHeapNodes.pop_back();
+        const auto& entry = m_toiQueue[node];
+        if (entry.toi != minToi)
+        {
+            // Entries below this one can't be any sooner.
+            continue;
+        }
+        if (!IsStale(entry))
+        {
+            m_toiSimultaneous.push_back(entry);
+        }
+        for (const auto child: {2 * node + 1, 2 * node + 2})
+        {
+            if (child < size(m_toiQueue))
+            {
+                m_toiHeapNodes.push_back(child);
+            }
+        }
+    }
+    sort(begin(m_toiSimultaneous), end(m_toiSimultaneous),
+         [](const ToiQueueEntry& lhs, const ToiQueueEntry& rhs) {
+        return lhs.position < rhs.position;
+    });
+    const auto numSimultaneous = std::distance(begin(m_toiSimultaneous),
+        unique(begin(m_toiSimultaneous), end(m_toiSimultaneous),
+               [](const ToiQueueEntry& lhs, const ToiQueueEntry& rhs) {
+        return lhs.position == rhs.position;
+    }));
+
+    const auto found = std::get<ContactID>(m_contacts[m_toiQueue.front().position]);
+    return ContactToiData{found, minToi, static_cast<ContactCounter>(numSimultaneous)};
+}
+
+void WorldImpl::FindToiBatch(Real maxToi)
+{
+    m_toiRegions.resize(size(m_bodyBuffer));
+    m_toiRegionAABBs.clear();
+    auto budget = MaxToiBatchBodies;
+    auto region = ContactCounter{1};
+    if (MarkToiRegion(m_toiBatch.front(), region, budget))
+    {
+        const auto firstPosition = m_contactPositions[UnderlyingValue(m_toiBatch.front())];
+
+        // The batch stops at the first event whose region overlaps an earlier one's since
+        // solving the events before it could then change how it'd get solved.
+        m_toiSimultaneous.clear();
+        while (!empty(m_toiQueue) && (m_toiQueue.front().toi <= maxToi) && (budget > 0))
+        {
+            pop_heap(begin(m_toiQueue), end(m_toiQueue), ToiQueueEntryGreater{});
+            const auto entry = m_toiQueue.back();
+            m_toiQueue.pop_back();
+            if (IsStale(entry))
+            {
+                continue;
+            }
+            m_toiSimultaneous.push_back(entry);
+            const auto contactID = std::get<ContactID>(m_contacts[entry.position]);
+            if ((entry.position == firstPosition) || m_islandedContacts[UnderlyingValue(contactID)])
+            {
+                continue;
+            }
+            ++region;
+            if (!MarkToiRegion(contactID, region, budget))
+            {
+                break;
+            }
+            m_toiBatch.push_back(contactID);
+        }
+
+        // The contacts stay queued since their times of impact are still valid.
+        for (const auto& entry: m_toiSimultaneous)
+        {
+            m_toiQueue.push_back(entry);
+            push_heap(begin(m_toiQueue), end(m_toiQueue), ToiQueueEntryGreater{});
+        }
+    }
+    for (const auto& id: m_toiRegionBodies)
+    {
+        m_toiRegions[UnderlyingValue(id)] = 0;
+    }
+    m_toiRegionBodies.clear();
+}
+
+bool WorldImpl::MarkToiRegion(ContactID contactID, ContactCounter region, BodyCounter& budget)
+{
+    const auto mark = [&](BodyID id) {
+        if (!m_bodyBuffer[UnderlyingValue(id)].IsSpeedable())
+        {
+            // Static bodies don't move so events can share them but not spread through them.
+            return true;
+        }
+        const auto marked = m_toiRegions[UnderlyingValue(id)];
+        if (marked != 0)
+        {
+            return marked == region;
+        }
+        if (budget == 0)
+        {
+            return false;
+        }
+        --budget;
+        m_toiRegions[UnderlyingValue(id)] = region;
+        m_toiRegionBodies.push_back(id);
+        return true;
+    };
+
+    const auto& contact = m_contactBuffer[UnderlyingValue(contactID)];
+    const auto first = size(m_toiRegionBodies);
+    if (!mark(contact.GetBodyA()) || !mark(contact.GetBodyB()))
+    {
+        return false;
+    }
+    for (auto i = first; i < size(m_toiRegionBodies); ++i)
+    {
+        const auto id = m_toiRegionBodies[i];
+        for (const auto& ci: m_bodyBuffer[UnderlyingValue(id)].GetContacts())
         {
-            const auto toi = c.GetToi();
-            if (minToi > toi)
+            const auto& c = m_contactBuffer[UnderlyingValue(std::get<ContactID>(ci))];
+            if (IsSensor(c) || !IsImpenetrable(c))
+            {
+                continue;
+            }
+            if (!mark((c.GetBodyA() != id)? c.GetBodyA(): c.GetBodyB()))
             {
-                minToi = toi;
-                found = contactID;
-                count = 1;
+                return false;
             }
-            else if (minToi == toi)
+        }
+    }
+
+    auto aabb = AABB{};
+    for (auto i = first; i < size(m_toiRegionBodies); ++i)
+    {
+        const auto& body = m_bodyBuffer[UnderlyingValue(m_toiRegionBodies[i])];
+        for (const auto& fixtureID: body.GetFixtures())
+        {
+            for (const auto& proxy: m_fixtureBuffer[UnderlyingValue(fixtureID)].GetProxies())
             {
-                // Have multiple contacts at the current minimum time of impact.
-                ++count;
+                Include(aabb, GetProxyAABB(m_broadPhase, m_staticTree, proxy.treeId));
             }
         }
     }
-    return ContactToiData{found, minToi, count};
+    if (std::any_of(cbegin(m_toiRegionAABBs), cend(m_toiRegionAABBs), [&](const AABB& other) {
+        return TestOverlap(aabb, other);
+    }))
+    {
+        return false;
+    }
+    m_toiRegionAABBs.push_back(aabb);
+    return true;
 }
 
 ToiStepStats WorldImpl::SolveToi(const StepConf& conf)
 {
     auto stats = ToiStepStats{};
 
-    if (IsStepComplete())
-    {
-        ResetBodiesForSolveTOI(m_bodies, m_bodyBuffer);
-        Unset(m_islandedBodies, m_bodies);
-        ResetContactsForSolveTOI(m_contactBuffer, m_contacts);
-        Unset(m_islandedContacts, m_contacts);
-    }
+    if (IsStepComplete())
+    {
+        ResetBodiesForSolveTOI(m_bodies, m_bodyBuffer);
+        Unset(m_islandedBodies, m_bodies);
+        ResetContactsForSolveTOI(m_contactBuffer, m_contacts);
+        Unset(m_islandedContacts, m_contacts);
+    }
+
+    const auto subStepping = GetSubStepping();
+
+    // Initially every contact is a candidate for getting its time of impact updated.
+    // After that, only the contacts whose times of impact have been unset are.
+    const auto numContacts = static_cast<ContactCounter>(size(m_contacts));
+    m_toiQueue.clear();
+    m_toiCandidates.resize(numContacts);
+    m_contactPositions.resize(size(m_contactBuffer));
+    for (auto i = decltype(numContacts){0}; i < numContacts; ++i)
+    {
+        m_toiCandidates[i] = i;
+        m_contactPositions[UnderlyingValue(std::get<ContactID>(m_contacts[i]))] = i;
+    }
+    const auto addCandidates = [this](const auto& contacts) {
+        for (const auto& ci: contacts)
+        {
+            // Skips the contacts that can't get a time of impact during this step anyway.
+            const auto contactID = std::get<ContactID>(ci);
+            const auto& c = m_contactBuffer[UnderlyingValue(contactID)];
+            if (!IsSensor(c) && IsActive(c) && IsImpenetrable(c))
+            {
+                m_toiCandidates.push_back(m_contactPositions[UnderlyingValue(contactID)]);
+            }
+        }
+    };
+
+    const auto addResults = [&stats](const IslandStats& results) {
+        stats.minSeparation = std::min(stats.minSeparation, results.minSeparation);
+        stats.maxIncImpulse = std::max(stats.maxIncImpulse, results.maxIncImpulse);
+        stats.islandsSolved += results.solved;
+        stats.sumPosIters += results.positionIterations;
+        stats.sumVelIters += results.velocityIterations;
+        if ((results.positionIterations > 0) || (results.velocityIterations > 0))
+        {
+            ++stats.islandsFound;
+        }
+        stats.contactsUpdatedTouching += results.contactsUpdated;
+        stats.contactsSkippedTouching += results.contactsSkipped;
+    };
+
+    // Resets the island's flags and synchronizes its bodies' proxies.
+    const auto syncIsland = [&](const Island& island) {
+        // Only the bodies of the island can have been flagged.
+        for (const auto& b: island.bodies) {
+            if (m_islandedBodies[UnderlyingValue(b)]) {
+                m_islandedBodies[UnderlyingValue(b)] = false;
+                auto& body = m_bodyBuffer[UnderlyingValue(b)];
+                if (body.IsAccelerable())
+                {
+                    const auto xfm0 = GetTransform0(body.GetSweep());
+                    const auto xfm1 = body.GetTransformation();
+                    stats.proxiesMoved += Synchronize(body, xfm0, xfm1, conf.displaceMultiplier,
+                                                      GetAabbExtension(b, conf),
+                                                      conf.aabbExtensionSteps > 0).moved;
+                    ResetContactsForSolveTOI(m_contactBuffer, body);
+                    Unset(m_islandedContacts, body.GetContacts());
+                    addCandidates(body.GetContacts());
+                }
+            }
+        }
+    };
+
+    // Commits fixture proxy movements to the broad-phase so that new contacts are created.
+    // Also, some contacts can be destroyed.
+    const auto findContacts = [&]() {
+        const auto numContactsBefore = static_cast<ContactCounter>(size(m_contacts));
+        stats.contactsAdded += FindNewContacts().added;
+        const auto numContactsAfter = static_cast<ContactCounter>(size(m_contacts));
+        m_contactPositions.resize(size(m_contactBuffer));
+        for (auto i = numContactsBefore; i < numContactsAfter; ++i)
+        {
+            m_contactPositions[UnderlyingValue(std::get<ContactID>(m_contacts[i]))] = i;
+        }
+        addCandidates(Range<Contacts::const_iterator>{
+            cbegin(m_contacts) + numContactsBefore, cend(m_contacts)});
+    };
 
-    const auto subStepping = GetSubStepping();
+    // Events get solved in batches when using more than one thread.
+    auto toiEvents = std::vector<ToiEvent>{};
 
     // Find TOI events and solve them.
     for (;;)
     {
-        const auto updateData = UpdateContactTOIs(m_contactBuffer, m_bodyBuffer, m_fixtureBuffer,
-                                                  m_contacts, conf);
+        const auto updateData = UpdateContactTOIs(conf);
         stats.contactsAtMaxSubSteps += updateData.numAtMaxSubSteps;
         stats.contactsUpdatedToi += updateData.numUpdatedTOI;
         stats.maxDistIters = std::max(stats.maxDistIters, updateData.maxDistIters);
         stats.maxRootIters = std::max(stats.maxRootIters, updateData.maxRootIters);
         stats.maxToiIters = std::max(stats.maxToiIters, updateData.maxToiIters);
+        stats.sumDistIters += updateData.sumDistIters;
+        stats.sumToiIters += updateData.sumToiIters;
         
-        const auto next = GetSoonestContact(m_contacts, m_contactBuffer);
+        const auto next = GetSoonestContact();
         const auto contactID = next.contact;
         const auto ncount = next.simultaneous;
         if (contactID == InvalidContactID)
@@ -1243,54 +2014,111 @@ ToiStepStats WorldImpl::SolveToi(const StepConf& conf)
         stats.maxSimulContacts = std::max(stats.maxSimulContacts,
                                           static_cast<decltype(stats.maxSimulContacts)>(ncount));
         stats.contactsFound += ncount;
-        auto islandsFound = 0u;
-        if (!m_islandedContacts[UnderlyingValue(contactID)]) {
-#ifndef NDEBUG
-            auto& contact = m_contactBuffer[UnderlyingValue(contactID)];
-            /*
-             * Confirm that contact is as it's supposed to be according to contract of the
-             * GetSoonestContact method from which this contact was obtained.
-             */
-            assert(contact.IsEnabled());
-            assert(!HasSensor(m_fixtureBuffer, contact));
-            assert(IsActive(contact));
-            assert(IsImpenetrable(contact));
-#endif
-            const auto solverResults = SolveToi(contactID, conf);
-            stats.minSeparation = std::min(stats.minSeparation, solverResults.minSeparation);
-            stats.maxIncImpulse = std::max(stats.maxIncImpulse, solverResults.maxIncImpulse);
-            stats.islandsSolved += solverResults.solved;
-            stats.sumPosIters += solverResults.positionIterations;
-            stats.sumVelIters += solverResults.velocityIterations;
-            if ((solverResults.positionIterations > 0) || (solverResults.velocityIterations > 0))
+
+        m_toiBatch.clear();
+        // Sub-stepping solves just one event per step so it doesn't batch events.
+        if ((m_threadPool.GetWorkers() > 0u) && !subStepping &&
+            !m_islandedContacts[UnderlyingValue(contactID)])
+        {
+            m_toiBatch.push_back(contactID);
+            FindToiBatch(next.toi + m_toiBatchWindow);
+        }
+        if (size(m_toiBatch) > 1)
+        {
+            // Builds the islands in the order the events would otherwise have been solved.
+            const auto numEvents = size(m_toiBatch);
+            toiEvents.resize(numEvents);
+            for (auto i = decltype(numEvents){0}; i < numEvents; ++i)
             {
-                ++islandsFound;
+                const auto id = m_toiBatch[i];
+                auto& event = toiEvents[i];
+                event.conf = conf;
+                event.conf.deltaTime = (1 - m_contactBuffer[UnderlyingValue(id)].GetToi()) *
+                    conf.deltaTime;
+                ::playrho::d2::Clear(event.island);
+                event.stats = BuildToiIsland(id, event.island, conf);
+                m_toiCandidates.push_back(m_contactPositions[UnderlyingValue(id)]);
             }
-            stats.contactsUpdatedTouching += solverResults.contactsUpdated;
-            stats.contactsSkippedTouching += solverResults.contactsSkipped;
-        }
-        stats.islandsFound += islandsFound;
 
-        // Reset island flags and synchronize broad-phase proxies.
-        for (const auto& b: m_bodies) {
-            if (m_islandedBodies[UnderlyingValue(b)]) {
-                m_islandedBodies[UnderlyingValue(b)] = false;
-                auto& body = m_bodyBuffer[UnderlyingValue(b)];
-                if (body.IsAccelerable())
+            // The islands have no bodies in common so they can be solved concurrently.
+            // Threads take events one at a time till there are none left.
+            // Each thread uses its own body constraints buffer.
+            auto nextEvent = std::atomic<std::size_t>{0};
+            const auto solveEvents = [&](std::size_t thread) {
+                auto& buffer = (thread == 0u)? m_bodyConstraintsBuffer:
+                    m_workerBodyConstraintsBuffers[thread - 1u];
+                for (auto i = nextEvent.fetch_add(1); i < numEvents; i = nextEvent.fetch_add(1))
                 {
-                    const auto xfm0 = GetTransform0(body.GetSweep());
-                    const auto xfm1 = body.GetTransformation();
-                    stats.proxiesMoved += Synchronize(body, xfm0, xfm1,
-                                                      conf.displaceMultiplier, conf.aabbExtension);
-                    ResetContactsForSolveTOI(m_contactBuffer, body);
-                    Unset(m_islandedContacts, body.GetContacts());
+                    auto& event = toiEvents[i];
+                    if (!empty(event.island.bodies))
+                    {
+                        const auto built = event.stats;
+                        event.stats = SolveToiViaGS(event.island, event.conf,
+                                                    event.velConstraints, event.moved, buffer);
+                        event.stats.contactsUpdated += built.contactsUpdated;
+                        event.stats.contactsSkipped += built.contactsSkipped;
+                    }
                 }
+            };
+            const auto numThreads = std::max(std::min(m_threadPool.GetWorkers() + 1u,
+                                                      numEvents / MinToiEventsPerThread),
+                                             std::size_t{1});
+            if (size(m_workerBodyConstraintsBuffers) < m_threadPool.GetWorkers())
+            {
+                m_workerBodyConstraintsBuffers.resize(m_threadPool.GetWorkers());
             }
-        }
+            for (auto i = decltype(numThreads){0}; i < numThreads; ++i)
+            {
+                m_threadPool.Push(solveEvents);
+            }
+            m_threadPool.Wait();
+            stats.maxBatchThreads = std::max(stats.maxBatchThreads,
+                                             static_cast<std::uint8_t>(numThreads));
 
-        // Commit fixture proxy movements to the broad-phase so that new contacts are created.
-        // Also, some contacts can be destroyed.
-        stats.contactsAdded += FindNewContacts();
+            // The rest is done from this thread in the order of the events.
+            for (auto& event: toiEvents)
+            {
+                if (!empty(event.island.bodies))
+                {
+                    for (const auto& id: event.moved)
+                    {
+                        FlagForUpdating(m_contactBuffer,
+                                        m_bodyBuffer[UnderlyingValue(id)].GetContacts());
+                    }
+                    if (m_postSolveContactListener)
+                    {
+                        Report(m_postSolveContactListener, event.island.contacts,
+                               event.velConstraints, event.stats.positionIterations);
+                    }
+                }
+                addResults(event.stats);
+                syncIsland(event.island);
+                findContacts();
+            }
+            stats.contactsFound += static_cast<ToiStepStats::counter_type>(numEvents - 1);
+            stats.eventsBatched += static_cast<ToiStepStats::counter_type>(numEvents);
+        }
+        else
+        {
+            ::playrho::d2::Clear(m_island);
+            if (!m_islandedContacts[UnderlyingValue(contactID)]) {
+#ifndef NDEBUG
+                auto& contact = m_contactBuffer[UnderlyingValue(contactID)];
+                /*
+                 * Confirm that contact is as it's supposed to be according to contract of the
+                 * GetSoonestContact method from which this contact was obtained.
+                 */
+                assert(contact.IsEnabled());
+                assert(!HasSensor(m_fixtureBuffer, contact));
+                assert(IsActive(contact));
+                assert(IsImpenetrable(contact));
+#endif
+                addResults(SolveToi(contactID, conf));
+                m_toiCandidates.push_back(m_contactPositions[UnderlyingValue(contactID)]);
+            }
+            syncIsland(m_island);
+            findContacts();
+        }
 
         if (subStepping)
         {
@@ -1310,6 +2138,30 @@ IslandStats WorldImpl::SolveToi(ContactID contactID, const StepConf& conf)
     //   Here's some specific behavioral differences:
     //   1. Bodies don't get their under-active times reset (like they do in Erin's code).
 
+    const auto toi = m_contactBuffer[UnderlyingValue(contactID)].GetToi();
+
+    ::playrho::d2::Clear(m_island);
+    ::playrho::d2::Reserve(m_island,
+                           static_cast<BodyCounter>(used(m_bodyBuffer)),
+                           static_cast<ContactCounter>(used(m_contactBuffer)),
+                           static_cast<JointCounter>(0));
+    const auto built = BuildToiIsland(contactID, m_island, conf);
+    if (empty(m_island.bodies))
+    {
+        return built;
+    }
+
+    // Now solve for remainder of time step.
+    auto subConf = StepConf{conf};
+    subConf.deltaTime = (1 - toi) * conf.deltaTime;
+    auto results = SolveToiViaGS(m_island, subConf);
+    results.contactsUpdated += built.contactsUpdated;
+    results.contactsSkipped += built.contactsSkipped;
+    return results;
+}
+
+IslandStats WorldImpl::BuildToiIsland(ContactID contactID, Island& island, const StepConf& conf)
+{
     auto contactsUpdated = ContactCounter{0};
     auto contactsSkipped = ContactCounter{0};
 
@@ -1349,7 +2201,10 @@ IslandStats WorldImpl::SolveToi(ContactID contactID, const StepConf& conf)
         contact.SetEnabled();
         if (contact.NeedsUpdating())
         {
-            Update(contactID, GetUpdateConf(conf));
+            // Its bodies were just advanced so its manifold doesn't get reused.
+            auto updateConf = GetUpdateConf(conf);
+            updateConf.reuseDistance = 0_m;
+            Update(contactID, updateConf);
             ++contactsUpdated;
         }
         else
@@ -1404,11 +2259,8 @@ IslandStats WorldImpl::SolveToi(ContactID contactID, const StepConf& conf)
     }
 
     // Build the island
-    ::playrho::d2::Clear(m_island);
-    ::playrho::d2::Reserve(m_island,
-                           static_cast<BodyCounter>(used(m_bodyBuffer)),
-                           static_cast<ContactCounter>(used(m_contactBuffer)),
-                           static_cast<JointCounter>(0));
+    assert(empty(island.bodies));
+    assert(empty(island.contacts));
 
      // These asserts get triggered sometimes if contacts within TOI are iterated over.
     assert(!m_islandedBodies[UnderlyingValue(bodyIdA)]);
@@ -1416,32 +2268,29 @@ IslandStats WorldImpl::SolveToi(ContactID contactID, const StepConf& conf)
     m_islandedBodies[UnderlyingValue(bodyIdA)] = true;
     m_islandedBodies[UnderlyingValue(bodyIdB)] = true;
     m_islandedContacts[UnderlyingValue(contactID)] = true;
-    m_island.bodies.push_back(bodyIdA);
-    m_island.bodies.push_back(bodyIdB);
-    m_island.contacts.push_back(contactID);
+    island.bodies.push_back(bodyIdA);
+    island.bodies.push_back(bodyIdB);
+    island.contacts.push_back(contactID);
 
     // Process the contacts of the two bodies, adding appropriate ones to the island,
     // adding appropriate other bodies of added contacts, and advancing those other
     // bodies sweeps and transforms to the minimum contact's TOI.
     if (bA.IsAccelerable())
     {
-        const auto procOut = ProcessContactsForTOI(bodyIdA, m_island, toi, conf);
+        const auto procOut = ProcessContactsForTOI(bodyIdA, island, toi, conf);
         contactsUpdated += procOut.contactsUpdated;
         contactsSkipped += procOut.contactsSkipped;
     }
     if (bB.IsAccelerable())
     {
-        const auto procOut = ProcessContactsForTOI(bodyIdB, m_island, toi, conf);
+        const auto procOut = ProcessContactsForTOI(bodyIdB, island, toi, conf);
         contactsUpdated += procOut.contactsUpdated;
         contactsSkipped += procOut.contactsSkipped;
     }
 
-    RemoveUnspeedablesFromIslanded(m_island.bodies, m_bodyBuffer, m_islandedBodies);
+    RemoveUnspeedablesFromIslanded(island.bodies, m_bodyBuffer, m_islandedBodies);
 
-    // Now solve for remainder of time step.
-    auto subConf = StepConf{conf};
-    subConf.deltaTime = (1 - toi) * conf.deltaTime;
-    auto results = SolveToiViaGS(m_island, subConf);
+    auto results = IslandStats{};
     results.contactsUpdated += contactsUpdated;
     results.contactsSkipped += contactsSkipped;
     return results;
@@ -1462,6 +2311,25 @@ bool WorldImpl::UpdateBody(Body& body, const Position& pos)
 }
 
 IslandStats WorldImpl::SolveToiViaGS(const Island& island, const StepConf& conf)
+{
+    auto velConstraints = VelocityConstraints{};
+    const auto results = SolveToiViaGS(island, conf, velConstraints, m_toiMoved,
+                                       m_bodyConstraintsBuffer);
+    for (const auto& id: m_toiMoved)
+    {
+        FlagForUpdating(m_contactBuffer, m_bodyBuffer[UnderlyingValue(id)].GetContacts());
+    }
+    if (m_postSolveContactListener)
+    {
+        Report(m_postSolveContactListener, island.contacts, velConstraints, results.positionIterations);
+    }
+    return results;
+}
+
+IslandStats WorldImpl::SolveToiViaGS(const Island& island, const StepConf& conf,
+                                     VelocityConstraints& velConstraints,
+                                     std::vector<BodyID>& moved,
+                                     BodyConstraintsBuffer& buffer)
 {
     auto results = IslandStats{};
 
@@ -1471,8 +2339,8 @@ IslandStats WorldImpl::SolveToiViaGS(const Island& island, const StepConf& conf)
      * the body constraint doesn't need to pass an elapsed time (and doesn't need to
      * update the velocity from what it already is).
      */
-    auto bodyConstraints = GetBodyConstraints(island.bodies, m_bodyBuffer, 0_s,
-                                              GetMovementConf(conf));
+    const auto bodyConstraints = GetBodyConstraints(island.bodies, m_bodyBuffer, 0_s,
+                                                    GetMovementConf(conf), buffer);
 
     // Initialize the body state.
 #if 0
@@ -1527,16 +2395,22 @@ IslandStats WorldImpl::SolveToiViaGS(const Island& island, const StepConf& conf)
     // Not doing this results in slower simulations.
     // Originally this update was only done to island.bodies 0 and 1.
     // Unclear whether rest of bodies should also be updated. No difference noticed.
-    for (const auto& id: island.bodies)
+    // Static bodies don't move so they're skipped. This keeps islands sharing them from
+    // writing to them.
+    const auto numBodies = size(island.bodies);
+    for (auto i = decltype(numBodies){0}; i < numBodies; ++i)
     {
-        const auto& bc = bodyConstraints[UnderlyingValue(id)];
-        m_bodyBuffer[UnderlyingValue(id)].SetPosition0(bc.GetPosition());
+        auto& body = m_bodyBuffer[UnderlyingValue(island.bodies[i])];
+        if (body.IsSpeedable())
+        {
+            body.SetPosition0(buffer.constraints[i].GetPosition());
+        }
     }
 
-    auto velConstraints = GetVelocityConstraints(island.contacts,
-                                                 m_fixtureBuffer, m_contactBuffer, m_manifoldBuffer,
-                                                 bodyConstraints,
-                                                 GetToiVelocityConstraintConf(conf));
+    velConstraints = GetVelocityConstraints(island.contacts,
+                                            m_fixtureBuffer, m_contactBuffer, m_manifoldBuffer,
+                                            bodyConstraints,
+                                            GetToiVelocityConstraintConf(conf));
 
     // No warm starting is needed for TOI events because warm
     // starting impulses were applied in the discrete solver.
@@ -1561,25 +2435,27 @@ IslandStats WorldImpl::SolveToiViaGS(const Island& island, const StepConf& conf)
 
     // Don't store TOI contact forces for warm starting because they can be quite large.
 
-    IntegratePositions(bodyConstraints, conf.deltaTime);
+    IntegratePositions(buffer.constraints, conf.deltaTime);
 
-    for (const auto& id: island.bodies)
+    // Contacts of moved bodies can be shared with the bodies of other islands so they're
+    // left for the caller to flag.
+    moved.clear();
+    for (auto i = decltype(numBodies){0}; i < numBodies; ++i)
     {
-        const auto i = UnderlyingValue(id);
-        auto& body = m_bodyBuffer[i];
-        auto& bc = bodyConstraints[i];
+        const auto id = island.bodies[i];
+        auto& body = m_bodyBuffer[UnderlyingValue(id)];
+        if (!body.IsSpeedable())
+        {
+            continue;
+        }
+        const auto& bc = buffer.constraints[i];
         body.JustSetVelocity(bc.GetVelocity());
         if (UpdateBody(body, bc.GetPosition()))
         {
-            FlagForUpdating(m_contactBuffer, body.GetContacts());
+            moved.push_back(id);
         }
     }
 
-    if (m_postSolveContactListener)
-    {
-        Report(m_postSolveContactListener, island.contacts, velConstraints, results.positionIterations);
-    }
-
     return results;
 }
 
@@ -1693,11 +2569,20 @@ StepStats WorldImpl::Step(const StepConf& conf)
     {
         FlagGuard<decltype(m_flags)> flagGaurd(m_flags, e_locked);
 
-        CreateAndDestroyProxies(conf.aabbExtension);
+        // New proxies have no motion to size their extensions by so they start out with
+        // the smallest of them when extensions are velocity based.
+        CreateAndDestroyProxies((conf.aabbExtensionSteps > 0)? conf.minAabbExtension:
+                                conf.aabbExtension);
         m_fixturesForProxies.clear();
 
-        stepStats.pre.proxiesMoved = SynchronizeProxies(conf);
-        // pre.proxiesMoved is usually zero but sometimes isn't.
+        {
+            const auto syncStats = SynchronizeProxies(conf);
+            // pre.proxiesMoved is usually zero but sometimes isn't.
+            stepStats.pre.proxiesMoved = syncStats.moved;
+            stepStats.pre.updatesAvoided = syncStats.unmoved;
+        }
+
+        OptimizeBroadPhase(conf, stepStats.pre);
 
         {
             // Note: this may update bodies (in addition to the contacts container).
@@ -1711,7 +2596,9 @@ StepStats WorldImpl::Step(const StepConf& conf)
             
             // New fixtures were added: need to find and create the new contacts.
             // Note: this may update bodies (in addition to the contacts container).
-            stepStats.pre.added = FindNewContacts();
+            const auto findStats = FindNewContacts(conf.doFalsePairStats);
+            stepStats.pre.added = findStats.added;
+            stepStats.pre.falsePairs = findStats.falsePairs;
         }
 
         if (conf.deltaTime != 0_s)
@@ -1723,6 +2610,7 @@ StepStats WorldImpl::Step(const StepConf& conf)
             stepStats.pre.ignored = updateStats.ignored;
             stepStats.pre.updated = updateStats.updated;
             stepStats.pre.skipped = updateStats.skipped;
+            stepStats.pre.reused = updateStats.reused;
 
             // Integrate velocities, solve velocity constraints, and integrate positions.
             if (IsStepComplete())
@@ -1767,7 +2655,8 @@ void WorldImpl::ShiftOrigin(Length2 newOrigin)
         ::playrho::d2::ShiftOrigin(j, newOrigin);
     });
 
-    m_tree.ShiftOrigin(newOrigin);
+    m_broadPhase.ShiftOrigin(newOrigin);
+    m_staticTree.ShiftOrigin(newOrigin);
 }
 
 void WorldImpl::InternalDestroy(ContactID contactID,
@@ -1830,7 +2719,8 @@ WorldImpl::DestroyContactsStats WorldImpl::DestroyContacts(Contacts& contacts)
         const auto key = std::get<ContactKey>(c);
         const auto contactID = std::get<ContactID>(c);
 
-        if (!TestOverlap(m_tree, key.GetMin(), key.GetMax()))
+        if (!TestOverlap(GetProxyAABB(m_broadPhase, m_staticTree, key.GetMin()),
+                         GetProxyAABB(m_broadPhase, m_staticTree, key.GetMax())))
         {
             // Destroy contacts that cease to overlap in the broad-phase.
             InternalDestroy(contactID, m_bodyBuffer, m_contactBuffer, m_manifoldBuffer,
@@ -1878,15 +2768,13 @@ WorldImpl::UpdateContactsStats WorldImpl::UpdateContacts(const StepConf& conf)
     auto updated = uint32_t{0};
     auto skipped = uint32_t{0};
 #endif
+    auto reused = uint32_t{0};
 
     const auto updateConf = GetUpdateConf(conf);
     
-#if defined(DO_THREADED)
-    std::vector<ContactID> contactsNeedingUpdate;
-    contactsNeedingUpdate.reserve(size(m_contacts));
-    std::vector<std::future<void>> futures;
-    futures.reserve(size(m_contacts));
-#endif
+    // With multiple threads, the contacts needing updating get collected up first.
+    const auto threaded = m_threadPool.GetWorkers() > 0u;
+    m_contactsToUpdate.clear();
 
     // Update awake contacts.
     for_each(/*execution::par_unseq,*/ begin(m_contacts), end(m_contacts), [&](const auto& c) {
@@ -1926,13 +2814,14 @@ WorldImpl::UpdateContactsStats WorldImpl::UpdateContacts(const StepConf& conf)
         if (contact.NeedsUpdating())
         {
             // The following may call listener but is otherwise thread-safe.
-#if defined(DO_THREADED)
-            contactsNeedingUpdate.push_back(contactID);
-            //futures.push_back(async(&Update, this, *contact, conf)));
-            //futures.push_back(async(launch::async, [=]{ Update(*contact, conf); }));
-#else
-            Update(contactID, updateConf);
-#endif
+            if (threaded)
+            {
+                m_contactsToUpdate.push_back(contactID);
+            }
+            else if (Update(contactID, updateConf))
+            {
+                ++reused;
+            }
         	++updated;
         }
         else
@@ -1942,44 +2831,24 @@ WorldImpl::UpdateContactsStats WorldImpl::UpdateContacts(const StepConf& conf)
 #endif
     });
     
-#if defined(DO_THREADED)
-    auto numJobs = size(contactsNeedingUpdate);
-    const auto jobsPerCore = numJobs / 4;
-    for (auto i = decltype(numJobs){0}; numJobs > 0 && i < 3; ++i)
-    {
-        futures.push_back(std::async(std::launch::async, [=]{
-            const auto offset = jobsPerCore * i;
-            for (auto j = decltype(jobsPerCore){0}; j < jobsPerCore; ++j)
-            {
-	            Update(contactsNeedingUpdate[offset + j], updateConf);
-            }
-        }));
-        numJobs -= jobsPerCore;
-    }
-    if (numJobs > 0)
-    {
-        futures.push_back(std::async(std::launch::async, [=]{
-            const auto offset = jobsPerCore * 3;
-            for (auto j = decltype(numJobs){0}; j < numJobs; ++j)
-            {
-                Update(contactsNeedingUpdate[offset + j], updateConf);
-            }
-        }));
-    }
-    for (auto&& future: futures)
+    if (!empty(m_contactsToUpdate))
     {
-        future.get();
+        const auto numContacts = size(m_contactsToUpdate);
+        const auto chunkSize = std::size_t{m_updateContactsChunkSize};
+        const auto numThreads = std::min(m_threadPool.GetWorkers() + 1u,
+                                         (numContacts + chunkSize - 1) / chunkSize);
+        reused += UpdateContacts(m_contactsToUpdate, updateConf, numThreads);
     }
-#endif
-    
+
     return UpdateContactsStats{
         static_cast<ContactCounter>(ignored),
         static_cast<ContactCounter>(updated),
-        static_cast<ContactCounter>(skipped)
+        static_cast<ContactCounter>(skipped),
+        static_cast<ContactCounter>(reused)
     };
 }
 
-ContactCounter WorldImpl::FindNewContacts()
+WorldImpl::FindNewContactsStats WorldImpl::FindNewContacts(bool countFalsePairs)
 {
     m_proxyKeys.clear();
 
@@ -1987,39 +2856,114 @@ ContactCounter WorldImpl::FindNewContacts()
     // Note that if the dynamic tree node provides the body pointer, it's assumed to be faster
     // to eliminate any node pairs that have the same body here before the key pairs are
     // sorted.
-    for_each(cbegin(m_proxies), cend(m_proxies), [&](ProxyId pid) {
-        const auto body0 = m_tree.GetLeafData(pid).body;
-        const auto aabb = m_tree.GetAABB(pid);
-        Query(m_tree, aabb, [&](ProxyId nodeId) {
-            const auto body1 = m_tree.GetLeafData(nodeId).body;
-            // A proxy cannot form a pair with itself.
-            if ((nodeId != pid) && (body0 != body1))
-            {
-                m_proxyKeys.push_back(ContactKey{nodeId, pid});
-            }
-            return DynamicTreeOpcode::Continue;
-        });
-    });
+    const auto numProxies = size(m_proxies);
+    const auto numThreads = std::min(m_threadPool.GetWorkers() + 1u,
+                                     numProxies / MinProxiesPerFindThread);
+    const auto tree = TypeCast<const DynamicTree*>(&m_broadPhase);
+    if (numThreads > 1u)
+    {
+        FindContactKeysConcurrently(numThreads);
+    }
+    else
+    {
+        if ((tree != nullptr) && (numProxies > 0) &&
+            ((numProxies * PairQueryLeafDivisor) >= tree->GetLeafCount()))
+        {
+            FindContactKeys(*tree, m_staticTree, m_proxies, m_proxyKeys);
+        }
+        else
+        {
+            FindContactKeys(m_broadPhase, m_staticTree, cbegin(m_proxies), cend(m_proxies),
+                            m_proxyKeys);
+        }
+
+        // Sort and eliminate any duplicate contact keys.
+        sort(begin(m_proxyKeys), end(m_proxyKeys));
+        m_proxyKeys.erase(unique(begin(m_proxyKeys), end(m_proxyKeys)), end(m_proxyKeys));
+    }
     m_proxies.clear();
 
-    // Sort and eliminate any duplicate contact keys.
-    sort(begin(m_proxyKeys), end(m_proxyKeys));
-    m_proxyKeys.erase(unique(begin(m_proxyKeys), end(m_proxyKeys)), end(m_proxyKeys));
+    // Gets the AABB of just the child shape of the given proxy.
+    const auto getChildAABB = [this](BroadPhase::Size pid) {
+        const auto leafData = GetProxyLeafData(m_broadPhase, m_staticTree, pid);
+        const auto& fixture = m_fixtureBuffer[UnderlyingValue(leafData.fixture)];
+        const auto& body = m_bodyBuffer[UnderlyingValue(leafData.body)];
+        return ComputeAABB(GetChild(fixture.GetShape(), leafData.childIndex),
+                           body.GetTransformation());
+    };
 
+    auto stats = FindNewContactsStats{};
     const auto numContactsBefore = size(m_contacts);
     for_each(cbegin(m_proxyKeys), cend(m_proxyKeys), [&](ContactKey key)
     {
-        Add(key);
+        if (Add(key) && countFalsePairs &&
+            !TestOverlap(getChildAABB(key.GetMin()), getChildAABB(key.GetMax())))
+        {
+            ++stats.falsePairs;
+        }
     });
     const auto numContactsAfter = size(m_contacts);
     m_islandedContacts.resize(numContactsAfter);
-    return static_cast<ContactCounter>(numContactsAfter - numContactsBefore);
+    stats.added = static_cast<ContactCounter>(numContactsAfter - numContactsBefore);
+    return stats;
+}
+
+void WorldImpl::FindContactKeysConcurrently(std::size_t numThreads)
+{
+    // Each thread finds, sorts, and eliminates the duplicates of, the keys for its own
+    // range of the proxies. The sorted ranges then get merged a pair at a time, the pairs
+    // of a round concurrently, till there's one. So the keys are the same as when found
+    // on one thread.
+    const auto numProxies = size(m_proxies);
+    const auto perThread = numProxies / numThreads;
+    m_threadProxyKeys.resize(numThreads);
+    m_mergedProxyKeys.resize(numThreads / 2u);
+    for (auto i = decltype(numThreads){0}; i < numThreads; ++i)
+    {
+        const auto first = cbegin(m_proxies) + static_cast<std::ptrdiff_t>(perThread * i);
+        const auto last = ((i + 1u) < numThreads)?
+            first + static_cast<std::ptrdiff_t>(perThread): cend(m_proxies);
+        m_threadPool.Push([this,i,first,last](std::size_t) {
+            auto& keys = m_threadProxyKeys[i];
+            keys.clear();
+            FindContactKeys(m_broadPhase, m_staticTree, first, last, keys);
+            sort(begin(keys), end(keys));
+            keys.erase(unique(begin(keys), end(keys)), end(keys));
+        });
+    }
+    m_threadPool.Wait();
+    for (auto count = numThreads; count > 1u;)
+    {
+        const auto pairs = count / 2u;
+        for (auto i = decltype(pairs){0}; i < pairs; ++i)
+        {
+            m_threadPool.Push([this,i](std::size_t) {
+                const auto& keysA = m_threadProxyKeys[i * 2u];
+                const auto& keysB = m_threadProxyKeys[i * 2u + 1u];
+                auto& merged = m_mergedProxyKeys[i];
+                merged.clear();
+                std::set_union(cbegin(keysA), cend(keysA), cbegin(keysB), cend(keysB),
+                               back_inserter(merged));
+            });
+        }
+        m_threadPool.Wait();
+        for (auto i = decltype(pairs){0}; i < pairs; ++i)
+        {
+            swap(m_threadProxyKeys[i], m_mergedProxyKeys[i]);
+        }
+        if ((count % 2u) != 0u)
+        {
+            swap(m_threadProxyKeys[pairs], m_threadProxyKeys[count - 1u]);
+        }
+        count = pairs + (count % 2u);
+    }
+    swap(m_proxyKeys, m_threadProxyKeys[0]);
 }
 
 bool WorldImpl::Add(ContactKey key)
 {
-    const auto minKeyLeafData = m_tree.GetLeafData(key.GetMin());
-    const auto maxKeyLeafData = m_tree.GetLeafData(key.GetMax());
+    const auto minKeyLeafData = GetProxyLeafData(m_broadPhase, m_staticTree, key.GetMin());
+    const auto maxKeyLeafData = GetProxyLeafData(m_broadPhase, m_staticTree, key.GetMax());
 
     const auto bodyIdA = minKeyLeafData.body; // fixtureA->GetBody();
     const auto fixtureIdA = minKeyLeafData.fixture;
@@ -2104,6 +3048,10 @@ bool WorldImpl::Add(ContactKey key)
     const auto contactID = static_cast<ContactID>(static_cast<ContactID::underlying_type>(
         m_contactBuffer.Allocate(bodyIdA, fixtureIdA, indexA, bodyIdB, fixtureIdB, indexB)));
     m_manifoldBuffer.Allocate();
+    m_manifoldPoses.resize(size(m_contactBuffer));
+    m_manifoldPoses[UnderlyingValue(contactID)] = Transformation{
+        GetInvalid<Length2>(), UnitVec::GetRight()
+    };
     auto& contact = m_contactBuffer[UnderlyingValue(contactID)];
     if (bodyA.IsImpenetrable() || bodyB.IsImpenetrable())
     {
@@ -2164,6 +3112,7 @@ void WorldImpl::SetSensor(FixtureID id, bool value)
 
 void WorldImpl::CreateAndDestroyProxies(Length extension)
 {
+    auto fixturesToCreate = Fixtures{};
     for_each(begin(m_fixturesForProxies), end(m_fixturesForProxies), [&](const auto& fixtureID) {
         auto& fixture = m_fixtureBuffer[UnderlyingValue(fixtureID)];
         auto& body = m_bodyBuffer[UnderlyingValue(fixture.GetBody())];
@@ -2173,14 +3122,14 @@ void WorldImpl::CreateAndDestroyProxies(Length extension)
         {
             if (enabled)
             {
-                CreateProxies(fixtureID, fixture, body.GetTransformation(), m_proxies, m_tree, extension);
+                fixturesToCreate.push_back(fixtureID);
             }
         }
         else
         {
             if (!enabled)
             {
-                DestroyProxies(fixture, m_proxies, m_tree);
+                DestroyProxies(fixture, m_proxies, m_broadPhase, m_staticTree);
 
                 // Destroy any contacts associated with the fixture.
                 body.Erase([&](ContactID contactID) {
@@ -2197,19 +3146,75 @@ void WorldImpl::CreateAndDestroyProxies(Length extension)
             }
         }
     });
+
+    // A fixture can get queued more than once, but must only get its proxies once.
+    sort(begin(fixturesToCreate), end(fixturesToCreate));
+    fixturesToCreate.erase(unique(begin(fixturesToCreate), end(fixturesToCreate)),
+                           end(fixturesToCreate));
+    CreateProxies(fixturesToCreate, extension);
 }
 
-PreStepStats::counter_type WorldImpl::SynchronizeProxies(const StepConf& conf)
+WorldImpl::SynchronizeStats WorldImpl::SynchronizeProxies(const StepConf& conf)
 {
-    auto proxiesMoved = PreStepStats::counter_type{0};
+    auto stats = SynchronizeStats{};
     for_each(begin(m_bodiesForProxies), end(m_bodiesForProxies), [&](const auto& bodyID) {
         const auto& b = m_bodyBuffer[UnderlyingValue(bodyID)];
         const auto xfm = b.GetTransformation();
         // Not always true: assert(GetTransform0(b->GetSweep()) == xfm);
-        proxiesMoved += Synchronize(b, xfm, xfm, conf.displaceMultiplier, conf.aabbExtension);
+        const auto syncStats = Synchronize(b, xfm, xfm, conf.displaceMultiplier,
+                                           GetAabbExtension(bodyID, conf),
+                                           conf.aabbExtensionSteps > 0);
+        stats.moved += syncStats.moved;
+        stats.unmoved += syncStats.unmoved;
     });
     m_bodiesForProxies.clear();
-    return proxiesMoved;
+    return stats;
+}
+
+Length WorldImpl::GetAabbExtension(BodyID id, const StepConf& conf) const noexcept
+{
+    if (!(conf.aabbExtensionSteps > 0))
+    {
+        return conf.aabbExtension;
+    }
+    const auto extension = conf.aabbExtensionSteps * m_bodyMotions[UnderlyingValue(id)];
+    return std::min(std::max(extension, conf.minAabbExtension), conf.maxAabbExtension);
+}
+
+void WorldImpl::UpdateMotion(BodyID id, Length distance) noexcept
+{
+    // Rises as soon as the body speeds up but decays gradually as it slows down. This
+    // avoids shrinking the extension of a body that only briefly slows down.
+    auto& motion = m_bodyMotions[UnderlyingValue(id)];
+    motion = std::max(distance, (motion + distance) / Real{2});
+}
+
+void WorldImpl::OptimizeBroadPhase(const StepConf& conf, PreStepStats& stats)
+{
+    if (conf.treeOptimizeBudget == 0)
+    {
+        return;
+    }
+    const auto result = m_broadPhase.Optimize(m_optimizer.next, conf.treeOptimizeBudget,
+                                              m_optimizer.buffer);
+    m_optimizer.next = result.next;
+    m_optimizer.perimeter += result.perimeter;
+    m_optimizer.maxImbalance = std::max(m_optimizer.maxImbalance, result.maxImbalance);
+    const auto& tree = GetTree();
+    if (result.sweepEnded)
+    {
+        const auto root = tree.GetRootIndex();
+        m_optimizer.lastPerimeterRatio = (root != DynamicTree::GetInvalidSize())?
+            Real{m_optimizer.perimeter / GetPerimeter(tree.GetAABB(root))}: Real{0};
+        m_optimizer.lastMaxImbalance = m_optimizer.maxImbalance;
+        m_optimizer.perimeter = 0_m;
+        m_optimizer.maxImbalance = 0;
+    }
+    stats.treeNodesVisited = result.visited;
+    stats.treeRebuilds = result.rebuilds;
+    stats.treeHeight = GetHeight(tree);
+    stats.treeMaxImbalance = m_optimizer.lastMaxImbalance;
+    stats.treePerimeterRatio = m_optimizer.lastPerimeterRatio;
 }
 
 void WorldImpl::SetType(BodyID bodyID, playrho::BodyType type)
@@ -2225,6 +3230,7 @@ void WorldImpl::SetType(BodyID bodyID, playrho::BodyType type)
         throw WrongState("SetType: world is locked");
     }
 
+    const auto oldType = body.GetType();
     body.SetType(type);
     SetMassData(bodyID, ComputeMassData(bodyID));
 
@@ -2234,6 +3240,19 @@ void WorldImpl::SetType(BodyID bodyID, playrho::BodyType type)
         return true;
     });
 
+    if (((m_flags & e_staticTree) != 0u) && body.IsEnabled() &&
+        ((type == BodyType::Static) || (oldType == BodyType::Static)))
+    {
+        // Recreate the proxies in the tree that's now right for them.
+        for (const auto& fixtureID: body.GetFixtures())
+        {
+            DestroyProxies(m_fixtureBuffer[UnderlyingValue(fixtureID)], m_proxies,
+                           m_broadPhase, m_staticTree);
+            m_fixturesForProxies.push_back(fixtureID);
+        }
+        m_flags |= e_newFixture;
+    }
+
     if (type == BodyType::Static)
     {
 #ifndef NDEBUG
@@ -2348,7 +3367,7 @@ bool WorldImpl::Destroy(FixtureID id, bool resetMassData)
     });
 
     EraseAll(m_fixturesForProxies, id);
-    DestroyProxies(fixture, m_proxies, m_tree);
+    DestroyProxies(fixture, m_proxies, m_broadPhase, m_staticTree);
 
     if (!body.RemoveFixture(id))
     {
@@ -2376,32 +3395,68 @@ void WorldImpl::DestroyFixtures(BodyID id)
     SetMassData(id, ComputeMassData(id));
 }
 
-void WorldImpl::CreateProxies(FixtureID fixtureID, Fixture& fixture, const Transformation& xfm,
-                              ProxyQueue& proxies, DynamicTree& tree, Length aabbExtension)
+void WorldImpl::CreateProxies(const Fixtures& fixtures, Length aabbExtension)
 {
-    assert(fixture.GetProxies().empty());
-
-    const auto bodyID = fixture.GetBody();
-    const auto shape = fixture.GetShape();
-
-    // Reserve proxy space and create proxies in the broad-phase.
-    const auto childCount = GetChildCount(shape);
-    auto fixtureProxies = std::vector<FixtureProxy>{};
-    fixtureProxies.reserve(childCount);
-    for (auto childIndex = decltype(childCount){0}; childIndex < childCount; ++childIndex)
+    if (empty(fixtures))
     {
-        const auto dp = GetChild(shape, childIndex);
-        const auto aabb = playrho::d2::ComputeAABB(dp, xfm);
+        return;
+    }
+
+    // Whether the given fixture's proxies go in the static tree.
+    const auto isStatic = [this](const Fixture& fixture) {
+        return ((m_flags & e_staticTree) != 0u) &&
+            (m_bodyBuffer[UnderlyingValue(fixture.GetBody())].GetType() == BodyType::Static);
+    };
 
-        // Note: treeId from CreateLeaf can be higher than the number of fixture proxies.
-        const auto fattenedAABB = GetFattenedAABB(aabb, aabbExtension);
-        const auto treeId = tree.CreateLeaf(fattenedAABB, DynamicTree::LeafData{
-            bodyID, fixtureID, childIndex});
-        proxies.push_back(treeId);
-        fixtureProxies.push_back(FixtureProxy{treeId});
+    // Gather up the AABBs and leaf data of all the proxies to create.
+    auto aabbs = std::vector<AABB>{};
+    auto leafData = std::vector<BroadPhase::LeafData>{};
+    auto staticAabbs = std::vector<AABB>{};
+    auto staticLeafData = std::vector<BroadPhase::LeafData>{};
+    for (const auto& fixtureID: fixtures)
+    {
+        const auto& fixture = m_fixtureBuffer[UnderlyingValue(fixtureID)];
+        assert(fixture.GetProxies().empty());
+        const auto bodyID = fixture.GetBody();
+        const auto xfm = m_bodyBuffer[UnderlyingValue(bodyID)].GetTransformation();
+        const auto shape = fixture.GetShape();
+        const auto childCount = GetChildCount(shape);
+        const auto toStatic = isStatic(fixture);
+        auto& fixtureAabbs = toStatic? staticAabbs: aabbs;
+        auto& fixtureLeafData = toStatic? staticLeafData: leafData;
+        for (auto childIndex = decltype(childCount){0}; childIndex < childCount; ++childIndex)
+        {
+            const auto dp = GetChild(shape, childIndex);
+            const auto aabb = playrho::d2::ComputeAABB(dp, xfm);
+            fixtureAabbs.push_back(GetFattenedAABB(aabb, aabbExtension));
+            fixtureLeafData.push_back(BroadPhase::LeafData{bodyID, fixtureID, childIndex});
+        }
     }
 
-    fixture.SetProxies(fixtureProxies);
+    // Note: tree IDs can be higher than the number of fixture proxies.
+    const auto treeIds = m_broadPhase.CreateLeafs(aabbs, leafData);
+    auto staticIds = m_staticTree.CreateLeafs(staticAabbs, staticLeafData);
+    for (auto& id: staticIds)
+    {
+        id |= StaticProxyFlag;
+    }
+    m_proxies.insert(end(m_proxies), begin(treeIds), end(treeIds));
+    m_proxies.insert(end(m_proxies), begin(staticIds), end(staticIds));
+    auto treeId = cbegin(treeIds);
+    auto staticId = cbegin(staticIds);
+    for (const auto& fixtureID: fixtures)
+    {
+        auto& fixture = m_fixtureBuffer[UnderlyingValue(fixtureID)];
+        auto& id = isStatic(fixture)? staticId: treeId;
+        const auto childCount = GetChildCount(fixture.GetShape());
+        auto fixtureProxies = std::vector<FixtureProxy>{};
+        fixtureProxies.reserve(childCount);
+        for (auto i = decltype(childCount){0}; i < childCount; ++i)
+        {
+            fixtureProxies.push_back(FixtureProxy{*id++});
+        }
+        fixture.SetProxies(fixtureProxies);
+    }
 }
 
 void WorldImpl::InternalTouchProxies(ProxyQueue& proxies, const Fixture& fixture) noexcept
@@ -2411,31 +3466,38 @@ void WorldImpl::InternalTouchProxies(ProxyQueue& proxies, const Fixture& fixture
     }
 }
 
-ContactCounter WorldImpl::Synchronize(const Body& body,
-                                      const Transformation& xfm1, const Transformation& xfm2,
-                                      Real multiplier, Length extension)
+WorldImpl::SynchronizeStats
+WorldImpl::Synchronize(const Body& body,
+                       const Transformation& xfm1, const Transformation& xfm2,
+                       Real multiplier, Length extension, bool refit)
 {
     assert(::playrho::IsValid(xfm1));
     assert(::playrho::IsValid(xfm2));
 
-    auto updatedCount = ContactCounter{0};
+    auto stats = SynchronizeStats{};
     const auto displacement = multiplier * (xfm2.p - xfm1.p);
+    const auto maxExtension = refit? extension * AabbRefitRatio:
+        std::numeric_limits<Length>::infinity();
     const auto fixtures = body.GetFixtures();
     for_each(cbegin(fixtures), cend(fixtures), [&](const auto& fixtureID) {
-        updatedCount += Synchronize(m_fixtureBuffer[UnderlyingValue(fixtureID)],
-                                    xfm1, xfm2, displacement, extension);
+        const auto fixtureStats = Synchronize(m_fixtureBuffer[UnderlyingValue(fixtureID)],
+                                              xfm1, xfm2, displacement, extension,
+                                              maxExtension);
+        stats.moved += fixtureStats.moved;
+        stats.unmoved += fixtureStats.unmoved;
     });
-    return updatedCount;
+    return stats;
 }
 
-ContactCounter WorldImpl::Synchronize(const Fixture& fixture,
-                                        const Transformation& xfm1, const Transformation& xfm2,
-                                        Length2 displacement, Length extension)
+WorldImpl::SynchronizeStats
+WorldImpl::Synchronize(const Fixture& fixture,
+                       const Transformation& xfm1, const Transformation& xfm2,
+                       Length2 displacement, Length extension, Length maxExtension)
 {
     assert(::playrho::IsValid(xfm1));
     assert(::playrho::IsValid(xfm2));
     
-    auto updatedCount = ContactCounter{0};
+    auto stats = SynchronizeStats{};
     const auto shape = fixture.GetShape();
     const auto proxies = fixture.GetProxies();
     auto childIndex = ChildCounter{0};
@@ -2445,17 +3507,31 @@ ContactCounter WorldImpl::Synchronize(const Fixture& fixture,
         
         // Compute an AABB that covers the swept shape (may miss some rotation effect).
         const auto aabb = ComputeAABB(GetChild(shape, childIndex), xfm1, xfm2);
-        if (!Contains(m_tree.GetAABB(treeId), aabb))
+        const auto oldAabb = GetProxyAABB(m_broadPhase, m_staticTree, treeId);
+        if (!Contains(oldAabb, aabb) ||
+            !Contains(GetDisplacedAABB(GetFattenedAABB(aabb, maxExtension), displacement),
+                      oldAabb))
         {
             const auto newAabb = GetDisplacedAABB(GetFattenedAABB(aabb, extension),
                                                   displacement);
-            m_tree.UpdateLeaf(treeId, newAabb);
+            if (IsStaticProxy(treeId))
+            {
+                m_staticTree.UpdateLeaf(GetStaticLeaf(treeId), newAabb);
+            }
+            else
+            {
+                m_broadPhase.UpdateLeaf(treeId, newAabb);
+            }
             m_proxies.push_back(treeId);
-            ++updatedCount;
+            ++stats.moved;
+        }
+        else
+        {
+            ++stats.unmoved;
         }
         ++childIndex;
     }
-    return updatedCount;
+    return stats;
 }
 
 void WorldImpl::Refilter(FixtureID id)
@@ -2615,7 +3691,68 @@ FixtureCounter WorldImpl::GetShapeCount() const noexcept
     return static_cast<FixtureCounter>(size(shapes));
 }
 
-void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
+ContactCounter WorldImpl::UpdateContacts(const std::vector<ContactID>& contacts,
+                                         const ContactUpdateConf& conf, std::size_t numThreads)
+{
+    auto reused = ContactCounter{0};
+    if (numThreads < 2)
+    {
+        for (const auto& contactID: contacts)
+        {
+            if (Update(contactID, conf))
+            {
+                ++reused;
+            }
+        }
+        return reused;
+    }
+
+    // Threads take chunks of contacts till there are none left. This balances the load
+    // better than splitting the contacts up evenly since some contacts are a lot more
+    // work to update than others.
+    const auto numContacts = size(contacts);
+    const auto chunkSize = std::size_t{m_updateContactsChunkSize};
+    m_contactUpdates.resize(numContacts);
+    auto next = std::atomic<std::size_t>{0};
+    const auto updateChunks = [&](std::size_t) {
+        for (auto first = next.fetch_add(chunkSize); first < numContacts;
+             first = next.fetch_add(chunkSize))
+        {
+            const auto last = std::min(first + chunkSize, numContacts);
+            for (auto i = first; i < last; ++i)
+            {
+                m_contactUpdates[i] = UpdateManifold(contacts[i], conf);
+            }
+        }
+    };
+    for (auto i = decltype(numThreads){0}; i < numThreads; ++i)
+    {
+        m_threadPool.Push(updateChunks);
+    }
+    m_threadPool.Wait();
+
+    // Listeners can do most anything so they're only called from this thread and in
+    // the same order as they would've been without the extra threads.
+    for (auto i = decltype(numContacts){0}; i < numContacts; ++i)
+    {
+        Notify(contacts[i], m_contactUpdates[i]);
+        if (m_contactUpdates[i].reused)
+        {
+            ++reused;
+        }
+    }
+    return reused;
+}
+
+bool WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
+{
+    const auto result = UpdateManifold(contactID, conf);
+    Notify(contactID, result);
+    return result.reused;
+}
+
+WorldImpl::ContactUpdateResult
+WorldImpl::UpdateManifold(ContactID contactID, const ContactUpdateConf& conf)
 {
     auto& c = m_contactBuffer[UnderlyingValue(contactID)];
     auto& manifold = m_manifoldBuffer[UnderlyingValue(contactID)];
@@ -2624,6 +3761,7 @@ void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
     // Note: do not assume the fixture AABBs are overlapping or are valid.
     const auto oldTouching = c.IsTouching();
     auto newTouching = false;
+    auto reused = false;
 
     const auto bodyIdA = c.GetBodyA();
     const auto fixtureIdA = c.GetFixtureA();
@@ -2633,14 +3771,13 @@ void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
     const auto indexB = c.GetChildIndexB();
     const auto& fixtureA = m_fixtureBuffer[UnderlyingValue(fixtureIdA)];
     const auto& fixtureB = m_fixtureBuffer[UnderlyingValue(fixtureIdB)];
-    const auto shapeA = fixtureA.GetShape();
+    const auto& shapeA = fixtureA.GetShape();
     const auto& bodyA = m_bodyBuffer[UnderlyingValue(bodyIdA)];
     const auto& bodyB = m_bodyBuffer[UnderlyingValue(bodyIdB)];
     const auto xfA = bodyA.GetTransformation();
-    const auto shapeB = fixtureB.GetShape();
+    const auto& shapeB = fixtureB.GetShape();
     const auto xfB = bodyB.GetTransformation();
-    const auto childA = GetChild(shapeA, indexA);
-    const auto childB = GetChild(shapeB, indexB);
+    const auto pose = MulT(xfA, xfB);
 
     // NOTE: Ideally, the touching state returned by the TestOverlap function
     //   agrees 100% of the time with that returned from the CollideShapes function.
@@ -2651,7 +3788,11 @@ void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
     const auto sensor = fixtureA.IsSensor() || fixtureB.IsSensor();
     if (sensor)
     {
-        const auto overlapping = TestOverlap(childA, xfA, childB, xfB, conf.distance);
+        const auto childA = GetChild(shapeA, indexA);
+        const auto childB = GetChild(shapeB, indexB);
+        auto indices = c.GetSimplexIndices();
+        const auto overlapping = TestOverlap(childA, xfA, childB, xfB, conf.distance, indices);
+        c.SetSimplexIndices(indices);
         newTouching = (overlapping >= 0_m2);
 
 #ifdef OVERLAP_TOLERANCE
@@ -2666,9 +3807,19 @@ void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
         // Sensors don't generate manifolds.
         manifold = Manifold{};
     }
+    else if (IsReusable(contactID, oldManifold, pose, conf))
+    {
+        // The solvers re-project the manifold with the bodies' current transformations.
+        newTouching = true;
+        reused = true;
+    }
     else
     {
-        auto newManifold = CollideShapes(childA, xfA, childB, xfB, conf.manifold);
+        m_manifoldPoses[UnderlyingValue(contactID)] = pose;
+
+        // Dispatches to the collision kernel for the shapes' types.
+        auto newManifold = CollideShapes(shapeA, indexA, xfA, shapeB, indexB, xfB,
+                                         conf.manifold);
 
         const auto old_point_count = oldManifold.GetPointCount();
         const auto new_point_count = newManifold.GetPointCount();
@@ -2678,7 +3829,8 @@ void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
 #ifdef OVERLAP_TOLERANCE
 #ifndef NDEBUG
         const auto tolerance = OVERLAP_TOLERANCE;
-        const auto overlapping = TestOverlap(childA, xfA, childB, xfB, conf.distance);
+        const auto overlapping = TestOverlap(GetChild(shapeA, indexA), xfA,
+                                             GetChild(shapeB, indexB), xfB, conf.distance);
         assert(newTouching == (overlapping >= 0_m2) ||
                abs(overlapping) < tolerance);
 #endif
@@ -2749,25 +3901,50 @@ void WorldImpl::Update(ContactID contactID, const ContactUpdateConf& conf)
     if (!oldTouching && newTouching)
     {
         c.SetTouching();
+    }
+    else if (oldTouching && !newTouching)
+    {
+        c.UnsetTouching();
+    }
+
+    return ContactUpdateResult{oldManifold, oldTouching, newTouching, sensor, reused};
+}
+
+bool WorldImpl::IsReusable(ContactID contactID, const Manifold& manifold,
+                           const Transformation& pose, const ContactUpdateConf& conf) const noexcept
+{
+    // Only touching manifolds get reused so that no new touching is missed.
+    if ((conf.reuseDistance <= 0_m) || (manifold.GetPointCount() == 0))
+    {
+        return false;
+    }
+    const auto& lastPose = m_manifoldPoses[UnderlyingValue(contactID)];
+    return (GetMagnitudeSquared(pose.p - lastPose.p) < Square(conf.reuseDistance)) &&
+        (Dot(pose.q, lastPose.q) > conf.reuseCosine);
+}
+
+void WorldImpl::Notify(ContactID contactID, const ContactUpdateResult& result)
+{
+    if (!result.oldTouching && result.newTouching)
+    {
         if (m_beginContactListener)
         {
             m_beginContactListener(contactID);
         }
     }
-    else if (oldTouching && !newTouching)
+    else if (result.oldTouching && !result.newTouching)
     {
-        c.UnsetTouching();
         if (m_endContactListener)
         {
             m_endContactListener(contactID);
         }
     }
 
-    if (!sensor && newTouching)
+    if (!result.sensor && result.newTouching)
     {
         if (m_preSolveContactListener)
         {
-            m_preSolveContactListener(contactID, oldManifold);
+            m_preSolveContactListener(contactID, result.oldManifold);
         }
     }
 }
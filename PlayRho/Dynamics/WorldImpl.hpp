@@ -29,9 +29,12 @@
 #include <PlayRho/Common/Range.hpp> // for SizedRange
 #include <PlayRho/Common/Positive.hpp>
 #include <PlayRho/Common/ArrayAllocator.hpp>
+#include <PlayRho/Common/ThreadPool.hpp>
 
+#include <PlayRho/Collision/BroadPhase.hpp>
 #include <PlayRho/Collision/DynamicTree.hpp>
 #include <PlayRho/Collision/MassData.hpp>
+#include <PlayRho/Collision/Manifold.hpp>
 
 #include <PlayRho/Dynamics/BodyID.hpp>
 #include <PlayRho/Dynamics/Filter.hpp>
@@ -42,6 +45,8 @@
 #include <PlayRho/Dynamics/StepStats.hpp>
 #include <PlayRho/Dynamics/Contacts/ContactKey.hpp>
 #include <PlayRho/Dynamics/Contacts/KeyedContactID.hpp> // for KeyedContactPtr
+#include <PlayRho/Dynamics/Contacts/BodyConstraint.hpp>
+#include <PlayRho/Dynamics/Contacts/VelocityConstraint.hpp>
 #include <PlayRho/Dynamics/FixtureProxy.hpp>
 #include <PlayRho/Dynamics/WorldConf.hpp>
 #include <PlayRho/Dynamics/Joints/JointID.hpp>
@@ -71,6 +76,7 @@ class Joint;
 class Shape;
 class Manifold;
 class ContactImpulsesList;
+class VelocityConstraint;
 
 /// @brief Definition of a "world" implementation.
 /// @see World.
@@ -102,6 +108,27 @@ public:
 
     struct ContactUpdateConf;
 
+    /// @brief Island-local body constraints buffer.
+    /// @details Reused from island to island so that getting the body constraints of an
+    ///   island takes time proportional to the island's size instead of the world's size.
+    struct BodyConstraintsBuffer
+    {
+        std::vector<BodyConstraint> constraints; ///< Constraints in island body order.
+        std::vector<BodyCounter> indices; ///< Island-local indices by body identifier.
+    };
+
+    /// @brief Colouring of the contact constraints of an island.
+    /// @details No two constraints of the same colour share a movable body, except for
+    ///   those of the last colour which get solved one at a time.
+    /// @see WorldConf::colorConstraints.
+    struct ConstraintColors
+    {
+        std::vector<std::size_t> constraints; ///< Constraint indices grouped by colour.
+        std::vector<std::size_t> offsets; ///< Offsets of the colours' groups plus the end.
+        std::vector<std::uint8_t> colors; ///< Colours indexed by constraint.
+        std::vector<std::uint64_t> bodyColors; ///< Colours taken, as bits, by island body.
+    };
+
     /// @brief Constructs a world implementation for a world.
     /// @param def A customized world configuration or its default value.
     /// @note A lot more configurability can be had via the <code>StepConf</code>
@@ -303,8 +330,17 @@ public:
     void SetSubStepping(bool flag) noexcept;
 
     /// @brief Gets access to the broad-phase dynamic tree information.
+    /// @note This is an empty tree if the world's broad-phase isn't a dynamic tree.
+    /// @see GetBroadPhase
     const DynamicTree& GetTree() const noexcept;
 
+    /// @brief Gets access to the broad-phase.
+    const BroadPhase& GetBroadPhase() const noexcept;
+
+    /// @brief Gets access to the dynamic tree of static proxies.
+    /// @see WorldConf::separateStaticTree
+    const DynamicTree& GetStaticTree() const noexcept;
+
     /// @brief Is the world locked (in the middle of a time step).
     bool IsLocked() const noexcept;
 
@@ -499,6 +535,10 @@ private:
         
         /// Step complete. @details Used for sub-stepping. @see e_substepping.
         e_stepComplete  = 0x0040,
+
+        /// Static tree. @details Static bodies' proxies go in the static tree.
+        /// @see WorldConf::separateStaticTree.
+        e_staticTree    = 0x0080,
     };
 
     /// @brief Solves the step.
@@ -510,26 +550,45 @@ private:
     /// @brief Solves the given island (regularly).
     ///
     /// @details This:
-    ///   1. Updates every island-body's <code>sweep.pos0</code> to its <code>sweep.pos1</code>.
-    ///   2. Updates every island-body's <code>sweep.pos1</code> to the new normalized "solved"
-    ///      position for it.
-    ///   3. Updates every island-body's velocity to the new accelerated, dampened, and "solved"
-    ///      velocity for it.
-    ///   4. Synchronizes every island-body's transform (by updating it to transform one of the
-    ///      body's sweep).
-    ///   5. Reports to the listener (if non-null).
+    ///   1. Updates every non-static island-body's <code>sweep.pos1</code> to the new
+    ///      normalized "solved" position for it.
+    ///   2. Updates every non-static island-body's velocity to the new accelerated, dampened,
+    ///      and "solved" velocity for it.
+    ///   3. Synchronizes every non-static island-body's transform (by updating it to
+    ///      transform one of the body's sweep).
+    ///
+    /// @note This doesn't flag contacts for updating nor call the post-solve contact
+    ///   listener. It only writes to the non-static bodies, the contacts' manifolds, and the
+    ///   joints of the given island. This makes it safe to call concurrently for islands
+    ///   that have none of those in common and that aren't solved by colour.
+    /// @note Islands that are solved by colour use the constraint colours buffer and the
+    ///   constraint threads so they must be solved one at a time.
+    ///
+    /// @pre Every island-body's <code>sweep.pos0</code> has been set to its
+    ///   <code>sweep.pos1</code>.
     ///
     /// @param conf Time step configuration information.
     /// @param island Island of bodies, contacts, and joints to solve for. Must contain at least
     ///   one body, contact, or joint.
+    /// @param[out] velConstraints Velocity constraints of the island's contacts.
+    /// @param[out] moved Bodies whose transformations changed. Their contacts need flagging
+    ///   for updating.
+    /// @param buffer Body constraints buffer to use. Concurrent calls need their own.
     ///
     /// @warning Behavior is undefined if the given island doesn't have at least one body,
     ///   contact, or joint.
     ///
     /// @return Island solver results.
     ///
-    IslandStats SolveRegIslandViaGS(const StepConf& conf, const Island& island);
+    IslandStats SolveRegIslandViaGS(const StepConf& conf, const Island& island,
+                                    std::vector<VelocityConstraint>& velConstraints,
+                                    std::vector<BodyID>& moved,
+                                    BodyConstraintsBuffer& buffer);
     
+    /// @brief Gets whether the contact constraints of the given island get solved by colour.
+    /// @see WorldConf::colorConstraints, StepConf::doWideSolve.
+    bool IsSolvedByColor(const Island& island, const StepConf& conf) const noexcept;
+
     /// @brief Adds to the island based off of a given "seed" body.
     /// @post Contacts are listed in the island in the order that bodies provide those contacts.
     /// @post Joints are listed the island in the order that bodies provide those joints.
@@ -580,6 +639,18 @@ private:
     ///
     IslandStats SolveToi(ContactID contactID, const StepConf& conf);
 
+    /// @brief Builds the island for the given time of impact event.
+    /// @details Advances the bodies of the given contact to its time of impact, updates the
+    ///   contact, and - if it's still touching - adds it, its bodies, and the appropriate
+    ///   other contacts and bodies of its bodies to the given island.
+    /// @note The island is left empty if the contact isn't touching at its time of impact.
+    /// @param contactID Identifier of contact to build the island for.
+    /// @param[in,out] island Empty island to build.
+    /// @param conf Time step configuration to build for.
+    /// @return Island statistics with just the counts of contacts updated and skipped.
+    /// @see SolveToi(ContactID, const StepConf&).
+    IslandStats BuildToiIsland(ContactID contactID, Island& island, const StepConf& conf);
+
     /// @brief Solves the time of impact for bodies 0 and 1 of the given island.
     ///
     /// @details This:
@@ -602,6 +673,23 @@ private:
     ///
     IslandStats SolveToiViaGS(const Island& island, const StepConf& conf);
 
+    /// @brief Solves the time of impact for the given island without flagging contacts for
+    ///   updating and without calling the post-solve contact listener.
+    /// @details This only writes to the non-static bodies of the given island. This makes
+    ///   it safe to call concurrently for islands that have no such bodies in common.
+    /// @param island Island to do time of impact solving for.
+    /// @param conf Time step configuration information.
+    /// @param[out] velConstraints Velocity constraints of the island's contacts.
+    /// @param[out] moved Bodies whose transformations changed. Their contacts need flagging
+    ///   for updating.
+    /// @param buffer Body constraints buffer to use. Concurrent calls need their own.
+    /// @return Island solver results.
+    /// @see SolveToiViaGS(const Island&, const StepConf&).
+    IslandStats SolveToiViaGS(const Island& island, const StepConf& conf,
+                              std::vector<VelocityConstraint>& velConstraints,
+                              std::vector<BodyID>& moved,
+                              BodyConstraintsBuffer& buffer);
+
     /// @brief Updates the given body.
     /// @details Updates the given body's sweep position 1, and its transformation.
     /// @param body Body to update.
@@ -665,6 +753,9 @@ private:
 
         /// @brief Number of contacts skipped because they weren't marked as needing updating.
         ContactCounter skipped = 0;
+
+        /// @brief Number of contacts updated by reusing their manifolds.
+        ContactCounter reused = 0;
     };
 
     /// @brief Destroy contacts statistics.
@@ -674,6 +765,20 @@ private:
         ContactCounter erased = 0; ///< Erased.
     };
 
+    /// @brief Synchronize statistics.
+    struct SynchronizeStats
+    {
+        ContactCounter moved = 0; ///< Proxies moved.
+        ContactCounter unmoved = 0; ///< Proxies whose AABB still contained their shape.
+    };
+
+    /// @brief Find new contacts statistics.
+    struct FindNewContactsStats
+    {
+        ContactCounter added = 0; ///< Contacts added.
+        ContactCounter falsePairs = 0; ///< Contacts added whose child AABBs don't overlap.
+    };
+
     /// @brief Contact TOI data.
     struct ContactToiData
     {
@@ -701,19 +806,73 @@ private:
         dist_iter_type maxDistIters = 0; ///< Max distance iterations.
         toi_iter_type maxToiIters = 0; ///< Max TOI iterations.
         root_iter_type maxRootIters = 0; ///< Max root iterations.
+
+        ToiStepStats::counter_type sumDistIters = 0; ///< Sum of distance iterations.
+        ToiStepStats::counter_type sumToiIters = 0; ///< Sum of TOI iterations.
+    };
+
+    /// @brief Island of the regular phase and the results of solving it.
+    struct RegIsland
+    {
+        Island island; ///< Island.
+        IslandStats stats; ///< Statistics of solving the island.
+        std::vector<VelocityConstraint> velConstraints; ///< Velocity constraints of its contacts.
+        std::vector<BodyID> moved; ///< Bodies whose transformations changed.
     };
 
-    /// @brief Updates the contact times of impact.
-    static UpdateContactsData UpdateContactTOIs(ArrayAllocator<Contact>& contactBuffer,
-                                                ArrayAllocator<Body>& bodyBuffer,
-                                                const ArrayAllocator<Fixture>& fixtureBuffer,
-                                                const Contacts& contacts, const StepConf& conf);
+    /// @brief Time of impact queue entry.
+    struct ToiQueueEntry
+    {
+        Real toi; ///< Time of impact the contact had when this entry was queued.
+        ContactCounter position; ///< Position of the contact in the contacts container.
+    };
+
+    /// @brief Updates the times of impact of the TOI candidate contacts.
+    /// @details Goes through the contacts at the positions in <code>m_toiCandidates</code>
+    ///   in the order they're in the contacts container. Those that get a time of impact
+    ///   which could be the soonest are queued. Afterwards, the candidates are just those
+    ///   whose eligibility for a time of impact could still change during this step.
+    UpdateContactsData UpdateContactTOIs(const StepConf& conf);
 
     /// @brief Gets the soonest contact.
-    /// @details This finds the contact with the lowest (soonest) time of impact.
+    /// @details This finds the contact with the lowest (soonest) time of impact from those
+    ///   queued, discarding entries for contacts whose times of impact have been unset
+    ///   or changed since they were queued. Ties go to the contact that's first in the
+    ///   contacts container.
     /// @return Contact with the least time of impact and its time of impact, or null contact.
     ///  A non-null contact will be enabled, not have sensors, be active, and impenetrable.
-    static ContactToiData GetSoonestContact(const Contacts& contacts, const ArrayAllocator<Contact>& buffer) noexcept;
+    ContactToiData GetSoonestContact();
+
+    /// @brief Determines whether the given queue entry is stale.
+    /// @details Entries are stale once the time of impact of their contact has been unset
+    ///   or changed since they were queued.
+    bool IsStale(const ToiQueueEntry& entry) const noexcept;
+
+    /// @brief Finds the time of impact events that can be solved together with the event
+    ///   of the contact that's first in <code>m_toiBatch</code>.
+    /// @details Appends to <code>m_toiBatch</code>, in the order they'd otherwise get
+    ///   solved in, the queued events having times of impact no greater than the given
+    ///   value up to the first one whose region isn't disjoint from those of the events
+    ///   before it.
+    /// @see MarkToiRegion.
+    void FindToiBatch(Real maxToi);
+
+    /// @brief Marks the region of bodies that solving the given contact's TOI event could
+    ///   involve.
+    /// @details The region is the set of non-static bodies reachable from the contact's
+    ///   bodies through non-sensor impenetrable contacts. Static bodies are left unmarked
+    ///   since they can be shared by the islands of different events. Islands
+    ///   of TOI events and the contacts getting their times of impact updated after
+    ///   solving them never reach outside of this. The region's bodies can only come into
+    ///   new contacts within the enclosing AABB of their proxies, which cover their motion
+    ///   for the rest of the step, so regions whose AABBs don't overlap can't interact.
+    /// @param contactID Identifier of contact to mark the region of.
+    /// @param region Non-zero number to mark the region's bodies with.
+    /// @param[in,out] budget Remaining number of bodies that can be marked.
+    /// @return <code>true</code> if the region was completely marked without running into
+    ///   any bodies of other regions nor overlapping their AABBs, <code>false</code>
+    ///   otherwise.
+    bool MarkToiRegion(ContactID contactID, ContactCounter region, BodyCounter& budget);
     
     /// @brief Determines whether this world has new fixtures.
     bool HasNewFixtures() const noexcept;
@@ -723,8 +882,15 @@ private:
     
     /// @brief Finds new contacts.
     /// @details Finds and adds new valid contacts to the contacts container.
-    /// @note The new contacts will all have overlapping AABBs.
-    ContactCounter FindNewContacts();
+    /// @param countFalsePairs Whether to count the contacts added whose fixture children's
+    ///   AABBs don't overlap.
+    /// @note The new contacts will all have overlapping proxy AABBs.
+    FindNewContactsStats FindNewContacts(bool countFalsePairs = false);
+
+    /// @brief Finds the sorted unique contact keys for the proxies queue on the given
+    ///   number of threads.
+    /// @post <code>m_proxyKeys</code> has the keys.
+    void FindContactKeysConcurrently(std::size_t numThreads);
 
     /// @brief Processes the narrow phase collision for the contacts collection.
     /// @details
@@ -768,10 +934,11 @@ private:
                                 ArrayAllocator<Manifold>& manifoldBuffer,
                                 ContactListener listener, Body* from = nullptr);
 
-    /// @brief Creates proxies for every child of the given fixture's shape.
-    /// @note This sets the proxy count to the child count of the shape.
-    static void CreateProxies(FixtureID id, Fixture& fixture, const Transformation& xfm,
-                              ProxyQueue& proxies, DynamicTree& tree, Length aabbExtension);
+    /// @brief Creates proxies for every child of the identified fixtures' shapes.
+    /// @details Creates the broad-phase leafs for all of the proxies in one batch so that
+    ///   the broad-phase can build them in bulk when there are many of them.
+    /// @note This sets the proxy count of each fixture to the child count of its shape.
+    void CreateProxies(const Fixtures& fixtures, Length aabbExtension);
 
     /// @brief Touches each proxy of the given fixture.
     /// @note This sets things up so that pairs may be created for potentially new contacts.
@@ -780,22 +947,39 @@ private:
     /// @brief Synchronizes the given body.
     /// @details This updates the broad phase dynamic tree data for all of the given
     ///   body's fixtures.
-    ContactCounter Synchronize(const Body& body,
-                               const Transformation& xfm1, const Transformation& xfm2,
-                               Real multiplier, Length extension);
+    /// @param refit Whether to also update proxies whose AABBs have become more than
+    ///   <code>AabbRefitRatio</code> times larger than the given extension needs.
+    SynchronizeStats Synchronize(const Body& body,
+                                 const Transformation& xfm1, const Transformation& xfm2,
+                                 Real multiplier, Length extension, bool refit);
     
     /// @brief Synchronizes the given fixture.
     /// @details This updates the broad phase dynamic tree data for all of the given
-    ///   fixture shape's children.
-    ContactCounter Synchronize(const Fixture& fixture,
-                               const Transformation& xfm1, const Transformation& xfm2,
-                               Length2 displacement, Length extension);
+    ///   fixture shape's children whose AABBs no longer contain them or whose AABBs
+    ///   aren't contained by the AABB extended by the given maximum extension.
+    SynchronizeStats Synchronize(const Fixture& fixture,
+                                 const Transformation& xfm1, const Transformation& xfm2,
+                                 Length2 displacement, Length extension, Length maxExtension);
+
+    /// @brief Gets the AABB extension for the proxies of the identified body.
+    /// @see StepConf::aabbExtensionSteps.
+    Length GetAabbExtension(BodyID id, const StepConf& conf) const noexcept;
+
+    /// @brief Updates the recent per-step distance moved of the identified body.
+    /// @see GetAabbExtension.
+    void UpdateMotion(BodyID id, Length distance) noexcept;
 
     /// @brief Creates and destroys proxies.
     void CreateAndDestroyProxies(Length extension);
 
     /// @brief Synchronizes proxies of the bodies for proxies.
-    PreStepStats::counter_type SynchronizeProxies(const StepConf& conf);
+    SynchronizeStats SynchronizeProxies(const StepConf& conf);
+
+    /// @brief Incrementally optimizes the broad-phase within the given step's budget.
+    /// @details Updates the given stats with the work done and with the broad-phase's
+    ///   quality metrics.
+    /// @see StepConf::treeOptimizeBudget, DynamicTree::Optimize.
+    void OptimizeBroadPhase(const StepConf& conf, PreStepStats& stats);
 
     /// @brief Updates the touching related state and notifies listener (if one given).
     ///
@@ -809,9 +993,49 @@ private:
     /// @param id Identifies the contact to update.
     /// @param conf Per-step configuration information.
     ///
+    /// @return Whether the contact's manifold was reused rather than recomputed.
+    ///
     /// @see GetManifold, IsTouching
     ///
-    void Update(ContactID id, const ContactUpdateConf& conf);
+    bool Update(ContactID id, const ContactUpdateConf& conf);
+
+    /// @brief Contact update result.
+    /// @details What updating a contact's manifold found that its listeners get told of.
+    struct ContactUpdateResult
+    {
+        Manifold oldManifold; ///< Manifold of the contact from before the update.
+        bool oldTouching = false; ///< Whether the contact was touching before the update.
+        bool newTouching = false; ///< Whether the contact is touching after the update.
+        bool sensor = false; ///< Whether the contact is for a sensor.
+        bool reused = false; ///< Whether the manifold was reused rather than recomputed.
+    };
+
+    /// @brief Updates the manifold and touching related state of the identified contact.
+    /// @details This is the part of updating a contact that doesn't call any listeners.
+    /// @note This only modifies the identified contact and its manifold. So this can be
+    ///   called for different contacts concurrently.
+    /// @see Update.
+    ContactUpdateResult UpdateManifold(ContactID id, const ContactUpdateConf& conf);
+
+    /// @brief Determines whether the given manifold of the identified contact can be reused.
+    /// @details The manifold can be reused if it's touching and the given relative
+    ///   transformation of the contact's bodies is within the reuse distance and angle
+    ///   of the given configuration of what it was when the manifold was computed.
+    /// @see StepConf::manifoldReuseDistance.
+    bool IsReusable(ContactID id, const Manifold& manifold, const Transformation& pose,
+                    const ContactUpdateConf& conf) const noexcept;
+
+    /// @brief Notifies the listeners of the given result of updating the identified contact.
+    /// @see UpdateManifold.
+    void Notify(ContactID id, const ContactUpdateResult& result);
+
+    /// @brief Updates the identified contacts over multiple threads.
+    /// @details Computes the manifolds of the contacts in chunks shared among up to the
+    ///   given number of threads, and then notifies the listeners of the results in the
+    ///   order of the given contacts.
+    /// @return Number of the contacts whose manifolds were reused.
+    ContactCounter UpdateContacts(const std::vector<ContactID>& contacts,
+                                  const ContactUpdateConf& conf, std::size_t numThreads);
 
     /******** Member variables. ********/
 
@@ -821,9 +1045,25 @@ private:
     ArrayAllocator<Contact> m_contactBuffer;
     ArrayAllocator<Manifold> m_manifoldBuffer;
 
-    DynamicTree m_tree; ///< Dynamic tree.
+    BroadPhase m_broadPhase; ///< Broad-phase.
+    DynamicTree m_staticTree; ///< Tree of static proxies. @see e_staticTree.
+
+    /// @brief Broad-phase optimizer progress.
+    struct OptimizerState
+    {
+        BroadPhase::Size next = 0; ///< Index to resume optimizing from.
+        Length perimeter = 0_m; ///< Perimeter sum of the nodes of the current sweep.
+        DynamicTree::Height maxImbalance = 0; ///< Max imbalance of the current sweep.
+        DynamicTree::Height lastMaxImbalance = 0; ///< Max imbalance of the last full sweep.
+        Real lastPerimeterRatio = 0; ///< Perimeter ratio of the last full sweep.
+        std::vector<BroadPhase::Size> buffer; ///< Scratch buffer of the optimizing.
+    };
+
+    OptimizerState m_optimizer; ///< Broad-phase optimizer progress.
 
     ContactKeyQueue m_proxyKeys; ///< Proxy keys.
+    std::vector<ContactKeyQueue> m_threadProxyKeys; ///< Per-thread proxy keys.
+    std::vector<ContactKeyQueue> m_mergedProxyKeys; ///< Merged per-thread proxy keys.
     ProxyQueue m_proxies; ///< Proxies queue.
     Fixtures m_fixturesForProxies; ///< Fixtures for proxies queue.
     Bodies m_bodiesForProxies; ///< Bodies for proxies queue.
@@ -838,10 +1078,63 @@ private:
     Contacts m_contacts;
 
     Island m_island; ///< Island buffer.
+
+    /// @brief Islands of the regular phase buffer.
+    /// @note Islands get reused from step to step so their containers keep their capacity.
+    std::vector<RegIsland> m_regIslands;
+
+    /// @brief Indices of the <code>m_regIslands</code> to solve from the island threads in
+    ///   the order of solving them.
+    std::vector<std::size_t> m_regIslandOrder;
     std::vector<bool> m_islandedBodies;
     std::vector<bool> m_islandedContacts;
     std::vector<bool> m_islandedJoints;
 
+    /// @brief Min-heap of times of impact of contacts.
+    /// @note Contacts only get appended to <code>m_contacts</code> while solving for TOI
+    ///   events so their positions in it can identify them and order ties between them.
+    /// @see GetSoonestContact.
+    std::vector<ToiQueueEntry> m_toiQueue;
+
+    std::vector<ToiQueueEntry> m_toiSimultaneous; ///< Soonest entries buffer.
+    std::vector<std::size_t> m_toiHeapNodes; ///< Indices of TOI queue nodes buffer.
+
+    std::vector<ContactID> m_toiBatch; ///< Contacts of batched TOI events buffer.
+    std::vector<ContactCounter> m_toiRegions; ///< TOI region numbers indexed by body identifier.
+    std::vector<BodyID> m_toiRegionBodies; ///< Bodies marked with TOI region numbers buffer.
+    std::vector<AABB> m_toiRegionAABBs; ///< Proxy AABBs of the marked TOI regions buffer.
+    std::vector<BodyID> m_toiMoved; ///< Bodies moved by solving a TOI island buffer.
+
+    /// @brief Body constraints buffer for solving islands from the calling thread.
+    BodyConstraintsBuffer m_bodyConstraintsBuffer;
+
+    /// @brief Colouring of the constraints of the island being solved by colour.
+    ConstraintColors m_constraintColors;
+
+    /// @brief Body constraints buffers for solving islands from the thread pool's workers,
+    ///   indexed by worker.
+    std::vector<BodyConstraintsBuffer> m_workerBodyConstraintsBuffers;
+
+    /// @brief Positions of contacts whose times of impact need updating.
+    /// @see UpdateContactTOIs.
+    std::vector<ContactCounter> m_toiCandidates;
+
+    /// @brief Positions of contacts in <code>m_contacts</code>, indexed by contact identifier.
+    std::vector<ContactCounter> m_contactPositions;
+
+    std::vector<ContactID> m_contactsToUpdate; ///< Contacts needing updating buffer.
+    std::vector<ContactUpdateResult> m_contactUpdates; ///< Contact update results buffer.
+
+    /// @brief Recent per-step distances moved of bodies, indexed by body identifier.
+    /// @see GetAabbExtension.
+    std::vector<Length> m_bodyMotions;
+
+    /// @brief Relative transformations of the second bodies of contacts to their first
+    ///   bodies from when the contacts' manifolds were last computed, indexed by contact
+    ///   identifier.
+    /// @see StepConf::manifoldReuseDistance.
+    std::vector<Transformation> m_manifoldPoses;
+
     FixtureListener m_fixtureDestructionListener;
     JointListener m_jointDestructionListener;
     ContactListener m_beginContactListener;
@@ -869,6 +1162,22 @@ private:
     /// numerical issues. It can also be set below this upper bound to constrain the differences
     /// between shape vertex radiuses to possibly more limited visual ranges.
     Positive<Length> m_maxVertexRadius;
+
+    /// @brief Pool of the extra threads to step with.
+    /// @see WorldConf::threads.
+    ThreadPool m_threadPool;
+
+    /// @brief Number of contacts that threads updating contacts take at a time.
+    /// @see WorldConf::updateContactsChunkSize.
+    ContactCounter m_updateContactsChunkSize = 64;
+
+    /// @brief Whether to solve the contact constraints of big islands colour by colour.
+    /// @see WorldConf::colorConstraints.
+    bool m_colorConstraints = false;
+
+    /// @brief Time window of batched TOI events.
+    /// @see WorldConf::toiBatchWindow.
+    Real m_toiBatchWindow = Real{1} / Real{16};
 };
 
 inline SizedRange<WorldImpl::Bodies::const_iterator> WorldImpl::GetBodies() const noexcept
@@ -960,9 +1269,14 @@ inline Frequency WorldImpl::GetInvDeltaTime() const noexcept
     return m_inv_dt0;
 }
 
-inline const DynamicTree& WorldImpl::GetTree() const noexcept
+inline const BroadPhase& WorldImpl::GetBroadPhase() const noexcept
+{
+    return m_broadPhase;
+}
+
+inline const DynamicTree& WorldImpl::GetStaticTree() const noexcept
 {
-    return m_tree;
+    return m_staticTree;
 }
 
 inline void WorldImpl::SetFixtureDestructionListener(FixtureListener listener) noexcept
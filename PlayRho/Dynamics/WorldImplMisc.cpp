@@ -166,6 +166,16 @@ const DynamicTree& GetTree(const WorldImpl& world) noexcept
     return world.GetTree();
 }
 
+const BroadPhase& GetBroadPhase(const WorldImpl& world) noexcept
+{
+    return world.GetBroadPhase();
+}
+
+const DynamicTree& GetStaticTree(const WorldImpl& world) noexcept
+{
+    return world.GetStaticTree();
+}
+
 FixtureCounter GetShapeCount(const WorldImpl& world) noexcept
 {
     return world.GetShapeCount();
@@ -51,6 +51,7 @@ class Manifold;
 struct BodyConf;
 struct JointConf;
 class DynamicTree;
+class BroadPhase;
 struct WorldConf;
 class ContactImpulsesList;
 
@@ -111,6 +112,10 @@ Frequency GetInvDeltaTime(const WorldImpl& world) noexcept;
 
 const DynamicTree& GetTree(const WorldImpl& world) noexcept;
 
+const BroadPhase& GetBroadPhase(const WorldImpl& world) noexcept;
+
+const DynamicTree& GetStaticTree(const WorldImpl& world) noexcept;
+
 FixtureCounter GetShapeCount(const WorldImpl& world) noexcept;
 
 } // namespace d2
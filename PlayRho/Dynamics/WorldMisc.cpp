@@ -29,6 +29,9 @@
 #include <PlayRho/Dynamics/FixtureProxy.hpp>
 #include <PlayRho/Dynamics/MovementConf.hpp>
 
+#include <PlayRho/Collision/BroadPhase.hpp>
+#include <PlayRho/Detail/QueryBatch.hpp>
+
 #include <algorithm> // for std::for_each
 
 using std::for_each;
@@ -74,6 +77,66 @@ const DynamicTree& GetTree(const World& world) noexcept
     return world.GetTree();
 }
 
+const BroadPhase& GetBroadPhase(const World& world) noexcept
+{
+    return world.GetBroadPhase();
+}
+
+const DynamicTree& GetStaticTree(const World& world) noexcept
+{
+    return world.GetStaticTree();
+}
+
+namespace {
+
+/// @brief Queries the given range of boxes, appending the hits found to the given buffer
+///   and setting the offsets of the queries into it.
+void QueryBatch(const World& world, Span<const AABB> aabbs, std::size_t first,
+                std::size_t last, std::vector<QueryHit>& hits, std::vector<std::size_t>& offsets)
+{
+    const auto& broadPhase = GetBroadPhase(world);
+    const auto& staticTree = GetStaticTree(world);
+    const auto tree = TypeCast<const DynamicTree*>(&broadPhase);
+    const auto addHit = [&hits](FixtureID fixture, ChildCounter child) {
+        hits.push_back(QueryHit{fixture, child});
+        return true;
+    };
+    for (auto i = first; i < last; ++i)
+    {
+        offsets[i] = size(hits);
+        if (tree)
+        {
+            Query(*tree, aabbs[i], addHit);
+        }
+        else
+        {
+            Query(broadPhase, aabbs[i], addHit);
+        }
+        Query(staticTree, aabbs[i], addHit);
+    }
+}
+
+} // anonymous namespace
+
+void QueryBatch(const World& world, Span<const AABB> aabbs, QueryBatchResults& results)
+{
+    const auto count = aabbs.size();
+    results.hits.clear();
+    results.offsets.resize(count + 1);
+    QueryBatch(world, aabbs, 0, count, results.hits, results.offsets);
+    results.offsets[count] = size(results.hits);
+}
+
+void QueryBatch(const World& world, Span<const AABB> aabbs, QueryBatchResults& results,
+                ThreadPool& pool)
+{
+    detail::QueryBatch(aabbs.size(), results, pool,
+                       [&world,aabbs,&results](std::size_t first, std::size_t last,
+                                               std::vector<QueryHit>& hits) {
+        QueryBatch(world, aabbs, first, last, hits, results.offsets);
+    });
+}
+
 FixtureCounter GetShapeCount(const World& world) noexcept
 {
     return world.GetShapeCount();
@@ -27,14 +27,21 @@
 
 #include <PlayRho/Common/Math.hpp>
 
+#include <PlayRho/Collision/AABB.hpp>
+
 #include <PlayRho/Dynamics/StepConf.hpp>
 #include <PlayRho/Dynamics/StepStats.hpp>
 
 namespace playrho {
+
+class ThreadPool;
+
 namespace d2 {
 
 class World;
 class DynamicTree;
+class BroadPhase;
+struct QueryBatchResults;
 
 /// @brief Steps the given world the specified amount.
 /// @relatedalso World
@@ -79,6 +86,37 @@ StepStats Step(World& world, Time delta,
 /// @relatedalso World
 const DynamicTree& GetTree(const World& world) noexcept;
 
+/// @copydoc World::GetBroadPhase
+/// @relatedalso World
+const BroadPhase& GetBroadPhase(const World& world) noexcept;
+
+/// @copydoc World::GetStaticTree
+/// @relatedalso World
+const DynamicTree& GetStaticTree(const World& world) noexcept;
+
+/// @brief Queries the given world for the fixture children overlapping each of the given
+///   AABBs.
+/// @details Each query's hits are those of its broad-phase followed by those of any
+///   separate static tree it has.
+/// @param world World to do the queries over.
+/// @param aabbs Query boxes.
+/// @param results Destination for the hits. Its hits are replaced with the fixture and
+///   child index of every proxy overlapping each of the query boxes.
+/// @throws std::bad_alloc If unable to allocate necessary memory.
+/// @see GetHits.
+/// @relatedalso World
+void QueryBatch(const World& world, Span<const AABB> aabbs, QueryBatchResults& results);
+
+/// @brief Queries the given world for the fixture children overlapping each of the given
+///   AABBs using the given pool's workers as well as the calling thread.
+/// @details Gets the same results as the overload without the pool. The queries only read
+///   the world so it mustn't be modified until this returns.
+/// @throws std::bad_alloc If unable to allocate necessary memory.
+/// @see GetHits.
+/// @relatedalso World
+void QueryBatch(const World& world, Span<const AABB> aabbs, QueryBatchResults& results,
+                ThreadPool& pool);
+
 /// @brief Gets the count of unique shapes in the given world.
 /// @relatedalso World
 FixtureCounter GetShapeCount(const World& world) noexcept;
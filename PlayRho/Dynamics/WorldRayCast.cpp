@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <PlayRho/Dynamics/WorldRayCast.hpp>
+#include <PlayRho/Collision/DistanceProxy.hpp>
+#include <PlayRho/Common/GrowableStack.hpp>
+#include <PlayRho/Common/InvalidArgument.hpp>
+#include <PlayRho/Common/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+
+namespace {
+
+/// @brief Maximum number of rays in a packet.
+constexpr auto RayPacketSize = std::size_t{8};
+
+/// @brief Bit set of the rays of a packet.
+using RayMask = std::uint32_t;
+
+/// @brief Rays of a packet in structure of arrays form.
+/// @details The layout lets the compiler vectorize the slab tests of a node against all
+///   the rays of a packet.
+struct RayPacket
+{
+    std::array<Real, RayPacketSize> originX; ///< X coordinates of the ray origins.
+    std::array<Real, RayPacketSize> originY; ///< Y coordinates of the ray origins.
+    std::array<Real, RayPacketSize> invDeltaX; ///< Inverses of the X deltas of the rays.
+    std::array<Real, RayPacketSize> invDeltaY; ///< Inverses of the Y deltas of the rays.
+    std::array<Real, RayPacketSize> maxFraction; ///< Fractions the rays are clipped to.
+    RayMask active = 0; ///< Rays actually in use.
+};
+
+/// @brief Node to visit with the rays that still reach it.
+struct PacketNode
+{
+    DynamicTree::Size index; ///< Index of the tree node.
+    RayMask rays; ///< Rays that reached the node's parent.
+};
+
+/// @brief Gets the inverse of the given delta.
+/// @note This avoids infinities, so the slab tests never multiply zero by infinity, by
+///   using the largest finite magnitude for zero deltas.
+inline Real GetInverse(Real delta) noexcept
+{
+    constexpr auto big = std::numeric_limits<Real>::max();
+    return (delta > 0)? Real{1} / delta: (delta < 0)? Real{1} / delta: big;
+}
+
+/// @brief Makes a packet of the given rays.
+RayPacket MakePacket(const RayCastInput* inputs, std::size_t count) noexcept
+{
+    auto packet = RayPacket{};
+    for (auto i = std::size_t{0}; i < RayPacketSize; ++i)
+    {
+        // Unused lanes get a ray that never reaches anything.
+        const auto& input = inputs[std::min(i, count - 1)];
+        const auto delta = input.p2 - input.p1;
+        packet.originX[i] = StripUnit(GetX(input.p1));
+        packet.originY[i] = StripUnit(GetY(input.p1));
+        packet.invDeltaX[i] = GetInverse(StripUnit(GetX(delta)));
+        packet.invDeltaY[i] = GetInverse(StripUnit(GetY(delta)));
+        packet.maxFraction[i] = (i < count)? Real{input.maxFraction}: Real{-1};
+    }
+    packet.active = static_cast<RayMask>((RayMask{1} << count) - 1u);
+    return packet;
+}
+
+/// @brief Gets which of the given rays of the packet overlap the given AABB.
+/// @details Uses the slab test of the ray segments against the AABB.
+RayMask TestSlabs(const RayPacket& packet, const AABB& aabb, RayMask rays) noexcept
+{
+    const auto minX = StripUnit(aabb.ranges[0].GetMin());
+    const auto maxX = StripUnit(aabb.ranges[0].GetMax());
+    const auto minY = StripUnit(aabb.ranges[1].GetMin());
+    const auto maxY = StripUnit(aabb.ranges[1].GetMax());
+    auto hits = RayMask{0};
+    for (auto i = std::size_t{0}; i < RayPacketSize; ++i)
+    {
+        const auto tx1 = (minX - packet.originX[i]) * packet.invDeltaX[i];
+        const auto tx2 = (maxX - packet.originX[i]) * packet.invDeltaX[i];
+        const auto ty1 = (minY - packet.originY[i]) * packet.invDeltaY[i];
+        const auto ty2 = (maxY - packet.originY[i]) * packet.invDeltaY[i];
+        const auto tNear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), Real{0});
+        const auto tFar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)),
+                                   packet.maxFraction[i]);
+        hits |= static_cast<RayMask>(RayMask{tNear <= tFar} << i);
+    }
+    return hits & rays;
+}
+
+/// @brief Casts the rays of the given packet against the leafs of the given tree.
+/// @details Clips the rays of the packet to the closest hits found and records them.
+void RayCast(const World& world, const DynamicTree& tree, const RayCastInput* inputs,
+             RayPacket& packet, FixtureRayCastOutput* outputs)
+{
+    GrowableStack<PacketNode, 256> stack;
+    stack.push(PacketNode{tree.GetRootIndex(), packet.active});
+    while (!empty(stack))
+    {
+        const auto node = stack.top();
+        stack.pop();
+        if (node.index == DynamicTree::GetInvalidSize())
+        {
+            continue;
+        }
+        const auto rays = TestSlabs(packet, tree.GetAABB(node.index), node.rays);
+        if (rays == 0)
+        {
+            continue;
+        }
+        if (DynamicTree::IsBranch(tree.GetHeight(node.index)))
+        {
+            const auto branchData = tree.GetBranchData(node.index);
+            stack.push(PacketNode{branchData.child1, rays});
+            stack.push(PacketNode{branchData.child2, rays});
+            continue;
+        }
+
+        // The shape and transformation get looked up once for all the rays reaching here.
+        const auto leafData = tree.GetLeafData(node.index);
+        const auto shape = GetShape(world, leafData.fixture);
+        const auto child = GetChild(shape, leafData.childIndex);
+        const auto xfm = GetTransformation(world, leafData.body);
+        for (auto i = std::size_t{0}; i < RayPacketSize; ++i)
+        {
+            if ((rays & (RayMask{1} << i)) == 0)
+            {
+                continue;
+            }
+            auto input = inputs[i];
+            input.maxFraction = UnitInterval<Real>{packet.maxFraction[i]};
+            const auto output = RayCast(child, input, xfm);
+            if (output.has_value())
+            {
+                const auto fraction = output->fraction;
+                packet.maxFraction[i] = Real{fraction};
+                outputs[i] = FixtureRayCastHit{
+                    leafData.body, leafData.fixture, leafData.childIndex,
+                    input.p1 + (input.p2 - input.p1) * fraction, output->normal, fraction
+                };
+            }
+        }
+    }
+}
+
+/// @brief Casts the given ray against the leafs of the given broad-phase.
+/// @details Clips the ray to the closest hit found and records it.
+void RayCast(const World& world, const BroadPhase& broadPhase, const RayCastInput& input,
+             Real& maxFraction, FixtureRayCastOutput& output)
+{
+    auto clipped = input;
+    clipped.maxFraction = UnitInterval<Real>{maxFraction};
+    RayCast(broadPhase, clipped, [&](BodyID body, FixtureID fixture, ChildCounter child,
+                                     const RayCastInput& rci) {
+        const auto hit = RayCast(GetChild(GetShape(world, fixture), child), rci,
+                                 GetTransformation(world, body));
+        if (!hit.has_value())
+        {
+            return Real{-1};
+        }
+        const auto fraction = hit->fraction;
+        maxFraction = Real{fraction};
+        output = FixtureRayCastHit{
+            body, fixture, child, rci.p1 + (rci.p2 - rci.p1) * fraction, hit->normal, fraction
+        };
+        return maxFraction;
+    });
+}
+
+/// @brief Casts the given range of rays through the given world one packet at a time.
+void RayCastClosest(const World& world, const RayCastInput* inputs,
+                    FixtureRayCastOutput* outputs, std::size_t count)
+{
+    const auto& broadPhase = GetBroadPhase(world);
+    const auto tree = TypeCast<const DynamicTree*>(&broadPhase);
+    for (auto first = std::size_t{0}; first < count; first += RayPacketSize)
+    {
+        const auto n = std::min(RayPacketSize, count - first);
+        std::fill(outputs + first, outputs + first + n, FixtureRayCastOutput{});
+        auto packet = MakePacket(inputs + first, n);
+        if (tree)
+        {
+            RayCast(world, *tree, inputs + first, packet, outputs + first);
+        }
+        else
+        {
+            for (auto i = std::size_t{0}; i < n; ++i)
+            {
+                RayCast(world, broadPhase, inputs[first + i], packet.maxFraction[i],
+                        outputs[first + i]);
+            }
+        }
+        RayCast(world, GetStaticTree(world), inputs + first, packet, outputs + first);
+    }
+}
+
+} // anonymous namespace
+
+void RayCastClosest(const World& world, Span<const RayCastInput> inputs,
+                    Span<FixtureRayCastOutput> outputs)
+{
+    if (inputs.size() != outputs.size())
+    {
+        throw InvalidArgument("RayCastClosest: spans must be of same size");
+    }
+    RayCastClosest(world, inputs.begin(), outputs.begin(), inputs.size());
+}
+
+void RayCastClosest(const World& world, Span<const RayCastInput> inputs,
+                    Span<FixtureRayCastOutput> outputs, ThreadPool& pool)
+{
+    if (inputs.size() != outputs.size())
+    {
+        throw InvalidArgument("RayCastClosest: spans must be of same size");
+    }
+    // Threads get whole packets so that the packets are the same as when not threaded.
+    const auto count = inputs.size();
+    const auto numPackets = (count + RayPacketSize - 1) / RayPacketSize;
+    const auto numThreads = std::max(std::min(pool.GetWorkers() + 1u, numPackets),
+                                     std::size_t{1});
+    const auto perThread = (numPackets / numThreads) * RayPacketSize;
+    for (auto i = decltype(numThreads){0}; i < numThreads; ++i)
+    {
+        const auto offset = perThread * i;
+        const auto n = ((i + 1u) < numThreads)? perThread: count - offset;
+        pool.Push([&world,&inputs,&outputs,offset,n](std::size_t) {
+            RayCastClosest(world, inputs.begin() + offset, outputs.begin() + offset, n);
+        });
+    }
+    pool.Wait();
+}
+
+} // namespace d2
+} // namespace playrho
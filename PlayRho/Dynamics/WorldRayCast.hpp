@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef PLAYRHO_DYNAMICS_WORLDRAYCAST_HPP
+#define PLAYRHO_DYNAMICS_WORLDRAYCAST_HPP
+
+/// @file
+/// Declarations of functions for ray casting a world.
+
+#include <PlayRho/Collision/BroadPhase.hpp>
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/RayCastOutput.hpp>
+#include <PlayRho/Collision/Shapes/Shape.hpp>
+
+#include <PlayRho/Common/OptionalValue.hpp>
+#include <PlayRho/Common/Span.hpp>
+
+#include <PlayRho/Dynamics/WorldBody.hpp>
+#include <PlayRho/Dynamics/WorldFixture.hpp>
+#include <PlayRho/Dynamics/WorldMisc.hpp>
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+namespace playrho {
+
+class ThreadPool;
+
+namespace d2 {
+
+/// @brief Hit of a fixture by a ray cast of a world.
+struct FixtureRayCastHit
+{
+    BodyID body = InvalidBodyID; ///< Body of the fixture that was hit.
+    FixtureID fixture = InvalidFixtureID; ///< Fixture that was hit.
+    ChildCounter child = 0; ///< Child index of the fixture's shape that was hit.
+    Length2 point = Length2{}; ///< Point in world coordinates where the ray hit.
+    UnitVec normal = UnitVec{}; ///< Surface normal in world coordinates at the point.
+
+    /// @brief Fraction along the ray at which it hit.
+    UnitInterval<Real> fraction = UnitInterval<Real>{0};
+};
+
+/// @brief Closest hit output of a ray cast of a world.
+/// @see RayCastClosest.
+using FixtureRayCastOutput = Optional<FixtureRayCastHit>;
+
+/// @brief Ray-cast the world for all fixtures in the path of the ray.
+///
+/// @details This is the template overload for any callable taking the same arguments as
+///   a <code>FixtureRayCastCB</code> and returning a <code>RayCastOpcode</code>, like a
+///   lambda expression. The callback is called directly, without going through
+///   <code>std::function</code>, for the ray casts of the world's static tree and of its
+///   broad-phase when that's a <code>DynamicTree</code>.
+///
+/// @note The callback controls whether you get the closest point, any point, or n-points.
+/// @note The ray-cast ignores shapes that contain the starting point.
+/// @note Any separate static tree the world has gets ray-cast after the broad-phase.
+///
+/// @param world The world instance to raycast in.
+/// @param input Ray cast input data.
+/// @param callback A user implemented callback.
+///
+/// @return <code>true</code> if terminated by callback, <code>false</code> otherwise.
+///
+/// @relatedalso World
+template <class F>
+auto RayCast(const World& world, const RayCastInput& input, F&& callback)
+    -> std::enable_if_t<std::is_convertible<
+        decltype(std::declval<F&>()(std::declval<BodyID>(), std::declval<FixtureID>(),
+                                    std::declval<ChildCounter>(), std::declval<Length2>(),
+                                    std::declval<UnitVec>())),
+        RayCastOpcode>::value, bool>
+{
+    // Fraction the ray's been clipped to so far. Carried over to the static tree.
+    auto maxFraction = input.maxFraction;
+    const auto treeCallback = [&world,&callback,&maxFraction](BodyID body, FixtureID fixture,
+                                                              ChildCounter index,
+                                                              const RayCastInput& rci) {
+        const auto output = RayCast(GetChild(GetShape(world, fixture), index), rci,
+                                    GetTransformation(world, body));
+        if (output.has_value())
+        {
+            const auto fraction = output->fraction;
+            assert(fraction >= 0 && fraction <= 1);
+            
+            // Here point can be calculated these two ways:
+            //   (1) point = p1 * (1 - fraction) + p2 * fraction
+            //   (2) point = p1 + (p2 - p1) * fraction.
+            //
+            // The first way however suffers from the fact that:
+            //     a * (1 - fraction) + a * fraction != a
+            // for all values of a and fraction between 0 and 1 when a and fraction are
+            // floating point types.
+            // This leads to the posibility that (p1 == p2) && (point != p1 || point != p2),
+            // which may be pretty surprising to the callback. So this way SHOULD NOT be used.
+            //
+            // The second way, does not have this problem.
+            //
+            const auto point = rci.p1 + (rci.p2 - rci.p1) * fraction;
+            const RayCastOpcode opcode = callback(body, fixture, index, point, output->normal);
+            switch (opcode)
+            {
+                case RayCastOpcode::Terminate: return Real{0};
+                case RayCastOpcode::IgnoreFixture: return Real{-1};
+                case RayCastOpcode::ClipRay:
+                    maxFraction = fraction;
+                    return Real{fraction};
+                case RayCastOpcode::ResetRay: return Real{rci.maxFraction};
+            }
+        }
+        return Real{rci.maxFraction};
+    };
+    const auto& broadPhase = GetBroadPhase(world);
+    if (const auto tree = TypeCast<const DynamicTree*>(&broadPhase))
+    {
+        if (RayCast(*tree, input, treeCallback))
+        {
+            return true;
+        }
+    }
+    else if (RayCast(broadPhase, input, treeCallback))
+    {
+        return true;
+    }
+    auto staticInput = input;
+    staticInput.maxFraction = maxFraction;
+    return RayCast(GetStaticTree(world), staticInput, treeCallback);
+}
+
+/// @brief Ray-casts the world for the closest fixture in the path of each of the given rays.
+///
+/// @details Gets the same hits as ray casting each ray separately with a callback that
+///   clips the ray to every hit, but does the work in packets of consecutive rays. The
+///   rays of a packet descend the world's trees together so that the tests of nodes and
+///   the lookups of the shapes of leafs get shared by all the rays of the packet that
+///   reach them. This works best when consecutive rays are near to each other, like the
+///   rays of a sweeping sensor.
+///
+/// @note Packets are only used for the world's static tree and for its broad-phase when
+///   that's a <code>DynamicTree</code>. Other broad-phase types get cast one ray at a time.
+/// @note The ray-cast ignores shapes that contain the starting point.
+///
+/// @param world The world instance to raycast in.
+/// @param inputs Ray cast input data of each ray.
+/// @param outputs Destination for the closest hit of each ray, if any.
+///
+/// @throws InvalidArgument If the given spans are of different sizes.
+///
+/// @relatedalso World
+void RayCastClosest(const World& world, Span<const RayCastInput> inputs,
+                    Span<FixtureRayCastOutput> outputs);
+
+/// @brief Ray-casts the world for the closest fixture in the path of each of the given
+///   rays using the given pool's workers as well as the calling thread.
+/// @details Gets the same hits as the overload without the pool. Whole packets of rays
+///   get spread over the threads so the packets are the same as for that overload.
+/// @throws InvalidArgument If the given spans are of different sizes.
+/// @relatedalso World
+void RayCastClosest(const World& world, Span<const RayCastInput> inputs,
+                    Span<FixtureRayCastOutput> outputs, ThreadPool& pool);
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_DYNAMICS_WORLDRAYCAST_HPP
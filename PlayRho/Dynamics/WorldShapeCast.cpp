@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include <PlayRho/Dynamics/WorldShapeCast.hpp>
+#include <PlayRho/Dynamics/WorldBody.hpp>
+#include <PlayRho/Dynamics/WorldFixture.hpp>
+#include <PlayRho/Dynamics/WorldMisc.hpp>
+#include <PlayRho/Collision/AABB.hpp>
+#include <PlayRho/Collision/BroadPhase.hpp>
+#include <PlayRho/Collision/Distance.hpp>
+#include <PlayRho/Collision/DistanceProxy.hpp>
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/Shapes/Shape.hpp>
+
+#include <utility>
+
+namespace playrho {
+namespace d2 {
+
+bool ShapeCast(const World& world, const DistanceProxy& proxy, const Transformation& start,
+               Length2 translation, const FixtureShapeCastCB& callback, ToiConf conf)
+{
+    const auto angle = GetAngle(start.q);
+    const auto sweep = Sweep{Position{start.p, angle}, Position{start.p + translation, angle}};
+    const auto maxFraction = conf.tMax;
+    const auto aabb = ComputeAABB(proxy, GetTransformation(sweep, Real{0}),
+                                  GetTransformation(sweep, maxFraction));
+
+    // Whether the callback terminated the shape cast.
+    auto terminated = false;
+    const auto visit = [&](const DynamicTree::LeafData& leafData) {
+        const auto shape = GetShape(world, leafData.fixture);
+        const auto child = GetChild(shape, leafData.childIndex);
+        const auto xfm = GetTransformation(world, leafData.body);
+        const auto output = GetToiViaSat(proxy, sweep,
+                                         child, Sweep{Position{xfm.p, GetAngle(xfm.q)}}, conf);
+        if (output.state != TOIOutput::e_touching)
+        {
+            return DynamicTreeOpcode::Continue;
+        }
+
+        // Gets where the hit is from the closest points of the shapes at the time of it.
+        const auto fraction = output.time;
+        const auto hitXfm = Transformation{start.p + translation * fraction, start.q};
+        const auto witnessPoints = GetWitnessPoints(Distance(proxy, hitXfm, child, xfm).simplex);
+        const auto normal = GetUnitVector(std::get<1>(witnessPoints) - std::get<0>(witnessPoints),
+                                          GetUnitVector(translation));
+        const auto point = std::get<1>(witnessPoints) - child.GetVertexRadius() * normal;
+        switch (callback(leafData.body, leafData.fixture, leafData.childIndex,
+                         fraction, point, normal))
+        {
+            case RayCastOpcode::Terminate:
+                terminated = true;
+                return DynamicTreeOpcode::End;
+            case RayCastOpcode::IgnoreFixture:
+                break;
+            case RayCastOpcode::ClipRay:
+                conf.tMax = fraction;
+                break;
+            case RayCastOpcode::ResetRay:
+                conf.tMax = maxFraction;
+                break;
+        }
+        return DynamicTreeOpcode::Continue;
+    };
+    const auto& broadPhase = GetBroadPhase(world);
+    Query(broadPhase, aabb, [&broadPhase,&visit](BroadPhase::Size id) {
+        return visit(broadPhase.GetLeafData(id));
+    });
+    if (terminated)
+    {
+        return true;
+    }
+    const auto& staticTree = GetStaticTree(world);
+    Query(staticTree, aabb, [&staticTree,&visit](DynamicTree::Size id) {
+        return visit(staticTree.GetLeafData(id));
+    });
+    return terminated;
+}
+
+} // namespace d2
+} // namespace playrho
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef PLAYRHO_DYNAMICS_WORLDSHAPECAST_HPP
+#define PLAYRHO_DYNAMICS_WORLDSHAPECAST_HPP
+
+/// @file
+/// Declarations of functions for shape casting a world.
+
+#include <PlayRho/Collision/RayCastOutput.hpp>
+#include <PlayRho/Collision/TimeOfImpact.hpp>
+#include <PlayRho/Common/Math.hpp>
+
+#include <functional>
+
+namespace playrho {
+namespace d2 {
+
+class DistanceProxy;
+class World;
+
+/// @brief Shape cast callback function signature.
+/// @details Gets called with the fixture child that's hit, the fraction of the translation
+///   at which the hit happens, the point of the hit in world coordinates on the surface of
+///   the fixture child, and the normal of the hit in world coordinates pointing from the
+///   cast shape towards the fixture child.
+/// @note Return <code>RayCastOpcode::ClipRay</code> to shorten the translation to the
+///   fraction of the hit.
+using FixtureShapeCastCB = std::function<RayCastOpcode(BodyID body,
+                                                       FixtureID fixture,
+                                                       ChildCounter child,
+                                                       Real fraction,
+                                                       Length2 point,
+                                                       UnitVec normal)>;
+
+/// @brief Shape-casts the world for all fixtures in the path of the given shape.
+///
+/// @details Translates the given shape, without rotating it, from the given start to the
+///   start plus the given translation. Culls the fixtures to the ones whose AABBs overlap
+///   the AABB of the whole sweep, then gets the time of impact with each of those.
+///
+/// @note The callback controls whether you get the closest hit, any hit, or n-hits.
+/// @note The shape-cast ignores fixtures that the shape already overlaps at its start.
+/// @note Any separate static tree the world has gets shape-cast after the broad-phase.
+///
+/// @param world The world instance to shape cast in.
+/// @param proxy Distance proxy of the shape to cast, in local coordinates.
+/// @param start Transformation of the shape at the start of the cast.
+/// @param translation Translation of the shape from the start to the end of the cast.
+/// @param callback A user implemented callback function.
+/// @param conf Time of impact configuration. Its target depth is how much the shape
+///   should overlap whatever it hits, and its max time is the initial max fraction of the
+///   translation.
+///
+/// @return <code>true</code> if terminated by callback, <code>false</code> otherwise.
+///
+/// @see GetToiViaSat.
+/// @relatedalso World
+bool ShapeCast(const World& world, const DistanceProxy& proxy, const Transformation& start,
+               Length2 translation, const FixtureShapeCastCB& callback,
+               ToiConf conf = GetDefaultToiConf().UseTargetDepth(0_m));
+
+} // namespace d2
+} // namespace playrho
+
+#endif // PLAYRHO_DYNAMICS_WORLDSHAPECAST_HPP
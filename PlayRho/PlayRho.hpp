@@ -107,6 +107,7 @@ For a more elaborate example, that's of an entire application, see
 #include <PlayRho/Dynamics/WorldFixture.hpp>
 #include <PlayRho/Dynamics/WorldJoint.hpp>
 #include <PlayRho/Dynamics/WorldContact.hpp>
+#include <PlayRho/Dynamics/WorldRayCast.hpp>
 
 // For any and all shape configurations, add one or more of the following.
 #include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
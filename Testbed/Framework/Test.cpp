@@ -514,13 +514,15 @@ void Test::MouseDown(const Length2& p)
     auto fixtures = FixtureSet{};
 
     // Query the world for overlapping shapes.
-    Query(m_world.GetTree(), aabb, [&](FixtureID f, const ChildCounter) {
+    const auto queryCallback = [&](FixtureID f, const ChildCounter) {
         if (TestPoint(m_world, f, p))
         {
             fixtures.insert(f);
         }
         return true; // Continue the query.
-    });
+    };
+    Query(m_world.GetBroadPhase(), aabb, queryCallback);
+    Query(m_world.GetStaticTree(), aabb, queryCallback);
 
     SetSelectedFixtures(fixtures);
     if (size(fixtures) == 1)
@@ -32,3 +32,32 @@ TEST(BodyConstraint, ByteSize)
         default: FAIL(); break;
     }
 }
+
+TEST(BodyConstraintsMap, AtByBodyIdentifier)
+{
+    auto constraints = std::vector<BodyConstraint>(2u);
+    const auto map = BodyConstraintsMap{constraints};
+    EXPECT_EQ(&map.at(BodyID(0u)), &constraints[0]);
+    EXPECT_EQ(&map.at(BodyID(1u)), &constraints[1]);
+    EXPECT_EQ(&map[BodyID(1u)], &constraints[1]);
+    EXPECT_THROW(map.at(BodyID(2u)), std::out_of_range);
+}
+
+TEST(BodyConstraintsMap, AtByIslandLocalIndex)
+{
+    const auto bodies = std::vector<BodyID>{BodyID(7u), BodyID(3u)};
+    auto constraints = std::vector<BodyConstraint>(2u);
+    auto indices = std::vector<BodyCounter>(8u);
+    indices[7] = 0;
+    indices[3] = 1;
+    const auto map = BodyConstraintsMap{constraints, bodies, indices};
+    EXPECT_EQ(&map.at(BodyID(7u)), &constraints[0]);
+    EXPECT_EQ(&map.at(BodyID(3u)), &constraints[1]);
+    EXPECT_EQ(&map[BodyID(3u)], &constraints[1]);
+
+    // Left over indices of bodies of other islands don't get used.
+    indices[5] = 1;
+    EXPECT_THROW(map.at(BodyID(5u)), std::out_of_range);
+    EXPECT_THROW(map.at(BodyID(0u)), std::out_of_range);
+    EXPECT_THROW(map.at(BodyID(8u)), std::out_of_range);
+}
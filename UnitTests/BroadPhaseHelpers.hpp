@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BroadPhaseHelpers_hpp
+#define BroadPhaseHelpers_hpp
+
+#include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Collision/RayCastInput.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace playrho {
+namespace d2 {
+
+/// @brief Gets the AABB of the identified cell of a grid of overlapping boxes that's 37
+///   boxes wide.
+inline AABB GetGridAABB(int i, Length offset = 0_m)
+{
+    const auto x = Real(i % 37) * 1_m + offset;
+    const auto y = Real(i / 37) * 1_m;
+    return AABB{LengthInterval{x, x + 1.5_m}, LengthInterval{y, y + 1.5_m}};
+}
+
+/// @brief Fills the given broad-phase container with the given number of grid boxes.
+/// @return Identifiers of the created leafs in the order of their boxes.
+template <class T>
+std::vector<DynamicTree::Size> FillGrid(T& container, int count)
+{
+    auto ids = std::vector<DynamicTree::Size>{};
+    for (auto i = 0; i < count; ++i)
+    {
+        ids.push_back(container.CreateLeaf(GetGridAABB(i), DynamicTree::LeafData{
+            BodyID(static_cast<unsigned>(i)), FixtureID(static_cast<unsigned>(i)), 0u}));
+    }
+    return ids;
+}
+
+/// @brief Gets the sorted fixtures of the leafs of the given container overlapping the
+///   given AABB.
+template <class T>
+std::vector<FixtureID> GetQueryResults(const T& container, const AABB& aabb)
+{
+    auto results = std::vector<FixtureID>{};
+    Query(container, aabb, [&](DynamicTree::Size id) {
+        results.push_back(container.GetLeafData(id).fixture);
+        return DynamicTreeOpcode::Continue;
+    });
+    std::sort(begin(results), end(results));
+    return results;
+}
+
+/// @brief Gets the sorted fixtures of the leafs of the given container that the given
+///   ray-cast reports.
+template <class T>
+std::vector<FixtureID> GetRayCastResults(const T& container, const RayCastInput& input)
+{
+    auto results = std::vector<FixtureID>{};
+    RayCast(container, input, [&](BodyID, FixtureID fixture, ChildCounter,
+                                  const RayCastInput& rci) {
+        results.push_back(fixture);
+        return rci.maxFraction;
+    });
+    std::sort(begin(results), end(results));
+    return results;
+}
+
+} // namespace d2
+} // namespace playrho
+
+#endif /* BroadPhaseHelpers_hpp */
@@ -25,6 +25,8 @@
 #include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
 #include <PlayRho/Collision/Shapes/PolygonShapeConf.hpp>
 #include <PlayRho/Collision/Shapes/EdgeShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/ChainShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/Shape.hpp>
 
 using namespace playrho;
 using namespace playrho::d2;
@@ -761,6 +763,94 @@ TEST(CollideShapes, GetMaxSeparationFreeFunction2)
                 std::abs(static_cast<double>(Real(maxSep10_4x4.distance / Meter)) / 1000000.0));
 }
 
+TEST(CollideShapes, GetMaxSeparationSameAsScalarSearch)
+{
+    // Scalar search of every normal of proxy1 against every vertex of proxy2.
+    const auto search = [](const DistanceProxy& proxy1, const DistanceProxy& proxy2,
+                           Transformation xf, Length stop) {
+        auto result = SeparationInfo{-std::numeric_limits<Length>::infinity(), InvalidVertex,
+            VertexCounter2{{InvalidVertex, InvalidVertex}}};
+        for (auto i = VertexCounter{0}; i < proxy1.GetVertexCount(); ++i)
+        {
+            const auto origin = Transform(proxy1.GetVertex(i), xf);
+            const auto normal = Rotate(proxy1.GetNormal(i), xf.q);
+            auto minSeparation = std::numeric_limits<Length>::infinity();
+            auto indices = VertexCounter2{{InvalidVertex, InvalidVertex}};
+            for (auto j = VertexCounter{0}; j < proxy2.GetVertexCount(); ++j)
+            {
+                const auto s = Dot(normal, proxy2.GetVertex(j) - origin);
+                if (minSeparation > s)
+                {
+                    minSeparation = s;
+                    indices = VertexCounter2{{j, InvalidVertex}};
+                }
+                else if (minSeparation == s)
+                {
+                    std::get<1>(indices) = j;
+                }
+            }
+            if (stop < minSeparation)
+            {
+                return SeparationInfo{minSeparation, i, indices};
+            }
+            if (result.distance < minSeparation)
+            {
+                result = SeparationInfo{minSeparation, i, indices};
+            }
+        }
+        return result;
+    };
+    const auto equal = [](const SeparationInfo& lhs, const SeparationInfo& rhs) {
+        return (lhs.distance == rhs.distance) && (lhs.firstShape == rhs.firstShape) &&
+            (lhs.secondShape == rhs.secondShape);
+    };
+
+    auto shapes = std::vector<PolygonShapeConf>{};
+    shapes.push_back(PolygonShapeConf{}.SetAsBox(1_m, 1_m));
+    shapes.push_back(PolygonShapeConf{}.SetAsBox(2_m, 0.5_m));
+    for (auto count = 3; count <= 9; ++count)
+    {
+        auto vertices = std::vector<Length2>{};
+        for (auto i = 0; i < count; ++i)
+        {
+            const auto angle = Real(i) * 2 * Pi / Real(count);
+            vertices.push_back(Length2{std::cos(angle) * 1_m, std::sin(angle) * 1_m});
+        }
+        shapes.push_back(PolygonShapeConf{}.Set(vertices));
+    }
+    for (const auto& shape1: shapes)
+    {
+        const auto proxy1 = GetChild(shape1, 0);
+        for (const auto& shape2: shapes)
+        {
+            const auto proxy2 = GetChild(shape2, 0);
+            for (auto i = 0; i < 16; ++i)
+            {
+                const auto xf1 = Transformation{Length2{}, UnitVec::Get(Real(i) * 0.5_rad)};
+                const auto location = Length2{Real(i % 4) * 0.75_m - 1_m,
+                                              Real(i / 4) * 0.75_m - 1.5_m};
+                const auto xf2 = Transformation{location, UnitVec::Get(Real(i) * -0.25_rad)};
+                const auto xf = MulT(xf2, xf1);
+                EXPECT_TRUE(equal(GetMaxSeparation(proxy1, xf1, proxy2, xf2),
+                                  search(proxy1, proxy2, xf,
+                                         std::numeric_limits<Length>::infinity())));
+                EXPECT_TRUE(equal(GetMaxSeparation(proxy1, xf1, proxy2, xf2, -0.5_m),
+                                  search(proxy1, proxy2, xf, -0.5_m)));
+                EXPECT_TRUE(equal(GetMaxSeparation(proxy1, proxy2, 0_m),
+                                  search(proxy1, proxy2, Transformation{}, 0_m)));
+                if ((proxy1.GetVertexCount() == 4) && (proxy2.GetVertexCount() == 4))
+                {
+                    const auto result = GetMaxSeparation4x4(proxy1, xf1, proxy2, xf2);
+                    const auto expected = search(proxy1, proxy2, xf,
+                                                 std::numeric_limits<Length>::infinity());
+                    EXPECT_NEAR(static_cast<double>(Real(result.distance / Meter)),
+                                static_cast<double>(Real(expected.distance / Meter)), 0.0001);
+                }
+            }
+        }
+    }
+}
+
 TEST(CollideShapes, SquareCornerTouchingSquareFaceAbove)
 {
     const auto dim = 2_m;
@@ -1669,3 +1759,84 @@ TEST(CollideShapes, R0EdgePerpendicularCrossingFromR0Edge)
     EXPECT_NEAR(static_cast<double>(StripUnit(GetY(manifold.GetLocalPoint()))), 0.0, 0.0001);
     EXPECT_EQ(manifold.GetPointCount(), decltype(manifold.GetPointCount()){1});
 }
+
+TEST(CollideShapes, ShapeDispatchSameAsDistanceProxies)
+{
+    const auto shapes = std::vector<Shape>{
+        Shape{DiskShapeConf{}.UseRadius(0.5_m)},
+        Shape{DiskShapeConf{}.UseRadius(1_m).UseLocation(Length2{0.25_m, -0.5_m})},
+        Shape{PolygonShapeConf{}.SetAsBox(0.5_m, 0.5_m)},
+        Shape{PolygonShapeConf{}.SetAsBox(1_m, 0.25_m)},
+        Shape{PolygonShapeConf{}.UseVertexRadius(0.1_m).Set({
+            Length2{-1_m, 0_m}, Length2{1_m, 0_m}, Length2{0_m, 1_m}})},
+        Shape{PolygonShapeConf{}.UseVertexRadius(0.2_m).Set({Length2{}})},
+        Shape{EdgeShapeConf{}.Set(Length2{-1_m, 0_m}, Length2{1_m, 0_m})},
+        Shape{ChainShapeConf{}.Add(Length2{-2_m, 0_m}).Add(Length2{0_m, 0.5_m})
+            .Add(Length2{2_m, 0_m})},
+    };
+    const auto conf = GetDefaultManifoldConf();
+    auto touching = 0;
+    for (const auto& shapeA: shapes)
+    {
+        for (const auto& shapeB: shapes)
+        {
+            for (auto i = 0; i < 16; ++i)
+            {
+                const auto xfA = Transformation{Length2{}, UnitVec::Get(Real(i) * 0.3_rad)};
+                const auto location = Length2{Real(i % 4) * 0.4_m - 0.6_m,
+                                              Real(i / 4) * 0.4_m - 0.6_m};
+                const auto xfB = Transformation{location, UnitVec::Get(Real(i) * -0.7_rad)};
+                for (auto a = ChildCounter{0}; a < GetChildCount(shapeA); ++a)
+                {
+                    for (auto b = ChildCounter{0}; b < GetChildCount(shapeB); ++b)
+                    {
+                        const auto expected = CollideShapes(GetChild(shapeA, a), xfA,
+                                                            GetChild(shapeB, b), xfB, conf);
+                        const auto manifold = CollideShapes(shapeA, a, xfA, shapeB, b, xfB,
+                                                            conf);
+                        EXPECT_EQ(manifold, expected);
+                        touching += (manifold.GetPointCount() > 0)? 1: 0;
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_GT(touching, 0);
+    EXPECT_THROW(CollideShapes(shapes[0], 1, Transformation{}, shapes[2], 0, Transformation{}),
+                 InvalidArgument);
+}
+
+TEST(CollideShapes, DiskAndPolygonKernelRegions)
+{
+    const auto disk = Shape{DiskShapeConf{}.UseRadius(0.5_m)};
+    const auto box = Shape{PolygonShapeConf{}.SetAsBox(1_m, 1_m)};
+    const auto conf = GetDefaultManifoldConf();
+    const auto xfBox = Transformation{Length2{}, UnitVec::GetRight()};
+    struct Placement
+    {
+        Length2 location;
+        Manifold::Type type;
+    };
+    const auto placements = {
+        Placement{Length2{0.2_m, 0.1_m}, Manifold::e_faceA}, // Center inside the box.
+        Placement{Length2{0_m, 1.4_m}, Manifold::e_faceA}, // Center in a face region.
+        Placement{Length2{1.3_m, 1.3_m}, Manifold::e_circles}, // Center in a vertex region.
+        Placement{Length2{0_m, 1.6_m}, Manifold::e_unset}, // Beyond a face.
+        Placement{Length2{1.4_m, 1.4_m}, Manifold::e_unset}, // Beyond a vertex.
+    };
+    for (const auto& placement: placements)
+    {
+        const auto xfDisk = Transformation{placement.location, UnitVec::GetRight()};
+        const auto manifold = CollideShapes(box, 0, xfBox, disk, 0, xfDisk, conf);
+        EXPECT_EQ(manifold.GetType(), placement.type);
+        EXPECT_EQ(manifold, CollideShapes(GetChild(box, 0), xfBox, GetChild(disk, 0), xfDisk,
+                                          conf));
+        const auto flipped = CollideShapes(disk, 0, xfDisk, box, 0, xfBox, conf);
+        EXPECT_EQ(flipped.GetType(), (placement.type == Manifold::e_faceA)?
+                  Manifold::e_faceB: placement.type);
+        EXPECT_EQ(flipped, CollideShapes(GetChild(disk, 0), xfDisk, GetChild(box, 0), xfBox,
+                                         conf));
+    }
+    EXPECT_THROW(CollideShapes(box, 1, xfBox, disk, 0, xfBox), InvalidArgument);
+    EXPECT_THROW(CollideShapes(disk, 0, xfBox, disk, 1, xfBox), InvalidArgument);
+}
@@ -31,7 +31,7 @@ TEST(Contact, ByteSize)
     {
         case  4:
             EXPECT_EQ(alignof(Contact), 4u);
-            EXPECT_EQ(sizeof(Contact), std::size_t(36));
+            EXPECT_EQ(sizeof(Contact), std::size_t(40));
             break;
         case  8:
             EXPECT_EQ(alignof(Contact), 8u);
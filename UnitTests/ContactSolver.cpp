@@ -22,7 +22,9 @@
 #include <PlayRho/Dynamics/Contacts/VelocityConstraint.hpp>
 #include <PlayRho/Dynamics/Contacts/BodyConstraint.hpp>
 #include <PlayRho/Collision/Shapes/PolygonShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
 #include <PlayRho/Collision/Manifold.hpp>
+#include <PlayRho/Collision/WorldManifold.hpp>
 
 using namespace playrho;
 using namespace playrho::d2;
@@ -581,3 +583,88 @@ TEST(ContactSolver, SolveVelocityConstraint2)
     EXPECT_FALSE(IsValid(vc.GetPointRelPosB(1)));
 }
 #endif
+
+TEST(ContactSolver, SolveVelocityConstraintsSameAsOneAtATime)
+{
+    // Boxes and disks on the same static ground with a range of velocities. The ground
+    // can't be moved so their constraints can all be solved at once.
+    const auto groundShape = PolygonShapeConf(40_m, 1_m);
+    const auto boxShape = PolygonShapeConf(0.5_m, 0.5_m);
+    const auto diskShape = DiskShapeConf{}.UseRadius(0.5_m);
+    const auto groundPos = Position{Length2{0_m, -1_m}, 0_deg};
+    const Position positions[] = {
+        Position{Length2{-6_m, 0.49_m}, 0_deg},
+        Position{Length2{-3_m, 0.48_m}, 2_deg},
+        Position{Length2{0_m, 0.49_m}, 0_deg},
+        Position{Length2{3_m, 0.49_m}, 0_deg},
+        Position{Length2{6_m, 0.45_m}, 0_deg},
+    };
+    const Velocity velocities[] = {
+        Velocity{LinearVelocity2{0.5_mps, -2_mps}, 0.3_rad / 1_s},
+        Velocity{LinearVelocity2{-1_mps, -0.5_mps}, -1_rad / 1_s},
+        Velocity{LinearVelocity2{2_mps, -4_mps}, 0_rad / 1_s},
+        Velocity{LinearVelocity2{0_mps, -1_mps}, 2_rad / 1_s},
+        Velocity{LinearVelocity2{-0.3_mps, -3_mps}, 0.5_rad / 1_s},
+    };
+    constexpr auto numBodies = std::size_t{5};
+    const auto makeConstraints = [&](std::vector<BodyConstraint>& bodies) {
+        bodies.clear();
+        bodies.reserve(numBodies + 1u);
+        bodies.emplace_back(InvMass{}, InvRotInertia{}, Length2{}, groundPos, Velocity{});
+        auto vcs = std::vector<VelocityConstraint>{};
+        for (auto i = std::size_t{0}; i < numBodies; ++i)
+        {
+            bodies.emplace_back(Real(1) / 1_kg,
+                                InvRotInertia{Real{1} * SquareRadian / (SquareMeter * 1_kg)},
+                                Length2{}, positions[i], velocities[i]);
+            const auto isDisk = (i == 4u);
+            const auto childA = GetChild(groundShape, 0);
+            const auto childB = isDisk? GetChild(diskShape, 0): GetChild(boxShape, 0);
+            const auto xfA = GetTransformation(groundPos, Length2{});
+            const auto xfB = GetTransformation(positions[i], Length2{});
+            const auto manifold = CollideShapes(childA, xfA, childB, xfB);
+            const auto worldManifold = GetWorldManifold(manifold,
+                                                        xfA, childA.GetVertexRadius(),
+                                                        xfB, childB.GetVertexRadius());
+            auto conf = VelocityConstraint::Conf{};
+            conf.blockSolve = (i != 2u);
+            vcs.emplace_back(Real(0.6), Real(0.2), (i == 3u)? 1_mps: 0_mps, worldManifold,
+                             bodies.front(), bodies.back(), conf);
+        }
+        return vcs;
+    };
+
+    auto bodies1 = std::vector<BodyConstraint>{};
+    auto bodies2 = std::vector<BodyConstraint>{};
+    auto vcs1 = makeConstraints(bodies1);
+    auto vcs2 = makeConstraints(bodies2);
+    ASSERT_EQ(vcs1[0].GetPointCount(), 2u);
+    ASSERT_EQ(vcs1[4].GetPointCount(), 1u);
+    for (auto iteration = 0; iteration < 10; ++iteration)
+    {
+        auto maxIncImpulse1 = 0_Ns;
+        for (auto& vc: vcs1)
+        {
+            maxIncImpulse1 = std::max(maxIncImpulse1, GaussSeidel::SolveVelocityConstraint(vc));
+        }
+        VelocityConstraint* first[] = {&vcs2[0], &vcs2[1], &vcs2[2]};
+        VelocityConstraint* second[] = {&vcs2[3], &vcs2[4]};
+        const auto maxIncImpulse2 = std::max(GaussSeidel::SolveVelocityConstraints(first, 3),
+                                             GaussSeidel::SolveVelocityConstraints(second, 2));
+        EXPECT_EQ(maxIncImpulse1, maxIncImpulse2);
+        for (auto i = std::size_t{0}; i <= numBodies; ++i)
+        {
+            EXPECT_EQ(bodies1[i].GetVelocity(), bodies2[i].GetVelocity());
+        }
+        for (auto i = std::size_t{0}; i < numBodies; ++i)
+        {
+            for (auto j = VelocityConstraint::size_type{0}; j < vcs1[i].GetPointCount(); ++j)
+            {
+                EXPECT_EQ(vcs1[i].GetNormalImpulseAtPoint(j), vcs2[i].GetNormalImpulseAtPoint(j));
+                EXPECT_EQ(vcs1[i].GetTangentImpulseAtPoint(j), vcs2[i].GetTangentImpulseAtPoint(j));
+            }
+        }
+    }
+    // The ground doesn't get moved.
+    EXPECT_EQ(bodies2.front().GetVelocity(), Velocity{});
+}
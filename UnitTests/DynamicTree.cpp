@@ -19,10 +19,14 @@
  */
 
 #include "UnitTests.hpp"
+#include "BroadPhaseHelpers.hpp"
 #include <PlayRho/Collision/DynamicTree.hpp>
+#include <PlayRho/Common/InvalidArgument.hpp>
+#include <PlayRho/Common/ThreadPool.hpp>
 #include <type_traits>
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
 using namespace playrho;
 using namespace playrho::d2;
@@ -31,13 +35,13 @@ TEST(DynamicTree, ByteSize)
 {
 #if defined(_WIN64)
     EXPECT_EQ(alignof(DynamicTree), 8u);
-    EXPECT_EQ(sizeof(DynamicTree), std::size_t(32));
+    EXPECT_EQ(sizeof(DynamicTree), std::size_t(48));
 #elif defined(_WIN32)
     EXPECT_EQ(alignof(DynamicTree), 4u);
-    EXPECT_EQ(sizeof(DynamicTree), std::size_t(24));
+    EXPECT_EQ(sizeof(DynamicTree), std::size_t(32));
 #else
     EXPECT_EQ(alignof(DynamicTree), 8u);
-    EXPECT_EQ(sizeof(DynamicTree), std::size_t(32));
+    EXPECT_EQ(sizeof(DynamicTree), std::size_t(48));
 #endif
 }
 
@@ -55,6 +59,11 @@ TEST(DynamicTree, VariantDataByteSize)
 #endif
 }
 
+TEST(DynamicTree, TopologyDataByteSize)
+{
+    EXPECT_EQ(sizeof(DynamicTree::TopologyData), std::size_t(16));
+}
+
 TEST(DynamicTree, TreeNodeByteSize)
 {
     switch (sizeof(Real))
@@ -622,16 +631,16 @@ TEST(DynamicTree, FourIdenticalProxies)
     EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
     EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
     
-    foo.RebuildBottomUp();
+    foo.Rebuild();
     
     EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
     EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
     EXPECT_EQ(foo.GetNodeCount(), DynamicTree::Size(7));
     EXPECT_EQ(foo.GetNodeCapacity(), DynamicTree::GetDefaultInitialNodeCapacity());
-    EXPECT_EQ(GetHeight(foo), DynamicTree::Height(3));
-    EXPECT_EQ(GetMaxImbalance(foo), DynamicTree::Height(2));
+    EXPECT_EQ(GetHeight(foo), DynamicTree::Height(2));
+    EXPECT_EQ(GetMaxImbalance(foo), DynamicTree::Height(0));
     EXPECT_EQ(ComputePerimeterRatio(foo), Real(7));
-    EXPECT_EQ(ComputeHeight(foo), DynamicTree::Height(3));
+    EXPECT_EQ(ComputeHeight(foo), DynamicTree::Height(2));
 }
 
 TEST(DynamicTree, MoveConstruction)
@@ -1004,6 +1013,331 @@ TEST(DynamicTree, Clear)
     EXPECT_EQ(foo.GetRootIndex(), DynamicTree::GetInvalidSize());
 }
 
+TEST(DynamicTree, SetLeafData)
+{
+    auto foo = DynamicTree{};
+    const auto aabb = AABB{LengthInterval{-1_m, 1_m}, LengthInterval{-1_m, 1_m}};
+    const auto id = foo.CreateLeaf(aabb, DynamicTree::LeafData{BodyID(1u), FixtureID(2u), 3u});
+    const auto newData = DynamicTree::LeafData{BodyID(4u), FixtureID(5u), 6u};
+    foo.SetLeafData(id, newData);
+    EXPECT_EQ(foo.GetLeafData(id).body, BodyID(4u));
+    EXPECT_EQ(foo.GetLeafData(id), newData);
+    EXPECT_EQ(foo.GetAABB(id), aabb);
+}
+
+namespace {
+
+AABB GetScatteredAABB(int i)
+{
+    // Deterministically scatters differently sized AABBs around.
+    const auto x = Real((i * 7919) % 1000) * 0.1_m;
+    const auto y = Real((i * 104729) % 997) * 0.1_m;
+    const auto w = Real(1 + i % 5) * 0.3_m;
+    return AABB{LengthInterval{x, x + w}, LengthInterval{y, y + w}};
+}
+
+AABB GetCrowdedAABB(int i)
+{
+    // Deterministically scatters AABBs close enough together for many of them to overlap.
+    const auto x = Real((i * 37) % 101) * 0.5_m;
+    const auto y = Real((i * 53) % 97) * 0.5_m;
+    const auto w = Real(1 + i % 3) * 1_m;
+    return AABB{LengthInterval{x, x + w}, LengthInterval{y, y + w}};
+}
+
+DynamicTree::LeafData GetLeafDataFor(int i)
+{
+    return DynamicTree::LeafData{
+        BodyID(static_cast<unsigned>(i)), FixtureID(static_cast<unsigned>(i)), 0u};
+}
+
+} // namespace
+
+TEST(DynamicTree, CreateLeafs)
+{
+    auto aabbs = std::vector<AABB>{};
+    auto data = std::vector<DynamicTree::LeafData>{};
+    for (auto i = 0; i < 1000; ++i)
+    {
+        aabbs.push_back(GetScatteredAABB(i));
+        data.push_back(GetLeafDataFor(i));
+    }
+
+    auto foo = DynamicTree{};
+    EXPECT_TRUE(empty(foo.CreateLeafs(Span<const AABB>{}, Span<const DynamicTree::LeafData>{})));
+    EXPECT_EQ(foo.GetLeafCount(), DynamicTree::Size(0));
+
+    const auto ids = foo.CreateLeafs(aabbs, data);
+    ASSERT_EQ(size(ids), size(aabbs));
+    EXPECT_EQ(foo.GetLeafCount(), DynamicTree::Size(1000));
+    EXPECT_EQ(foo.GetNodeCount(), DynamicTree::Size(1999));
+    EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
+    EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
+    EXPECT_LT(GetHeight(foo), DynamicTree::Height(24));
+    for (auto i = std::size_t{0}; i < size(ids); ++i)
+    {
+        EXPECT_EQ(foo.GetAABB(ids[i]), aabbs[i]);
+        EXPECT_EQ(foo.GetLeafData(ids[i]), data[i]);
+    }
+
+    auto bar = DynamicTree{};
+    for (auto i = std::size_t{0}; i < size(aabbs); ++i)
+    {
+        bar.CreateLeaf(aabbs[i], data[i]);
+    }
+    for (auto i = 0; i < 1000; i += 11)
+    {
+        const auto aabb = GetFattenedAABB(GetScatteredAABB(i), 1_m);
+        EXPECT_EQ(GetQueryResults(foo, aabb), GetQueryResults(bar, aabb));
+    }
+}
+
+TEST(DynamicTree, CreateLeafsIntoNonEmptyTree)
+{
+    auto aabbs = std::vector<AABB>{};
+    auto data = std::vector<DynamicTree::LeafData>{};
+    for (auto i = 0; i < 300; ++i)
+    {
+        aabbs.push_back(GetScatteredAABB(i));
+        data.push_back(GetLeafDataFor(i));
+    }
+
+    auto foo = DynamicTree{};
+    for (auto i = 0; i < 100; ++i)
+    {
+        foo.CreateLeaf(aabbs[static_cast<std::size_t>(i)], data[static_cast<std::size_t>(i)]);
+    }
+
+    // Fewer new leafs than existing ones get inserted one by one...
+    const auto few = foo.CreateLeafs(Span<const AABB>(aabbs.data() + 100, 50),
+                                     Span<const DynamicTree::LeafData>(data.data() + 100, 50));
+    EXPECT_EQ(size(few), 50u);
+    EXPECT_EQ(foo.GetLeafCount(), DynamicTree::Size(150));
+    EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
+    EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
+
+    // ...while at least as many new leafs as existing ones get the tree rebuilt.
+    const auto many = foo.CreateLeafs(Span<const AABB>(aabbs.data() + 150, 150),
+                                      Span<const DynamicTree::LeafData>(data.data() + 150, 150));
+    EXPECT_EQ(size(many), 150u);
+    EXPECT_EQ(foo.GetLeafCount(), DynamicTree::Size(300));
+    EXPECT_EQ(foo.GetNodeCount(), DynamicTree::Size(599));
+    EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
+    EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
+    for (auto i = std::size_t{0}; i < size(many); ++i)
+    {
+        EXPECT_EQ(foo.GetAABB(many[i]), aabbs[150 + i]);
+        EXPECT_EQ(foo.GetLeafData(many[i]), data[150 + i]);
+    }
+
+    const auto everything = AABB{LengthInterval{-1_m, 200_m}, LengthInterval{-1_m, 200_m}};
+    EXPECT_EQ(size(GetQueryResults(foo, everything)), 300u);
+}
+
+TEST(DynamicTree, CreateLeafsFewSameAsCreateLeaf)
+{
+    auto aabbs = std::vector<AABB>{};
+    auto data = std::vector<DynamicTree::LeafData>{};
+    for (auto i = 0; i < 5; ++i)
+    {
+        aabbs.push_back(GetScatteredAABB(i));
+        data.push_back(GetLeafDataFor(i));
+    }
+    auto foo = DynamicTree{};
+    const auto ids = foo.CreateLeafs(aabbs, data);
+    auto bar = DynamicTree{};
+    for (auto i = std::size_t{0}; i < size(aabbs); ++i)
+    {
+        EXPECT_EQ(bar.CreateLeaf(aabbs[i], data[i]), ids[i]);
+    }
+    EXPECT_EQ(foo.GetRootIndex(), bar.GetRootIndex());
+    EXPECT_EQ(GetHeight(foo), GetHeight(bar));
+}
+
+TEST(DynamicTree, CreateLeafsThrowsOnSizeMismatch)
+{
+    auto foo = DynamicTree{};
+    const auto aabbs = std::vector<AABB>{GetScatteredAABB(0), GetScatteredAABB(1)};
+    const auto data = std::vector<DynamicTree::LeafData>{GetLeafDataFor(0)};
+    EXPECT_THROW(foo.CreateLeafs(aabbs, data), InvalidArgument);
+    EXPECT_EQ(foo.GetLeafCount(), DynamicTree::Size(0));
+    EXPECT_EQ(foo.GetNodeCount(), DynamicTree::Size(0));
+}
+
+TEST(DynamicTree, Rebuild)
+{
+    auto foo = DynamicTree{};
+    foo.Rebuild();
+    EXPECT_EQ(foo.GetRootIndex(), DynamicTree::GetInvalidSize());
+
+    for (auto i = 0; i < 500; ++i)
+    {
+        foo.CreateLeaf(GetScatteredAABB(i), GetLeafDataFor(i));
+    }
+    const auto aabb = AABB{LengthInterval{10_m, 30_m}, LengthInterval{40_m, 50_m}};
+    const auto before = GetQueryResults(foo, aabb);
+    const auto nodeCount = foo.GetNodeCount();
+    foo.Rebuild();
+    EXPECT_EQ(foo.GetLeafCount(), DynamicTree::Size(500));
+    EXPECT_EQ(foo.GetNodeCount(), nodeCount);
+    EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
+    EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
+    EXPECT_EQ(GetQueryResults(foo, aabb), before);
+}
+
+TEST(DynamicTree, Optimize)
+{
+    auto foo = DynamicTree{};
+    EXPECT_EQ(foo.Optimize(0, 10).visited, DynamicTree::Size(0));
+
+    auto ids = std::vector<DynamicTree::Size>{};
+    for (auto i = 0; i < 500; ++i)
+    {
+        ids.push_back(foo.CreateLeaf(GetScatteredAABB(i), GetLeafDataFor(i)));
+    }
+    // Churn the leafs around to degrade the tree.
+    for (auto round = 0; round < 4; ++round)
+    {
+        for (auto i = 0; i < 500; ++i)
+        {
+            foo.UpdateLeaf(ids[static_cast<std::size_t>(i)],
+                           GetScatteredAABB(i * 3 + round * 1000 + 1));
+        }
+    }
+    const auto aabb = AABB{LengthInterval{10_m, 30_m}, LengthInterval{40_m, 50_m}};
+    const auto results = GetQueryResults(foo, aabb);
+    const auto ratio = ComputePerimeterRatio(foo);
+    const auto height = GetHeight(foo);
+
+    const auto stats = foo.Optimize(0, 10);
+    EXPECT_GT(stats.visited, DynamicTree::Size(0));
+    EXPECT_LE(stats.visited, DynamicTree::Size(10));
+    EXPECT_GT(stats.next, DynamicTree::Size(0));
+    EXPECT_FALSE(stats.sweepEnded);
+
+    auto next = stats.next;
+    auto rebuilds = stats.rebuilds;
+    auto buffer = std::vector<DynamicTree::Size>{};
+    for (;;)
+    {
+        const auto result = foo.Optimize(next, 64, buffer);
+        EXPECT_LE(result.visited, DynamicTree::Size(64));
+        rebuilds += result.rebuilds;
+        next = result.next;
+        if (result.sweepEnded)
+        {
+            break;
+        }
+    }
+    EXPECT_EQ(next, DynamicTree::Size(0));
+    EXPECT_GT(rebuilds, DynamicTree::Size(0));
+    EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
+    EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
+    EXPECT_LT(ComputePerimeterRatio(foo), ratio);
+    EXPECT_LE(GetHeight(foo), height);
+    EXPECT_EQ(GetQueryResults(foo, aabb), results);
+
+    // A budget for the whole tree gets it all rebuilt from the root in one call.
+    const auto budget = (DynamicTree::Size{2} << GetHeight(foo)) + foo.GetNodeCapacity();
+    const auto sweep = foo.Optimize(0, budget);
+    EXPECT_TRUE(sweep.sweepEnded);
+    EXPECT_EQ(sweep.next, DynamicTree::Size(0));
+    EXPECT_EQ(sweep.rebuilds, DynamicTree::Size(1));
+    EXPECT_TRUE(ValidateStructure(foo, foo.GetRootIndex()));
+    EXPECT_TRUE(ValidateMetrics(foo, foo.GetRootIndex()));
+    EXPECT_EQ(sweep.maxImbalance, GetMaxImbalance(foo));
+    EXPECT_NEAR(static_cast<double>(StripUnit(sweep.perimeter)),
+                static_cast<double>(StripUnit(ComputeTotalPerimeter(foo))),
+                static_cast<double>(StripUnit(ComputeTotalPerimeter(foo))) / 1000.0);
+    EXPECT_EQ(GetQueryResults(foo, aabb), results);
+}
+
+TEST(DynamicTree, QueryPairs)
+{
+    auto foo = DynamicTree{};
+    auto npairs = 0;
+    QueryPairs(foo, [&](DynamicTree::Size, DynamicTree::Size) {
+        ++npairs;
+        return DynamicTreeOpcode::Continue;
+    });
+    EXPECT_EQ(npairs, 0);
+
+    auto ids = std::vector<DynamicTree::Size>{};
+    for (auto i = 0; i < 300; ++i)
+    {
+        ids.push_back(foo.CreateLeaf(GetCrowdedAABB(i), GetLeafDataFor(i)));
+    }
+    using Pair = std::pair<DynamicTree::Size, DynamicTree::Size>;
+    auto expected = std::vector<Pair>{};
+    for (auto i = std::size_t{0}; i < size(ids); ++i)
+    {
+        for (auto j = i + 1; j < size(ids); ++j)
+        {
+            if (TestOverlap(foo.GetAABB(ids[i]), foo.GetAABB(ids[j])))
+            {
+                expected.emplace_back(std::min(ids[i], ids[j]), std::max(ids[i], ids[j]));
+            }
+        }
+    }
+    std::sort(begin(expected), end(expected));
+    ASSERT_FALSE(empty(expected));
+
+    auto pairs = std::vector<Pair>{};
+    QueryPairs(foo, [&](DynamicTree::Size a, DynamicTree::Size b) {
+        pairs.emplace_back(std::min(a, b), std::max(a, b));
+        return DynamicTreeOpcode::Continue;
+    });
+    std::sort(begin(pairs), end(pairs));
+    EXPECT_EQ(pairs, expected);
+
+    npairs = 0;
+    QueryPairs(foo, [&](DynamicTree::Size, DynamicTree::Size) {
+        ++npairs;
+        return DynamicTreeOpcode::End;
+    });
+    EXPECT_EQ(npairs, 1);
+}
+
+TEST(DynamicTree, QueryPairsOfTwoTrees)
+{
+    auto treeA = DynamicTree{};
+    auto treeB = DynamicTree{};
+    using Pair = std::pair<DynamicTree::Size, DynamicTree::Size>;
+    auto pairs = std::vector<Pair>{};
+    const auto callback = [&](DynamicTree::Size a, DynamicTree::Size b) {
+        pairs.emplace_back(a, b);
+        return DynamicTreeOpcode::Continue;
+    };
+    for (auto i = 0; i < 200; ++i)
+    {
+        treeA.CreateLeaf(GetCrowdedAABB(i), GetLeafDataFor(i));
+    }
+    QueryPairs(treeA, treeB, callback);
+    EXPECT_TRUE(empty(pairs));
+    for (auto i = 200; i < 300; ++i)
+    {
+        treeB.CreateLeaf(GetCrowdedAABB(i), GetLeafDataFor(i));
+    }
+
+    auto expected = std::vector<Pair>{};
+    for (auto a = DynamicTree::Size{0}; a < treeA.GetNodeCapacity(); ++a)
+    {
+        for (auto b = DynamicTree::Size{0}; b < treeB.GetNodeCapacity(); ++b)
+        {
+            if (DynamicTree::IsLeaf(treeA.GetHeight(a)) &&
+                DynamicTree::IsLeaf(treeB.GetHeight(b)) &&
+                TestOverlap(treeA.GetAABB(a), treeB.GetAABB(b)))
+            {
+                expected.emplace_back(a, b);
+            }
+        }
+    }
+    ASSERT_FALSE(empty(expected));
+    QueryPairs(treeA, treeB, callback);
+    std::sort(begin(pairs), end(pairs));
+    EXPECT_EQ(pairs, expected);
+}
+
 TEST(DynamicTree, QueryFF)
 {
     auto foo = DynamicTree{};
@@ -1040,3 +1374,86 @@ TEST(DynamicTree, QueryFF)
     });
     EXPECT_EQ(ncalls, 2);
 }
+
+TEST(DynamicTree, QueryAnyCallableSameAsStdFunction)
+{
+    auto foo = DynamicTree{};
+    for (auto i = 0; i < 300; ++i)
+    {
+        foo.CreateLeaf(GetCrowdedAABB(i), GetLeafDataFor(i));
+    }
+    const auto aabb = AABB{LengthInterval{5_m, 20_m}, LengthInterval{5_m, 20_m}};
+
+    auto expected = std::vector<DynamicTree::Size>{};
+    Query(foo, aabb, DynamicTreeSizeCB{[&](DynamicTree::Size id) {
+        expected.push_back(id);
+        return DynamicTreeOpcode::Continue;
+    }});
+    ASSERT_FALSE(empty(expected));
+
+    auto found = std::vector<DynamicTree::Size>{};
+    Query(foo, aabb, [&](DynamicTree::Size id) {
+        found.push_back(id);
+        return DynamicTreeOpcode::Continue;
+    });
+    EXPECT_EQ(found, expected);
+
+    auto fixtures = std::vector<FixtureID>{};
+    Query(foo, aabb, [&](FixtureID fixture, ChildCounter) {
+        fixtures.push_back(fixture);
+        return size(fixtures) < 2u;
+    });
+    ASSERT_EQ(size(fixtures), 2u);
+    EXPECT_EQ(fixtures[0], foo.GetLeafData(expected[0]).fixture);
+    EXPECT_EQ(fixtures[1], foo.GetLeafData(expected[1]).fixture);
+}
+
+TEST(DynamicTree, QueryBatch)
+{
+    auto foo = DynamicTree{};
+    auto aabbs = std::vector<AABB>{};
+    auto results = QueryBatchResults{};
+    QueryBatch(foo, aabbs, results);
+    ASSERT_EQ(size(results.offsets), 1u);
+    EXPECT_TRUE(empty(results.hits));
+
+    for (auto i = 0; i < 300; ++i)
+    {
+        foo.CreateLeaf(GetCrowdedAABB(i), GetLeafDataFor(i));
+    }
+    for (auto i = 0; i < 50; ++i)
+    {
+        aabbs.push_back(GetCrowdedAABB(i * 7));
+    }
+    aabbs.push_back(AABB{});
+    for (const auto workers: {0u, 2u, 63u})
+    {
+        if (workers == 0u)
+        {
+            QueryBatch(foo, aabbs, results);
+        }
+        else
+        {
+            auto pool = ThreadPool{workers};
+            QueryBatch(foo, aabbs, results, pool);
+        }
+        ASSERT_EQ(size(results.offsets), size(aabbs) + 1u);
+        for (auto i = std::size_t{0}; i < size(aabbs); ++i)
+        {
+            auto expected = std::vector<FixtureID>{};
+            Query(foo, aabbs[i], [&](FixtureID fixture, ChildCounter) {
+                expected.push_back(fixture);
+                return true;
+            });
+            const auto hits = GetHits(results, i);
+            ASSERT_EQ(hits.size(), size(expected));
+            for (auto j = std::size_t{0}; j < hits.size(); ++j)
+            {
+                EXPECT_EQ(hits[j].fixture, expected[j]);
+                EXPECT_EQ(hits[j].child, ChildCounter(0));
+            }
+        }
+        EXPECT_EQ(GetHits(results, size(aabbs) - 1u).size(), 0u);
+        EXPECT_EQ(results.offsets.back(), size(results.hits));
+    }
+}
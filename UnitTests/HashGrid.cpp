@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "UnitTests.hpp"
+#include "BroadPhaseHelpers.hpp"
+#include <PlayRho/Collision/HashGrid.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace playrho;
+using namespace playrho::d2;
+
+TEST(HashGrid, DefaultConstruction)
+{
+    const auto grid = HashGrid{};
+    EXPECT_EQ(grid.GetCellSize(), HashGrid::GetDefaultCellSize());
+    EXPECT_EQ(grid.GetLeafCount(), 0u);
+    EXPECT_EQ(grid.GetCellCount(), 0u);
+    EXPECT_EQ(size(grid), 0u);
+    EXPECT_TRUE(empty(GetQueryResults(grid, GetGridAABB(0))));
+}
+
+TEST(HashGrid, GetCellRange)
+{
+    const auto grid = HashGrid{1_m};
+    const auto range = grid.GetCellRange(AABB{LengthInterval{-0.5_m, 1.5_m},
+                                              LengthInterval{2_m, 2.5_m}});
+    EXPECT_EQ(range.minX, -1);
+    EXPECT_EQ(range.maxX, 1);
+    EXPECT_EQ(range.minY, 2);
+    EXPECT_EQ(range.maxY, 2);
+}
+
+TEST(HashGrid, CreateUpdateDestroy)
+{
+    auto grid = HashGrid{1_m};
+    const auto aabb0 = AABB{LengthInterval{0.1_m, 0.9_m}, LengthInterval{0.1_m, 0.9_m}};
+    const auto aabb1 = AABB{LengthInterval{4_m, 6_m}, LengthInterval{0.1_m, 0.9_m}};
+    const auto data0 = DynamicTree::LeafData{BodyID(0u), FixtureID(0u), 0u};
+    const auto data1 = DynamicTree::LeafData{BodyID(1u), FixtureID(1u), 0u};
+    const auto id0 = grid.CreateLeaf(aabb0, data0);
+    const auto id1 = grid.CreateLeaf(aabb1, data1);
+    EXPECT_NE(id0, id1);
+    EXPECT_EQ(grid.GetLeafCount(), 2u);
+    EXPECT_EQ(grid.GetCellCount(), 4u);
+    EXPECT_EQ(grid.GetAABB(id0), aabb0);
+    EXPECT_EQ(grid.GetLeafData(id1), data1);
+    EXPECT_FALSE(TestOverlap(grid, id0, id1));
+
+    // Moving within the same cell doesn't change the cells.
+    const auto aabb2 = AABB{LengthInterval{0.2_m, 0.8_m}, LengthInterval{0.2_m, 0.8_m}};
+    grid.UpdateLeaf(id0, aabb2);
+    EXPECT_EQ(grid.GetAABB(id0), aabb2);
+    EXPECT_EQ(grid.GetCellCount(), 4u);
+    ASSERT_NE(grid.GetCell(0, 0), nullptr);
+    EXPECT_EQ(*grid.GetCell(0, 0), std::vector<HashGrid::Size>{id0});
+
+    const auto aabb3 = AABB{LengthInterval{5.1_m, 5.9_m}, LengthInterval{0.1_m, 0.9_m}};
+    grid.UpdateLeaf(id0, aabb3);
+    EXPECT_EQ(grid.GetCell(0, 0), nullptr);
+    EXPECT_EQ(grid.GetCellCount(), 3u);
+    EXPECT_TRUE(TestOverlap(grid, id0, id1));
+
+    grid.DestroyLeaf(id1);
+    EXPECT_EQ(grid.GetLeafCount(), 1u);
+    EXPECT_EQ(grid.GetCellCount(), 1u);
+    EXPECT_EQ(grid.CreateLeaf(aabb1, data1), id1);
+
+    grid.Clear();
+    EXPECT_EQ(grid.GetLeafCount(), 0u);
+    EXPECT_EQ(grid.GetCellCount(), 0u);
+}
+
+TEST(HashGrid, OversizedLeafs)
+{
+    auto grid = HashGrid{1_m};
+    const auto big = AABB{LengthInterval{-100_m, 100_m}, LengthInterval{-1_m, 1_m}};
+    const auto id = grid.CreateLeaf(big, DynamicTree::LeafData{BodyID(0u), FixtureID(0u), 0u});
+    EXPECT_EQ(grid.GetCellCount(), 0u);
+    EXPECT_EQ(grid.GetOversized(), std::vector<HashGrid::Size>{id});
+    const auto small = AABB{LengthInterval{1.1_m, 1.9_m}, LengthInterval{0.1_m, 0.9_m}};
+    EXPECT_EQ(GetQueryResults(grid, small), std::vector<FixtureID>{FixtureID(0u)});
+    grid.UpdateLeaf(id, small);
+    EXPECT_TRUE(empty(grid.GetOversized()));
+    EXPECT_EQ(grid.GetCellCount(), 1u);
+    grid.UpdateLeaf(id, big);
+    EXPECT_EQ(grid.GetOversized(), std::vector<HashGrid::Size>{id});
+    grid.DestroyLeaf(id);
+    EXPECT_TRUE(empty(grid.GetOversized()));
+}
+
+TEST(HashGrid, QueryMatchesDynamicTree)
+{
+    for (const auto cellSize: {0.5_m, 1_m, 3_m})
+    {
+        auto tree = DynamicTree{};
+        auto grid = HashGrid{cellSize};
+        const auto treeIds = FillGrid(tree, 1000);
+        const auto gridIds = FillGrid(grid, 1000);
+        for (auto i = 0; i < 1000; i += 7)
+        {
+            const auto aabb = GetGridAABB(i, Real(i % 5) * 0.3_m);
+            tree.UpdateLeaf(treeIds[static_cast<std::size_t>(i)], aabb);
+            grid.UpdateLeaf(gridIds[static_cast<std::size_t>(i)], aabb);
+        }
+        for (auto i = 0; i < 1000; i += 13)
+        {
+            const auto aabb = GetGridAABB(i, 0.25_m);
+            EXPECT_EQ(GetQueryResults(grid, aabb), GetQueryResults(tree, aabb));
+        }
+        const auto big = AABB{LengthInterval{-1_m, 20_m}, LengthInterval{3_m, 9_m}};
+        EXPECT_EQ(GetQueryResults(grid, big), GetQueryResults(tree, big));
+        const auto huge = AABB{LengthInterval{-1e4_m, 1e4_m}, LengthInterval{-1e4_m, 1e4_m}};
+        EXPECT_EQ(GetQueryResults(grid, huge), GetQueryResults(tree, huge));
+    }
+}
+
+TEST(HashGrid, RayCastMatchesDynamicTree)
+{
+    auto tree = DynamicTree{};
+    auto grid = HashGrid{1_m};
+    FillGrid(tree, 1000);
+    FillGrid(grid, 1000);
+    const auto inputs = {
+        RayCastInput{Length2{-5.1_m, 0.3_m}, Length2{40.1_m, 20.6_m}, Real(1)},
+        RayCastInput{Length2{18.3_m, -2.1_m}, Length2{18.7_m, 30.2_m}, Real(1)},
+        RayCastInput{Length2{40.2_m, 7.3_m}, Length2{-3.1_m, 7.6_m}, Real(1)},
+    };
+    for (const auto& input: inputs)
+    {
+        const auto results = GetRayCastResults(grid, input);
+        EXPECT_FALSE(empty(results));
+        EXPECT_EQ(results, GetRayCastResults(tree, input));
+    }
+}
+
+TEST(HashGrid, QueryEnds)
+{
+    auto grid = HashGrid{};
+    FillGrid(grid, 100);
+    auto ncalls = 0;
+    Query(grid, AABB{LengthInterval{-10_m, 100_m}, LengthInterval{-10_m, 100_m}},
+          [&](DynamicTree::Size) {
+        ++ncalls;
+        return DynamicTreeOpcode::End;
+    });
+    EXPECT_EQ(ncalls, 1);
+}
+
+TEST(HashGrid, ShiftOrigin)
+{
+    auto grid = HashGrid{1_m};
+    const auto aabb = AABB{LengthInterval{1.5_m, 1.75_m}, LengthInterval{3.5_m, 3.75_m}};
+    const auto id = grid.CreateLeaf(aabb, DynamicTree::LeafData{BodyID(0u), FixtureID(0u), 0u});
+    ASSERT_NE(grid.GetCell(1, 3), nullptr);
+    grid.ShiftOrigin(Length2{1_m, 1_m});
+    EXPECT_EQ(grid.GetAABB(id), (AABB{LengthInterval{0.5_m, 0.75_m}, LengthInterval{2.5_m, 2.75_m}}));
+    EXPECT_EQ(grid.GetCell(1, 3), nullptr);
+    ASSERT_NE(grid.GetCell(0, 2), nullptr);
+}
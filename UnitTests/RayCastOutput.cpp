@@ -24,6 +24,7 @@
 #include <PlayRho/Collision/RayCastInput.hpp>
 #include <PlayRho/Collision/AABB.hpp>
 #include <PlayRho/Collision/DistanceProxy.hpp>
+#include <PlayRho/Collision/DynamicTree.hpp>
 #include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
 #include <PlayRho/Collision/Shapes/Shape.hpp>
 
@@ -186,6 +187,41 @@ TEST(RayCastOutput, RayCastShapeFF)
     EXPECT_NEAR(static_cast<double>(Real{output->fraction}), 0.75, 0.01);
 }
 
+TEST(RayCastOutput, RayCastDynamicTreeAnyCallable)
+{
+    auto tree = DynamicTree{};
+    for (auto i = 0; i < 10; ++i)
+    {
+        const auto x = Real(i) * 2_m;
+        tree.CreateLeaf(AABB{LengthInterval{x, x + 1_m}, LengthInterval{-1_m, +1_m}},
+                        DynamicTree::LeafData{BodyID(0u), FixtureID(static_cast<unsigned>(i)), 0});
+    }
+    const auto input = RayCastInput{Length2{-1_m, 0_m}, Length2{+21_m, 0_m}, Real(1)};
+
+    auto expected = std::vector<FixtureID>{};
+    EXPECT_FALSE(RayCast(tree, input, DynamicTreeRayCastCB{
+        [&](BodyID, FixtureID f, ChildCounter, const RayCastInput& rci) {
+        expected.push_back(f);
+        return Real{rci.maxFraction};
+    }}));
+    ASSERT_EQ(size(expected), 10u);
+
+    auto found = std::vector<FixtureID>{};
+    EXPECT_FALSE(RayCast(tree, input, [&](BodyID, FixtureID f, ChildCounter,
+                                          const RayCastInput& rci) {
+        found.push_back(f);
+        return Real{rci.maxFraction};
+    }));
+    EXPECT_EQ(found, expected);
+
+    auto ncalls = 0;
+    EXPECT_TRUE(RayCast(tree, input, [&](BodyID, FixtureID, ChildCounter, const RayCastInput&) {
+        ++ncalls;
+        return Real{0};
+    }));
+    EXPECT_EQ(ncalls, 1);
+}
+
 TEST(RayCastHit, ByteSize)
 {
     switch (sizeof(Real))
@@ -28,9 +28,9 @@ TEST(StepConf, ByteSize)
 {
     switch (sizeof(Real))
     {
-        case  4: EXPECT_EQ(sizeof(StepConf), std::size_t(104)); break;
-        case  8: EXPECT_EQ(sizeof(StepConf), std::size_t(200)); break;
-        case 16: EXPECT_EQ(sizeof(StepConf), std::size_t(384)); break;
+        case  4: EXPECT_EQ(sizeof(StepConf), std::size_t(132)); break;
+        case  8: EXPECT_EQ(sizeof(StepConf), std::size_t(248)); break;
+        case 16: EXPECT_EQ(sizeof(StepConf), std::size_t(480)); break;
         default: FAIL(); break;
     }
 }
@@ -27,9 +27,9 @@ TEST(StepStats, PreStatsByteSize)
 {
     switch (sizeof(Real))
     {
-        case  4: EXPECT_EQ(sizeof(PreStepStats), std::size_t(24)); break;
-        case  8: EXPECT_EQ(sizeof(PreStepStats), std::size_t(24)); break;
-        case 16: EXPECT_EQ(sizeof(PreStepStats), std::size_t(24)); break;
+        case  4: EXPECT_EQ(sizeof(PreStepStats), std::size_t(56)); break;
+        case  8: EXPECT_EQ(sizeof(PreStepStats), std::size_t(64)); break;
+        case 16: EXPECT_EQ(sizeof(PreStepStats), std::size_t(80)); break;
         default: FAIL(); break;
     }
 }
@@ -38,8 +38,8 @@ TEST(StepStats, RegStatsByteSize)
 {
     switch (sizeof(Real))
     {
-        case  4: EXPECT_EQ(sizeof(RegStepStats), std::size_t(32)); break;
-        case  8: EXPECT_EQ(sizeof(RegStepStats), std::size_t(40)); break;
+        case  4: EXPECT_EQ(sizeof(RegStepStats), std::size_t(40)); break;
+        case  8: EXPECT_EQ(sizeof(RegStepStats), std::size_t(48)); break;
         case 16: EXPECT_EQ(sizeof(RegStepStats), std::size_t(64)); break;
         default: FAIL(); break;
     }
@@ -49,8 +49,8 @@ TEST(StepStats, ToiStatsByteSize)
 {
     switch (sizeof(Real))
     {
-        case  4: EXPECT_EQ(sizeof(ToiStepStats), std::size_t(60)); break;
-        case  8: EXPECT_EQ(sizeof(ToiStepStats), std::size_t(72)); break;
+        case  4: EXPECT_EQ(sizeof(ToiStepStats), std::size_t(72)); break;
+        case  8: EXPECT_EQ(sizeof(ToiStepStats), std::size_t(80)); break;
         case 16: EXPECT_EQ(sizeof(ToiStepStats), std::size_t(96)); break;
         default: FAIL(); break;
     }
@@ -60,9 +60,9 @@ TEST(StepStats, ByteSize)
 {
     switch (sizeof(Real))
     {
-        case  4: EXPECT_EQ(sizeof(StepStats), std::size_t(116)); break;
-        case  8: EXPECT_EQ(sizeof(StepStats), std::size_t(136)); break;
-        case 16: EXPECT_EQ(sizeof(StepStats), std::size_t(192)); break;
+        case  4: EXPECT_EQ(sizeof(StepStats), std::size_t(168)); break;
+        case  8: EXPECT_EQ(sizeof(StepStats), std::size_t(192)); break;
+        case 16: EXPECT_EQ(sizeof(StepStats), std::size_t(240)); break;
         default: FAIL(); break;
     }
 }
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#include "UnitTests.hpp"
+#include "BroadPhaseHelpers.hpp"
+#include <PlayRho/Collision/SweepAndPrune.hpp>
+#include <PlayRho/Collision/BroadPhase.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace playrho;
+using namespace playrho::d2;
+
+TEST(SweepAndPrune, DefaultConstruction)
+{
+    const auto sap = SweepAndPrune{};
+    EXPECT_EQ(sap.GetLeafCount(), 0u);
+    EXPECT_EQ(sap.GetSortedCount(), 0u);
+    EXPECT_EQ(sap.GetMaxWidth(), 0_m);
+    EXPECT_EQ(size(sap), 0u);
+    EXPECT_TRUE(empty(GetQueryResults(sap, GetGridAABB(0))));
+}
+
+TEST(SweepAndPrune, CreateUpdateDestroy)
+{
+    auto sap = SweepAndPrune{};
+    const auto aabb0 = AABB{LengthInterval{0_m, 1_m}, LengthInterval{0_m, 1_m}};
+    const auto aabb1 = AABB{LengthInterval{4_m, 6_m}, LengthInterval{0_m, 1_m}};
+    const auto data0 = DynamicTree::LeafData{BodyID(0u), FixtureID(0u), 0u};
+    const auto data1 = DynamicTree::LeafData{BodyID(1u), FixtureID(1u), 0u};
+    const auto id0 = sap.CreateLeaf(aabb0, data0);
+    const auto id1 = sap.CreateLeaf(aabb1, data1);
+    EXPECT_NE(id0, id1);
+    EXPECT_EQ(sap.GetLeafCount(), 2u);
+    EXPECT_EQ(sap.GetAABB(id0), aabb0);
+    EXPECT_EQ(sap.GetAABB(id1), aabb1);
+    EXPECT_EQ(sap.GetLeafData(id0), data0);
+    EXPECT_EQ(sap.GetLeafData(id1), data1);
+    EXPECT_EQ(sap.GetSortedCount(), 0u);
+    EXPECT_EQ(sap.Optimize(0u, 10u).visited, 2u);
+    EXPECT_EQ(sap.GetSortedCount(), 2u);
+    EXPECT_GE(sap.GetMaxWidth(), 2_m);
+    EXPECT_FALSE(TestOverlap(sap, id0, id1));
+
+    const auto aabb2 = AABB{LengthInterval{5_m, 6_m}, LengthInterval{0_m, 1_m}};
+    sap.UpdateLeaf(id0, aabb2);
+    EXPECT_EQ(sap.GetAABB(id0), aabb2);
+    EXPECT_TRUE(TestOverlap(sap, id0, id1));
+
+    sap.DestroyLeaf(id0);
+    EXPECT_EQ(sap.GetLeafCount(), 1u);
+    EXPECT_EQ(sap.GetAABB(id1), aabb1);
+    EXPECT_EQ(sap.CreateLeaf(aabb0, data0), id0);
+
+    sap.Clear();
+    EXPECT_EQ(sap.GetLeafCount(), 0u);
+    EXPECT_EQ(sap.GetMaxWidth(), 0_m);
+}
+
+TEST(SweepAndPrune, EntriesStaySorted)
+{
+    auto sap = SweepAndPrune{};
+    FillGrid(sap, 500);
+    ASSERT_EQ(sap.GetLeafCount(), 500u);
+    ASSERT_GT(sap.GetSortedCount(), 0u);
+    for (auto i = 0; i < 500; i += 3)
+    {
+        sap.UpdateLeaf(static_cast<SweepAndPrune::Size>(i),
+                       GetGridAABB(i, Real((i * 7) % 11 - 5) * 1_m));
+    }
+    for (auto i = 0; i < 500; i += 5)
+    {
+        sap.DestroyLeaf(static_cast<SweepAndPrune::Size>(i));
+    }
+    EXPECT_EQ(sap.GetLeafCount(), 400u);
+    const auto& entries = sap.GetEntries();
+    const auto sortedEnd = begin(entries) + sap.GetSortedCount();
+    EXPECT_TRUE(std::is_sorted(begin(entries), sortedEnd, [](const auto& a, const auto& b) {
+        return a.aabb.ranges[0].GetMin() < b.aabb.ranges[0].GetMin();
+    }));
+    auto live = std::size_t{0};
+    for (const auto& entry: entries)
+    {
+        if (entry.index != SweepAndPrune::GetInvalidSize())
+        {
+            EXPECT_EQ(sap.GetAABB(entry.index), entry.aabb);
+            ++live;
+        }
+    }
+    EXPECT_EQ(live, 400u);
+    EXPECT_TRUE(empty(sap.GetWideEntries()));
+
+    // Destroying only marks entries as dead until they get compacted out.
+    EXPECT_EQ(size(entries), 500u);
+    const auto unsorted = size(entries) - sap.GetSortedCount();
+    EXPECT_EQ(sap.Optimize(0u, 1000u).visited, unsorted + 100u);
+    EXPECT_EQ(size(sap.GetEntries()), 400u);
+    EXPECT_EQ(sap.GetSortedCount(), 400u);
+}
+
+TEST(SweepAndPrune, WideLeafsKeptApart)
+{
+    auto sap = SweepAndPrune{};
+    auto tree = DynamicTree{};
+    FillGrid(sap, 1000);
+    const auto treeIds = FillGrid(tree, 1000);
+    const auto ground = AABB{LengthInterval{-500_m, 500_m}, LengthInterval{-2_m, 0.5_m}};
+    const auto groundData = DynamicTree::LeafData{BodyID(1000u), FixtureID(1000u), 0u};
+    const auto groundId = sap.CreateLeaf(ground, groundData);
+    tree.CreateLeaf(ground, groundData);
+    sap.Optimize(0u, 1000u);
+    ASSERT_EQ(size(sap.GetWideEntries()), 1u);
+    EXPECT_EQ(sap.GetWideEntries().front().index, groundId);
+    EXPECT_EQ(sap.GetAABB(groundId), ground);
+    EXPECT_LT(sap.GetMaxWidth(), 2_m);
+    EXPECT_GT(sap.GetWideWidth(), sap.GetMaxWidth());
+    EXPECT_LT(sap.GetWideWidth(), 1000_m);
+
+    // Widening a sorted leaf moves it to the wide ones rather than widening the scan.
+    const auto wide = AABB{LengthInterval{-20_m, 60_m}, LengthInterval{3_m, 4_m}};
+    sap.UpdateLeaf(5u, wide);
+    tree.UpdateLeaf(treeIds[5], wide);
+    EXPECT_EQ(size(sap.GetWideEntries()), 2u);
+    EXPECT_EQ(sap.GetAABB(5u), wide);
+    EXPECT_LT(sap.GetMaxWidth(), 2_m);
+    for (auto i = 0; i < 1000; i += 13)
+    {
+        const auto aabb = GetGridAABB(i, 0.25_m);
+        EXPECT_EQ(GetQueryResults(sap, aabb), GetQueryResults(tree, aabb));
+    }
+    const auto input = RayCastInput{Length2{-5.1_m, 0.3_m}, Length2{40.1_m, 20.6_m}, Real(1)};
+    EXPECT_EQ(GetRayCastResults(sap, input), GetRayCastResults(tree, input));
+
+    // Shrinking it back makes it a sorted one again on the next merge.
+    sap.UpdateLeaf(5u, GetGridAABB(5));
+    sap.DestroyLeaf(groundId);
+    EXPECT_EQ(sap.GetLeafCount(), 1000u);
+    EXPECT_EQ(size(sap.GetWideEntries()), 1u);
+    sap.Optimize(0u, 1000u);
+    EXPECT_TRUE(empty(sap.GetWideEntries()));
+    EXPECT_EQ(sap.GetAABB(5u), GetGridAABB(5));
+    EXPECT_EQ(sap.GetSortedCount(), 1000u);
+}
+
+TEST(SweepAndPrune, CreateLeafs)
+{
+    auto aabbs = std::vector<AABB>{};
+    auto data = std::vector<SweepAndPrune::LeafData>{};
+    for (auto i = 0; i < 200; ++i)
+    {
+        aabbs.push_back(GetGridAABB(199 - i));
+        data.push_back(SweepAndPrune::LeafData{
+            BodyID(static_cast<unsigned>(i)), FixtureID(static_cast<unsigned>(i)), 0u});
+    }
+    auto sap = SweepAndPrune{};
+    const auto ids = sap.CreateLeafs(aabbs, data);
+    ASSERT_EQ(size(ids), size(aabbs));
+    EXPECT_EQ(sap.GetLeafCount(), SweepAndPrune::Size(200));
+    EXPECT_EQ(sap.GetSortedCount(), SweepAndPrune::Size(200));
+    const auto& entries = sap.GetEntries();
+    EXPECT_TRUE(std::is_sorted(begin(entries), end(entries), [](const auto& lhs, const auto& rhs) {
+        return lhs.aabb.ranges[0].GetMin() < rhs.aabb.ranges[0].GetMin();
+    }));
+    for (auto i = std::size_t{0}; i < size(ids); ++i)
+    {
+        EXPECT_EQ(sap.GetAABB(ids[i]), aabbs[i]);
+        EXPECT_EQ(sap.GetLeafData(ids[i]), data[i]);
+    }
+}
+
+TEST(SweepAndPrune, QueryMatchesDynamicTree)
+{
+    auto sap = SweepAndPrune{};
+    FillGrid(sap, 1000);
+    for (auto i = 0; i < 1000; i += 7)
+    {
+        sap.UpdateLeaf(static_cast<SweepAndPrune::Size>(i),
+                       GetGridAABB(i, Real(i % 5) * 0.3_m));
+    }
+    auto tree = DynamicTree{};
+    for (auto i = 0; i < 1000; ++i)
+    {
+        const auto id = static_cast<SweepAndPrune::Size>(i);
+        tree.CreateLeaf(sap.GetAABB(id), sap.GetLeafData(id));
+    }
+    for (auto i = 0; i < 1000; i += 13)
+    {
+        const auto aabb = GetGridAABB(i, 0.25_m);
+        EXPECT_EQ(GetQueryResults(sap, aabb), GetQueryResults(tree, aabb));
+    }
+    const auto big = AABB{LengthInterval{-1_m, 20_m}, LengthInterval{3_m, 9_m}};
+    EXPECT_EQ(GetQueryResults(sap, big), GetQueryResults(tree, big));
+}
+
+TEST(SweepAndPrune, RayCastMatchesDynamicTree)
+{
+    auto tree = DynamicTree{};
+    auto sap = SweepAndPrune{};
+    FillGrid(tree, 1000);
+    FillGrid(sap, 1000);
+    const auto inputs = {
+        RayCastInput{Length2{-5.1_m, 0.3_m}, Length2{40.1_m, 20.6_m}, Real(1)},
+        RayCastInput{Length2{18.3_m, -2.1_m}, Length2{18.7_m, 30.2_m}, Real(1)},
+        RayCastInput{Length2{40.2_m, 7.3_m}, Length2{-3.1_m, 7.6_m}, Real(1)},
+    };
+    for (const auto& input: inputs)
+    {
+        const auto results = GetRayCastResults(sap, input);
+        EXPECT_FALSE(empty(results));
+        EXPECT_EQ(results, GetRayCastResults(tree, input));
+    }
+}
+
+TEST(SweepAndPrune, QueryEnds)
+{
+    auto sap = SweepAndPrune{};
+    FillGrid(sap, 100);
+    auto ncalls = 0;
+    Query(sap, AABB{LengthInterval{-10_m, 100_m}, LengthInterval{-10_m, 100_m}},
+          [&](DynamicTree::Size) {
+        ++ncalls;
+        return DynamicTreeOpcode::End;
+    });
+    EXPECT_EQ(ncalls, 1);
+}
+
+TEST(SweepAndPrune, ShiftOrigin)
+{
+    auto sap = SweepAndPrune{};
+    const auto aabb = AABB{LengthInterval{1_m, 2_m}, LengthInterval{3_m, 4_m}};
+    const auto id = sap.CreateLeaf(aabb, DynamicTree::LeafData{BodyID(0u), FixtureID(0u), 0u});
+    sap.ShiftOrigin(Length2{1_m, 1_m});
+    EXPECT_EQ(sap.GetAABB(id), (AABB{LengthInterval{0_m, 1_m}, LengthInterval{2_m, 3_m}}));
+}
+
+TEST(BroadPhase, DefaultConstructionIsDynamicTree)
+{
+    const auto broadPhase = BroadPhase{};
+    EXPECT_EQ(GetType(broadPhase), GetTypeID<DynamicTree>());
+    EXPECT_NE(TypeCast<const DynamicTree*>(&broadPhase), nullptr);
+    EXPECT_EQ(TypeCast<const SweepAndPrune*>(&broadPhase), nullptr);
+    EXPECT_EQ(broadPhase.GetLeafCount(), 0u);
+}
+
+TEST(BroadPhase, CopyIsIndependent)
+{
+    auto broadPhase = BroadPhase{SweepAndPrune{}};
+    EXPECT_EQ(GetType(broadPhase), GetTypeID<SweepAndPrune>());
+    FillGrid(broadPhase, 10);
+    auto copy = broadPhase;
+    EXPECT_EQ(copy.GetLeafCount(), 10u);
+    copy.Clear();
+    EXPECT_EQ(copy.GetLeafCount(), 0u);
+    EXPECT_EQ(broadPhase.GetLeafCount(), 10u);
+    const auto aabb = AABB{LengthInterval{-1_m, 3_m}, LengthInterval{-1_m, 0.5_m}};
+    EXPECT_EQ(GetQueryResults(broadPhase, aabb),
+              (std::vector<FixtureID>{FixtureID(0u), FixtureID(1u), FixtureID(2u), FixtureID(3u)}));
+}
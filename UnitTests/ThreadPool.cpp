@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software
+ * in a product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "UnitTests.hpp"
+#include <PlayRho/Common/ThreadPool.hpp>
+#include <stdexcept>
+
+using namespace playrho;
+
+TEST(ThreadPool, DefaultConstruction)
+{
+    EXPECT_EQ(ThreadPool{}.GetWorkers(), 0u);
+}
+
+TEST(ThreadPool, CopiesGetAsManyWorkers)
+{
+    const auto pool = ThreadPool{3};
+    EXPECT_EQ(pool.GetWorkers(), 3u);
+    const auto copy = pool;
+    EXPECT_EQ(copy.GetWorkers(), 3u);
+    auto other = ThreadPool{1};
+    other = pool;
+    EXPECT_EQ(other.GetWorkers(), 3u);
+}
+
+TEST(ThreadPool, WithoutWorkersRunsTasksInOrderOnCaller)
+{
+    auto pool = ThreadPool{};
+    auto order = std::vector<int>{};
+    for (auto i = 0; i < 4; ++i)
+    {
+        pool.Push([&order,i](std::size_t thread) {
+            EXPECT_EQ(thread, 0u);
+            order.push_back(i);
+        });
+    }
+    EXPECT_TRUE(empty(order));
+    pool.Wait();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(ThreadPool, RunsEveryTaskOnce)
+{
+    auto pool = ThreadPool{4};
+    constexpr auto numTasks = std::size_t{1000};
+    auto runs = std::vector<int>(numTasks, 0);
+    auto threads = std::vector<std::size_t>(numTasks, 0u);
+    for (auto round = 0; round < 3; ++round)
+    {
+        for (auto i = std::size_t{0}; i < numTasks; ++i)
+        {
+            pool.Push([&runs,&threads,i](std::size_t thread) {
+                ++runs[i];
+                threads[i] = thread;
+            });
+        }
+        pool.Wait();
+    }
+    for (auto i = std::size_t{0}; i < numTasks; ++i)
+    {
+        EXPECT_EQ(runs[i], 3);
+        EXPECT_LE(threads[i], 4u);
+    }
+}
+
+TEST(ThreadPool, WaitRethrowsTaskException)
+{
+    auto pool = ThreadPool{2};
+    auto ran = std::atomic<int>{0};
+    for (auto i = 0; i < 10; ++i)
+    {
+        pool.Push([&ran,i](std::size_t) {
+            ++ran;
+            if (i == 5)
+            {
+                throw std::runtime_error{"task failed"};
+            }
+        });
+    }
+    EXPECT_THROW(pool.Wait(), std::runtime_error);
+    EXPECT_EQ(ran, 10);
+    EXPECT_NO_THROW(pool.Wait());
+}
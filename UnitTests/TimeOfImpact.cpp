@@ -294,6 +294,39 @@ TEST(TimeOfImpact, CollideEdgeCircleTouchingly)
     EXPECT_EQ(output.stats.sum_dist_iters, 3u);
 }
 
+TEST(TimeOfImpact, GetToiViaSatWarmStartedFromIndices)
+{
+    const auto limits = ToiConf{}.UseTimeMax(1).UseTargetDepth(0.003_m).UseTolerance(0.00025_m);
+
+    const Length2 vertices[] = {
+        Length2{+0.5_m, -0.5_m}, Length2{+0.5_m, +0.5_m},
+        Length2{-0.5_m, +0.5_m}, Length2{-0.5_m, -0.5_m}
+    };
+    const UnitVec normals[] = {
+        UnitVec::GetRight(), UnitVec::GetTop(), UnitVec::GetLeft(), UnitVec::GetBottom()
+    };
+    const auto proxyA = DistanceProxy{0.01_m, 4, vertices, normals};
+    const auto sweepA = Sweep{Position{Length2{-3_m, 0_m}, 0_deg}, Position{Length2{}, 10_deg}};
+    const auto proxyB = DistanceProxy{0.01_m, 4, vertices, normals};
+    const auto sweepB = Sweep{Position{Length2{+3_m, 1_m}, 0_deg}, Position{Length2{}, 0_deg}};
+
+    auto indices = InvalidIndexPair3;
+    const auto cold = GetToiViaSat(proxyA, sweepA, proxyB, sweepB, limits, indices);
+    EXPECT_EQ(cold.state, TOIOutput::e_touching);
+    EXPECT_GT(GetNumValidIndices(indices), 0u);
+
+    const auto expected = GetToiViaSat(proxyA, sweepA, proxyB, sweepB, limits);
+    EXPECT_EQ(cold.state, expected.state);
+    EXPECT_EQ(cold.time, expected.time);
+    EXPECT_EQ(cold.stats.sum_dist_iters, expected.stats.sum_dist_iters);
+
+    // Starting from where the previous call left off shouldn't take more iterations.
+    const auto warm = GetToiViaSat(proxyA, sweepA, proxyB, sweepB, limits, indices);
+    EXPECT_EQ(warm.state, cold.state);
+    EXPECT_NEAR(static_cast<double>(warm.time), static_cast<double>(cold.time), 0.0001);
+    EXPECT_LE(warm.stats.sum_dist_iters, cold.stats.sum_dist_iters);
+}
+
 TEST(TimeOfImpact, CollideCirclesVertically)
 {
     const auto slop = Real{0.001f};
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "UnitTests.hpp"
+#include <PlayRho/Collision/WideDynamicTree.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace playrho;
+using namespace playrho::d2;
+
+namespace {
+
+DynamicTree GetGridTree(int count)
+{
+    auto tree = DynamicTree{};
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto x = Real(i % 37) * 1_m;
+        const auto y = Real(i / 37) * 1_m;
+        const auto aabb = AABB{LengthInterval{x, x + 1.5_m}, LengthInterval{y, y + 1.5_m}};
+        tree.CreateLeaf(aabb, DynamicTree::LeafData{BodyID(static_cast<unsigned>(i)),
+            FixtureID(static_cast<unsigned>(i)), 0u});
+    }
+    return tree;
+}
+
+template <class T>
+std::vector<DynamicTree::Size> GetQueryResults(const T& tree, const AABB& aabb)
+{
+    auto results = std::vector<DynamicTree::Size>{};
+    Query(tree, aabb, [&](DynamicTree::Size id) {
+        results.push_back(id);
+        return DynamicTreeOpcode::Continue;
+    });
+    std::sort(begin(results), end(results));
+    return results;
+}
+
+template <class T>
+std::vector<FixtureID> GetRayCastResults(const T& tree, const RayCastInput& input)
+{
+    auto results = std::vector<FixtureID>{};
+    RayCast(tree, input, [&](BodyID, FixtureID fixture, ChildCounter, const RayCastInput& rci) {
+        results.push_back(fixture);
+        return rci.maxFraction;
+    });
+    std::sort(begin(results), end(results));
+    return results;
+}
+
+} // namespace
+
+TEST(WideDynamicTree, DefaultConstruction)
+{
+    const auto tree = WideDynamicTree4{};
+    EXPECT_EQ(tree.GetRootIndex(), WideDynamicTree4::GetInvalidSize());
+    EXPECT_EQ(tree.GetNodeCount(), 0u);
+    EXPECT_EQ(tree.GetLeafCount(), 0u);
+    EXPECT_EQ(size(tree), 0u);
+    EXPECT_EQ(tree.GetAABB(), AABB{});
+    auto ncalls = 0;
+    Query(tree, AABB{LengthInterval{-10_m, 10_m}, LengthInterval{-10_m, 10_m}},
+          [&](DynamicTree::Size) {
+        ++ncalls;
+        return DynamicTreeOpcode::Continue;
+    });
+    EXPECT_EQ(ncalls, 0);
+    EXPECT_FALSE(RayCast(tree, RayCastInput{Length2{-10_m, 0_m}, Length2{10_m, 0_m}, 1},
+                         [&](BodyID, FixtureID, ChildCounter, const RayCastInput&) {
+        ++ncalls;
+        return Real(0);
+    }));
+    EXPECT_EQ(ncalls, 0);
+}
+
+TEST(WideDynamicTree, SingleLeaf)
+{
+    auto dynamicTree = DynamicTree{};
+    const auto aabb = AABB{LengthInterval{-1_m, 1_m}, LengthInterval{-2_m, 2_m}};
+    const auto leafData = DynamicTree::LeafData{BodyID(3u), FixtureID(2u), 1u};
+    const auto id = dynamicTree.CreateLeaf(aabb, leafData);
+    const auto tree = WideDynamicTree8{dynamicTree};
+    EXPECT_EQ(tree.GetNodeCount(), 1u);
+    EXPECT_EQ(tree.GetLeafCount(), 1u);
+    EXPECT_EQ(tree.GetAABB(), aabb);
+    EXPECT_EQ(tree.GetAABB(id), aabb);
+    EXPECT_EQ(tree.GetLeafData(id), leafData);
+    EXPECT_EQ(GetQueryResults(tree, aabb), std::vector<DynamicTree::Size>{id});
+    EXPECT_TRUE(empty(GetQueryResults(tree, AABB{})));
+}
+
+TEST(WideDynamicTree, QueryMatchesDynamicTree)
+{
+    const auto dynamicTree = GetGridTree(1000);
+    const auto tree4 = WideDynamicTree4{dynamicTree};
+    const auto tree8 = WideDynamicTree8{dynamicTree};
+    EXPECT_EQ(tree4.GetLeafCount(), dynamicTree.GetLeafCount());
+    EXPECT_EQ(tree8.GetLeafCount(), dynamicTree.GetLeafCount());
+    EXPECT_LT(tree4.GetNodeCount(), dynamicTree.GetNodeCount() - dynamicTree.GetLeafCount());
+    EXPECT_EQ(tree4.GetAABB(), GetAABB(dynamicTree));
+    for (auto i = 0; i < 40; ++i)
+    {
+        const auto x = Real(i) * 1_m;
+        const auto y = Real(i % 27) * 1_m;
+        const auto aabb = AABB{LengthInterval{x, x + Real(i % 5) * 1_m},
+                               LengthInterval{y, y + Real(i % 3) * 1_m}};
+        const auto expected = GetQueryResults(dynamicTree, aabb);
+        EXPECT_EQ(GetQueryResults(tree4, aabb), expected);
+        EXPECT_EQ(GetQueryResults(tree8, aabb), expected);
+    }
+}
+
+TEST(WideDynamicTree, QueryEnds)
+{
+    const auto tree = WideDynamicTree4{GetGridTree(100)};
+    auto ncalls = 0;
+    Query(tree, tree.GetAABB(), [&](DynamicTree::Size) {
+        ++ncalls;
+        return DynamicTreeOpcode::End;
+    });
+    EXPECT_EQ(ncalls, 1);
+}
+
+TEST(WideDynamicTree, RayCastMatchesDynamicTree)
+{
+    const auto dynamicTree = GetGridTree(1000);
+    const auto tree4 = WideDynamicTree4{dynamicTree};
+    const auto tree8 = WideDynamicTree8{dynamicTree};
+    for (auto i = 0; i < 20; ++i)
+    {
+        // Offsets avoid rays that just graze leafs and so depend on rounding.
+        const auto p1 = Length2{-5.1_m, (Real(i) + Real(0.3)) * 1_m};
+        const auto p2 = Length2{40.1_m, (Real(30 - i) + Real(0.6)) * 1_m};
+        const auto input = RayCastInput{p1, p2, Real(1)};
+        const auto expected = GetRayCastResults(dynamicTree, input);
+        EXPECT_FALSE(empty(expected));
+        EXPECT_EQ(GetRayCastResults(tree4, input), expected);
+        EXPECT_EQ(GetRayCastResults(tree8, input), expected);
+    }
+}
+
+TEST(WideDynamicTree, RayCastSkipsLeafsPastClippedSegment)
+{
+    const auto dynamicTree = GetGridTree(1000);
+    const auto tree4 = WideDynamicTree4{dynamicTree};
+    const auto tree8 = WideDynamicTree8{dynamicTree};
+    const auto p1 = Length2{-5.1_m, 10.7_m};
+    const auto p2 = Length2{40.1_m, 10.7_m};
+    const auto input = RayCastInput{p1, p2, Real(1)};
+    const auto getNearest = [&](const auto& tree) {
+        auto nearest = FixtureID(0u);
+        auto calls = 0;
+        RayCast(tree, input, [&](BodyID, FixtureID fixture, ChildCounter,
+                                 const RayCastInput& rci) -> Real {
+            ++calls;
+            // Leaf's AABB must overlap the segment as clipped so far.
+            const auto i = UnderlyingValue(fixture);
+            const auto lowerX = Real(i % 37) * 1_m;
+            const auto deltaX = GetX(rci.p2) - GetX(rci.p1);
+            EXPECT_LE(lowerX, GetX(rci.p1) + deltaX * rci.maxFraction);
+            const auto fraction = Real{(lowerX - GetX(rci.p1)) / deltaX};
+            if (fraction < rci.maxFraction)
+            {
+                nearest = fixture;
+                return fraction;
+            }
+            return rci.maxFraction;
+        });
+        EXPECT_LT(calls, 37);
+        return nearest;
+    };
+    // Ray only passes through the row of 37 leafs starting with leaf 370.
+    EXPECT_EQ(getNearest(dynamicTree), FixtureID(370u));
+    EXPECT_EQ(getNearest(tree4), FixtureID(370u));
+    EXPECT_EQ(getNearest(tree8), FixtureID(370u));
+}
+
+namespace {
+
+template <class T>
+std::vector<FixtureID> GetQueryFixtures(const T& tree, const AABB& aabb)
+{
+    auto results = std::vector<FixtureID>{};
+    Query(tree, aabb, [&](DynamicTree::Size id) {
+        results.push_back(tree.GetLeafData(id).fixture);
+        return DynamicTreeOpcode::Continue;
+    });
+    std::sort(begin(results), end(results));
+    return results;
+}
+
+/// @brief Counts the leafs of the given tree while checking that the bounds of every
+///   slot enclose those of the slots under it and that children point back at their slots.
+template <std::size_t N>
+std::size_t CountValidLeafs(const WideDynamicTree<N>& tree, DynamicTree::Size index,
+                            const AABB& bounds)
+{
+    const auto& node = tree.GetNode(index);
+    EXPECT_GE(node.count, (node.parent == DynamicTree::GetInvalidSize())? 1u: 2u);
+    auto count = std::size_t{0};
+    for (auto i = std::size_t{0}; i < node.count; ++i)
+    {
+        const auto aabb = AABB{LengthInterval{node.lowerX[i], node.upperX[i]},
+                               LengthInterval{node.lowerY[i], node.upperY[i]}};
+        EXPECT_TRUE(Contains(bounds, aabb));
+        if (node.leafs & (std::uint32_t{1} << i))
+        {
+            EXPECT_EQ(tree.GetAABB(node.children[i]), aabb);
+            ++count;
+        }
+        else
+        {
+            EXPECT_EQ(tree.GetNode(node.children[i]).parent, index);
+            EXPECT_EQ(tree.GetNode(node.children[i]).parentSlot, i);
+            count += CountValidLeafs(tree, node.children[i], aabb);
+        }
+    }
+    for (auto i = std::size_t{node.count}; i < N; ++i)
+    {
+        EXPECT_FALSE(node.lowerX[i] <= node.upperX[i]);
+    }
+    return count;
+}
+
+template <std::size_t N>
+void TestIncrementalMatchesDynamicTree()
+{
+    auto tree = WideDynamicTree<N>{};
+    auto dynamicTree = DynamicTree{};
+    auto ids = std::vector<DynamicTree::Size>{};
+    auto treeIds = std::vector<DynamicTree::Size>{};
+    const auto getAABB = [](int i, Length offset) {
+        const auto x = Real(i % 37) * 1_m + offset;
+        const auto y = Real(i / 37) * 1_m;
+        return AABB{LengthInterval{x, x + 1.5_m}, LengthInterval{y, y + 1.5_m}};
+    };
+    for (auto i = 0; i < 1000; ++i)
+    {
+        const auto data = DynamicTree::LeafData{BodyID(static_cast<unsigned>(i)),
+            FixtureID(static_cast<unsigned>(i)), 0u};
+        ids.push_back(tree.CreateLeaf(getAABB(i, 0_m), data));
+        treeIds.push_back(dynamicTree.CreateLeaf(getAABB(i, 0_m), data));
+    }
+    EXPECT_EQ(tree.GetLeafCount(), 1000u);
+
+    // Small moves get refit in place while big ones get reinserted.
+    for (auto i = 0; i < 1000; i += 3)
+    {
+        const auto offset = Real((i * 7) % 11 - 5) * ((i % 2)? 0.01_m: 4_m);
+        tree.UpdateLeaf(ids[i], getAABB(i, offset));
+        dynamicTree.UpdateLeaf(treeIds[i], getAABB(i, offset));
+    }
+    for (auto i = 0; i < 1000; i += 5)
+    {
+        tree.DestroyLeaf(ids[i]);
+        dynamicTree.DestroyLeaf(treeIds[i]);
+    }
+    EXPECT_EQ(tree.GetLeafCount(), 800u);
+    EXPECT_EQ(CountValidLeafs(tree, tree.GetRootIndex(), tree.GetAABB()), 800u);
+
+    const auto check = [&]() {
+        for (auto i = 0; i < 60; ++i)
+        {
+            const auto x = Real(i - 5) * 1_m;
+            const auto y = Real(i % 27) * 1_m;
+            const auto aabb = AABB{LengthInterval{x, x + Real(i % 5) * 1_m},
+                                   LengthInterval{y, y + Real(i % 3) * 1_m}};
+            EXPECT_EQ(GetQueryFixtures(tree, aabb), GetQueryFixtures(dynamicTree, aabb));
+        }
+    };
+    check();
+
+    // Rebuilding only happens once enough leafs have been inserted and keeps the ids.
+    const auto stats = tree.Optimize(0u, 1u);
+    EXPECT_TRUE(stats.sweepEnded);
+    EXPECT_EQ(stats.visited, 800u);
+    EXPECT_EQ(tree.Optimize(0u, 1u).visited, 0u);
+    EXPECT_EQ(CountValidLeafs(tree, tree.GetRootIndex(), tree.GetAABB()), 800u);
+    check();
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        if (i % 5)
+        {
+            tree.DestroyLeaf(ids[i]);
+        }
+    }
+    EXPECT_EQ(tree.GetLeafCount(), 0u);
+    EXPECT_EQ(tree.GetRootIndex(), WideDynamicTree<N>::GetInvalidSize());
+    EXPECT_EQ(tree.GetNodeCount(), 0u);
+}
+
+} // namespace
+
+TEST(WideDynamicTree, IncrementalMatchesDynamicTree)
+{
+    TestIncrementalMatchesDynamicTree<4>();
+    TestIncrementalMatchesDynamicTree<8>();
+}
+
+TEST(WideDynamicTree, CreateLeafs)
+{
+    auto aabbs = std::vector<AABB>{};
+    auto data = std::vector<DynamicTree::LeafData>{};
+    for (auto i = 0; i < 300; ++i)
+    {
+        const auto x = Real(i % 37) * 1_m;
+        const auto y = Real(i / 37) * 1_m;
+        aabbs.push_back(AABB{LengthInterval{x, x + 1.5_m}, LengthInterval{y, y + 1.5_m}});
+        data.push_back(DynamicTree::LeafData{BodyID(static_cast<unsigned>(i)),
+            FixtureID(static_cast<unsigned>(i)), 0u});
+    }
+    auto tree = WideDynamicTree8{};
+    EXPECT_THROW(tree.CreateLeafs(aabbs, Span<const DynamicTree::LeafData>{}), InvalidArgument);
+    const auto first = tree.CreateLeaf(aabbs.back(), data.back());
+    aabbs.pop_back();
+    data.pop_back();
+    const auto ids = tree.CreateLeafs(aabbs, data);
+    ASSERT_EQ(size(ids), size(aabbs));
+    EXPECT_EQ(tree.GetLeafCount(), 300u);
+    EXPECT_EQ(CountValidLeafs(tree, tree.GetRootIndex(), tree.GetAABB()), 300u);
+    EXPECT_EQ(tree.GetLeafData(first).fixture, FixtureID(299u));
+    for (auto i = std::size_t{0}; i < size(ids); ++i)
+    {
+        EXPECT_EQ(tree.GetAABB(ids[i]), aabbs[i]);
+        EXPECT_EQ(tree.GetLeafData(ids[i]), data[i]);
+    }
+}
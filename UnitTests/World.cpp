@@ -26,6 +26,7 @@
 #include <PlayRho/Dynamics/WorldJoint.hpp>
 #include <PlayRho/Dynamics/WorldContact.hpp>
 #include <PlayRho/Dynamics/WorldFixture.hpp>
+#include <PlayRho/Dynamics/WorldRayCast.hpp>
 #include <PlayRho/Dynamics/StepConf.hpp>
 #include <PlayRho/Dynamics/BodyConf.hpp>
 #include <PlayRho/Dynamics/Contacts/Contact.hpp>
@@ -35,6 +36,8 @@
 #include <PlayRho/Collision/Shapes/EdgeShapeConf.hpp>
 #include <PlayRho/Collision/Collision.hpp>
 #include <PlayRho/Collision/DynamicTree.hpp> // for GetTree
+#include <PlayRho/Collision/SweepAndPrune.hpp>
+#include <PlayRho/Collision/BroadPhase.hpp>
 #include <PlayRho/Collision/RayCastInput.hpp>
 #include <PlayRho/Collision/RayCastOutput.hpp>
 #include <PlayRho/Collision/Manifold.hpp>
@@ -54,7 +57,10 @@
 #include <PlayRho/Dynamics/Joints/WheelJointConf.hpp>
 #include <PlayRho/Dynamics/Joints/GearJointConf.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <functional>
 #include <type_traits>
 
 using namespace playrho;
@@ -82,6 +88,21 @@ TEST(World, Conf)
     
     EXPECT_EQ(defaultConf.maxVertexRadius, worldConf.maxVertexRadius);
     EXPECT_EQ(defaultConf.minVertexRadius, worldConf.minVertexRadius);
+    EXPECT_EQ(defaultConf.threads, worldConf.threads);
+    EXPECT_EQ(WorldConf{}.UseThreads(4).threads, 4u);
+    EXPECT_EQ(defaultConf.updateContactsChunkSize, worldConf.updateContactsChunkSize);
+    EXPECT_EQ(WorldConf{}.UseUpdateContactsChunkSize(8u).updateContactsChunkSize, 8u);
+    EXPECT_EQ(defaultConf.colorConstraints, worldConf.colorConstraints);
+    EXPECT_TRUE(WorldConf{}.UseColorConstraints(true).colorConstraints);
+    EXPECT_EQ(defaultConf.toiBatchWindow, worldConf.toiBatchWindow);
+    EXPECT_EQ(WorldConf{}.UseToiBatchWindow(Real(0.5)).toiBatchWindow, Real(0.5));
+    EXPECT_EQ(defaultConf.broadPhaseType, BroadPhaseType::DynamicTree);
+    EXPECT_EQ(WorldConf{}.UseBroadPhaseType(BroadPhaseType::SweepAndPrune).broadPhaseType,
+              BroadPhaseType::SweepAndPrune);
+    EXPECT_EQ(defaultConf.hashGridCellSize, worldConf.hashGridCellSize);
+    EXPECT_EQ(WorldConf{}.UseHashGridCellSize(3_m).hashGridCellSize, 3_m);
+    EXPECT_FALSE(defaultConf.separateStaticTree);
+    EXPECT_TRUE(WorldConf{}.UseSeparateStaticTree(true).separateStaticTree);
     const auto stepConf = StepConf{};
 
     const auto v = Real(1);
@@ -681,6 +702,8 @@ TEST(World, CreateDestroyContactingBodies)
     EXPECT_EQ(stats0.toi.maxDistIters, static_cast<decltype(stats0.toi.maxDistIters)>(0));
     EXPECT_EQ(stats0.toi.maxToiIters, static_cast<decltype(stats0.toi.maxToiIters)>(0));
     EXPECT_EQ(stats0.toi.maxRootIters, static_cast<decltype(stats0.toi.maxRootIters)>(0));
+    EXPECT_EQ(stats0.toi.sumDistIters, static_cast<decltype(stats0.toi.sumDistIters)>(0));
+    EXPECT_EQ(stats0.toi.sumToiIters, static_cast<decltype(stats0.toi.sumToiIters)>(0));
 
     contacts = world.GetContacts();
     EXPECT_FALSE(contacts.empty());
@@ -829,6 +852,604 @@ TEST(World, SynchronizeProxies)
     EXPECT_EQ(world.Step(stepConf).pre.proxiesMoved, PreStepStats::counter_type(1));
 }
 
+namespace {
+
+/// @brief Scenario of a world whose steps get compared between numbers of threads.
+struct ThreadsScenario
+{
+    const char* name; ///< Name of the scenario.
+    WorldConf conf; ///< Configuration of the world besides its number of threads.
+    StepConf stepConf; ///< Configuration of the steps.
+    int steps; ///< Number of steps.
+    std::function<std::vector<BodyID>(World&)> populate; ///< Creates the world's bodies.
+    bool batchesToiEvents; ///< Whether more than one thread batches TOI events.
+};
+
+/// @brief Everything that the number of threads a world steps with mustn't change.
+struct ThreadsResult
+{
+    /// @brief Contacts after each step.
+    std::vector<std::vector<KeyedContactPtr>> contacts;
+
+    /// @brief Contact listener calls of each step, with their manifold point counts.
+    std::vector<std::vector<std::tuple<char, ContactID, std::size_t>>> events;
+
+    /// @brief Transformations of the populated bodies after the last step.
+    std::vector<Transformation> transformations;
+};
+
+bool operator==(const ThreadsResult& lhs, const ThreadsResult& rhs)
+{
+    return (lhs.contacts == rhs.contacts) && (lhs.events == rhs.events) &&
+        (lhs.transformations == rhs.transformations);
+}
+
+ThreadsResult RunThreadsScenario(const ThreadsScenario& scenario, std::uint8_t threads,
+                                 ToiStepStats& toiStats)
+{
+    auto world = World{WorldConf{scenario.conf}.UseThreads(threads)};
+    const auto bodies = scenario.populate(world);
+    auto result = ThreadsResult{};
+    result.events.resize(static_cast<std::size_t>(scenario.steps));
+    auto step = std::size_t{0};
+    world.SetBeginContactListener([&](ContactID id) {
+        result.events[step].emplace_back('b', id, 0u);
+    });
+    world.SetEndContactListener([&](ContactID id) {
+        result.events[step].emplace_back('e', id, 0u);
+    });
+    world.SetPreSolveContactListener([&](ContactID id, const Manifold& oldManifold) {
+        result.events[step].emplace_back('p', id, std::size_t{oldManifold.GetPointCount()});
+    });
+    world.SetPostSolveContactListener([&](ContactID id, const ContactImpulsesList& impulses,
+                                          unsigned) {
+        result.events[step].emplace_back('s', id, std::size_t{impulses.GetCount()});
+    });
+    toiStats = ToiStepStats{};
+    for (step = 0; step < size(result.events); ++step)
+    {
+        const auto stats = world.Step(scenario.stepConf).toi;
+        toiStats.eventsBatched += stats.eventsBatched;
+        toiStats.maxBatchThreads = std::max(toiStats.maxBatchThreads, stats.maxBatchThreads);
+        result.contacts.emplace_back(begin(world.GetContacts()), end(world.GetContacts()));
+    }
+    for (const auto& id: bodies)
+    {
+        result.transformations.push_back(GetTransformation(world, id));
+    }
+    return result;
+}
+
+/// @brief Creates a grid of falling disks - lots of proxies to find contacts for and of
+///   contacts to update.
+std::vector<BodyID> PopulateDiskGrid(World& world)
+{
+    const auto shape = Shape{DiskShapeConf{}.UseRadius(0.5_m).UseDensity(1_kgpm2)};
+    auto bodies = std::vector<BodyID>{};
+    for (auto i = 0; i < 40; ++i)
+    {
+        for (auto j = 0; j < 20; ++j)
+        {
+            const auto location = Length2{i * 0.75_m, j * 0.75_m};
+            const auto body = world.CreateBody(BodyConf{}
+                                               .UseType(BodyType::Dynamic)
+                                               .UseLocation(location)
+                                               .UseLinearAcceleration(EarthlyGravity));
+            world.CreateFixture(body, shape);
+            bodies.push_back(body);
+        }
+    }
+    return bodies;
+}
+
+/// @brief Creates stacks of different heights on a shared ground - islands of different
+///   sizes that share a static body.
+std::vector<BodyID> PopulateStacks(World& world)
+{
+    const auto ground = Shape{EdgeShapeConf{Length2{-20_m, 0_m}, Length2{20_m, 0_m}}};
+    const auto box = Shape{PolygonShapeConf{}.SetAsBox(0.5_m, 0.5_m).UseDensity(1_kgpm2)};
+    world.CreateFixture(world.CreateBody(), ground);
+    auto bodies = std::vector<BodyID>{};
+    for (auto i = 0; i < 10; ++i)
+    {
+        for (auto j = 0; j <= i; ++j)
+        {
+            const auto location = Length2{(i - 5) * 3_m, (Real(j) + Real(0.5)) * 1.01_m};
+            const auto body = world.CreateBody(BodyConf{}
+                                               .UseType(BodyType::Dynamic)
+                                               .UseLocation(location)
+                                               .UseLinearAcceleration(EarthlyGravity));
+            world.CreateFixture(body, box);
+            bodies.push_back(body);
+        }
+    }
+    return bodies;
+}
+
+/// @brief Creates a pyramid - one island with enough contacts to get solved by colour.
+std::vector<BodyID> PopulatePyramid(World& world)
+{
+    constexpr auto numRows = 20;
+    const auto ground = Shape{EdgeShapeConf{Length2{-40_m, 0_m}, Length2{40_m, 0_m}}};
+    const auto box = Shape{PolygonShapeConf{}.SetAsBox(0.5_m, 0.5_m).UseDensity(1_kgpm2)};
+    world.CreateFixture(world.CreateBody(), ground);
+    auto bodies = std::vector<BodyID>{};
+    for (auto row = 0; row < numRows; ++row)
+    {
+        for (auto column = 0; column < numRows - row; ++column)
+        {
+            const auto location = Length2{
+                (Real(column) + Real(row) / 2 - Real(numRows) / 2) * 1_m,
+                (Real(row) + Real(0.5)) * 1_m
+            };
+            const auto body = world.CreateBody(BodyConf{}
+                                               .UseType(BodyType::Dynamic)
+                                               .UseLocation(location)
+                                               .UseLinearAcceleration(EarthlyGravity));
+            world.CreateFixture(body, box);
+            bodies.push_back(body);
+        }
+    }
+    return bodies;
+}
+
+/// @brief Creates bullets that each hit their own wall - independent TOI events.
+std::vector<BodyID> PopulateBullets(World& world)
+{
+    const auto wall = Shape{PolygonShapeConf{}.SetAsBox(0.05_m, 2_m)};
+    const auto bullet = Shape{DiskShapeConf{}.UseRadius(0.1_m).UseDensity(1_kgpm2)};
+    auto bodies = std::vector<BodyID>{};
+    for (auto i = 0; i < 64; ++i)
+    {
+        const auto y = i * 10_m;
+        world.CreateFixture(world.CreateBody(BodyConf{}.UseLocation(Length2{5_m, y})), wall);
+        const auto body = world.CreateBody(BodyConf{}
+                                           .UseType(BodyType::Dynamic)
+                                           .UseBullet(true)
+                                           .UseLocation(Length2{0_m, y})
+                                           .UseLinearVelocity(LinearVelocity2{
+            (100 + i) * 1_mps, 0_mps}));
+        world.CreateFixture(body, bullet);
+        bodies.push_back(body);
+    }
+    return bodies;
+}
+
+std::vector<BodyID> PopulateBouncingBullets(World& world)
+{
+    const auto wall = Shape{PolygonShapeConf{}.UseRestitution(1).SetAsBox(0.05_m, 10_m)};
+    for (const auto& offset: {-10_m, +10_m})
+    {
+        world.CreateFixture(world.CreateBody(BodyConf{}.UseLocation(Length2{offset, 0_m})), wall);
+        world.CreateFixture(world.CreateBody(BodyConf{}.UseLocation(Length2{0_m, offset})
+                                             .UseAngle(90_deg)), wall);
+    }
+    const auto bullet = Shape{DiskShapeConf{}.UseRadius(0.1_m).UseDensity(1_kgpm2)
+        .UseRestitution(1)};
+    auto bodies = std::vector<BodyID>{};
+    for (auto i = 0; i < 64; ++i)
+    {
+        // Spreads the bullets over the box and their headings over the circle.
+        const auto x = std::fmod(i * Real(0.618034), Real(1)) * 18 - 9;
+        const auto y = std::fmod(i * Real(0.754878), Real(1)) * 18 - 9;
+        const auto angle = i * Real(2.39996) * 1_rad;
+        const auto body = world.CreateBody(BodyConf{}
+                                           .UseType(BodyType::Dynamic)
+                                           .UseBullet(true)
+                                           .UseLocation(Length2{x * 1_m, y * 1_m})
+                                           .UseLinearVelocity((100 + i) * 1_mps *
+                                                              UnitVec::Get(angle)));
+        world.CreateFixture(body, bullet);
+        bodies.push_back(body);
+    }
+    return bodies;
+}
+
+StepConf GetWideSolveStepConf()
+{
+    auto conf = StepConf{};
+    conf.doWideSolve = true;
+    return conf;
+}
+
+class WorldThreads: public ::testing::TestWithParam<ThreadsScenario>
+{
+};
+
+std::string GetThreadsScenarioName(const ::testing::TestParamInfo<ThreadsScenario>& info)
+{
+    return info.param.name;
+}
+
+} // namespace
+
+TEST_P(WorldThreads, MatchOneThread)
+{
+    const auto& scenario = GetParam();
+    auto toiStats = ToiStepStats{};
+    const auto serial = RunThreadsScenario(scenario, 1u, toiStats);
+    ASSERT_TRUE(std::any_of(begin(serial.events), end(serial.events), [](const auto& events) {
+        return !empty(events);
+    }));
+    EXPECT_EQ(toiStats.eventsBatched, 0u);
+    auto sortedSerial = serial;
+    for (auto& events: sortedSerial.events)
+    {
+        std::sort(begin(events), end(events));
+    }
+    for (const auto threads: {2u, 3u, 4u})
+    {
+        auto result = RunThreadsScenario(scenario, static_cast<std::uint8_t>(threads), toiStats);
+        if (toiStats.eventsBatched == 0u)
+        {
+            EXPECT_TRUE(result == serial) << "threads=" << threads;
+        }
+        else
+        {
+            // The listeners of a batch's events get called a batch at a time, so only the
+            // calls of each step are the same.
+            for (auto& events: result.events)
+            {
+                std::sort(begin(events), end(events));
+            }
+            EXPECT_TRUE(result == sortedSerial) << "threads=" << threads;
+        }
+        if (scenario.batchesToiEvents)
+        {
+            // The events get batched and the batches get split among the threads.
+            EXPECT_GT(toiStats.eventsBatched, 0u);
+            EXPECT_GT(toiStats.maxBatchThreads, 1u);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(World, WorldThreads, ::testing::Values(
+    // All 800 proxies are new for the first step. That's enough for one thread to descend
+    // the tree against itself but with extra threads they get split up over them instead.
+    ThreadsScenario{"DiskGrid", WorldConf{}.UseUpdateContactsChunkSize(7u), StepConf{}, 10,
+        PopulateDiskGrid, false},
+    ThreadsScenario{"Stacks", WorldConf{}, StepConf{}, 20, PopulateStacks, false},
+    ThreadsScenario{"ColoredPyramid", WorldConf{}.UseColorConstraints(true), StepConf{}, 30,
+        PopulatePyramid, false},
+    ThreadsScenario{"WideSolvedPyramid", WorldConf{}, GetWideSolveStepConf(), 30,
+        PopulatePyramid, false},
+    // The events are independent so batching all of them gets the serial results.
+    ThreadsScenario{"Bullets", WorldConf{}.UseToiBatchWindow(1), StepConf{}, 5,
+        PopulateBullets, true},
+    // Bullets bounce around a box passing close to each other so batches have to stop at
+    // the events whose regions overlap earlier ones'.
+    ThreadsScenario{"BouncingBullets", WorldConf{}.UseToiBatchWindow(1), StepConf{}, 30,
+        PopulateBouncingBullets, false}
+), GetThreadsScenarioName);
+
+TEST(World, ColoredPyramidHoldsUp)
+{
+    const auto run = [](const WorldConf& conf, const StepConf& stepConf) {
+        auto world = World{conf};
+        const auto bodies = PopulatePyramid(world);
+        for (auto i = 0; i < 30; ++i)
+        {
+            world.Step(stepConf);
+        }
+        auto transformations = std::vector<Transformation>{};
+        for (const auto& id: bodies)
+        {
+            transformations.push_back(GetTransformation(world, id));
+        }
+        return transformations;
+    };
+    const auto colored = run(WorldConf{}.UseColorConstraints(true), StepConf{});
+    EXPECT_GT(GetY(colored.back().p), 19_m);
+    // Wide solving colours the constraints too and solves them the same way a batch at a time.
+    EXPECT_TRUE(colored == run(WorldConf{}, GetWideSolveStepConf()));
+}
+
+TEST(World, BroadPhaseTypesFindSameContacts)
+{
+    const auto shape = Shape{DiskShapeConf{}.UseRadius(0.5_m).UseDensity(1_kgpm2)};
+    const auto stepConf = StepConf{};
+    const auto getFixturePairs = [&](BroadPhaseType type) {
+        auto world = World{WorldConf{}.UseBroadPhaseType(type)};
+        for (auto i = 0; i < 40; ++i)
+        {
+            for (auto j = 0; j < 20; ++j)
+            {
+                const auto location = Length2{i * 0.75_m, j * 0.75_m};
+                const auto body = world.CreateBody(BodyConf{}
+                                                   .UseType(BodyType::Dynamic)
+                                                   .UseLocation(location));
+                world.CreateFixture(body, shape);
+            }
+        }
+        world.Step(stepConf);
+        auto pairs = std::vector<std::pair<FixtureID, FixtureID>>{};
+        for (const auto& c: world.GetContacts())
+        {
+            const auto fixtureA = GetFixtureA(world, std::get<ContactID>(c));
+            const auto fixtureB = GetFixtureB(world, std::get<ContactID>(c));
+            pairs.emplace_back(std::min(fixtureA, fixtureB), std::max(fixtureA, fixtureB));
+        }
+        std::sort(begin(pairs), end(pairs));
+        return pairs;
+    };
+    const auto treePairs = getFixturePairs(BroadPhaseType::DynamicTree);
+    ASSERT_FALSE(empty(treePairs));
+    EXPECT_TRUE(treePairs == getFixturePairs(BroadPhaseType::SweepAndPrune));
+    EXPECT_TRUE(treePairs == getFixturePairs(BroadPhaseType::HashGrid));
+    EXPECT_TRUE(treePairs == getFixturePairs(BroadPhaseType::WideDynamicTree));
+}
+
+TEST(World, SweepAndPruneBroadPhase)
+{
+    auto world = World{WorldConf{}.UseBroadPhaseType(BroadPhaseType::SweepAndPrune)};
+    EXPECT_EQ(GetType(world.GetBroadPhase()), GetTypeID<SweepAndPrune>());
+    EXPECT_EQ(world.GetTree().GetLeafCount(), 0u);
+
+    const auto body = world.CreateBody(BodyConf{}.UseType(BodyType::Dynamic));
+    const auto fixture = world.CreateFixture(body, Shape{DiskShapeConf{1_m}});
+    ASSERT_NE(fixture, InvalidFixtureID);
+    world.Step(StepConf{});
+    EXPECT_EQ(world.GetBroadPhase().GetLeafCount(), 1u);
+    EXPECT_EQ(world.GetTree().GetLeafCount(), 0u);
+
+    auto found = InvalidFixtureID;
+    Query(GetBroadPhase(world), AABB{LengthInterval{-0.5_m, 0.5_m}, LengthInterval{0_m, 1_m}},
+          [&](FixtureID f, ChildCounter) {
+        found = f;
+        return true;
+    });
+    EXPECT_EQ(found, fixture);
+
+    found = InvalidFixtureID;
+    const auto input = RayCastInput{Length2{-5_m, 0.1_m}, Length2{+5_m, 0.1_m}, Real(1)};
+    RayCast(world, input, [&](BodyID, FixtureID f, ChildCounter, Length2, UnitVec) {
+        found = f;
+        return RayCastOpcode::Terminate;
+    });
+    EXPECT_EQ(found, fixture);
+}
+
+TEST(World, SeparateStaticTree)
+{
+    auto world = World{WorldConf{}.UseSeparateStaticTree(true)};
+    const auto ground = world.CreateBody(BodyConf{}.UseType(BodyType::Static));
+    const auto groundFixture = world.CreateFixture(ground, Shape{EdgeShapeConf{}
+        .Set(Length2{-10_m, 0_m}, Length2{+10_m, 0_m})});
+    const auto wall = world.CreateBody(BodyConf{}.UseType(BodyType::Static));
+    world.CreateFixture(wall, Shape{EdgeShapeConf{}
+        .Set(Length2{-10_m, 0_m}, Length2{-10_m, 10_m})});
+    const auto disk = world.CreateBody(BodyConf{}.UseType(BodyType::Dynamic)
+                                       .UseLocation(Length2{0_m, 0.9_m}));
+    const auto diskFixture = world.CreateFixture(disk, Shape{DiskShapeConf{1_m}});
+
+    auto stepConf = StepConf{};
+    stepConf.deltaTime = 0_s;
+    world.Step(stepConf);
+    EXPECT_EQ(world.GetStaticTree().GetLeafCount(), 2u);
+    EXPECT_EQ(world.GetBroadPhase().GetLeafCount(), 1u);
+
+    // Only the disk and the ground overlap. The touching static ground and wall don't pair.
+    ASSERT_EQ(size(world.GetContacts()), 1u);
+    const auto contact = std::get<ContactID>(*begin(world.GetContacts()));
+    const auto fixtures = std::minmax({GetFixtureA(world, contact), GetFixtureB(world, contact)});
+    EXPECT_EQ(fixtures, std::minmax({groundFixture, diskFixture}));
+
+    auto found = InvalidFixtureID;
+    const auto input = RayCastInput{Length2{0_m, 5_m}, Length2{0_m, -5_m}, Real(1)};
+    RayCast(world, input, [&](BodyID, FixtureID f, ChildCounter, Length2, UnitVec) {
+        found = f;
+        return RayCastOpcode::ClipRay;
+    });
+    EXPECT_EQ(found, diskFixture);
+    found = InvalidFixtureID;
+    RayCast(world, RayCastInput{Length2{5_m, 5_m}, Length2{5_m, -5_m}, Real(1)},
+            [&](BodyID, FixtureID f, ChildCounter, Length2, UnitVec) {
+        found = f;
+        return RayCastOpcode::ClipRay;
+    });
+    EXPECT_EQ(found, groundFixture);
+
+    // Changing body types moves proxies between the trees.
+    SetType(world, ground, BodyType::Dynamic);
+    SetType(world, disk, BodyType::Static);
+    world.Step(stepConf);
+    EXPECT_EQ(world.GetStaticTree().GetLeafCount(), 2u);
+    EXPECT_EQ(world.GetBroadPhase().GetLeafCount(), 1u);
+    EXPECT_EQ(size(world.GetContacts()), 2u);
+
+    Destroy(world, ground);
+    world.Step(stepConf);
+    EXPECT_EQ(world.GetStaticTree().GetLeafCount(), 2u);
+    EXPECT_EQ(world.GetBroadPhase().GetLeafCount(), 0u);
+    EXPECT_EQ(size(world.GetContacts()), 0u);
+
+    world.Clear();
+    EXPECT_EQ(world.GetStaticTree().GetLeafCount(), 0u);
+}
+
+TEST(World, RayCastAnyCallableSameAsStdFunction)
+{
+    for (const auto separateStaticTree: {false, true})
+    {
+        auto world = World{WorldConf{}.UseSeparateStaticTree(separateStaticTree)};
+        for (auto i = 0; i < 10; ++i)
+        {
+            const auto type = (i % 2)? BodyType::Static: BodyType::Dynamic;
+            const auto location = Length2{Real(i) * 3_m, 0_m};
+            const auto body = world.CreateBody(BodyConf{}.UseType(type).UseLocation(location));
+            world.CreateFixture(body, Shape{DiskShapeConf{1_m}});
+        }
+        auto stepConf = StepConf{};
+        stepConf.deltaTime = 0_s;
+        world.Step(stepConf);
+
+        const auto input = RayCastInput{Length2{-5_m, 0_m}, Length2{+35_m, 0_m}, Real(1)};
+        auto expected = std::vector<FixtureID>{};
+        EXPECT_FALSE(RayCast(world, input, FixtureRayCastCB{
+            [&](BodyID, FixtureID f, ChildCounter, Length2, UnitVec) {
+            expected.push_back(f);
+            return RayCastOpcode::ResetRay;
+        }}));
+        ASSERT_EQ(size(expected), 10u);
+
+        auto found = std::vector<FixtureID>{};
+        EXPECT_FALSE(RayCast(world, input, [&](BodyID, FixtureID f, ChildCounter,
+                                               Length2, UnitVec) {
+            found.push_back(f);
+            return RayCastOpcode::ResetRay;
+        }));
+        EXPECT_EQ(found, expected);
+
+        auto closest = InvalidFixtureID;
+        RayCast(world, input, [&](BodyID, FixtureID f, ChildCounter, Length2, UnitVec) {
+            closest = f;
+            return RayCastOpcode::ClipRay;
+        });
+        EXPECT_EQ(closest, FixtureID(0u));
+    }
+}
+
+TEST(World, TreeOptimizeBudget)
+{
+    auto world = World{};
+    for (auto i = 0; i < 40; ++i)
+    {
+        const auto location = Length2{Real(i % 8) * 3_m, Real(i / 8) * 3_m};
+        const auto body = world.CreateBody(BodyConf{}.UseLocation(location));
+        world.CreateFixture(body, Shape{DiskShapeConf{1_m}});
+    }
+
+    auto stepConf = StepConf{};
+    EXPECT_EQ(stepConf.treeOptimizeBudget, 0u);
+    auto stats = world.Step(stepConf);
+    EXPECT_EQ(stats.pre.treeNodesVisited, 0u);
+    EXPECT_EQ(stats.pre.treeRebuilds, 0u);
+    EXPECT_EQ(stats.pre.treePerimeterRatio, Real(0));
+
+    stepConf.treeOptimizeBudget = 16;
+    stats = world.Step(stepConf);
+    EXPECT_GT(stats.pre.treeNodesVisited, 0u);
+    EXPECT_LE(stats.pre.treeNodesVisited, 16u);
+    EXPECT_EQ(stats.pre.treeHeight, GetHeight(world.GetTree()));
+
+    // Keep stepping till the optimizer has swept the whole tree at least once.
+    for (auto i = 0; (i < 1000) && (stats.pre.treePerimeterRatio == Real(0)); ++i)
+    {
+        stats = world.Step(stepConf);
+    }
+    EXPECT_GT(stats.pre.treePerimeterRatio, Real(1));
+    EXPECT_LE(stats.pre.treeMaxImbalance, stats.pre.treeHeight);
+}
+
+TEST(World, AabbExtensionSteps)
+{
+    const auto shape = Shape{DiskShapeConf{1_m}.UseDensity(1_kgpm2)};
+    auto fixedConf = StepConf{};
+    ASSERT_EQ(fixedConf.aabbExtensionSteps, Real(0));
+    ASSERT_FALSE(fixedConf.doFalsePairStats);
+    fixedConf.doFalsePairStats = true;
+    auto adaptiveConf = fixedConf;
+    adaptiveConf.aabbExtensionSteps = 4;
+
+    // Bodies at rest whose fixtures are just farther apart than the fixed extension.
+    for (const auto& conf: {fixedConf, adaptiveConf})
+    {
+        auto world = World{};
+        const auto gap = (conf.aabbExtension + conf.minAabbExtension) * Real(1.5);
+        for (const auto x: {0_m, 2_m + gap})
+        {
+            const auto body = world.CreateBody(BodyConf{}.UseType(BodyType::Dynamic)
+                                               .UseLocation(Length2{x, 0_m}));
+            world.CreateFixture(body, shape);
+        }
+        const auto stats = world.Step(conf);
+        const auto expected = (conf.aabbExtensionSteps > 0)? 0u: 1u;
+        EXPECT_EQ(stats.pre.added, expected);
+        EXPECT_EQ(stats.pre.falsePairs, expected);
+        EXPECT_EQ(stats.reg.falsePairs, 0u);
+    }
+    {
+        // False pairs aren't counted unless asked for.
+        auto world = World{};
+        const auto gap = (fixedConf.aabbExtension + fixedConf.minAabbExtension) * Real(1.5);
+        for (const auto x: {0_m, 2_m + gap})
+        {
+            const auto body = world.CreateBody(BodyConf{}.UseType(BodyType::Dynamic)
+                                               .UseLocation(Length2{x, 0_m}));
+            world.CreateFixture(body, shape);
+        }
+        const auto stats = world.Step(StepConf{});
+        EXPECT_EQ(stats.pre.added, 1u);
+        EXPECT_EQ(stats.pre.falsePairs, 0u);
+    }
+
+    // A fast moving body.
+    auto updates = std::vector<PreStepStats::counter_type>{};
+    auto avoided = std::vector<PreStepStats::counter_type>{};
+    for (const auto& conf: {fixedConf, adaptiveConf})
+    {
+        auto world = World{};
+        const auto body = world.CreateBody(BodyConf{}.UseType(BodyType::Dynamic)
+                                           .UseLinearVelocity(LinearVelocity2{20_mps, 0_mps}));
+        world.CreateFixture(body, shape);
+        auto moved = PreStepStats::counter_type{0};
+        auto unmoved = PreStepStats::counter_type{0};
+        for (auto i = 0; i < 60; ++i)
+        {
+            const auto stats = world.Step(conf);
+            moved += stats.reg.proxiesMoved;
+            unmoved += stats.reg.updatesAvoided;
+        }
+        EXPECT_EQ(moved + unmoved, 60u);
+        updates.push_back(moved);
+        avoided.push_back(unmoved);
+    }
+    EXPECT_LT(updates[1], updates[0]);
+    EXPECT_GT(avoided[1], avoided[0]);
+}
+
+TEST(World, ManifoldReuse)
+{
+    const auto ground = Shape{EdgeShapeConf{}.Set(Length2{-10_m, 0_m}, Length2{10_m, 0_m})};
+    const auto box = Shape{PolygonShapeConf{}.UseDensity(1_kgpm2).SetAsBox(0.5_m, 0.5_m)};
+    auto defaultConf = StepConf{};
+    ASSERT_EQ(defaultConf.manifoldReuseDistance, 0_m);
+    ASSERT_EQ(defaultConf.manifoldReuseAngle, 0_deg);
+    auto reuseConf = StepConf{};
+    reuseConf.manifoldReuseDistance = reuseConf.linearSlop / Real(4);
+    reuseConf.manifoldReuseAngle = 0.5_deg;
+
+    // A stack of boxes settling on the ground.
+    auto sumsReused = std::vector<PreStepStats::counter_type>{};
+    auto tops = std::vector<Length>{};
+    for (const auto& conf: {defaultConf, reuseConf})
+    {
+        auto world = World{};
+        world.CreateFixture(world.CreateBody(), ground);
+        auto top = InvalidBodyID;
+        for (auto i = 0; i < 4; ++i)
+        {
+            top = world.CreateBody(BodyConf{}.UseType(BodyType::Dynamic)
+                                   .UseLinearAcceleration(EarthlyGravity)
+                                   .UseLocation(Length2{0_m, Real(i) * 1_m + 0.5_m}));
+            world.CreateFixture(top, box);
+        }
+        auto sumReused = PreStepStats::counter_type{0};
+        for (auto i = 0; i < 120; ++i)
+        {
+            const auto stats = world.Step(conf);
+            EXPECT_LE(stats.pre.reused, stats.pre.updated);
+            sumReused += stats.pre.reused;
+        }
+        sumsReused.push_back(sumReused);
+        tops.push_back(GetY(GetLocation(world, top)));
+    }
+    EXPECT_EQ(sumsReused[0], 0u);
+    EXPECT_GT(sumsReused[1], 0u);
+    EXPECT_NEAR(static_cast<double>(Real(tops[1] / Meter)),
+                static_cast<double>(Real(tops[0] / Meter)), 0.01);
+}
+
 TEST(World, SetTypeOfBody)
 {
     auto world = World{};
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "UnitTests.hpp"
+
+#include <PlayRho/Dynamics/World.hpp>
+#include <PlayRho/Dynamics/WorldBody.hpp>
+#include <PlayRho/Dynamics/WorldFixture.hpp>
+#include <PlayRho/Dynamics/WorldRayCast.hpp>
+#include <PlayRho/Dynamics/WorldMisc.hpp>
+#include <PlayRho/Dynamics/BodyConf.hpp>
+#include <PlayRho/Dynamics/StepConf.hpp>
+
+#include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/PolygonShapeConf.hpp>
+#include <PlayRho/Collision/BroadPhase.hpp>
+#include <PlayRho/Collision/DynamicTree.hpp>
+
+#include <PlayRho/Common/InvalidArgument.hpp>
+#include <PlayRho/Common/ThreadPool.hpp>
+
+#include <vector>
+
+using namespace playrho;
+using namespace playrho::d2;
+
+namespace {
+
+World MakeRayCastWorld(const WorldConf& conf)
+{
+    auto world = World{conf};
+    for (auto i = 0; i < 60; ++i)
+    {
+        const auto type = (i % 3 == 0)? BodyType::Static: BodyType::Dynamic;
+        const auto location = Length2{Real((i * 37) % 41 - 20) * 1_m,
+                                      Real((i * 53) % 43 - 21) * 1_m};
+        const auto body = world.CreateBody(BodyConf{}.UseType(type).UseLocation(location));
+        if (i % 2)
+        {
+            world.CreateFixture(body, Shape{DiskShapeConf{0.5_m}});
+        }
+        else
+        {
+            world.CreateFixture(body, Shape{PolygonShapeConf{}.SetAsBox(0.4_m, 0.6_m)});
+        }
+    }
+    auto stepConf = StepConf{};
+    stepConf.deltaTime = 0_s;
+    world.Step(stepConf);
+    return world;
+}
+
+std::vector<RayCastInput> GetSweepInputs(std::size_t count)
+{
+    auto inputs = std::vector<RayCastInput>{};
+    for (auto i = std::size_t{0}; i < count; ++i)
+    {
+        const auto angle = Real(i) * 2 * Pi / Real(count) * 1_rad;
+        inputs.push_back(RayCastInput{Length2{0.1_m, 0.2_m},
+            Length2{0.1_m, 0.2_m} + Rotate(Length2{30_m, 0_m}, UnitVec::Get(angle)),
+            Real(1)});
+    }
+    return inputs;
+}
+
+} // anonymous namespace
+
+TEST(WorldRayCast, FixtureRayCastHitDefaultConstruction)
+{
+    const auto hit = FixtureRayCastHit{};
+    EXPECT_EQ(hit.body, InvalidBodyID);
+    EXPECT_EQ(hit.fixture, InvalidFixtureID);
+    EXPECT_EQ(hit.child, ChildCounter(0));
+    EXPECT_EQ(hit.fraction, UnitInterval<Real>(0));
+}
+
+TEST(WorldRayCast, RayCastClosestThrowsOnSizeMismatch)
+{
+    const auto world = World{};
+    auto inputs = std::vector<RayCastInput>(2u);
+    auto outputs = std::vector<FixtureRayCastOutput>(1u);
+    EXPECT_THROW(RayCastClosest(world, inputs, outputs), InvalidArgument);
+    outputs.clear();
+    inputs.clear();
+    EXPECT_NO_THROW(RayCastClosest(world, inputs, outputs));
+}
+
+TEST(WorldRayCast, RayCastClosestSameAsRayCastEachRay)
+{
+    const auto inputs = GetSweepInputs(101u);
+    for (const auto type: {BroadPhaseType::DynamicTree, BroadPhaseType::SweepAndPrune})
+    {
+        for (const auto separateStaticTree: {false, true})
+        {
+            const auto world = MakeRayCastWorld(WorldConf{}.UseBroadPhaseType(type)
+                                                .UseSeparateStaticTree(separateStaticTree));
+            auto expected = std::vector<FixtureRayCastOutput>(size(inputs));
+            for (auto i = std::size_t{0}; i < size(inputs); ++i)
+            {
+                RayCast(world, inputs[i], [&](BodyID body, FixtureID fixture,
+                                              ChildCounter child, Length2 point,
+                                              UnitVec normal) {
+                    expected[i] = FixtureRayCastHit{body, fixture, child, point, normal};
+                    return RayCastOpcode::ClipRay;
+                });
+            }
+            ASSERT_GT(std::count_if(cbegin(expected), cend(expected),
+                                    [](const FixtureRayCastOutput& output) {
+                return output.has_value();
+            }), 50);
+
+            for (const auto workers: {0u, 2u})
+            {
+                auto outputs = std::vector<FixtureRayCastOutput>(size(inputs));
+                if (workers == 0u)
+                {
+                    RayCastClosest(world, inputs, outputs);
+                }
+                else
+                {
+                    auto pool = ThreadPool{workers};
+                    RayCastClosest(world, inputs, outputs, pool);
+                }
+                for (auto i = std::size_t{0}; i < size(inputs); ++i)
+                {
+                    ASSERT_EQ(outputs[i].has_value(), expected[i].has_value()) << i;
+                    if (outputs[i].has_value())
+                    {
+                        EXPECT_EQ(outputs[i]->body, expected[i]->body);
+                        EXPECT_EQ(outputs[i]->fixture, expected[i]->fixture);
+                        EXPECT_EQ(outputs[i]->child, expected[i]->child);
+                        EXPECT_NEAR(static_cast<double>(Real{GetX(outputs[i]->point) / 1_m}),
+                                    static_cast<double>(Real{GetX(expected[i]->point) / 1_m}),
+                                    0.0001);
+                        EXPECT_NEAR(static_cast<double>(Real{GetY(outputs[i]->point) / 1_m}),
+                                    static_cast<double>(Real{GetY(expected[i]->point) / 1_m}),
+                                    0.0001);
+                        EXPECT_EQ(outputs[i]->normal, expected[i]->normal);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(WorldRayCast, QueryBatchSameAsQueryEachAABB)
+{
+    auto aabbs = std::vector<AABB>{};
+    for (auto i = 0; i < 40; ++i)
+    {
+        const auto center = Length2{Real((i * 31) % 43 - 21) * 1_m,
+                                    Real((i * 17) % 41 - 20) * 1_m};
+        const auto extent = Real(1 + i % 4) * 1_m;
+        aabbs.push_back(AABB{center - Length2{extent, extent}, center + Length2{extent, extent}});
+    }
+    aabbs.push_back(AABB{});
+    for (const auto type: {BroadPhaseType::DynamicTree, BroadPhaseType::SweepAndPrune})
+    {
+        for (const auto separateStaticTree: {false, true})
+        {
+            const auto world = MakeRayCastWorld(WorldConf{}.UseBroadPhaseType(type)
+                                                .UseSeparateStaticTree(separateStaticTree));
+            auto expected = std::vector<std::vector<QueryHit>>(size(aabbs));
+            auto total = std::size_t{0};
+            for (auto i = std::size_t{0}; i < size(aabbs); ++i)
+            {
+                const auto addHit = [&](FixtureID fixture, ChildCounter child) {
+                    expected[i].push_back(QueryHit{fixture, child});
+                    return true;
+                };
+                Query(GetBroadPhase(world), aabbs[i], addHit);
+                Query(GetStaticTree(world), aabbs[i], addHit);
+                total += size(expected[i]);
+            }
+            ASSERT_GT(total, std::size_t{40});
+
+            for (const auto workers: {0u, 2u})
+            {
+                auto results = QueryBatchResults{};
+                if (workers == 0u)
+                {
+                    QueryBatch(world, aabbs, results);
+                }
+                else
+                {
+                    auto pool = ThreadPool{workers};
+                    QueryBatch(world, aabbs, results, pool);
+                }
+                ASSERT_EQ(size(results.offsets), size(aabbs) + 1u);
+                for (auto i = std::size_t{0}; i < size(aabbs); ++i)
+                {
+                    const auto hits = GetHits(results, i);
+                    ASSERT_EQ(hits.size(), size(expected[i])) << i;
+                    for (auto j = std::size_t{0}; j < hits.size(); ++j)
+                    {
+                        EXPECT_EQ(hits[j].fixture, expected[i][j].fixture);
+                        EXPECT_EQ(hits[j].child, expected[i][j].child);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020 Louis Langholtz https://github.com/louis-langholtz/PlayRho
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "UnitTests.hpp"
+
+#include <PlayRho/Dynamics/World.hpp>
+#include <PlayRho/Dynamics/WorldBody.hpp>
+#include <PlayRho/Dynamics/WorldFixture.hpp>
+#include <PlayRho/Dynamics/WorldShapeCast.hpp>
+#include <PlayRho/Dynamics/BodyConf.hpp>
+#include <PlayRho/Dynamics/StepConf.hpp>
+
+#include <PlayRho/Collision/DistanceProxy.hpp>
+#include <PlayRho/Collision/Shapes/DiskShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/EdgeShapeConf.hpp>
+#include <PlayRho/Collision/Shapes/PolygonShapeConf.hpp>
+
+using namespace playrho;
+using namespace playrho::d2;
+
+TEST(WorldShapeCast, EmptyWorld)
+{
+    const auto world = World{};
+    const auto disk = Shape{DiskShapeConf{0.5_m}};
+    auto ncalls = 0;
+    EXPECT_FALSE(ShapeCast(world, GetChild(disk, 0), Transformation{}, Length2{10_m, 0_m},
+                           [&](BodyID, FixtureID, ChildCounter, Real, Length2, UnitVec) {
+        ++ncalls;
+        return RayCastOpcode::ClipRay;
+    }));
+    EXPECT_EQ(ncalls, 0);
+}
+
+TEST(WorldShapeCast, ClosestHit)
+{
+    for (const auto separateStaticTree: {false, true})
+    {
+        auto world = World{WorldConf{}.UseSeparateStaticTree(separateStaticTree)};
+        const auto edgeConf = EdgeShapeConf{Length2{-10_m, 0_m}, Length2{+10_m, 0_m}};
+        const auto ground = world.CreateBody(BodyConf{}.UseType(BodyType::Static));
+        const auto groundFixture = world.CreateFixture(ground, Shape{edgeConf});
+        const auto box = world.CreateBody(BodyConf{}.UseType(BodyType::Static)
+                                          .UseLocation(Length2{4_m, 2_m}));
+        const auto boxFixture = world.CreateFixture(box, Shape{PolygonShapeConf{1_m, 1_m}});
+        auto stepConf = StepConf{};
+        stepConf.deltaTime = 0_s;
+        world.Step(stepConf);
+
+        const auto disk = Shape{DiskShapeConf{0.5_m}};
+        const auto proxy = GetChild(disk, 0);
+        const auto radius = GetVertexRadius(edgeConf);
+        const auto tolerance = static_cast<double>(Real{DefaultLinearSlop / 1_m});
+
+        // Falls straight down onto the ground.
+        auto found = InvalidFixtureID;
+        auto foundFraction = Real{0};
+        auto foundPoint = Length2{};
+        auto foundNormal = UnitVec{};
+        EXPECT_FALSE(ShapeCast(world, proxy, Transformation{Length2{0_m, 5_m}},
+                               Length2{0_m, -10_m},
+                               [&](BodyID, FixtureID f, ChildCounter, Real fraction,
+                                   Length2 point, UnitVec normal) {
+            found = f;
+            foundFraction = fraction;
+            foundPoint = point;
+            foundNormal = normal;
+            return RayCastOpcode::ClipRay;
+        }));
+        EXPECT_EQ(found, groundFixture);
+        EXPECT_NEAR(static_cast<double>(foundFraction),
+                    static_cast<double>(Real{(5_m - 0.5_m - radius) / 10_m}), tolerance);
+        EXPECT_NEAR(static_cast<double>(Real{GetX(foundPoint) / 1_m}), 0.0, tolerance);
+        EXPECT_NEAR(static_cast<double>(Real{GetY(foundPoint) / 1_m}),
+                    static_cast<double>(Real{radius / 1_m}), tolerance);
+        EXPECT_NEAR(static_cast<double>(foundNormal.GetX()), 0.0, 0.001);
+        EXPECT_NEAR(static_cast<double>(foundNormal.GetY()), -1.0, 0.001);
+
+        // Falls onto the box that's above the ground.
+        found = InvalidFixtureID;
+        EXPECT_FALSE(ShapeCast(world, proxy, Transformation{Length2{4_m, 8_m}},
+                               Length2{0_m, -10_m},
+                               [&](BodyID, FixtureID f, ChildCounter, Real, Length2, UnitVec) {
+            found = f;
+            return RayCastOpcode::ClipRay;
+        }));
+        EXPECT_EQ(found, boxFixture);
+
+        // Doesn't get as far as anything.
+        auto ncalls = 0;
+        EXPECT_FALSE(ShapeCast(world, proxy, Transformation{Length2{-4_m, 8_m}},
+                               Length2{0_m, -5_m},
+                               [&](BodyID, FixtureID, ChildCounter, Real, Length2, UnitVec) {
+            ++ncalls;
+            return RayCastOpcode::ClipRay;
+        }));
+        EXPECT_EQ(ncalls, 0);
+
+        // Ignores the ground that the disk starts out overlapping.
+        EXPECT_FALSE(ShapeCast(world, proxy, Transformation{Length2{-4_m, 0.1_m}},
+                               Length2{0_m, 5_m},
+                               [&](BodyID, FixtureID, ChildCounter, Real, Length2, UnitVec) {
+            ++ncalls;
+            return RayCastOpcode::ClipRay;
+        }));
+        EXPECT_EQ(ncalls, 0);
+
+        // Terminates at the callback's request.
+        EXPECT_TRUE(ShapeCast(world, proxy, Transformation{Length2{4_m, 8_m}},
+                              Length2{0_m, -10_m},
+                              [&](BodyID, FixtureID, ChildCounter, Real, Length2, UnitVec) {
+            ++ncalls;
+            return RayCastOpcode::Terminate;
+        }));
+        EXPECT_EQ(ncalls, 1);
+    }
+}